@@ -1,10 +1,8 @@
-#version 450 compatibility
-#pragma import_defines(SHADOW_CAST)
 #ifdef SHADOW_CAST
 
 void main()
 {
-	gl_Position = ftransform();
+	gl_Position = ModelPosition();
 }
 
 #else // not SHADOW_CAST
@@ -17,12 +15,13 @@ out vec3	shadowPos;
 
 void main()
 {
-	vec4 viewVertPos = gl_ModelViewMatrix * gl_Vertex;
+	vec4 modelVertex = ModelVertex();
+	vec4 viewVertPos = gl_ModelViewMatrix * modelVertex;
 
-	objPos = gl_Vertex;
+	objPos = modelVertex;
 	viewPos = viewVertPos.xyz / viewVertPos.w;
 	shadowPos = (view2ShadowMatrix*viewVertPos).xyz;
-	gl_Position = ftransform();
+	gl_Position = ModelPosition();
 }
 
 #endif // SHADOW_CAST or not
\ No newline at end of file
@@ -70,6 +70,19 @@ vec3 EnvDFGLazarov(vec3 F0, float gloss, float dotVN)
 	return F0 * scale + bias;
 }
 
+/* 环境探针的漫反射辐照度（已除以π），9个球谐系数由CPU烘焙 */
+uniform vec3 envIrradiance[9];
+uniform float envIrradianceWeight;
+vec3 EnvIrradiance(vec3 localNorm)
+{
+	vec3 n = localNorm;
+	vec3 irradiance = envIrradiance[0]
+		+ envIrradiance[1]*n.y + envIrradiance[2]*n.z + envIrradiance[3]*n.x
+		+ envIrradiance[4]*n.x*n.y + envIrradiance[5]*n.y*n.z + envIrradiance[6]*(3.0*n.z*n.z-1.0)
+		+ envIrradiance[7]*n.x*n.z + envIrradiance[8]*(n.x*n.x-n.y*n.y);
+	return max(irradiance, vec3(0));
+}
+
 #ifdef SHADOW_RECEIVE
 uniform sampler2D texShadow;
 float Shadow(vec3 shadowPos)
@@ -0,0 +1,68 @@
+#version 450 compatibility
+#pragma import_defines(SHADOW_CAST)
+#pragma import_defines(GM_QUANT_POSITION)
+#pragma import_defines(GM_QUANT_NORMAL)
+#pragma import_defines(GM_QUANT_TANGENT)
+#pragma import_defines(GM_QUANT_UV)
+
+/* quantized vertex formats, written by CGMVertexQuantizer when SGMModelData::bQuantize is set */
+#ifdef GM_QUANT_POSITION
+uniform vec3 quantPosOffset; // center of the asset's bounding box
+uniform vec3 quantPosScale; // half extent / 32767
+#endif // GM_QUANT_POSITION
+#ifdef GM_QUANT_NORMAL
+layout(location = 6) in vec2		quantNormal; // octahedral normal, snorm16
+#endif // GM_QUANT_NORMAL
+#ifdef GM_QUANT_UV
+uniform vec4 quantUVRange; // xy = offset, zw = scale
+#endif // GM_QUANT_UV
+
+/* object space vertex */
+vec4 ModelVertex()
+{
+#ifdef GM_QUANT_POSITION
+	return vec4(quantPosOffset + gl_Vertex.xyz*quantPosScale, 1.0);
+#else
+	return gl_Vertex;
+#endif // GM_QUANT_POSITION
+}
+
+/* clip space position, keep ftransform() for float vertices */
+vec4 ModelPosition()
+{
+#ifdef GM_QUANT_POSITION
+	return gl_ModelViewProjectionMatrix * ModelVertex();
+#else
+	return ftransform();
+#endif // GM_QUANT_POSITION
+}
+
+/* octahedral unit vector decode */
+vec3 OctDecode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += (n.x >= 0.0) ? -t : t;
+	n.y += (n.y >= 0.0) ? -t : t;
+	return normalize(n);
+}
+
+/* object space normal */
+vec3 ModelNormal()
+{
+#ifdef GM_QUANT_NORMAL
+	return OctDecode(quantNormal);
+#else
+	return gl_Normal;
+#endif // GM_QUANT_NORMAL
+}
+
+/* texture coordinate of unit 0 */
+vec4 ModelTexCoord()
+{
+#ifdef GM_QUANT_UV
+	return vec4(quantUVRange.xy + gl_MultiTexCoord0.xy*quantUVRange.zw, 0.0, 1.0);
+#else
+	return gl_MultiTexCoord0;
+#endif // GM_QUANT_UV
+}
\ No newline at end of file
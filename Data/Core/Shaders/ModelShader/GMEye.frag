@@ -99,7 +99,9 @@ void main()
 	reflectIn.rgb *= mainlightColor;
 	
 	/* ambient BRDF */
-	vec4 ambient = vec4(mix(vec3(0.2, 0.24, 0.26), vec3(0.04), max(0.5*(1.0-localReflect.z),0)), 1.0);
+	vec3 localNorm = normalize((osg_ViewMatrixInverse*vec4(viewNorm,0.0)).xyz);
+	vec3 ambientEnv = mix(mix(vec3(0.2, 0.24, 0.26), vec3(0.04), max(0.5*(1.0-localReflect.z),0)), EnvIrradiance(localNorm), envIrradianceWeight);
+	vec4 ambient = vec4(ambientEnv, 1.0);
 
 	/* Diffuse BRDF */
 	vec3 diffuseL = (shadow*max(0,dotNL))*mainlightColor;
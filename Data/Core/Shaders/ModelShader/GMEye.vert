@@ -1,10 +1,8 @@
-#version 450 compatibility
-#pragma import_defines(SHADOW_CAST)
 #ifdef SHADOW_CAST
 
 void main()
 {
-	gl_Position = ftransform();
+	gl_Position = ModelPosition();
 }
 
 #else // not SHADOW_CAST
@@ -23,17 +21,19 @@ out vData
 
 void main()
 {
-	vec4 viewVertPos = gl_ModelViewMatrix * gl_Vertex;
+	vec4 modelVertex = ModelVertex();
+	vec3 modelNormal = ModelNormal();
+	vec4 viewVertPos = gl_ModelViewMatrix * modelVertex;
 
-	vertOut.modelPos = gl_Vertex.xyz;
+	vertOut.modelPos = modelVertex.xyz;
 	vertOut.modelCameraPos = (inverse(gl_ModelViewMatrix))[3].xyz;
-	vertOut.modelNormal = gl_Normal;
+	vertOut.modelNormal = modelNormal;
 	vertOut.viewPos = viewVertPos.xyz / viewVertPos.w;
-	vertOut.viewNormal = normalize(gl_NormalMatrix*gl_Normal);
+	vertOut.viewNormal = normalize(gl_NormalMatrix*modelNormal);
 	vertOut.shadowPos = (view2ShadowMatrix*viewVertPos).xyz;
 
-	gl_TexCoord[0] = gl_MultiTexCoord0;
-	gl_Position = ftransform();
+	gl_TexCoord[0] = ModelTexCoord();
+	gl_Position = ModelPosition();
 }
 
 #endif // SHADOW_CAST or not
\ No newline at end of file
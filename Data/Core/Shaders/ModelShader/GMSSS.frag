@@ -42,24 +42,15 @@ vec4 ReflectEnvironment(vec3 localReflect, float roughness)
 	return vec4(color*16.0, 1.0);
 }
 
-vec4 Blur5x5(sampler2D texIn, vec2 uv, vec2 pix)
+// level 1 of the half resolution target is generated by the downsample compute pass,
+// each texel already averages 4x4 screen pixels, so 4 bilinear taps cover the old 12 taps
+vec4 BlurMip(sampler2D texIn, vec2 uv, vec2 pix)
 {
-	vec4 WS = texture(texIn, (uv + vec2(-1,-1))*pix);
-	vec4 WN = texture(texIn, (uv + vec2(-1,1))*pix);
-	vec4 ES = texture(texIn, (uv + vec2(1,-1))*pix);
-	vec4 EN = texture(texIn, (uv + vec2(1,1))*pix);
-
-	vec4 WS1 = texture(texIn, (uv + vec2(-1,-3))*pix);
-	vec4 WN1 = texture(texIn, (uv + vec2(-1,3))*pix);
-	vec4 ES1 = texture(texIn, (uv + vec2(1,-3))*pix);
-	vec4 EN1 = texture(texIn, (uv + vec2(1,3))*pix);
-
-	vec4 W1S = texture(texIn, (uv + vec2(-3,-1))*pix);
-	vec4 W1N = texture(texIn, (uv + vec2(-3,1))*pix);
-	vec4 E1S = texture(texIn, (uv + vec2(3,-1))*pix);
-	vec4 E1N = texture(texIn, (uv + vec2(3,1))*pix);
-
-	return (WS + WN + ES + EN + WS1 + WN1 + ES1 + EN1 + W1S + W1N + E1S + E1N) / 12.0;
+	vec4 WS = textureLod(texIn, (uv + vec2(-1,-1))*pix, 1.0);
+	vec4 WN = textureLod(texIn, (uv + vec2(-1,1))*pix, 1.0);
+	vec4 ES = textureLod(texIn, (uv + vec2(1,-1))*pix, 1.0);
+	vec4 EN = textureLod(texIn, (uv + vec2(1,1))*pix, 1.0);
+	return (WS + WN + ES + EN) * 0.25;
 }
 
 vec3 SSS(vec4 subdermalColor, float dotNL, float curvature)
@@ -143,9 +134,11 @@ void main()
 	reflectEnv.rgb *= mainlightColor*ambientOcc;
 	
 	/* ambient BRDF */
-	vec3 ambient = mix(vec3(0.1, 0.12, 0.13), vec3(0.02), max(0.5*(1.0-localReflect.z),0))*outColor.rgb*ambientOcc;
+	vec3 localNorm = normalize((osg_ViewMatrixInverse*vec4(viewTexNorm,0.0)).xyz);
+	vec3 ambientEnv = mix(mix(vec3(0.1, 0.12, 0.13), vec3(0.02), max(0.5*(1.0-localReflect.z),0)), EnvIrradiance(localNorm), envIrradianceWeight);
+	vec3 ambient = ambientEnv*outColor.rgb*ambientOcc;
 	/* subdermal BSSDF */
-	vec4 subdermal = Blur5x5(texSSSBlur, gl_FragCoord.st - 0.5, pixSize);
+	vec4 subdermal = BlurMip(texSSSBlur, gl_FragCoord.st - 0.5, pixSize);
 	/* epidermis BRDF */
 	vec3 epidermis = SSS(vec4(baseColor.rgb, 1), dotNL, curvature);
 	epidermis *= shadow;
@@ -1,18 +1,20 @@
-#version 450 compatibility
-#pragma import_defines(SHADOW_CAST)
 #ifdef SHADOW_CAST
 
 void main()
 {
-	gl_Position = ftransform();
+	gl_Position = ModelPosition();
 }
 
 #else // not SHADOW_CAST
 
 uniform mat4 view2ShadowMatrix;
 
+#ifdef GM_QUANT_TANGENT
+layout(location = 7) in vec4		quantTangent; // 10_10_10_2, w = binormal sign
+#else
 layout(location = 6) in vec3		tangent;
 layout(location = 7) in vec3		binormal;
+#endif // GM_QUANT_TANGENT
 
 out vData
 {
@@ -26,17 +28,23 @@ out vData
 
 void main()
 {
-	vec4 viewVertPos = gl_ModelViewMatrix * gl_Vertex;
-
-	vertOut.objPos = gl_Vertex;
+	vec4 modelVertex = ModelVertex();
+	vec3 modelNormal = ModelNormal();
+#ifdef GM_QUANT_TANGENT
+	vec3 tangent = quantTangent.xyz;
+	vec3 binormal = cross(modelNormal, tangent)*quantTangent.w;
+#endif // GM_QUANT_TANGENT
+	vec4 viewVertPos = gl_ModelViewMatrix * modelVertex;
+
+	vertOut.objPos = modelVertex;
 	vertOut.viewPos = viewVertPos.xyz / viewVertPos.w;
-	vertOut.viewNormal = gl_NormalMatrix*gl_Normal;
+	vertOut.viewNormal = gl_NormalMatrix*modelNormal;
 	vertOut.viewTang = gl_NormalMatrix*tangent;
 	vertOut.viewBinormal = gl_NormalMatrix*binormal;
 	vertOut.shadowPos = (view2ShadowMatrix*viewVertPos).xyz;
 
-	gl_TexCoord[0] = gl_MultiTexCoord0;
-	gl_Position = ftransform();
+	gl_TexCoord[0] = ModelTexCoord();
+	gl_Position = ModelPosition();
 }
 
 #endif // SHADOW_CAST or not
\ No newline at end of file
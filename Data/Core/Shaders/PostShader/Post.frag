@@ -1,6 +1,7 @@
 #version 430 compatibility
 
 #pragma import_defines(VOLUME)
+#pragma import_defines(BLOOM)
 
 uniform vec3 screenSize;
 uniform sampler2D sceneTex;
@@ -11,6 +12,25 @@ uniform sampler2D foregroundTex;
 uniform sampler2D volumeTex;
 #endif //VOLUME
 
+#ifdef BLOOM
+// soft threshold on the luminance, keeps only the bright part of the scene
+vec3 BrightPass(vec4 color)
+{
+	float lum = dot(color.rgb, vec3(0.299, 0.587, 0.114));
+	float knee = clamp((lum - 0.6)*2.5, 0.0, 1.0);
+	return color.rgb*color.a*knee*knee;
+}
+
+// mip chain of the scene color is generated by the downsample compute pass
+vec3 Bloom(vec2 uv)
+{
+	vec3 bloom = BrightPass(textureLod(sceneTex, uv, 2.0))*0.5;
+	bloom += BrightPass(textureLod(sceneTex, uv, 4.0))*0.3;
+	bloom += BrightPass(textureLod(sceneTex, uv, 6.0))*0.2;
+	return bloom;
+}
+#endif //BLOOM
+
 void main()
 {
 	vec2 sideUV = gl_TexCoord[0].xy - 0.5/screenSize.xy;
@@ -44,6 +64,10 @@ void main()
 	color.rgb = mix(color.rgb, sceneColor.rgb, sceneColor.a);
 	color.a = 1 - (1-color.a)*(1-sceneColor.a);
 
+#ifdef BLOOM
+	color.rgb += Bloom(gl_TexCoord[0].xy)*0.35;
+#endif //BLOOM
+
 	vec4 foregroundColor = texture(foregroundTex, gl_TexCoord[0].xy);
 	color.rgb = mix(color.rgb, foregroundColor.rgb, foregroundColor.a);
 	color.a = 1 - (1-color.a)*(1-foregroundColor.a);
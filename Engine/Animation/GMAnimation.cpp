@@ -21,6 +21,9 @@ using namespace GM;
 *************************************************************************/
 #define  ANIM_LIST				_manager->getAnimationList()		// 获取动画
 
+// 当前线程录制命令的位置，为空时设置函数直接修改动画
+static thread_local std::vector<GM::SGMAnimationCommand>* s_pRecordVec = nullptr;
+
 namespace GM
 {
 	/*
@@ -92,7 +95,9 @@ namespace GM
 			if (node.getUpdateCallback()) {
 				osgAnimation::AnimationManagerBase* b = dynamic_cast<osgAnimation::AnimationManagerBase*>(node.getUpdateCallback());
 				if (b) {
-					_am = new CGMBasicAnimationManager(*b);
+					// 每个实例需要自己的动画和通道（通道的目标要链接到实例自己的骨骼上），
+					// 关键帧容器仍然是共享的，所以同一个资源的多个实例不会重复占用动画数据
+					_am = new CGMBasicAnimationManager(*b, osg::CopyOp::DEEP_COPY_OBJECTS);
 					return;
 				}
 			}
@@ -101,7 +106,8 @@ namespace GM
 	};
 
 	/*
-	*  @brief 动画播放器，同一个模型文件可以共享一个播放器（但目前还没有实现共用），播放器可以同时播放多个动画
+	*  @brief 动画播放器，每个模型实例对应一个播放器，播放器可以同时播放多个动画
+	*  同一个模型文件的多个实例共享关键帧，只有播放状态和动画通道是各自的
 	*/
 	class CAnimationPlayer : public osg::Referenced
 	{
@@ -472,6 +478,7 @@ bool CGMAnimation::GetAnimationEnable(const std::string& strName)
 
 bool CGMAnimation::SetAnimationDuration(const std::string& strModelName, const float fDuration, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_DURATION, strModelName, strAnimationName, fDuration)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -503,6 +510,7 @@ float CGMAnimation::GetAnimationDuration(const std::string& strModelName, const
 
 bool CGMAnimation::SetAnimationMode(const std::string& strModelName, EGMPlayMode ePlayMode, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_MODE, strModelName, strAnimationName, 0.0f, int(ePlayMode))) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -534,6 +542,7 @@ EGMPlayMode CGMAnimation::GetAnimationMode(const std::string& strModelName, cons
 
 bool CGMAnimation::SetAnimationPriority(const std::string& strModelName, const int iPriority, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_PRIORITY, strModelName, strAnimationName, 0.0f, iPriority)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -565,6 +574,7 @@ int CGMAnimation::GetAnimationPriority(const std::string& strModelName, const st
 
 bool CGMAnimation::SetAnimationWeight(const std::string& strModelName, float fWeight, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_WEIGHT, strModelName, strAnimationName, fWeight)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -590,6 +600,7 @@ float CGMAnimation::GetAnimationWeight(const std::string& strModelName, const st
 
 bool CGMAnimation::SetAnimationPlay(const std::string& strModelName, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_PLAY, strModelName, strAnimationName)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -612,6 +623,7 @@ bool CGMAnimation::SetAnimationPlay(const std::string& strModelName, const std::
 
 bool CGMAnimation::SetAnimationStop(const std::string& strModelName, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_STOP, strModelName, strAnimationName)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -630,6 +642,7 @@ bool CGMAnimation::SetAnimationStop(const std::string& strModelName, const std::
 
 bool CGMAnimation::SetAnimationPause(const std::string& strModelName, const std::string& strAnimationName)
 {
+	if (_Record(EGM_ANIM_PAUSE, strModelName, strAnimationName)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -652,6 +665,7 @@ bool CGMAnimation::SetAnimationPause(const std::string& strModelName, const std:
 
 bool CGMAnimation::SetAnimationResume(const std::string& strModelName, const std::string& strAnimationName, float fWeight)
 {
+	if (_Record(EGM_ANIM_RESUME, strModelName, strAnimationName, fWeight)) return true;
 	CAnimationPlayer* pAniPlayer = _GetPlayerByModelName(strModelName);
 	if (pAniPlayer)
 	{
@@ -685,6 +699,67 @@ bool CGMAnimation::IsAnimationPlaying(const std::string& strModelName, const std
 	return pAniPlayer->isAnimationPlaying(strAnimationName);
 }
 
+void CGMAnimation::BeginRecord(std::vector<SGMAnimationCommand>* pCommandVec)
+{
+	s_pRecordVec = pCommandVec;
+}
+
+void CGMAnimation::EndRecord()
+{
+	s_pRecordVec = nullptr;
+}
+
+void CGMAnimation::Apply(const std::vector<SGMAnimationCommand>& vCommand)
+{
+	for (auto& itr : vCommand)
+	{
+		switch (itr.eType)
+		{
+		case EGM_ANIM_DURATION:
+			SetAnimationDuration(itr.strModelName, itr.fValue, itr.strAnimationName);
+			break;
+		case EGM_ANIM_MODE:
+			SetAnimationMode(itr.strModelName, EGMPlayMode(itr.iValue), itr.strAnimationName);
+			break;
+		case EGM_ANIM_PRIORITY:
+			SetAnimationPriority(itr.strModelName, itr.iValue, itr.strAnimationName);
+			break;
+		case EGM_ANIM_WEIGHT:
+			SetAnimationWeight(itr.strModelName, itr.fValue, itr.strAnimationName);
+			break;
+		case EGM_ANIM_PLAY:
+			SetAnimationPlay(itr.strModelName, itr.strAnimationName);
+			break;
+		case EGM_ANIM_STOP:
+			SetAnimationStop(itr.strModelName, itr.strAnimationName);
+			break;
+		case EGM_ANIM_PAUSE:
+			SetAnimationPause(itr.strModelName, itr.strAnimationName);
+			break;
+		case EGM_ANIM_RESUME:
+			SetAnimationResume(itr.strModelName, itr.strAnimationName, itr.fValue);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+bool CGMAnimation::_Record(const EGMAnimationCommand eType, const std::string& strModelName,
+	const std::string& strAnimationName, const float fValue, const int iValue)
+{
+	if (!s_pRecordVec) return false;
+
+	SGMAnimationCommand sCommand;
+	sCommand.eType = eType;
+	sCommand.strModelName = strModelName;
+	sCommand.strAnimationName = strAnimationName;
+	sCommand.fValue = fValue;
+	sCommand.iValue = iValue;
+	s_pRecordVec->push_back(sCommand);
+	return true;
+}
+
 CAnimationPlayer* CGMAnimation::_GetPlayerByModelName(const std::string& strModelName)
 {
 	std::string strPlayerName = _GetPlayerName(strModelName);
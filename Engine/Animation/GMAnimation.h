@@ -15,6 +15,7 @@
 
 #include <osg/Node>
 #include <osgAnimation/BasicAnimationManager>
+#include <vector>
 
 namespace GM
 {
@@ -23,6 +24,41 @@ namespace GM
 	*************************************************************************/
 	#define GM_ANIMATION                    CGMAnimation::getSingleton()
 
+	/*************************************************************************
+	 Enums
+	*************************************************************************/
+	/*!
+	 *  @enum EGMAnimationCommand
+	 *  @brief 录制的动画命令类型，与CGMAnimation的设置函数一一对应
+	 */
+	enum EGMAnimationCommand
+	{
+		EGM_ANIM_DURATION,		// SetAnimationDuration
+		EGM_ANIM_MODE,			// SetAnimationMode
+		EGM_ANIM_PRIORITY,		// SetAnimationPriority
+		EGM_ANIM_WEIGHT,		// SetAnimationWeight
+		EGM_ANIM_PLAY,			// SetAnimationPlay
+		EGM_ANIM_STOP,			// SetAnimationStop
+		EGM_ANIM_PAUSE,			// SetAnimationPause
+		EGM_ANIM_RESUME			// SetAnimationResume
+	};
+
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+	/*!
+	 *  @struct SGMAnimationCommand
+	 *  @brief 录制状态下设置函数不直接修改动画，而是记下参数，由主线程按顺序执行
+	 */
+	struct SGMAnimationCommand
+	{
+		EGMAnimationCommand		eType = EGM_ANIM_WEIGHT;	//!< 命令类型
+		std::string				strModelName;				//!< 模型名称
+		std::string				strAnimationName;			//!< 动画名称
+		float					fValue = 0.0f;				//!< 时长、权重
+		int						iValue = 0;					//!< 播放模式、优先级
+	};
+
 	/*************************************************************************
 	Class
 	*************************************************************************/
@@ -180,8 +216,28 @@ namespace GM
 		*/
 		bool IsAnimationPlaying(const std::string& strModelName, const std::string& strAnimationName);
 
+		/**
+		* @brief 开始录制当前线程的设置函数，录制期间只记下命令、不修改动画
+		* @brief 查询函数仍然读取当前的动画状态，所以录制只能在更新遍历之外进行
+		* @param pCommandVec 命令写入的位置，由调用者保存
+		*/
+		void BeginRecord(std::vector<SGMAnimationCommand>* pCommandVec);
+		/** @brief 结束录制当前线程的设置函数 */
+		void EndRecord();
+		/**
+		* @brief 按录制的顺序执行命令，必须在主线程中、更新遍历之前调用
+		* @param vCommand 录制的命令
+		*/
+		void Apply(const std::vector<SGMAnimationCommand>& vCommand);
+
 	private:
 		/**
+		* @brief 录制状态下记下命令
+		* @return bool 当前线程正在录制返回true，调用者不再修改动画
+		*/
+		bool _Record(const EGMAnimationCommand eType, const std::string& strModelName,
+			const std::string& strAnimationName, const float fValue = 0.0f, const int iValue = 0);
+		/**
 		* @brief 获取动画播放器，如果该模型有的话，每个模型会对应一个动画播放器
 		* @param strName 模型在场景中的名称
 		* @return CAnimationPlayer* 动画播放器指针
@@ -11,6 +11,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "GMAudio.h"
+#include "GMScheduler.h"
 
 using namespace GM;
 
@@ -18,6 +19,9 @@ using namespace GM;
 Macro Defines
 *************************************************************************/
 
+#define AUDIO_PREBUFFER_TIME			2.0				// 预读的时长，单位：s
+#define AUDIO_INNER_STEP				0.1				// 间隔更新的时间，单位：s
+
 /*************************************************************************
 Structs
 *************************************************************************/
@@ -34,61 +38,114 @@ CGMAudio::CGMAudio()
 /** @brief 析构 */
 CGMAudio::~CGMAudio()
 {
+	Release();
 }
 
 /** @brief 初始化 */
-bool CGMAudio::Init(SGMConfigData * pConfigData)
+bool CGMAudio::Init(SGMConfigData * pConfigData, CGMScheduler* pScheduler, const EGMAUDIO_BACKEND eBackend)
 {
 	m_pConfigData = pConfigData;
+	m_pScheduler = pScheduler;
+	m_iInnerTask = m_pScheduler->AddPeriodic(AUDIO_INNER_STEP,
+		[this](double fElapsed) { _InnerUpdate(fElapsed); }, EGMTASK_PRIORITY_HIGH);
 
 	m_fVolume = m_pConfigData->fVolume;
+	m_iCrossfade = max(0, m_pConfigData->iCrossfade);
+
+	m_pBackend = CGMAudioBackend::Create(eBackend);
+	m_pBackend->Init();
+	m_pBackend->SetVolume(m_fVolume);
+
+	m_pLipSync = new CGMLipSync();
+	m_pLipSync->Init();
+
+	m_bExit = false;
+	m_thread = std::thread(&CGMAudio::_Prefetch, this);
 
-	_InitBASS();
 	// 为“欢迎效果”做准备工作
 	_PreWelcome();
 
 	return true;
 }
 
+/** @brief 释放 */
+void CGMAudio::Release()
+{
+	if (m_iInnerTask)
+	{
+		m_pScheduler->Remove(m_iInnerTask);
+		m_iInnerTask = 0;
+	}
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			m_bExit = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+	if (m_pBackend)
+	{
+		_CloseAll();
+		m_pBackend->Release();
+		GM_DELETE(m_pBackend);
+	}
+	// 输出流关闭后才不会再推送采样
+	GM_DELETE(m_pLipSync);
+}
+
 /** @brief 更新 */
 bool CGMAudio::Update(double dDeltaTime)
 {
+	_UpdateTrack();
+
 	if (m_bWelcomeStart && !m_bWelcomeEnd)
 	{
-		QWORD pos_bytes;
-		pos_bytes = BASS_ChannelGetPosition(m_streamAudio, BASS_POS_BYTE);
-		double pos_sec;
-		pos_sec = BASS_ChannelBytes2Seconds(m_streamAudio, pos_bytes);
-
-		if (m_iWelcomeDuration <= static_cast<int>(pos_sec * 1000))
+		if (m_iWelcomeDuration <= _GetAudioCurrentTime())
 		{
-			BASS_StreamFree(m_streamAudio);
+			_CloseAll();
 			m_eAudioState = EGMA_STA_MUTE;
+			m_iAudioDuration = 0;
+			m_iAudioCurrentTime = 0;
+			m_iAudioLastTime = 0;
 
 			m_bWelcomeEnd = true;
 		}
 	}
 
-	static double s_fConstantStep = 0.1;
-	static double s_fDeltaStep = 0.0;
-	double fDeltaTime = dDeltaTime;
-	fDeltaTime += s_fDeltaStep;
-	while (fDeltaTime >= s_fConstantStep)
-	{
-		_InnerUpdate(s_fConstantStep);
-		fDeltaTime -= s_fConstantStep;
-	}
-	s_fDeltaStep = fDeltaTime;
-
 	return true;
 }
 
 void CGMAudio::Welcome()
 {
-	BASS_ChannelPlay(m_streamAudio, FALSE);
+	std::unique_ptr<SGMAudioTrack> pTrack;
+	{
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		pTrack = std::move(m_pNextTrack);
+	}
+	m_bWelcomeStart = true;
+	if (!pTrack)
+	{
+		// 没有欢迎音频，直接结束
+		m_bWelcomeEnd = true;
+		return;
+	}
+
+	_SwitchTo(std::move(pTrack), false);
+	m_pBackend->Play();
 	m_eAudioState = EGMA_STA_PLAY;
+}
 
+void CGMAudio::SkipWelcome()
+{
+	if (m_bWelcomeStart) return;
+	{
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		if (m_pNextTrack) m_freeVec.push_back(std::move(m_pNextTrack));
+	}
 	m_bWelcomeStart = true;
+	m_bWelcomeEnd = true;
 }
 
 bool CGMAudio::SetCurrentAudio(const std::wstring& strAudioFile)
@@ -97,9 +154,10 @@ bool CGMAudio::SetCurrentAudio(const std::wstring& strAudioFile)
 
 	if (L"" != strAudioFile)
 	{
-		AudioControl(EGMA_CMD_CLOSE);
-		m_strCurrentFile = strAudioFile;
-		AudioControl(EGMA_CMD_OPEN);
+		m_tRequest = std::chrono::steady_clock::now();
+		_Request(strAudioFile, true);
+		// 已经预读好了就直接切换
+		_UpdateTrack();
 		return true;
 	}
 	else
@@ -108,6 +166,26 @@ bool CGMAudio::SetCurrentAudio(const std::wstring& strAudioFile)
 	}
 }
 
+void CGMAudio::PrefetchAudio(const std::wstring& strAudioFile)
+{
+	if (!m_bWelcomeEnd || m_bSwitchPending) return;
+	if (strAudioFile == m_strNextFile) return;
+
+	if (L"" == strAudioFile)
+	{
+		m_strNextFile = L"";
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			m_strJobFile = L"";
+			m_iJobSerial++;
+		}
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		if (m_pNextTrack) m_freeVec.push_back(std::move(m_pNextTrack));
+		return;
+	}
+	_Request(strAudioFile, false);
+}
+
 void CGMAudio::AudioControl(EGMA_COMMAND command)
 {
 	if (!m_bWelcomeEnd) return;
@@ -116,46 +194,48 @@ void CGMAudio::AudioControl(EGMA_COMMAND command)
 	{
 	case EGMA_CMD_OPEN:
 	{
-		std::wstring strFile = m_pConfigData->strMediaPath + m_strAudioPath + m_strCurrentFile;
-		m_streamAudio = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0, 0);
-
-		// 获取当前音频时长
-		QWORD length_bytes = BASS_ChannelGetLength(m_streamAudio, BASS_POS_BYTE);
-		double length_sec = BASS_ChannelBytes2Seconds(m_streamAudio, length_bytes);
-		m_iAudioDuration = static_cast<int>(std::fmax(0.0,length_sec) * 1000);
-
-		//const char* tag = BASS_ChannelGetTags(m_streamAudio, BASS_TAG_ID3V2);
-		// https://blog.csdn.net/u013401219/article/details/48103315
-		// https://github.com/alkatrazstudio/meson-sound-engine/blob/0e289ad770a892cda7999431ebe51eebbec51ef5/modules/MesonSoundEngine/mse/sources/source_stream.cpp
-
-		m_iAudioCurrentTime = 0;
-		m_iAudioLastTime = 0;
-
+		if (L"" != m_strCurrentFile)
+		{
+			m_tRequest = std::chrono::steady_clock::now();
+			_Request(m_strCurrentFile, true);
+		}
 		m_eAudioState = EGMA_STA_MUTE;
 	}
 	break;
 	case EGMA_CMD_PLAY:
 	{
-		BASS_ChannelSetAttribute(m_streamAudio, BASS_ATTRIB_VOL, m_fVolume);
-		BASS_ChannelPlay(m_streamAudio, FALSE);
+		// 已经播放完、又没有下一首时，从头开始
+		bool bEnd = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mixMutex);
+			bEnd = m_pTrack && m_pTrack->bEnd && !m_pNextTrack;
+		}
+		if (bEnd && !m_bSwitchPending) _SeekTo(0);
+
+		m_pBackend->SetVolume(m_fVolume);
+		m_pBackend->Play();
 		m_eAudioState = EGMA_STA_PLAY;
 	}
 	break;
 	case EGMA_CMD_CLOSE:
 	{
-		BASS_StreamFree(m_streamAudio);
+		_CloseAll();
+		m_strCurrentFile = L"";
+		m_iAudioDuration = 0;
+		m_iAudioCurrentTime = 0;
+		m_iAudioLastTime = 0;
 		m_eAudioState = EGMA_STA_MUTE;
 	}
 	break;
 	case EGMA_CMD_PAUSE:
 	{
-		BASS_ChannelPause(m_streamAudio);
+		m_pBackend->Pause();
 		m_eAudioState = EGMA_STA_PAUSE;
 	}
 	break;
 	case EGMA_CMD_STOP:
 	{
-		BASS_ChannelStop(m_streamAudio);
+		m_pBackend->Pause();
 		_SeekTo(0);
 		m_eAudioState = EGMA_STA_MUTE;
 	}
@@ -168,6 +248,7 @@ void CGMAudio::AudioControl(EGMA_COMMAND command)
 bool CGMAudio::IsAudioOver() const
 {
 	if (EGMA_STA_PLAY == m_eAudioState
+		&& L"" == m_strNextFile
 		&& m_iAudioCurrentTime == m_iAudioLastTime
 		&& m_iAudioCurrentTime != 0
 		&& m_iAudioCurrentTime > m_iAudioDuration - 100)
@@ -183,7 +264,7 @@ bool CGMAudio::IsAudioOver() const
 bool CGMAudio::SetVolume(float fLevel)
 {
 	m_fVolume = fLevel;
-	return BASS_ChannelSetAttribute(m_streamAudio, BASS_ATTRIB_VOL, m_fVolume);
+	return m_pBackend->SetVolume(m_fVolume);
 }
 
 float CGMAudio::GetLevel() const
@@ -198,21 +279,22 @@ float CGMAudio::GetLevel() const
 	//	return 1.0f;
 	//}
 
-	DWORD level, left, right;
-	level = BASS_ChannelGetLevel(m_streamAudio);
-	left = LOWORD(level); // the left level
-	right = HIWORD(level); // the right level
-	float fLevel = min(1.0f, max(left, right) / 32768.0f);
+	return m_pBackend->GetLevel();
+}
 
-	//float fft[128]; // fft data buffer
-	//BASS_ChannelGetData(m_streamAudio, fft, BASS_DATA_FFT256);
-	//float fMax = 0.0f;
-	//for (int i = 0; i < 128; i++)
-	//{
-	//	fMax = std::fmax(fMax, fft[i]);
-	//}
-	//fMax = min(10*fMax, 1.0f);
-	return fLevel;
+SGMViseme CGMAudio::GetViseme() const
+{
+	if (EGMA_STA_PLAY != m_eAudioState || !m_bWelcomeEnd || IsAudioOver())
+	{
+		return SGMViseme();
+	}
+	return m_pLipSync->GetViseme(m_pBackend->GetPlayedFrames());
+}
+
+void CGMAudio::AdvanceOutput(const double fSeconds)
+{
+	m_pBackend->Advance(fSeconds);
+	if (m_pLipSync) m_pLipSync->WaitIdle();
 }
 
 bool CGMAudio::SetAudioCurrentTime(int iTime)
@@ -229,11 +311,12 @@ void CGMAudio::_InnerUpdate(float updateStep)
 
 int CGMAudio::_GetAudioCurrentTime() const
 {
-	QWORD pos_bytes;
-	pos_bytes = BASS_ChannelGetPosition(m_streamAudio, BASS_POS_BYTE);
-	double pos_sec;
-	pos_sec = BASS_ChannelBytes2Seconds(m_streamAudio, pos_bytes);
-	return static_cast<int>(pos_sec * 1000);
+	if (m_iCurrentSerial < 0 || m_iCurrentRate <= 0) return 0;
+
+	// 用输出流真正播放出去的帧数计算，已经包含了输出缓冲的延迟
+	long long iFrame = m_iCurrentOffset + max(0LL, m_pBackend->GetPlayedFrames() - m_iCurrentStart);
+	int iTime = static_cast<int>(iFrame * 1000 / m_iCurrentRate);
+	return min(iTime, max(0, m_iAudioDuration));
 }
 
 bool CGMAudio::_SeekTo(int iTime)
@@ -242,19 +325,368 @@ bool CGMAudio::_SeekTo(int iTime)
 	{
 		iTime = m_iAudioDuration;
 	}
-	m_iAudioCurrentTime = iTime;
-	double pos_sec = static_cast<double>(iTime) / 1000.0;
-	QWORD pos_bytes = BASS_ChannelSeconds2Bytes(m_streamAudio, pos_sec);
-	return BASS_ChannelSetPosition(m_streamAudio, pos_bytes, BASS_POS_BYTE);
+	iTime = max(0, iTime);
+
+	bool bSeek = false;
+	m_pBackend->Lock(true);
+	{
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		SGMAudioTrack* pTrack = m_pTrack.get();
+		if (pTrack && pTrack->iSerial == m_iCurrentSerial)
+		{
+			const long long iFrame = static_cast<long long>(iTime) * pTrack->pDecoder->GetSampleRate() / 1000;
+			bSeek = pTrack->pDecoder->Seek(iFrame);
+			if (bSeek)
+			{
+				// 预读的开头部分作废
+				pTrack->preVec.clear();
+				pTrack->iPrePos = 0;
+				pTrack->iReadFrames = iFrame;
+				pTrack->iOffset = iFrame;
+				pTrack->iStartFrame = m_pBackend->GetPulledFrames();
+				pTrack->bEnd = false;
+				if (m_pFadeTrack) m_freeVec.push_back(std::move(m_pFadeTrack));
+
+				m_iCurrentStart = pTrack->iStartFrame;
+				m_iCurrentOffset = iFrame;
+			}
+		}
+	}
+	if (bSeek) m_pBackend->Flush();
+	m_pBackend->Lock(false);
+
+	if (bSeek)
+	{
+		m_iAudioCurrentTime = iTime;
+		m_iAudioLastTime = iTime;
+	}
+	return bSeek;
 }
 
 void CGMAudio::_PreWelcome()
 {
 	std::string strFile = m_pConfigData->strCorePath + m_strCoreAudioPath + "Start.mp3";
-	m_streamAudio = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0, 0);
+	std::wstring wstrFile(MultiByteToWideChar(CP_ACP, 0, strFile.c_str(), -1, nullptr, 0), L'\0');
+	MultiByteToWideChar(CP_ACP, 0, strFile.c_str(), -1, &wstrFile[0], int(wstrFile.size()));
+	wstrFile.resize(wcslen(wstrFile.c_str()));
+
+	// 欢迎音频在启动时同步打开，放在预读槽里，Welcome时切换过去
+	SGMAudioTrack* pTrack = _OpenTrack(wstrFile);
+	if (!pTrack) return;
+
+	pTrack->iSerial = ++m_iSerial;
+	const long long iLength = pTrack->pDecoder->GetLength();
+	m_iWelcomeDuration = static_cast<int>(iLength * 1000 / max(1, pTrack->pDecoder->GetSampleRate()));
 
-	// 获取当前音频时长
-	QWORD length_bytes = BASS_ChannelGetLength(m_streamAudio, BASS_POS_BYTE);
-	double length_sec = BASS_ChannelBytes2Seconds(m_streamAudio, length_bytes);
-	m_iWelcomeDuration = static_cast<int>(std::fmax(0.0, length_sec) * 1000);
+	std::lock_guard<std::mutex> lock(m_mixMutex);
+	m_pNextTrack.reset(pTrack);
+}
+
+void CGMAudio::_Request(const std::wstring& strAudioFile, const bool bSwitch)
+{
+	m_strNextFile = strAudioFile;
+	m_bSwitchPending = bSwitch;
+
+	// 预读槽里已经是这一首了
+	{
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		m_bPrefetchFailed = false;
+		if (m_pNextTrack && m_pNextTrack->strFile == strAudioFile) return;
+		if (m_pNextTrack) m_freeVec.push_back(std::move(m_pNextTrack));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_strJobFile = strAudioFile;
+		m_iJobSerial++;
+	}
+	m_condition.notify_one();
+}
+
+void CGMAudio::_Prefetch()
+{
+	while (true)
+	{
+		std::wstring strFile;
+		int iJob = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_condition.wait(lock, [this] { return m_bExit || L"" != m_strJobFile; });
+			if (m_bExit) return;
+			strFile = m_strJobFile;
+			iJob = m_iJobSerial;
+			m_strJobFile = L"";
+		}
+
+		// 打开文件、解码开头部分都可能卡在磁盘或网络上，所以放在这个线程里
+		SGMAudioTrack* pTrack = _OpenTrack(GetAudioPath(strFile));
+		if (pTrack) pTrack->strFile = strFile;
+
+		std::lock_guard<std::mutex> lockJob(m_jobMutex);
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		if (iJob != m_iJobSerial)
+		{
+			// 打开的过程中又换了一首
+			delete pTrack;
+			continue;
+		}
+		if (pTrack)
+		{
+			pTrack->iSerial = ++m_iSerial;
+			m_pNextTrack.reset(pTrack);
+		}
+		else
+		{
+			m_bPrefetchFailed = true;
+		}
+	}
+}
+
+SGMAudioTrack* CGMAudio::_OpenTrack(const std::wstring& strFile) const
+{
+	CGMAudioDecoder* pDecoder = m_pBackend->OpenDecoder(strFile);
+	if (!pDecoder) return nullptr;
+	if (pDecoder->GetSampleRate() <= 0 || pDecoder->GetChannels() <= 0)
+	{
+		delete pDecoder;
+		return nullptr;
+	}
+
+	SGMAudioTrack* pTrack = new SGMAudioTrack();
+	pTrack->pDecoder.reset(pDecoder);
+
+	const int iChannels = pDecoder->GetChannels();
+	const int iFrames = static_cast<int>(AUDIO_PREBUFFER_TIME * pDecoder->GetSampleRate());
+	pTrack->preVec.resize(size_t(iFrames) * iChannels);
+	int iRead = 0;
+	while (iRead < iFrames)
+	{
+		int iNum = pDecoder->Read(pTrack->preVec.data() + size_t(iRead) * iChannels, iFrames - iRead);
+		if (iNum <= 0) break;
+		iRead += iNum;
+	}
+	pTrack->preVec.resize(size_t(iRead) * iChannels);
+	return pTrack;
+}
+
+void CGMAudio::_UpdateTrack()
+{
+	std::unique_ptr<SGMAudioTrack> pSwitch;
+	std::vector<std::unique_ptr<SGMAudioTrack>> vFree;
+	{
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		vFree.swap(m_freeVec);
+
+		if (m_bPrefetchFailed)
+		{
+			// 打不开的文件，不再等待
+			m_bPrefetchFailed = false;
+			m_bSwitchPending = false;
+			m_strNextFile = L"";
+		}
+		else if (m_pNextTrack && m_bWelcomeEnd)
+		{
+			// 手动切歌，或者上一首已经读完但混音线程没法直接接上（格式不同，或者预读得太晚）
+			const bool bEnd = m_pTrack && m_pTrack->bEnd;
+			if (m_bSwitchPending || bEnd)
+			{
+				pSwitch = std::move(m_pNextTrack);
+				pSwitch->bManual = m_bSwitchPending;
+				if (bEnd) pSwitch->iPrevEndFrame = m_pTrack->iReadFrames - m_pTrack->iOffset + m_pTrack->iStartFrame;
+			}
+		}
+	}
+	vFree.clear();
+
+	if (pSwitch)
+	{
+		const bool bManual = pSwitch->bManual;
+		m_bSwitchPending = false;
+		_SwitchTo(std::move(pSwitch), bManual);
+	}
+
+	// 新的音频开始发声时，才更新文件名、时长等信息
+	const long long iPlayed = m_pBackend->GetPlayedFrames();
+	std::lock_guard<std::mutex> lock(m_mixMutex);
+	SGMAudioTrack* pTrack = m_pTrack.get();
+	if (!pTrack || pTrack->iSerial == m_iCurrentSerial) return;
+	if (pTrack->iStartFrame < 0 || iPlayed < pTrack->iStartFrame) return;
+
+	const int iRate = pTrack->pDecoder->GetSampleRate();
+	m_iCurrentSerial = pTrack->iSerial;
+	m_iCurrentStart = pTrack->iStartFrame;
+	m_iCurrentOffset = pTrack->iOffset;
+	m_iCurrentRate = iRate;
+	m_strCurrentFile = pTrack->strFile;
+	m_iAudioDuration = static_cast<int>(pTrack->pDecoder->GetLength() * 1000 / iRate);
+	m_iAudioCurrentTime = 0;
+	m_iAudioLastTime = 0;
+	if (m_strNextFile == m_strCurrentFile && !m_pNextTrack) m_strNextFile = L"";
+
+	if (pTrack->bManual)
+	{
+		m_fSwitchLatency = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_tRequest).count();
+	}
+	else if (pTrack->iPrevEndFrame >= 0)
+	{
+		m_fSwitchLatency = 1000.0f * float(pTrack->iStartFrame - pTrack->iPrevEndFrame) / float(iRate);
+	}
+}
+
+void CGMAudio::_SwitchTo(std::unique_ptr<SGMAudioTrack> pTrack, const bool bFlush)
+{
+	const int iRate = pTrack->pDecoder->GetSampleRate();
+	const int iChannels = pTrack->pDecoder->GetChannels();
+	if (iRate != m_pBackend->GetOutputSampleRate() || iChannels != m_pBackend->GetOutputChannels())
+	{
+		// 格式不同，只能重新创建输出流
+		m_pBackend->CloseOutput();
+		{
+			std::lock_guard<std::mutex> lock(m_mixMutex);
+			if (m_pTrack) m_freeVec.push_back(std::move(m_pTrack));
+			if (m_pFadeTrack) m_freeVec.push_back(std::move(m_pFadeTrack));
+			m_pTrack = std::move(pTrack);
+		}
+		m_pBackend->OpenOutput(iRate, iChannels, [this](float* pData, int iFrames) { _Mix(pData, iFrames); });
+		m_pBackend->SetVolume(m_fVolume);
+		if (EGMA_STA_PLAY == m_eAudioState) m_pBackend->Play();
+	}
+	else if (!bFlush)
+	{
+		// 上一首已经读完，缓冲里剩下的部分要播完，新的音频从下一次拉取开始
+		std::lock_guard<std::mutex> lock(m_mixMutex);
+		if (m_pTrack) m_freeVec.push_back(std::move(m_pTrack));
+		if (m_pFadeTrack) m_freeVec.push_back(std::move(m_pFadeTrack));
+		m_pTrack = std::move(pTrack);
+		m_pTrack->iStartFrame = -1;
+	}
+	else
+	{
+		// 锁住输出流，替换音频后清空缓冲，新的音频立即发声
+		m_pBackend->Lock(true);
+		{
+			std::lock_guard<std::mutex> lock(m_mixMutex);
+			if (m_pTrack) m_freeVec.push_back(std::move(m_pTrack));
+			if (m_pFadeTrack) m_freeVec.push_back(std::move(m_pFadeTrack));
+			m_pTrack = std::move(pTrack);
+			m_pTrack->iStartFrame = m_pBackend->GetPulledFrames();
+		}
+		m_pBackend->Flush();
+		m_pBackend->Lock(false);
+	}
+}
+
+void CGMAudio::_Mix(float* pData, int iFrames)
+{
+	std::lock_guard<std::mutex> lock(m_mixMutex);
+	const int iChannels = m_pBackend->GetOutputChannels();
+	const long long iFirst = m_pBackend->GetPulledFrames();
+	memset(pData, 0, sizeof(float) * iFrames * iChannels);
+	if (!m_pTrack) return;
+
+	// 快要结束时开始交叉淡入淡出，只在缓冲的边界上开始
+	SGMAudioTrack* pTrack = m_pTrack.get();
+	const int iRate = m_pBackend->GetOutputSampleRate();
+	const long long iRemain = pTrack->pDecoder->GetLength() - pTrack->iReadFrames;
+	if (m_iCrossfade > 0 && !m_pFadeTrack && !pTrack->bEnd && pTrack->iStartFrame >= 0 && m_pNextTrack
+		&& iRemain > 0 && iRemain <= static_cast<long long>(m_iCrossfade) * iRate / 1000
+		&& m_pNextTrack->pDecoder->GetSampleRate() == iRate
+		&& m_pNextTrack->pDecoder->GetChannels() == iChannels)
+	{
+		m_pFadeTrack = std::move(m_pTrack);
+		m_iFadeLeft = iRemain;
+		m_iFadeTotal = iRemain;
+		m_pTrack = std::move(m_pNextTrack);
+		m_pTrack->iStartFrame = iFirst;
+		m_pTrack->iPrevEndFrame = iFirst;
+	}
+
+	int iDone = 0;
+	while (iDone < iFrames)
+	{
+		pTrack = m_pTrack.get();
+		if (pTrack->bEnd) break;
+		if (pTrack->iStartFrame < 0) pTrack->iStartFrame = iFirst + iDone;
+
+		int iRead = _ReadTrack(*pTrack, pData + size_t(iDone) * iChannels, iFrames - iDone);
+		iDone += iRead;
+		if (iDone < iFrames)
+		{
+			// 读完了，在同一个缓冲里接上下一首，做到采样级的无缝衔接
+			pTrack->bEnd = true;
+			if (!_Advance(iFirst + iDone)) break;
+		}
+	}
+
+	if (m_pFadeTrack)
+	{
+		m_fadeVec.resize(size_t(iFrames) * iChannels);
+		int iRead = _ReadTrack(*m_pFadeTrack, m_fadeVec.data(), iFrames);
+		for (int i = 0; i < iRead; i++)
+		{
+			const float fOut = float(max(0LL, m_iFadeLeft - i)) / float(max(1LL, m_iFadeTotal));
+			for (int c = 0; c < iChannels; c++)
+			{
+				float& fValue = pData[size_t(i) * iChannels + c];
+				fValue = fValue * (1.0f - fOut) + m_fadeVec[size_t(i) * iChannels + c] * fOut;
+			}
+		}
+		m_iFadeLeft -= iFrames;
+		if (iRead < iFrames || m_iFadeLeft <= 0)
+		{
+			m_freeVec.push_back(std::move(m_pFadeTrack));
+		}
+	}
+
+	// 交给口型分析线程，这里只做一次拷贝
+	if (m_pLipSync) m_pLipSync->Push(pData, iFrames, iChannels, iRate, iFirst);
+}
+
+int CGMAudio::_ReadTrack(SGMAudioTrack& sTrack, float* pData, int iFrames)
+{
+	const int iChannels = sTrack.pDecoder->GetChannels();
+	int iDone = 0;
+	if (sTrack.iPrePos < sTrack.preVec.size())
+	{
+		const int iPre = min(iFrames, int((sTrack.preVec.size() - sTrack.iPrePos) / iChannels));
+		memcpy(pData, sTrack.preVec.data() + sTrack.iPrePos, sizeof(float) * iPre * iChannels);
+		sTrack.iPrePos += size_t(iPre) * iChannels;
+		iDone = iPre;
+	}
+	while (iDone < iFrames)
+	{
+		int iRead = sTrack.pDecoder->Read(pData + size_t(iDone) * iChannels, iFrames - iDone);
+		if (iRead <= 0) break;
+		iDone += iRead;
+	}
+	sTrack.iReadFrames += iDone;
+	return iDone;
+}
+
+bool CGMAudio::_Advance(const long long iFrame)
+{
+	// 没有预读好、或者格式不同时，交给主线程处理
+	if (!m_pNextTrack) return false;
+	if (m_pNextTrack->pDecoder->GetSampleRate() != m_pBackend->GetOutputSampleRate()
+		|| m_pNextTrack->pDecoder->GetChannels() != m_pBackend->GetOutputChannels())
+		return false;
+
+	m_freeVec.push_back(std::move(m_pTrack));
+	m_pTrack = std::move(m_pNextTrack);
+	m_pTrack->iStartFrame = iFrame;
+	m_pTrack->iPrevEndFrame = iFrame;
+	return true;
+}
+
+void CGMAudio::_CloseAll()
+{
+	m_pBackend->CloseOutput();
+	std::lock_guard<std::mutex> lock(m_mixMutex);
+	m_pTrack.reset();
+	m_pNextTrack.reset();
+	m_pFadeTrack.reset();
+	m_freeVec.clear();
+	m_iCurrentSerial = -1;
+	m_strNextFile = L"";
+	m_bSwitchPending = false;
 }
@@ -12,8 +12,15 @@
 #pragma once
 
 #include "GMCommon.h"
-#include "bass.h"
+#include "GMAudioBackend.h"
+#include "GMLipSync.h"
 #include <osg/Vec2f>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 
 namespace GM
 {
@@ -43,9 +50,31 @@ namespace GM
 	Structs
 	*************************************************************************/
 
+	/*!
+	 *  @struct SGMAudioTrack
+	 *  @brief 一首正在播放或者已经预读的音频
+	 */
+	struct SGMAudioTrack
+	{
+		SGMAudioTrack() {}
+
+		std::wstring						strFile = L"";				//!< 文件名，例如：xxx.mp3
+		std::unique_ptr<CGMAudioDecoder>	pDecoder;					//!< 解码器
+		std::vector<float>					preVec;						//!< 预读的开头部分，切歌时不用等待磁盘
+		size_t								iPrePos = 0;				//!< 预读部分已经用掉的采样数
+		long long							iReadFrames = 0;			//!< 已经读取到的位置，单位：帧
+		long long							iOffset = 0;				//!< 开始输出时在音频内的位置，单位：帧
+		long long							iStartFrame = -1;			//!< 第一帧在输出流上的序号，-1表示还没开始输出
+		long long							iPrevEndFrame = -1;			//!< 上一首结束时在输出流上的序号，用于统计切歌间隔
+		int									iSerial = 0;				//!< 序号，每打开一首加1
+		bool								bManual = false;			//!< 是否是手动切歌
+		bool								bEnd = false;				//!< 是否已经读完
+	};
+
 	/*************************************************************************
 	Class
 	*************************************************************************/
+	class CGMScheduler;
 
 	/*!
 	*  @class CGMAudio
@@ -61,8 +90,15 @@ namespace GM
 		/** @brief 析构 */
 		~CGMAudio();
 
-		/** @brief 初始化 */
-		bool Init(SGMConfigData* pConfigData);
+		/**
+		* @brief 初始化
+		* @param pConfigData: 配置数据
+		* @param pScheduler: 定时任务调度器，间隔更新注册在其中
+		* @param eBackend: 音频后端，没有声卡的环境可以用文件后端
+		*/
+		bool Init(SGMConfigData* pConfigData, CGMScheduler* pScheduler, const EGMAUDIO_BACKEND eBackend = EGMAUDIO_BACKEND_BASS);
+		/** @brief 释放 */
+		void Release();
 		/** @brief 更新 */
 		bool Update(double dDeltaTime);
 
@@ -78,19 +114,60 @@ namespace GM
 		* @return bool 结束则返回true，否则false
 		*/
 		inline bool IsWelcomeFinished() const { return m_bWelcomeEnd;}
+		/**
+		* @brief 跳过“欢迎效果”，离线导出时直接从指定的音频开始
+		* @brief 只能在Welcome之前调用
+		*/
+		void SkipWelcome();
 
 		/**
 		* @brief 根据文件名，设置当前音频
+		* @brief 已经预读的音频立即切换，否则在后台打开，打开后再切换，GetCurrentAudio在新的音频发声后才改变
 		* @param strAudioFile:	当前音频文件名称，例如：xxx.mp3
-		* @return bool 设置成功返回true，失败或者文件未找到返回false
+		* @return bool 设置成功返回true，欢迎效果未结束或者文件名为空返回false
 		*/
 		bool SetCurrentAudio(const std::wstring& strAudioFile);
+		/**
+		* @brief 在后台打开并预读下一首，当前音频播放完时无缝切换过去
+		* @param strAudioFile:	下一首的文件名称，L""表示取消
+		*/
+		void PrefetchAudio(const std::wstring& strAudioFile);
+		/**
+		* @brief 设置自动切歌时的交叉淡入淡出时长
+		* @param iTime: 时长，单位：ms，0表示无缝衔接
+		*/
+		inline void SetCrossfade(const int iTime) { m_iCrossfade = max(0, iTime); }
+		/**
+		* @brief 获取最近一次切歌的延迟
+		* @brief 手动切歌是从调用SetCurrentAudio到新的音频发声的时间，自动切歌是两首之间插入的静音时长
+		* @return float 延迟，单位：ms
+		*/
+		inline float GetSwitchLatency() const { return m_fSwitchLatency; }
+		/**
+		* @brief 是否还有等待打开的手动切歌
+		* @return bool SetCurrentAudio的音频还没有发声时返回true
+		*/
+		inline bool IsSwitchPending() const { return m_bSwitchPending; }
 
 		/**
 		* @brief 获取当前音频文件名称
 		* @return std::wstring 当前音频文件名称，例如：xxx.mp3,或者L""
 		*/
 		inline std::wstring GetCurrentAudio() const{ return m_strCurrentFile; }
+		/**
+		* @brief 获取当前音频的序号，每切换一次就会改变，单曲循环时文件名不变但序号会变
+		* @return int 序号，没有音频时为-1
+		*/
+		inline int GetAudioSerial() const { return m_iCurrentSerial; }
+		/**
+		* @brief 获取音频文件的完整路径
+		* @param strAudioFile:	音频文件名称，例如：xxx.mp3
+		* @return std::wstring 完整路径
+		*/
+		inline std::wstring GetAudioPath(const std::wstring& strAudioFile) const
+		{
+			return m_pConfigData->strMediaPath + m_strAudioPath + strAudioFile;
+		}
 
 		/**
 		* @brief 音频播放控制
@@ -121,6 +198,17 @@ namespace GM
 		* @return float 当前帧振幅 [0.0f,1.0f]
 		*/
 		float GetLevel() const;
+		/**
+		* @brief 获取和正在听到的声音对齐的口型，不加锁
+		* @return SGMViseme 口型，没有播放时bValid为false
+		*/
+		SGMViseme GetViseme() const;
+		/**
+		* @brief 推进输出流，只对导出后端有效，其他后端由声卡或者定时器推进
+		* @brief 返回前口型分析已经追上，保证每帧的结果和实时速度无关
+		* @param fSeconds: 推进的时长，单位：秒
+		*/
+		void AdvanceOutput(const double fSeconds);
 
 		/**
 		* @brief 获取当前播放音频的时长，单位：ms
@@ -148,25 +236,54 @@ namespace GM
 		*/
 		void _InnerUpdate(float updateStep);
 
-		/** @brief 初始化BASS音频库 */
-		inline void _InitBASS()
-		{
-			//初始化BASS音频库
-			BASS_Init(
-				-1,//默认设备
-				44100,//输出采样率44100（常用值）
-				BASS_DEVICE_CPSPEAKERS,//信号，BASS_DEVICE_CPSPEAKERS 
-				NULL,//程序窗口,0用于控制台程序
-				nullptr//类标识符,0使用默认值
-			);
-		}
-
 		/**
 		* @brief 获取当前播放到的位置（时域坐标）
 		* @return int 当前音频播放位置的时域坐标，单位：ms
 		*/
 		int _GetAudioCurrentTime() const;
 
+		/**
+		* @brief 在后台打开一首音频
+		* @param strAudioFile: 文件名
+		* @param bSwitch: 打开后是否立即切换过去
+		*/
+		void _Request(const std::wstring& strAudioFile, const bool bSwitch);
+		/** @brief 后台线程，打开并预读音频 */
+		void _Prefetch();
+		/**
+		* @brief 打开一首音频，并预读开头部分
+		* @param strFile: 完整路径
+		* @return SGMAudioTrack* 打开失败返回nullptr
+		*/
+		SGMAudioTrack* _OpenTrack(const std::wstring& strFile) const;
+		/** @brief 主线程中检查是否需要切歌，以及新的音频是否已经发声 */
+		void _UpdateTrack();
+		/**
+		* @brief 在主线程中切换到新的音频，格式不同时重新创建输出流
+		* @param pTrack: 新的音频
+		* @param bFlush: 是否丢弃输出缓冲中还没播放的部分，手动切歌时为true
+		*/
+		void _SwitchTo(std::unique_ptr<SGMAudioTrack> pTrack, const bool bFlush);
+		/**
+		* @brief 输出流的回调，在后端的混音线程中调用
+		* @param pData: 输出
+		* @param iFrames: 需要的帧数
+		*/
+		void _Mix(float* pData, int iFrames);
+		/**
+		* @brief 从音频中读取采样，先读预读部分
+		* @return int 实际读取的帧数
+		*/
+		int _ReadTrack(SGMAudioTrack& sTrack, float* pData, int iFrames);
+		/**
+		* @brief 当前音频读完时，在混音线程中切到预读好的下一首
+		* @param iFrame: 当前音频结束时在输出流上的序号
+		* @return bool 切换成功返回true
+		*/
+		bool _Advance(const long long iFrame);
+		/** @brief 关闭所有音频和输出流 */
+		void _CloseAll();
+
 		/**
 		* @brief 设置开始播放的时域坐标
 		* @param time 时域坐标，单位ms
@@ -180,10 +297,14 @@ namespace GM
 		// 变量
 	private:
 		SGMConfigData*						m_pConfigData = nullptr;				//!< 配置数据
+		CGMScheduler*						m_pScheduler = nullptr;					//!< 定时任务调度器
+		unsigned int						m_iInnerTask = 0;						//!< 间隔更新的任务编号
 		std::string							m_strCoreAudioPath = "Audios/";			//!< 核心音频存放路径
 		std::wstring						m_strAudioPath = L"Music/";				//!< 音乐存放路径
 		std::wstring						m_strCurrentFile = L"";					//!< 正在播放的文件名,XXX.mp3
-		HSTREAM								m_streamAudio = 0;
+		std::wstring						m_strNextFile = L"";					//!< 预读或者正在打开的文件名
+		CGMAudioBackend*					m_pBackend = nullptr;					//!< 音频后端
+		CGMLipSync*							m_pLipSync = nullptr;					//!< 口型分析
 		EGMA_STATE							m_eAudioState = EGMA_STA_MUTE;			//!< 当前播放状态
 		int									m_iAudioLastTime = 0;					//!< 上一帧音频时域坐标,单位ms
 		int									m_iAudioCurrentTime = 0;				//!< 当前帧音频时域坐标,单位ms
@@ -194,5 +315,32 @@ namespace GM
 		int									m_iWelcomeDuration = 5000;				//!< 欢迎音频时长,单位ms
 
 		float								m_fVolume = 0.5f;						//!< 软件音量
+
+		std::thread							m_thread;								//!< 预读线程
+		std::mutex							m_jobMutex;								//!< 保护预读任务
+		std::condition_variable				m_condition;							//!< 通知预读线程
+		std::wstring						m_strJobFile = L"";						//!< 等待打开的文件名
+		int									m_iJobSerial = 0;						//!< 最新的预读任务序号
+		bool								m_bExit = false;						//!< 预读线程退出标志
+
+		std::mutex							m_mixMutex;								//!< 保护混音线程用到的音频
+		std::unique_ptr<SGMAudioTrack>		m_pTrack;								//!< 正在输出的音频
+		std::unique_ptr<SGMAudioTrack>		m_pNextTrack;							//!< 预读好的下一首
+		std::unique_ptr<SGMAudioTrack>		m_pFadeTrack;							//!< 正在淡出的上一首
+		std::vector<std::unique_ptr<SGMAudioTrack>> m_freeVec;						//!< 混音线程用完的音频，在主线程中释放
+		std::vector<float>					m_fadeVec;								//!< 淡出音频的临时缓冲
+		long long							m_iFadeLeft = 0;						//!< 淡出剩余的帧数
+		long long							m_iFadeTotal = 0;						//!< 淡出的总帧数
+		std::atomic<int>					m_iCrossfade{ 0 };						//!< 交叉淡入淡出时长,单位ms
+		int									m_iSerial = 0;							//!< 已经打开的音频数量，用作序号
+		bool								m_bPrefetchFailed = false;				//!< 预读失败
+		bool								m_bSwitchPending = false;				//!< 打开后是否立即切换
+
+		int									m_iCurrentSerial = -1;					//!< 已经发声的音频序号
+		long long							m_iCurrentStart = 0;					//!< 已经发声的音频在输出流上的起点,单位帧
+		long long							m_iCurrentOffset = 0;					//!< 已经发声的音频起点在音频内的位置,单位帧
+		int									m_iCurrentRate = 44100;					//!< 已经发声的音频采样率
+		std::chrono::steady_clock::time_point m_tRequest;							//!< 手动切歌的时刻
+		float								m_fSwitchLatency = 0.0f;				//!< 最近一次切歌的延迟,单位ms
 	};
 }	// GM
@@ -0,0 +1,250 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMAudioBackend.cpp
+/// @brief		Galaxy-Music Engine - GMAudioBackend
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.21
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMAudioBackend.h"
+#include <cmath>
+#include <cstring>
+#include <chrono>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define FILE_BACKEND_INTERVAL			5				// 文件后端的更新间隔，单位：ms
+#define NULL_BACKEND_CHUNK				1024			// 空输出每次拉取的最大帧数
+
+/*************************************************************************
+CGMWavDecoder Methods
+*************************************************************************/
+
+bool CGMWavDecoder::Open(const std::wstring& strFile)
+{
+#ifdef _WIN32
+	m_file.open(strFile, std::ios::binary);
+#else
+	m_file.open(_ToUTF8(strFile), std::ios::binary);
+#endif
+	if (!m_file.is_open()) return false;
+
+	char szTag[4];
+	unsigned int iSize = 0;
+	m_file.read(szTag, 4);
+	if (!m_file || 0 != memcmp(szTag, "RIFF", 4)) return false;
+	m_file.read(reinterpret_cast<char*>(&iSize), 4);
+	m_file.read(szTag, 4);
+	if (!m_file || 0 != memcmp(szTag, "WAVE", 4)) return false;
+
+	unsigned short iFormat = 0;
+	bool bFormat = false;
+	while (m_file.read(szTag, 4) && m_file.read(reinterpret_cast<char*>(&iSize), 4))
+	{
+		if (0 == memcmp(szTag, "fmt ", 4) && iSize >= 16)
+		{
+			unsigned short iChannels = 0, iBlockAlign = 0, iBits = 0;
+			unsigned int iRate = 0, iByteRate = 0;
+			m_file.read(reinterpret_cast<char*>(&iFormat), 2);
+			m_file.read(reinterpret_cast<char*>(&iChannels), 2);
+			m_file.read(reinterpret_cast<char*>(&iRate), 4);
+			m_file.read(reinterpret_cast<char*>(&iByteRate), 4);
+			m_file.read(reinterpret_cast<char*>(&iBlockAlign), 2);
+			m_file.read(reinterpret_cast<char*>(&iBits), 2);
+			if (iSize >= 26 && 0xFFFE == iFormat)
+			{
+				// WAVE_FORMAT_EXTENSIBLE，子格式的前两个字节就是格式
+				m_file.seekg(8, std::ios::cur);
+				m_file.read(reinterpret_cast<char*>(&iFormat), 2);
+				m_file.seekg(iSize - 26, std::ios::cur);
+			}
+			else
+			{
+				m_file.seekg(iSize - 16, std::ios::cur);
+			}
+			m_iChannels = iChannels;
+			m_iSampleRate = int(iRate);
+			m_iBytes = iBits / 8;
+			m_bFloat = (3 == iFormat);
+			bFormat = (1 == iFormat || 3 == iFormat) && iChannels > 0 && iRate > 0
+				&& (m_bFloat ? (4 == m_iBytes) : (m_iBytes >= 2 && m_iBytes <= 4));
+		}
+		else if (0 == memcmp(szTag, "data", 4))
+		{
+			if (!bFormat) return false;
+			m_iDataPos = static_cast<long long>(m_file.tellg());
+			m_iLength = iSize / (m_iBytes * m_iChannels);
+			return true;
+		}
+		else
+		{
+			m_file.seekg(iSize + (iSize & 1), std::ios::cur);
+		}
+	}
+	return false;
+}
+
+int CGMWavDecoder::Read(float* pData, int iFrames)
+{
+	if (iFrames > m_iLength - m_iPos) iFrames = int(m_iLength - m_iPos);
+	if (iFrames <= 0) return 0;
+	const int iSamples = iFrames * m_iChannels;
+	m_rawVec.resize(size_t(iSamples) * m_iBytes);
+	m_file.read(reinterpret_cast<char*>(m_rawVec.data()), m_rawVec.size());
+	const int iRead = int(m_file.gcount() / (m_iBytes * m_iChannels));
+	const unsigned char* pRaw = m_rawVec.data();
+	for (int i = 0; i < iRead * m_iChannels; i++, pRaw += m_iBytes)
+	{
+		if (m_bFloat)
+		{
+			memcpy(&pData[i], pRaw, 4);
+		}
+		else
+		{
+			// 放到32位整数的高位，再统一缩放
+			int iValue = 0;
+			for (int b = 0; b < m_iBytes; b++)
+			{
+				iValue |= int(pRaw[b]) << (8 * (4 - m_iBytes + b));
+			}
+			pData[i] = float(iValue) / 2147483648.0f;
+		}
+	}
+	m_iPos += iRead;
+	return iRead;
+}
+
+bool CGMWavDecoder::Seek(long long iFrame)
+{
+	m_iPos = (iFrame < 0) ? 0 : ((iFrame > m_iLength) ? m_iLength : iFrame);
+	m_file.clear();
+	m_file.seekg(m_iDataPos + m_iPos * m_iBytes * m_iChannels, std::ios::beg);
+	return bool(m_file);
+}
+
+std::string CGMWavDecoder::_ToUTF8(const std::wstring& wstr)
+{
+	std::string str;
+	for (wchar_t c : wstr)
+	{
+		unsigned int u = static_cast<unsigned int>(c);
+		if (u < 0x80) { str += char(u); }
+		else if (u < 0x800) { str += char(0xC0 | (u >> 6)); str += char(0x80 | (u & 0x3F)); }
+		else if (u < 0x10000) { str += char(0xE0 | (u >> 12)); str += char(0x80 | ((u >> 6) & 0x3F)); str += char(0x80 | (u & 0x3F)); }
+		else { str += char(0xF0 | (u >> 18)); str += char(0x80 | ((u >> 12) & 0x3F)); str += char(0x80 | ((u >> 6) & 0x3F)); str += char(0x80 | (u & 0x3F)); }
+	}
+	return str;
+}
+
+/*************************************************************************
+CGMNullBackend Methods
+*************************************************************************/
+
+bool CGMNullBackend::OpenOutput(const int iSampleRate, const int iChannels, GMAudioCallback fnCallback)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_fnCallback = fnCallback;
+	m_iSampleRate = iSampleRate;
+	m_iChannels = iChannels;
+	m_bPlay = false;
+	m_fDebt = 0.0;
+	return true;
+}
+
+void CGMNullBackend::CloseOutput()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_fnCallback = nullptr;
+	m_iSampleRate = 0;
+	m_iChannels = 0;
+	m_bPlay = false;
+}
+
+void CGMNullBackend::Lock(const bool bLock)
+{
+	if (bLock)
+		m_mutex.lock();
+	else
+		m_mutex.unlock();
+}
+
+bool CGMNullBackend::SetVolume(const float fVolume)
+{
+	m_fVolume = fVolume;
+	return true;
+}
+
+void CGMNullBackend::_Mix(const double fSeconds)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_bPlay || !m_fnCallback || 0 == m_iChannels)
+	{
+		m_fLevel = 0.0f;
+		return;
+	}
+	// 不足一帧的部分留到下一次，长时间运行也不会漂移
+	m_fDebt += fSeconds * m_iSampleRate;
+	float fPeak = 0.0f;
+	while (m_fDebt >= 1.0)
+	{
+		const int iFrames = (m_fDebt < NULL_BACKEND_CHUNK) ? int(m_fDebt) : NULL_BACKEND_CHUNK;
+		m_bufferVec.resize(size_t(iFrames) * m_iChannels);
+		m_fnCallback(m_bufferVec.data(), iFrames);
+		for (float f : m_bufferVec) fPeak = fmax(fPeak, fabs(f));
+		m_iPulled += iFrames;
+		m_fDebt -= iFrames;
+	}
+	const float fLevel = fPeak * m_fVolume;
+	m_fLevel = (fLevel < 1.0f) ? fLevel : 1.0f;
+}
+
+/*************************************************************************
+CGMFileBackend Methods
+*************************************************************************/
+
+bool CGMFileBackend::Init()
+{
+	if (m_thread.joinable()) return true;
+	m_bExit = false;
+	m_thread = std::thread(&CGMFileBackend::_Run, this);
+	return true;
+}
+
+void CGMFileBackend::Release()
+{
+	m_bExit = true;
+	if (m_thread.joinable()) m_thread.join();
+	CloseOutput();
+}
+
+CGMAudioDecoder* CGMFileBackend::OpenDecoder(const std::wstring& strFile)
+{
+	CGMWavDecoder* pDecoder = new CGMWavDecoder();
+	if (!pDecoder->Open(strFile))
+	{
+		delete pDecoder;
+		return nullptr;
+	}
+	return pDecoder;
+}
+
+void CGMFileBackend::_Run()
+{
+	auto tLast = std::chrono::steady_clock::now();
+	while (!m_bExit)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(FILE_BACKEND_INTERVAL));
+		auto tNow = std::chrono::steady_clock::now();
+		const double fDelta = std::chrono::duration<double>(tNow - tLast).count();
+		tLast = tNow;
+		_Mix(fDelta);
+	}
+}
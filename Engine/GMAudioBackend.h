@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMAudioBackend.h
+/// @brief		Galaxy-Music Engine - GMAudioBackend
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.21
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+#include <functional>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+namespace GM
+{
+	/*************************************************************************
+	Enums
+	*************************************************************************/
+
+	// 音频后端类型
+	enum EGMAUDIO_BACKEND
+	{
+		EGMAUDIO_BACKEND_BASS,			// BASS解码 + 声卡输出
+		EGMAUDIO_BACKEND_FILE,			// 只支持wav的文件解码 + 按真实时间消耗采样的空输出，用于没有声卡的测试环境
+		EGMAUDIO_BACKEND_EXPORT			// BASS解码 + 由导出程序按仿真时间推进的空输出，用于离线导出视频
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMAudioDecoder
+	*  @brief 一首音频的解码器，输出交错排列的float采样
+	*  @brief 可以在任意线程创建，但同一时刻只能被一个线程读取
+	*/
+	class CGMAudioDecoder
+	{
+	public:
+		virtual ~CGMAudioDecoder() {}
+
+		/** @brief 采样率，单位：Hz */
+		virtual int GetSampleRate() const = 0;
+		/** @brief 声道数 */
+		virtual int GetChannels() const = 0;
+		/** @brief 总帧数，一帧包含所有声道的一个采样 */
+		virtual long long GetLength() const = 0;
+		/**
+		* @brief 从当前位置读取采样
+		* @param pData: 输出，至少iFrames * GetChannels()个float
+		* @param iFrames: 想要读取的帧数
+		* @return int 实际读取的帧数，0表示已经结束
+		*/
+		virtual int Read(float* pData, int iFrames) = 0;
+		/**
+		* @brief 跳转到指定帧
+		* @param iFrame: 帧序号
+		* @return bool 成功true， 失败false
+		*/
+		virtual bool Seek(long long iFrame) = 0;
+	};
+
+	/**
+	* @brief 输出回调，在后端的混音线程中调用，必须填满iFrames帧
+	* @param pData: 输出，iFrames * 声道数个float
+	* @param iFrames: 需要的帧数
+	*/
+	typedef std::function<void(float* pData, int iFrames)> GMAudioCallback;
+
+	/*!
+	*  @class CGMAudioBackend
+	*  @brief 音频后端：打开解码器，以及一个从回调里拉取采样的输出流
+	*  @brief 已经输出的帧数在整个生命周期内单调递增，换输出流、清空缓冲都不会归零
+	*/
+	class CGMAudioBackend
+	{
+	public:
+		virtual ~CGMAudioBackend() {}
+
+		/**
+		* @brief 创建后端
+		* @param eType: 后端类型
+		* @return CGMAudioBackend* 后端，需要调用者删除
+		*/
+		static CGMAudioBackend* Create(const EGMAUDIO_BACKEND eType);
+
+		/** @brief 初始化输出设备 */
+		virtual bool Init() = 0;
+		/** @brief 释放输出设备 */
+		virtual void Release() = 0;
+		/**
+		* @brief 打开解码器，可能读盘，不要在主线程中对未缓存的文件调用
+		* @param strFile: 完整路径
+		* @return CGMAudioDecoder* 解码器，失败返回nullptr，需要调用者删除
+		*/
+		virtual CGMAudioDecoder* OpenDecoder(const std::wstring& strFile) = 0;
+
+		/**
+		* @brief 创建输出流，已有的输出流会先关闭
+		* @param iSampleRate: 采样率，单位：Hz
+		* @param iChannels: 声道数
+		* @param fnCallback: 拉取采样的回调
+		* @return bool 成功true， 失败false
+		*/
+		virtual bool OpenOutput(const int iSampleRate, const int iChannels, GMAudioCallback fnCallback) = 0;
+		/** @brief 关闭输出流 */
+		virtual void CloseOutput() = 0;
+		/** @brief 输出流的采样率，没有输出流时返回0 */
+		virtual int GetOutputSampleRate() const = 0;
+		/** @brief 输出流的声道数，没有输出流时返回0 */
+		virtual int GetOutputChannels() const = 0;
+		/** @brief 开始或继续输出 */
+		virtual void Play() = 0;
+		/** @brief 暂停输出 */
+		virtual void Pause() = 0;
+		/** @brief 丢弃已经拉取但还没播放的采样，必须在Lock(true)之后调用 */
+		virtual void Flush() = 0;
+		/**
+		* @brief 锁住输出流，锁住期间不会调用回调
+		* @param bLock: true加锁，false解锁
+		*/
+		virtual void Lock(const bool bLock) = 0;
+		/** @brief 已经从回调拉取的总帧数 */
+		virtual long long GetPulledFrames() const = 0;
+		/** @brief 已经真正播放出去的总帧数，包含了输出缓冲的延迟 */
+		virtual long long GetPlayedFrames() const = 0;
+		/**
+		* @brief 设置输出音量
+		* @param fVolume: 音量 [0.0f,1.0f]
+		*/
+		virtual bool SetVolume(const float fVolume) = 0;
+		/** @brief 当前输出的振幅 [0.0f,1.0f] */
+		virtual float GetLevel() const = 0;
+		/**
+		* @brief 按仿真时间推进输出，在调用线程中拉取采样，只有导出后端使用
+		* @param fSeconds: 推进的时间，单位：秒
+		*/
+		virtual void Advance(const double /*fSeconds*/) {}
+	};
+
+	/*!
+	*  @class CGMWavDecoder
+	*  @brief 只依赖标准库的wav解码器，支持16/24/32位整数和32位浮点PCM
+	*/
+	class CGMWavDecoder : public CGMAudioDecoder
+	{
+	public:
+		/**
+		* @brief 打开wav文件，读取格式并定位到数据块
+		* @param strFile: 完整路径
+		* @return bool 成功true， 不是支持的wav格式false
+		*/
+		bool Open(const std::wstring& strFile);
+
+		virtual int GetSampleRate() const { return m_iSampleRate; }
+		virtual int GetChannels() const { return m_iChannels; }
+		virtual long long GetLength() const { return m_iLength; }
+		virtual int Read(float* pData, int iFrames);
+		virtual bool Seek(long long iFrame);
+
+	private:
+		static std::string _ToUTF8(const std::wstring& wstr);
+
+	private:
+		std::ifstream				m_file;
+		std::vector<unsigned char>	m_rawVec;
+		int							m_iSampleRate = 0;
+		int							m_iChannels = 0;
+		int							m_iBytes = 2;
+		bool						m_bFloat = false;
+		long long					m_iDataPos = 0;
+		long long					m_iLength = 0;
+		long long					m_iPos = 0;
+	};
+
+	/*!
+	*  @class CGMNullBackend
+	*  @brief 没有声卡的空输出，拉取的采样只用来计算振幅然后丢弃，没有输出延迟
+	*  @brief 子类只决定按什么时间推进：文件后端按真实时间，导出后端按仿真时间
+	*/
+	class CGMNullBackend : public CGMAudioBackend
+	{
+	public:
+		virtual bool OpenOutput(const int iSampleRate, const int iChannels, GMAudioCallback fnCallback);
+		virtual void CloseOutput();
+		virtual int GetOutputSampleRate() const { return m_iSampleRate; }
+		virtual int GetOutputChannels() const { return m_iChannels; }
+		virtual void Play() { m_bPlay = true; }
+		virtual void Pause() { m_bPlay = false; }
+		virtual void Flush() { m_fDebt = 0.0; }
+		virtual void Lock(const bool bLock);
+		virtual long long GetPulledFrames() const { return m_iPulled; }
+		virtual long long GetPlayedFrames() const { return m_iPulled; }
+		virtual bool SetVolume(const float fVolume);
+		virtual float GetLevel() const { return m_fLevel; }
+
+	protected:
+		/**
+		* @brief 推进输出，在调用线程中拉取这段时间的采样，不足一帧的部分留到下一次
+		* @param fSeconds: 推进的时间，单位：秒
+		*/
+		void _Mix(const double fSeconds);
+
+	private:
+		std::mutex					m_mutex;
+		GMAudioCallback				m_fnCallback;
+		std::atomic<int>			m_iSampleRate{ 0 };
+		std::atomic<int>			m_iChannels{ 0 };
+		std::atomic<bool>			m_bPlay{ false };
+		std::atomic<long long>		m_iPulled{ 0 };
+		std::atomic<float>			m_fLevel{ 0.0f };
+		std::vector<float>			m_bufferVec;
+		double						m_fDebt = 0.0;
+		float						m_fVolume = 0.5f;
+	};
+
+	/*!
+	*  @class CGMFileBackend
+	*  @brief 文件后端，解码wav，输出线程按真实时间推进空输出
+	*  @brief 只依赖标准库，不需要BASS和声卡，可以单独编译测试
+	*/
+	class CGMFileBackend : public CGMNullBackend
+	{
+	public:
+		~CGMFileBackend() { Release(); }
+
+		virtual bool Init();
+		virtual void Release();
+		virtual CGMAudioDecoder* OpenDecoder(const std::wstring& strFile);
+
+	private:
+		/** @brief 输出线程 */
+		void _Run();
+
+	private:
+		std::thread					m_thread;
+		std::atomic<bool>			m_bExit{ false };
+	};
+}	// GM
@@ -0,0 +1,258 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMAudioBassBackend.cpp
+/// @brief		Galaxy-Music Engine - GMAudioBassBackend
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMAudioBackend.h"
+#include "GMCommon.h"
+#include "bass.h"
+#include <atomic>
+
+using namespace GM;
+
+/*************************************************************************
+CGMBassDecoder
+*************************************************************************/
+
+/*!
+*  @class CGMBassDecoder
+*  @brief 用BASS的解码流实现的解码器，文件异步读取
+*/
+class CGMBassDecoder : public CGMAudioDecoder
+{
+public:
+	CGMBassDecoder(HSTREAM hStream) : m_hStream(hStream)
+	{
+		BASS_CHANNELINFO sInfo;
+		if (BASS_ChannelGetInfo(m_hStream, &sInfo))
+		{
+			m_iSampleRate = int(sInfo.freq);
+			m_iChannels = int(sInfo.chans);
+		}
+		QWORD iBytes = BASS_ChannelGetLength(m_hStream, BASS_POS_BYTE);
+		if (QWORD(-1) != iBytes && m_iChannels > 0)
+		{
+			m_iLength = static_cast<long long>(iBytes / (sizeof(float) * m_iChannels));
+		}
+	}
+	~CGMBassDecoder()
+	{
+		BASS_StreamFree(m_hStream);
+	}
+
+	int GetSampleRate() const { return m_iSampleRate; }
+	int GetChannels() const { return m_iChannels; }
+	long long GetLength() const { return m_iLength; }
+
+	int Read(float* pData, int iFrames)
+	{
+		const DWORD iFrameBytes = DWORD(sizeof(float) * m_iChannels);
+		DWORD iBytes = BASS_ChannelGetData(m_hStream, pData, iFrameBytes * DWORD(iFrames));
+		if (DWORD(-1) == iBytes) return 0;
+		return int(iBytes / iFrameBytes);
+	}
+	bool Seek(long long iFrame)
+	{
+		QWORD iBytes = QWORD(iFrame) * sizeof(float) * m_iChannels;
+		return TRUE == BASS_ChannelSetPosition(m_hStream, iBytes, BASS_POS_BYTE);
+	}
+
+private:
+	HSTREAM						m_hStream = 0;
+	int							m_iSampleRate = 44100;
+	int							m_iChannels = 2;
+	long long					m_iLength = 0;
+};
+
+/*************************************************************************
+CGMBassBackend
+*************************************************************************/
+
+/*!
+*  @class CGMBassBackend
+*  @brief BASS后端，输出流是一个用户流，BASS的更新线程调用回调拉取采样
+*/
+class CGMBassBackend : public CGMAudioBackend
+{
+public:
+	~CGMBassBackend() { Release(); }
+
+	bool Init()
+	{
+		//初始化BASS音频库
+		return TRUE == BASS_Init(
+			-1,//默认设备
+			44100,//输出采样率44100（常用值）
+			BASS_DEVICE_CPSPEAKERS,//信号，BASS_DEVICE_CPSPEAKERS
+			NULL,//程序窗口,0用于控制台程序
+			nullptr//类标识符,0使用默认值
+		);
+	}
+	void Release()
+	{
+		CloseOutput();
+	}
+	CGMAudioDecoder* OpenDecoder(const std::wstring& strFile)
+	{
+		HSTREAM hStream = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0,
+			BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | BASS_ASYNCFILE);
+		if (0 == hStream) return nullptr;
+		return new CGMBassDecoder(hStream);
+	}
+
+	bool OpenOutput(const int iSampleRate, const int iChannels, GMAudioCallback fnCallback)
+	{
+		CloseOutput();
+		m_fnCallback = fnCallback;
+		m_iSampleRate = iSampleRate;
+		m_iChannels = iChannels;
+		m_iBase = m_iPulled.load();
+		m_hOutput = BASS_StreamCreate(DWORD(iSampleRate), DWORD(iChannels), BASS_SAMPLE_FLOAT, &_StreamProc, this);
+		if (0 == m_hOutput)
+		{
+			m_iSampleRate = 0;
+			m_iChannels = 0;
+			return false;
+		}
+		BASS_ChannelSetAttribute(m_hOutput, BASS_ATTRIB_VOL, m_fVolume);
+		return true;
+	}
+	void CloseOutput()
+	{
+		if (0 == m_hOutput) return;
+		// 关闭前把已经播放的帧数记下来，保证帧数单调递增
+		m_iBase = GetPlayedFrames();
+		m_iPulled = m_iBase;
+		BASS_StreamFree(m_hOutput);
+		m_hOutput = 0;
+		m_iSampleRate = 0;
+		m_iChannels = 0;
+	}
+	int GetOutputSampleRate() const { return m_iSampleRate; }
+	int GetOutputChannels() const { return m_iChannels; }
+	void Play() { if (m_hOutput) BASS_ChannelPlay(m_hOutput, FALSE); }
+	void Pause() { if (m_hOutput) BASS_ChannelPause(m_hOutput); }
+	void Flush()
+	{
+		if (0 == m_hOutput) return;
+		// 用户流不能跳转，但设置到0会清空缓冲
+		BASS_ChannelSetPosition(m_hOutput, 0, BASS_POS_BYTE);
+		m_iBase = m_iPulled.load();
+	}
+	void Lock(const bool bLock)
+	{
+		if (m_hOutput) BASS_ChannelLock(m_hOutput, bLock ? TRUE : FALSE);
+	}
+	long long GetPulledFrames() const { return m_iPulled; }
+	long long GetPlayedFrames() const
+	{
+		if (0 == m_hOutput || 0 == m_iChannels) return m_iBase;
+		QWORD iBytes = BASS_ChannelGetPosition(m_hOutput, BASS_POS_BYTE);
+		if (QWORD(-1) == iBytes) return m_iBase;
+		return m_iBase + static_cast<long long>(iBytes / (sizeof(float) * m_iChannels));
+	}
+	bool SetVolume(const float fVolume)
+	{
+		m_fVolume = fVolume;
+		if (0 == m_hOutput) return true;
+		return TRUE == BASS_ChannelSetAttribute(m_hOutput, BASS_ATTRIB_VOL, m_fVolume);
+	}
+	float GetLevel() const
+	{
+		if (0 == m_hOutput) return 0.0f;
+		DWORD level, left, right;
+		level = BASS_ChannelGetLevel(m_hOutput);
+		if (DWORD(-1) == level) return 0.0f;
+		left = LOWORD(level); // the left level
+		right = HIWORD(level); // the right level
+		return min(1.0f, max(left, right) / 32768.0f);
+	}
+
+private:
+	static DWORD CALLBACK _StreamProc(HSTREAM /*handle*/, void* buffer, DWORD length, void* user)
+	{
+		CGMBassBackend* pThis = static_cast<CGMBassBackend*>(user);
+		const DWORD iFrameBytes = DWORD(sizeof(float) * pThis->m_iChannels);
+		const int iFrames = int(length / iFrameBytes);
+		pThis->m_fnCallback(static_cast<float*>(buffer), iFrames);
+		pThis->m_iPulled += iFrames;
+		return DWORD(iFrames) * iFrameBytes;
+	}
+
+private:
+	HSTREAM						m_hOutput = 0;
+	GMAudioCallback				m_fnCallback;
+	int							m_iSampleRate = 0;
+	int							m_iChannels = 0;
+	std::atomic<long long>		m_iPulled{ 0 };
+	long long					m_iBase = 0;
+	float						m_fVolume = 0.5f;
+};
+
+/*************************************************************************
+CGMExportBackend
+*************************************************************************/
+
+/*!
+*  @class CGMExportBackend
+*  @brief 导出后端，BASS解码，空输出不跟随真实时间，每帧由导出程序推进固定的时间
+*  @brief 导出可以比实时快，也可以比实时慢，音频位置和画面始终一致
+*/
+class CGMExportBackend : public CGMNullBackend
+{
+public:
+	~CGMExportBackend() { Release(); }
+
+	bool Init()
+	{
+		// 0号设备不输出声音，只用来解码
+		return TRUE == BASS_Init(0, 44100, 0, NULL, nullptr) || BASS_ERROR_ALREADY == BASS_ErrorGetCode();
+	}
+	void Release()
+	{
+		CloseOutput();
+	}
+	CGMAudioDecoder* OpenDecoder(const std::wstring& strFile)
+	{
+		// 不用异步读取，解码速度只受CPU限制
+		HSTREAM hStream = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT);
+		if (0 != hStream) return new CGMBassDecoder(hStream);
+
+		CGMWavDecoder* pDecoder = new CGMWavDecoder();
+		if (!pDecoder->Open(strFile))
+		{
+			delete pDecoder;
+			return nullptr;
+		}
+		return pDecoder;
+	}
+	void Advance(const double fSeconds)
+	{
+		_Mix(fSeconds);
+	}
+};
+
+/*************************************************************************
+CGMAudioBackend Methods
+*************************************************************************/
+
+CGMAudioBackend* CGMAudioBackend::Create(const EGMAUDIO_BACKEND eType)
+{
+	switch (eType)
+	{
+	case EGMAUDIO_BACKEND_FILE:
+		return new CGMFileBackend();
+	case EGMAUDIO_BACKEND_EXPORT:
+		return new CGMExportBackend();
+	case EGMAUDIO_BACKEND_BASS:
+	default:
+		return new CGMBassBackend();
+	}
+}
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "GMCommon.h"
+#include "GMVectorOps.h"
 #include <osgGA/CameraManipulator>
 
 namespace GM
@@ -112,29 +113,29 @@ namespace GM
 		/* @brief SGMVector 转 osg::Vec */
 		inline osg::Vec2f _GM2OSG(const SGMVector2f& vGM) const
 		{
-			return osg::Vec2f(vGM.x, vGM.y);
+			return GM2OSG(vGM);
 		}
 		inline osg::Vec3d _GM2OSG(const SGMVector3& vGM) const
 		{
-			return osg::Vec3d(vGM.x, vGM.y, vGM.z);
+			return GM2OSG(vGM);
 		}
 		inline osg::Vec4d _GM2OSG(const SGMVector4& vGM) const
 		{
-			return osg::Vec4d(vGM.x, vGM.y, vGM.z, vGM.w);
+			return GM2OSG(vGM);
 		}
 
 		/* @brief osg::Vec 转 SGMVector */
 		inline SGMVector2f _OSG2GM(const osg::Vec2f& vOSG) const
 		{
-			return SGMVector2f(vOSG.x(), vOSG.y());
+			return OSG2GM(vOSG);
 		}
 		inline SGMVector3 _OSG2GM(const osg::Vec3d& vOSG) const
 		{
-			return SGMVector3(vOSG.x(), vOSG.y(), vOSG.z());
+			return OSG2GM(vOSG);
 		}
 		inline SGMVector4 _OSG2GM(const osg::Vec4d& vOSG) const
 		{
-			return SGMVector4(vOSG.x(), vOSG.y(), vOSG.z(), vOSG.w());
+			return OSG2GM(vOSG);
 		}
 
 	private:
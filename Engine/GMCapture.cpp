@@ -0,0 +1,346 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMCapture.cpp
+/// @brief		Galaxy-Music Engine - GMCapture
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMCapture.h"
+#include <osg/FrameBufferObject>
+#include <osg/Notify>
+#include <osgDB/WriteFile>
+#include <osgDB/FileUtils>
+#include <cstring>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define CAPTURE_RING_SIZE			3			// PBO环形缓冲的大小，即同时在读取中的截图数量
+#define CAPTURE_WORKER_NUM			2			// 后台编码线程的数量
+#define CAPTURE_WAIT_TIMEOUT		1000000000	// 等待读取完成时每次的超时，单位：纳秒
+
+/*************************************************************************
+CGMCaptureCallback
+*************************************************************************/
+
+namespace GM
+{
+	/*!
+	*  @class CGMCaptureCallback
+	*  @brief 相机绘制完成后的回调，转给截图模块
+	*/
+	class CGMCaptureCallback : public osg::Camera::DrawCallback
+	{
+	public:
+		CGMCaptureCallback(CGMCapture* pCapture) : m_pCapture(pCapture) {}
+
+		virtual void operator() (osg::RenderInfo& renderInfo) const
+		{
+			if (m_pCapture) m_pCapture->_Draw(renderInfo);
+		}
+
+	private:
+		CGMCapture*			m_pCapture = nullptr;
+	};
+}	// GM
+
+/*************************************************************************
+CGMCapture Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMCapture::CGMCapture()
+{
+}
+
+/** @brief 析构 */
+CGMCapture::~CGMCapture()
+{
+	Release();
+}
+
+/** @brief 初始化 */
+bool CGMCapture::Init(SGMConfigData* pConfigData)
+{
+	m_pConfigData = pConfigData;
+	m_bExit = false;
+	m_slotVec.resize(CAPTURE_RING_SIZE);
+	while (m_threadVec.size() < CAPTURE_WORKER_NUM)
+	{
+		m_threadVec.push_back(std::thread(&CGMCapture::_WorkerLoop, this));
+	}
+	return true;
+}
+
+/** @brief 释放 */
+void CGMCapture::Release()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_condition.notify_all();
+	for (auto& itr : m_threadVec)
+	{
+		if (itr.joinable()) itr.join();
+	}
+	m_threadVec.clear();
+	// PBO和栅栏随图形上下文一起释放
+}
+
+void CGMCapture::AddTarget(const std::string& strName, osg::Texture2D* pTex)
+{
+	if (!pTex || CAPTURE_TARGET_SCREEN == strName) return;
+	std::lock_guard<std::mutex> lock(m_requestMutex);
+	m_targetMap[strName] = pTex;
+}
+
+bool CGMCapture::Attach(osg::Camera* pCamera)
+{
+	if (!pCamera) return false;
+	pCamera->setFinalDrawCallback(new CGMCaptureCallback(this));
+	return true;
+}
+
+bool CGMCapture::Capture(const std::string& strTarget, const std::string& strFile)
+{
+	if (strFile.empty()) return false;
+
+	std::lock_guard<std::mutex> lock(m_requestMutex);
+	if (CAPTURE_TARGET_SCREEN != strTarget && m_targetMap.end() == m_targetMap.find(strTarget)) return false;
+
+	SGMCaptureRequest sRequest;
+	sRequest.strTarget = strTarget;
+	sRequest.strFile = strFile;
+	m_requestQueue.push_back(sRequest);
+	m_iPending++;
+	return true;
+}
+
+bool CGMCapture::Capture(const std::string& strTarget, GMCaptureCallback fnCallback)
+{
+	if (!fnCallback) return false;
+
+	std::lock_guard<std::mutex> lock(m_requestMutex);
+	if (CAPTURE_TARGET_SCREEN != strTarget && m_targetMap.end() == m_targetMap.find(strTarget)) return false;
+
+	SGMCaptureRequest sRequest;
+	sRequest.strTarget = strTarget;
+	sRequest.fnCallback = fnCallback;
+	m_requestQueue.push_back(sRequest);
+	m_iPending++;
+	return true;
+}
+
+void CGMCapture::_Draw(osg::RenderInfo& renderInfo)
+{
+	osg::State* pState = renderInfo.getState();
+	const osg::GLExtensions* pExt = pState->get<osg::GLExtensions>();
+	if (!pExt || !pExt->isPBOSupported || !pExt->isSyncSupported || !pExt->glMapBufferRange) return;
+
+	// 先收取上一两帧发出的读取，从最早的开始
+	for (size_t i = 0; i < m_slotVec.size(); i++)
+	{
+		SGMCaptureSlot& sSlot = m_slotVec[(m_iNextSlot + i) % m_slotVec.size()];
+		if (sSlot.pSync) _Collect(pExt, sSlot);
+	}
+
+	// 每个空闲的PBO发出一个读取，PBO都在读取中时请求留到下一帧
+	while (true)
+	{
+		SGMCaptureSlot& sSlot = m_slotVec[m_iNextSlot];
+		if (sSlot.pSync)
+		{
+			if (!m_bFrameExact) break;
+			{
+				std::lock_guard<std::mutex> lock(m_requestMutex);
+				if (m_requestQueue.empty()) break;
+			}
+			// 逐帧模式下不能把请求留到后面的帧，等最早的读取完成腾出PBO
+			_WaitCollect(pExt, sSlot);
+		}
+
+		SGMCaptureRequest sRequest;
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			if (m_requestQueue.empty()) break;
+			sRequest = m_requestQueue.front();
+			m_requestQueue.pop_front();
+		}
+		if (_Issue(renderInfo, sRequest, sSlot))
+		{
+			m_iNextSlot = (m_iNextSlot + 1) % m_slotVec.size();
+		}
+		else
+		{
+			OSG_WARN << "Capture: target " << sRequest.strTarget << " is not ready" << std::endl;
+			m_iPending--;
+		}
+	}
+
+	if (m_bFlush)
+	{
+		for (size_t i = 0; i < m_slotVec.size(); i++)
+		{
+			SGMCaptureSlot& sSlot = m_slotVec[(m_iNextSlot + i) % m_slotVec.size()];
+			if (sSlot.pSync) _WaitCollect(pExt, sSlot);
+		}
+		m_bFlush = false;
+	}
+}
+
+bool CGMCapture::_Issue(osg::RenderInfo& renderInfo, const SGMCaptureRequest& sRequest, SGMCaptureSlot& sSlot)
+{
+	osg::State* pState = renderInfo.getState();
+	const osg::GLExtensions* pExt = pState->get<osg::GLExtensions>();
+
+	int iWidth = 0;
+	int iHeight = 0;
+	osg::ref_ptr<osg::Texture2D> pTex = nullptr;
+	osg::Texture::TextureObject* pTexObj = nullptr;
+	if (CAPTURE_TARGET_SCREEN == sRequest.strTarget)
+	{
+		const osg::Viewport* pViewport = renderInfo.getCurrentCamera() ? renderInfo.getCurrentCamera()->getViewport() : nullptr;
+		if (!pViewport) return false;
+		iWidth = int(pViewport->width());
+		iHeight = int(pViewport->height());
+	}
+	else
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			auto itr = m_targetMap.find(sRequest.strTarget);
+			if (m_targetMap.end() != itr) pTex = itr->second;
+		}
+		if (pTex.valid()) pTexObj = pTex->getTextureObject(pState->getContextID());
+		if (!pTexObj) return false;
+		iWidth = pTex->getTextureWidth();
+		iHeight = pTex->getTextureHeight();
+	}
+	if (iWidth <= 0 || iHeight <= 0) return false;
+
+	if (!sSlot.iPBO) pExt->glGenBuffers(1, &sSlot.iPBO);
+	pExt->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, sSlot.iPBO);
+	const GLsizeiptr iSize = GLsizeiptr(iWidth) * iHeight * 4;
+	if (iSize != sSlot.iSize)
+	{
+		pExt->glBufferData(GL_PIXEL_PACK_BUFFER_ARB, iSize, nullptr, GL_STREAM_READ_ARB);
+		sSlot.iSize = iSize;
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	// 读到PBO里，函数立即返回，拷贝在GPU上排队执行
+	if (pTexObj)
+	{
+		glBindTexture(GL_TEXTURE_2D, pTexObj->id());
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		pState->haveAppliedTextureAttribute(pState->getActiveTextureUnit(), pTex.get());
+	}
+	else
+	{
+		GLint iReadFBO = 0;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING_EXT, &iReadFBO);
+		osg::GraphicsContext* pGC = pState->getGraphicsContext();
+		const bool bDoubleBuffer = pGC && pGC->getTraits() && pGC->getTraits()->doubleBuffer;
+		if (pExt->isFrameBufferObjectSupported)
+			pExt->glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, pGC ? pGC->getDefaultFboId() : 0);
+		glReadBuffer(bDoubleBuffer ? GL_BACK : GL_FRONT);
+		glReadPixels(0, 0, iWidth, iHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		if (pExt->isFrameBufferObjectSupported)
+			pExt->glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, GLuint(iReadFBO));
+	}
+	pExt->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+	sSlot.pSync = pExt->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	sSlot.iWidth = iWidth;
+	sSlot.iHeight = iHeight;
+	sSlot.strFile = sRequest.strFile;
+	sSlot.fnCallback = sRequest.fnCallback;
+	return nullptr != sSlot.pSync;
+}
+
+bool CGMCapture::_Collect(const osg::GLExtensions* pExt, SGMCaptureSlot& sSlot, const GLuint64 iTimeout)
+{
+	const GLenum eResult = pExt->glClientWaitSync(sSlot.pSync, GL_SYNC_FLUSH_COMMANDS_BIT, iTimeout);
+	if (GL_TIMEOUT_EXPIRED == eResult) return false;
+	pExt->glDeleteSync(sSlot.pSync);
+	sSlot.pSync = nullptr;
+	if (GL_WAIT_FAILED == eResult)
+	{
+		m_iPending--;
+		return true;
+	}
+
+	osg::ref_ptr<osg::Image> pImage = new osg::Image();
+	pImage->allocateImage(sSlot.iWidth, sSlot.iHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+	pExt->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, sSlot.iPBO);
+	const void* pData = pExt->glMapBufferRange(GL_PIXEL_PACK_BUFFER_ARB, 0, sSlot.iSize, GL_MAP_READ_BIT);
+	if (pData)
+	{
+		memcpy(pImage->data(), pData, size_t(sSlot.iSize));
+		pExt->glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+	}
+	pExt->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+	if (!pData)
+	{
+		m_iPending--;
+		return true;
+	}
+
+	SGMCaptureJob sJob;
+	sJob.pImage = pImage;
+	sJob.strFile = sSlot.strFile;
+	sJob.fnCallback = sSlot.fnCallback;
+	sSlot.fnCallback = nullptr;
+	m_iEncoding++;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobQueue.push_back(sJob);
+	}
+	m_condition.notify_one();
+	return true;
+}
+
+void CGMCapture::_WaitCollect(const osg::GLExtensions* pExt, SGMCaptureSlot& sSlot)
+{
+	while (sSlot.pSync && !_Collect(pExt, sSlot, CAPTURE_WAIT_TIMEOUT)) {}
+}
+
+void CGMCapture::_WorkerLoop()
+{
+	while (true)
+	{
+		SGMCaptureJob sJob;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_bExit || !m_jobQueue.empty(); });
+			// 退出前把已经读回的图片写完
+			if (m_jobQueue.empty()) return;
+			sJob = m_jobQueue.front();
+			m_jobQueue.pop_front();
+		}
+
+		if (sJob.fnCallback)
+		{
+			sJob.fnCallback(sJob.pImage.get());
+		}
+		else
+		{
+			osgDB::makeDirectoryForFile(sJob.strFile);
+			if (!osgDB::writeImageFile(*sJob.pImage, sJob.strFile))
+			{
+				OSG_WARN << "Capture: can not write " << sJob.strFile << std::endl;
+			}
+		}
+		m_iEncoding--;
+		m_iPending--;
+	}
+}
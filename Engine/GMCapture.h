@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMCapture.h
+/// @brief		Galaxy-Music Engine - GMCapture
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMCommon.h"
+#include <osg/Camera>
+#include <osg/Texture2D>
+#include <osg/GLExtensions>
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace GM
+{
+	/*************************************************************************
+	Macro Defines
+	*************************************************************************/
+	#define CAPTURE_TARGET_SCREEN		"screen"		// 最终画面，即后期相机输出到窗口的结果
+
+	/** @brief 读回的图片交给调用者处理，在后台编码线程中调用，图片自下而上存放 */
+	typedef std::function<void(osg::Image*)> GMCaptureCallback;
+
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMCaptureRequest
+	*  @brief 一次截图请求
+	*/
+	struct SGMCaptureRequest
+	{
+		std::string						strTarget = "";				//!< 截图的对象
+		std::string						strFile = "";				//!< 图片文件路径
+		GMCaptureCallback				fnCallback;					//!< 不为空时交给回调，不写文件
+	};
+
+	/*!
+	*  @struct SGMCaptureSlot
+	*  @brief 环形缓冲中的一个PBO，从发出读取到GPU完成之前一直被占用
+	*/
+	struct SGMCaptureSlot
+	{
+		GLuint							iPBO = 0;					//!< 像素缓冲对象
+		GLsync							pSync = nullptr;			//!< 读取完成的栅栏，空表示空闲
+		GLsizeiptr						iSize = 0;					//!< 已分配的字节数
+		int								iWidth = 0;					//!< 图片宽度
+		int								iHeight = 0;				//!< 图片高度
+		std::string						strFile = "";				//!< 图片文件路径
+		GMCaptureCallback				fnCallback;					//!< 读回后的回调
+	};
+
+	/*!
+	*  @struct SGMCaptureJob
+	*  @brief 等待编码写入的图片
+	*/
+	struct SGMCaptureJob
+	{
+		osg::ref_ptr<osg::Image>		pImage;						//!< 读回的像素
+		std::string						strFile = "";				//!< 图片文件路径
+		GMCaptureCallback				fnCallback;					//!< 读回后的回调
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMCapture
+	*  @brief 异步截图：绘制线程把画面读到PBO环形缓冲并插入栅栏，不等待GPU，
+	*  @brief 一两帧后栅栏完成再映射拷贝，交给后台线程编码写入文件
+	*  @brief 可以按名称截取最终画面或者任意一个渲染目标
+	*/
+	class CGMCapture
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMCapture();
+		/** @brief 析构 */
+		~CGMCapture();
+
+		/** @brief 初始化，启动后台编码线程 */
+		bool Init(SGMConfigData* pConfigData);
+		/** @brief 释放，等待已经读回的图片写完 */
+		void Release();
+
+		/**
+		* @brief 注册可以截取的渲染目标
+		* @param strName: 名称
+		* @param pTex: 渲染目标的颜色图
+		*/
+		void AddTarget(const std::string& strName, osg::Texture2D* pTex);
+		/**
+		* @brief 在相机上挂截图回调，应该是每帧最后绘制的相机
+		* @param pCamera: 相机
+		* @return bool 成功true，失败false
+		*/
+		bool Attach(osg::Camera* pCamera);
+		/**
+		* @brief 请求截图，立即返回，下一次绘制时发出读取
+		* @param strTarget: 截图的对象，CAPTURE_TARGET_SCREEN或者注册过的渲染目标
+		* @param strFile: 图片文件路径，扩展名决定格式
+		* @return bool 请求成功true，对象不存在返回false
+		*/
+		bool Capture(const std::string& strTarget, const std::string& strFile);
+		/**
+		* @brief 请求截图，读回的图片交给回调，不写文件
+		* @param strTarget: 截图的对象，CAPTURE_TARGET_SCREEN或者注册过的渲染目标
+		* @param fnCallback: 回调，在后台编码线程中调用
+		* @return bool 请求成功true，对象不存在返回false
+		*/
+		bool Capture(const std::string& strTarget, GMCaptureCallback fnCallback);
+		/** @brief 还没有写完的截图数量 */
+		inline int GetPendingNum() const { return m_iPending; }
+		/** @brief 已经读回、排队等待或者正在编码的图片数量 */
+		inline int GetEncodingNum() const { return m_iEncoding; }
+		/**
+		* @brief 逐帧模式：请求必须在下一次绘制时发出，PBO都在读取中时等待最早的一个
+		* @brief 默认模式下请求会留到后面的帧，截到的可能是之后的画面，导出视频时要打开逐帧模式
+		* @param bEnable: 是否打开
+		*/
+		inline void SetFrameExact(const bool bEnable) { m_bFrameExact = bEnable; }
+		/** @brief 下一次绘制发出读取后，等待所有读取完成，最后一帧之后不会再有绘制时调用 */
+		inline void Flush() { m_bFlush = true; }
+
+	private:
+		friend class CGMCaptureCallback;
+		/** @brief 每帧在绘制线程中调用，先收取完成的读取，再发出新的读取 */
+		void _Draw(osg::RenderInfo& renderInfo);
+		/**
+		* @brief 发出一次读取
+		* @param renderInfo: 绘制信息
+		* @param sRequest: 截图请求
+		* @param sSlot: 空闲的PBO
+		* @return bool 成功true，对象还没有创建返回false
+		*/
+		bool _Issue(osg::RenderInfo& renderInfo, const SGMCaptureRequest& sRequest, SGMCaptureSlot& sSlot);
+		/**
+		* @brief 栅栏已经完成时映射PBO，拷贝后交给后台线程
+		* @param pExt: OpenGL扩展
+		* @param sSlot: 正在读取的PBO
+		* @param iTimeout: 等待的时长，单位：纳秒，0表示只查询不等待
+		* @return bool 已经收取true，GPU还没有完成返回false
+		*/
+		bool _Collect(const osg::GLExtensions* pExt, SGMCaptureSlot& sSlot, const GLuint64 iTimeout = 0);
+		/**
+		* @brief 一直等到读取完成再收取
+		* @param pExt: OpenGL扩展
+		* @param sSlot: 正在读取的PBO
+		*/
+		void _WaitCollect(const osg::GLExtensions* pExt, SGMCaptureSlot& sSlot);
+		/** @brief 后台编码线程 */
+		void _WorkerLoop();
+
+		// 变量
+	private:
+		SGMConfigData*						m_pConfigData = nullptr;				//!< 配置数据
+
+		std::mutex							m_requestMutex;							//!< 保护请求队列和渲染目标
+		std::deque<SGMCaptureRequest>		m_requestQueue;							//!< 还没有发出读取的请求
+		std::map<std::string, osg::ref_ptr<osg::Texture2D>> m_targetMap;			//!< 可以截取的渲染目标
+		std::atomic<int>					m_iPending{ 0 };						//!< 还没有写完的截图数量
+		std::atomic<int>					m_iEncoding{ 0 };						//!< 已经读回还没有写完的截图数量
+		std::atomic<bool>					m_bFrameExact{ false };					//!< 逐帧模式
+		std::atomic<bool>					m_bFlush{ false };						//!< 下一次绘制后等待所有读取
+
+		std::vector<SGMCaptureSlot>			m_slotVec;								//!< PBO环形缓冲，只在绘制线程中使用
+		size_t								m_iNextSlot = 0;						//!< 下一个发出读取的PBO
+
+		std::vector<std::thread>			m_threadVec;							//!< 后台编码线程
+		std::mutex							m_mutex;								//!< 保护编码队列
+		std::condition_variable				m_condition;							//!< 有新图片时唤醒后台线程
+		std::atomic<bool>					m_bExit{ false };						//!< 后台线程退出标志
+		std::deque<SGMCaptureJob>			m_jobQueue;								//!< 等待编码的图片
+	};
+}	// GM
@@ -12,9 +12,13 @@
 #include "GMCharacter.h"
 #include "GMCommonUniform.h"
 #include "GMModel.h"
+#include "GMMusicAnalyzer.h"
 #include "GMKit.h"
+#include "GMVectorOps.h"
 #include "Animation/GMAnimation.h"
 #include <osg/MatrixTransform>
+#include <functional>
+#include <algorithm>
 
 using namespace GM;
 
@@ -36,6 +40,13 @@ Global Constants
 #define  ARM_FADE_TIME						(0.8f)		// 手部动画的淡入淡出时间，单位：秒
 #define  RUN_FADE_TIME						(0.333f)	// 跑步动画的淡入淡出时间，单位：秒
 
+#define  CHARACTER_INNER_STEP				(0.05)		// 角色间隔更新的时间，单位：秒
+#define  ARM_UP_ACCE_THRESHOLD				(0.05f)		// 让手部抬起的目标挥舞加速度阈值，单位：cm/s
+#define  DANCE_BURST_BARS					(2)			// 高潮乐段开头换成“跳舞1”的小节数
+#define  DANCE_BURST_GAP_BARS				(16)		// 两次“跳舞1”之间至少间隔的小节数
+#define  VISEME_OPEN_THRESHOLD				(0.15f)		// 张嘴程度超过这个值才重新播放“啊”“哦”口型
+#define  VISEME_WEIGHT_STEP					(0.01f)		// 口型权重变化小于这个值时不更新
+
 /*************************************************************************
 CGMCharacter Methods
 *************************************************************************/
@@ -81,29 +92,29 @@ bool CGMCharacter::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData,
 	m_pConfigData = pConfigData;
 	m_pModel = pModel;
 
-	m_danceSequenceVec.push_back(SGMDanceSequence(14, 16, EA_BONE_DANCE_1));
-	m_danceSequenceVec.push_back(SGMDanceSequence(39, 42, EA_BONE_DANCE_1));
-	m_danceSequenceVec.push_back(SGMDanceSequence(65, 67, EA_BONE_DANCE_1));
-	m_danceSequenceVec.push_back(SGMDanceSequence(84, 86, EA_BONE_DANCE_1));
+	_ScheduleDance();
 
 	return true;
 }
 
 bool CGMCharacter::Update(double dDeltaTime)
 {
+	// 动画命令只录制，由主线程在Apply中执行
+	SGMCharacterFrame& sFrame = m_frameBuffer[m_iBackFrame];
+	sFrame.Clear();
+	GM_ANIMATION.BeginRecord(&sFrame.animCommandVec);
+
 	// 程序开始的时候，角色必须忽视目标一段时间
 	m_fSyncTime += dDeltaTime;
 	// 刚鄙视完，气还没消，直接无视目标
 	m_bLookAtTarget = (m_fSyncTime > 3) && (!m_bDisdain || (m_fAngry < 0.5)) && (m_fInterest > 0.2);
 
-	static double s_fConstantStep = 0.05;
-	static double s_fDeltaStep = 0.0;
-	if (s_fDeltaStep > s_fConstantStep)
+	if (m_fInnerDeltaTime > CHARACTER_INNER_STEP)
 	{
-		_InnerUpdate(s_fDeltaStep);
-		s_fDeltaStep = 0.0;
+		_InnerUpdate(m_fInnerDeltaTime);
+		m_fInnerDeltaTime = 0.0;
 	}
-	s_fDeltaStep += dDeltaTime;
+	m_fInnerDeltaTime += dDeltaTime;
 
 	// 更新等待/走路/跑步动画权重
 	_UpdatePose(dDeltaTime);
@@ -113,6 +124,8 @@ bool CGMCharacter::Update(double dDeltaTime)
 	_UpdateLookAnimation(dDeltaTime);
 	// 更新手部动画权重
 	_UpdateArmAnimation(dDeltaTime);
+	// 口型跟随声音
+	_UpdateViseme(dDeltaTime);
 
 	// 每帧累加音乐播放时间
 	if(m_bMusicOn) m_fMusicTime += dDeltaTime;
@@ -126,9 +139,24 @@ bool CGMCharacter::Update(double dDeltaTime)
 	// 每帧都在减少害怕值
 	m_fScared = fmax(0.0f, m_fScared - 0.4f * dDeltaTime);
 
+	GM_ANIMATION.EndRecord();
 	return true;
 }
 
+void CGMCharacter::Apply()
+{
+	m_iBackFrame = 1 - m_iBackFrame;
+	SGMCharacterFrame& sFrame = m_frameBuffer[1 - m_iBackFrame];
+	GM_ANIMATION.Apply(sFrame.animCommandVec);
+	if (sFrame.bMoved)
+	{
+		SGMModelData sModelData = m_pModel->GetModelData(m_strName);
+		sModelData.vPos = OSG2GM(sFrame.vPos);
+		m_pModel->Edit(m_strName, sModelData);
+	}
+	sFrame.Clear();
+}
+
 bool CGMCharacter::UpdatePost(double dDeltaTime)
 {
 	// 必须在更新过骨骼之后再更新眼球
@@ -136,18 +164,26 @@ bool CGMCharacter::UpdatePost(double dDeltaTime)
 	return true;
 }
 
-bool CGMCharacter::CreateCharacter(const std::string& strName)
+bool CGMCharacter::CreateCharacter(const std::string& strName, const std::string& strAssetName, const osg::Vec3d& vPos)
 {
 	m_strName = strName;
+	// 同一个资源的其他角色，用名称区分随机种子，避免动作完全同步
+	if (!strAssetName.empty() && strAssetName != strName)
+		m_iRandom.seed(unsigned(std::hash<std::string>()(strName)));
 
 	SGMModelData sData = SGMModelData();
 	sData.strName = strName;
-	sData.strFilePath = strName + ".CIP";
+	sData.strFilePath = (strAssetName.empty() ? strName : strAssetName) + ".CIP";
 	sData.eMaterial = EGM_MATERIAL_Human;
+	sData.vPos = OSG2GM(vPos);
 	if (!(m_pModel->Add(sData))) return false;
 
+	m_vDestinationPos = vPos;
+	m_vLastDestiPos = vPos;
+
 	m_pModel->SetAnimationEnable(strName, true);
-	m_pModel->GetEyeTransform(m_pEyeTransVector);
+	m_pModel->GetEyeTransform(strName, m_pEyeTransVector);
+	m_mEyeTransVector.clear();
 	for (auto& itr : m_pEyeTransVector)
 	{
 		m_mEyeTransVector.push_back(itr->asMatrixTransform()->getMatrix());
@@ -162,6 +198,11 @@ void CGMCharacter::Welcome()
 {
 }
 
+void CGMCharacter::SetRandomSeed(const uint32_t iSeed)
+{
+	m_iRandom.seed(unsigned(iSeed ^ uint32_t(std::hash<std::string>()(m_strName))));
+}
+
 void CGMCharacter::SetMusicEnable(bool bEnable)
 {
 	if (m_bMusicOn == bEnable) return;
@@ -220,6 +261,18 @@ void CGMCharacter::SetMusicCurrentTime(int iTime)
 	m_vTargetLastWorldPos = m_vTargetWorldPos;
 }
 
+void CGMCharacter::SetMusicGrid(std::shared_ptr<const SGMMusicGrid> pGrid)
+{
+	if (m_pMusicGrid == pGrid) return;
+	m_pMusicGrid = pGrid;
+
+	float fBPM = m_pMusicGrid ? m_pMusicGrid->fBPM : 120.0f;
+	m_fMusicBeatTime = 60.0f / fBPM;
+	m_fMusicBarTime = m_fMusicBeatTime * MUSIC_BEATS_PER_BAR;
+	m_fMusicPhraseTime = m_fMusicBarTime * MUSIC_BARS_PER_PHRASE;
+	_ScheduleDance();
+}
+
 bool CGMCharacter::_InitAnimation(const std::string& strName)
 {
 	GM_ANIMATION.SetAnimationMode(strName, EGM_PLAY_LOOP, m_strBoneAnimNameVec.at(EA_BONE_IDLE));
@@ -324,35 +377,31 @@ void CGMCharacter::_InnerUpdate(const double dDeltaTime)
 
 void CGMCharacter::_InnerUpdateBlink(const double dDeltaTime)
 {
-	static double s_fBlinkTime = 0.0;
-	static double s_fDeltaBlinkTime = 2.0;
 	// “惊讶”和“半闭眼”时不眨眼
-	if (s_fBlinkTime > s_fDeltaBlinkTime)
+	if (m_fBlinkTime > m_fBlinkInterval)
 	{
 		GM_ANIMATION.SetAnimationWeight(m_strName, 1.0, m_strMorphAnimNameVec.at(EA_MORPH_BLINK));
 		GM_ANIMATION.SetAnimationPlay(m_strName, m_strMorphAnimNameVec.at(EA_MORPH_BLINK));
-		s_fBlinkTime = 0.0;
-		s_fDeltaBlinkTime = m_iPseudoNoise(m_iRandom) * 0.1 + 0.3;
+		m_fBlinkTime = 0.0;
+		m_fBlinkInterval = m_iPseudoNoise(m_iRandom) * 0.1 + 0.3;
 	}
-	s_fBlinkTime += dDeltaTime;
+	m_fBlinkTime += dDeltaTime;
 }
 
 void CGMCharacter::_InnerUpdateLip(const double dDeltaTime)
 {
 	// 等待时的默认口型
-	static double s_fMorphIdleTime = 0.0;
-	static double s_fDeltaMorphIdleTime = 2.0;
 	// “惊讶”和“半闭眼”时不会做其他口型
-	if (s_fMorphIdleTime > s_fDeltaMorphIdleTime && m_fAngry < 0.9)
+	if (m_fMorphIdleTime > m_fMorphIdleInterval && m_fAngry < 0.9)
 	{
 		double fMorphDuration = m_iPseudoNoise(m_iRandom) * 0.05 + 2;
-		if (m_bMusicOn) fMorphDuration *= 0.25;
+		if (m_bMusicOn) fMorphDuration *= 0.5 * m_fMusicBeatTime;
 		GM_ANIMATION.SetAnimationDuration(m_strName, fMorphDuration, m_strMorphAnimNameVec.at(EA_MORPH_IDLE));
 		GM_ANIMATION.SetAnimationWeight(m_strName, 1.0, m_strMorphAnimNameVec.at(EA_MORPH_IDLE));
 		GM_ANIMATION.SetAnimationPlay(m_strName, m_strMorphAnimNameVec.at(EA_MORPH_IDLE));
 
-		// 放音乐时会添加的口型
-		if (m_bMusicOn)
+		// 放音乐时会添加的口型，有实时分析的口型时由_UpdateViseme负责
+		if (m_bMusicOn && !m_bVisemeOn)
 		{
 			double fAAMix = m_iPseudoNoise(m_iRandom) * 0.01;
 			GM_ANIMATION.SetAnimationPlay(m_strName, m_strMorphAnimNameVec.at(EA_MORPH_AA));
@@ -360,12 +409,12 @@ void CGMCharacter::_InnerUpdateLip(const double dDeltaTime)
 			GM_ANIMATION.SetAnimationDuration(m_strName, fMorphDuration*(0.4+0.4*fAAMix), m_strMorphAnimNameVec.at(EA_MORPH_AA));
 		}
 
-		s_fMorphIdleTime = 0.0;
+		m_fMorphIdleTime = 0.0;
 		double fMouthCloseDuration = m_iPseudoNoise(m_iRandom) * 0.1;
 		if (m_bMusicOn) fMouthCloseDuration *= 0.1;
-		s_fDeltaMorphIdleTime = fMouthCloseDuration + fMorphDuration;
+		m_fMorphIdleInterval = fMouthCloseDuration + fMorphDuration;
 	}
-	s_fMorphIdleTime += dDeltaTime;
+	m_fMorphIdleTime += dDeltaTime;
 }
 
 void CGMCharacter::_ChangePose(const double dDeltaTime)
@@ -388,8 +437,8 @@ void CGMCharacter::_ChangeDance(const double dDeltaTime)
 	if (m_fHappy > 0.5f)
 	{
 		EGMANIMATION_BONE eDanceAnim = EA_BONE_IDLE;
-		// 计算当前的乐段编号
-		int iBarCount = int(m_fMusicTime / m_fMusicBarTime);
+		// 计算当前的小节编号，有节拍网格时从第一个强拍开始算
+		int iBarCount = m_pMusicGrid ? m_pMusicGrid->GetBarIndex(m_fMusicTime) : int(m_fMusicTime / m_fMusicBarTime);
 		if (m_iBarCount != iBarCount)
 		{
 			bool bChangeDance = false;
@@ -441,24 +490,61 @@ void CGMCharacter::_ChangeDance(const double dDeltaTime)
 	}
 }
 
-void CGMCharacter::_ChangeArm(const double dDeltaTime)
+void CGMCharacter::_ScheduleDance()
 {
-	static float s_fWaveSumTime = 0.0f;	// 目标挥舞的时间，单位：秒
-	static float s_fArmUpAcceThreshold = 0.05f;	// 让手部抬起的目标挥舞加速度阈值，单位：cm/s
+	m_danceSequenceVec.clear();
+	if (!m_pMusicGrid || m_pMusicGrid->phraseVec.empty())
+	{
+		// 没有节拍网格时，使用默认歌曲手工排好的顺序
+		m_danceSequenceVec.push_back(SGMDanceSequence(14, 16, EA_BONE_DANCE_1));
+		m_danceSequenceVec.push_back(SGMDanceSequence(39, 42, EA_BONE_DANCE_1));
+		m_danceSequenceVec.push_back(SGMDanceSequence(65, 67, EA_BONE_DANCE_1));
+		m_danceSequenceVec.push_back(SGMDanceSequence(84, 86, EA_BONE_DANCE_1));
+		return;
+	}
+
+	// 每个乐段的平均能量
+	const SGMMusicGrid& sGrid = *m_pMusicGrid;
+	const int iPhraseNum = int(sGrid.phraseVec.size());
+	std::vector<float> vPhraseEnergy(iPhraseNum);
+	for (int i = 0; i < iPhraseNum; i++)
+	{
+		float fEnd = (i + 1 < iPhraseNum) ? sGrid.phraseVec.at(i + 1) : (sGrid.phraseVec.at(i) + m_fMusicPhraseTime);
+		vPhraseEnergy[i] = sGrid.GetMeanEnergy(sGrid.phraseVec.at(i), fEnd);
+	}
+	std::vector<float> vSorted = vPhraseEnergy;
+	std::sort(vSorted.begin(), vSorted.end());
+	float fThreshold = vSorted.at(iPhraseNum * 3 / 4);
+
+	// 能量进入前25%的乐段，开头几个小节换成“跳舞1”，第一个乐段不换
+	int iLastBar = -DANCE_BURST_GAP_BARS;
+	for (int i = 1; i < iPhraseNum; i++)
+	{
+		if (vPhraseEnergy[i] < fThreshold || vPhraseEnergy[i] <= vPhraseEnergy[i - 1]) continue;
 
+		int iBar = sGrid.GetBarIndex(sGrid.phraseVec.at(i));
+		if (iBar - iLastBar < DANCE_BURST_GAP_BARS) continue;
+
+		m_danceSequenceVec.push_back(SGMDanceSequence(iBar, iBar + DANCE_BURST_BARS, EA_BONE_DANCE_1));
+		iLastBar = iBar;
+	}
+}
+
+void CGMCharacter::_ChangeArm(const double dDeltaTime)
+{
 	// 目标加速度大于某个阈值时，才会抬手，
-	if(m_fDeltaVelocity > s_fArmUpAcceThreshold)
-		s_fWaveSumTime += dDeltaTime;
+	if(m_fDeltaVelocity > ARM_UP_ACCE_THRESHOLD)
+		m_fWaveSumTime += dDeltaTime;
 	else
-		s_fWaveSumTime = 0.0f;
+		m_fWaveSumTime = 0.0f;
 	// 目标挥舞的时间大于1秒，才会抬手
-	bool bArmUp = s_fWaveSumTime > 1.0f;
+	bool bArmUp = m_fWaveSumTime > 1.0f;
 	if (bArmUp)
-		s_fWaveSumTime = 0.0f;
+		m_fWaveSumTime = 0.0f;
 
 
 	// 加速度越大，抬手越快
-	float fArmDuration = 6.0f / osg::clampTo((m_fDeltaVelocity - s_fArmUpAcceThreshold) * 0.2, 1.0, 2.0);
+	float fArmDuration = 6.0f / osg::clampTo((m_fDeltaVelocity - ARM_UP_ACCE_THRESHOLD) * 0.2, 1.0, 2.0);
 	// 抬手不能过于频繁，所以等一段时间后，下一个手臂动画才会开始
 	if (bArmUp && (m_fArmTimeL > m_fArmDurationL) && (m_fInterest > 0.5)
 		&& (m_animHeadL.fWeightNow > 0.05) && (m_animHeadL.fWeightTarget > 0.1))
@@ -578,21 +664,19 @@ void CGMCharacter::_ChangeLookAtTarget(const double dDeltaTime)
 
 void CGMCharacter::_ChangeLookAround(const double dDeltaTime)
 {
-	static double s_fLookAroundTime = 0.0;
-	if (s_fLookAroundTime > m_fTurnDuration) // 朝向固定的时候
+	if (m_fLookAroundTime > m_fTurnDuration) // 朝向固定的时候
 	{
-		static int s_i = 0;
-		if (s_i > 20)
+		if (m_iEyeSaccadeCount > 20)
 		{
 			_SetEyeFinalDir(
 				m_iRandomAngle(m_iRandom) / 36.0 - 5.0, // [-5, 5]
 				m_iRandomAngle(m_iRandom) / 24.0 - 7.5); // [-7.5, 7.5]
-			s_i = 0;
+			m_iEyeSaccadeCount = 0;
 		}
-		s_i++;
+		m_iEyeSaccadeCount++;
 	}
 
-	if (s_fLookAroundTime >= (m_fLookDuration + m_fTurnDuration)) // 开始改变朝向
+	if (m_fLookAroundTime >= (m_fLookDuration + m_fTurnDuration)) // 开始改变朝向
 	{
 		float fDeltaHeading = m_iRandomAngle(m_iRandom) / 3.0 - 60.0; // [-60, 60]
 		float fDeltaPitch = m_iRandomAngle(m_iRandom) / 12.0 - 15.0; // [-15, 15]
@@ -630,13 +714,13 @@ void CGMCharacter::_ChangeLookAround(const double dDeltaTime)
 		// 这里要保证传入的是最终的俯仰和偏航角
 		_ChangeTargetAnimation(fHeading, fPitch);
 
-		s_fLookAroundTime = 0.0;
+		m_fLookAroundTime = 0.0;
 		//重置混合时间，开始混合动画
 		m_fTurnMixTime = 0.0f;
 		m_fLookDuration = max(0, m_iPseudoNoise(m_iRandom) * 0.001 / max(0.05, 0.2*m_fInterest)) + 0.5;
 		m_fTurnDuration = ((m_iPseudoNoise(m_iRandom) * 0.00001 + 0.001) * fDeltaAngle + 0.03) / max(0.1, 0.15*m_fInterest);
 	}
-	s_fLookAroundTime += dDeltaTime;
+	m_fLookAroundTime += dDeltaTime;
 }
 
 void CGMCharacter::_ChangeTargetAnimation(const float fTargetHeading, const float fTargetPitch)
@@ -724,7 +808,7 @@ void CGMCharacter::_UpdatePose(const double dDeltaTime)
 		m_fIdleAddTime = 0.0;
 
 	// 更新主角的位置
-	double fTime = osg::Timer::instance()->time_s();
+	double fTime = m_fSyncTime;
 	if (fTime < (m_fStartMoveTime + m_fMoveDuration))
 	{
 		if (!GM_ANIMATION.IsAnimationPlaying(m_strName, m_strBoneAnimNameVec.at(EA_BONE_RUN_L)))
@@ -738,13 +822,13 @@ void CGMCharacter::_UpdatePose(const double dDeltaTime)
 
 		if (1.0f == fRunLeftWeight)
 		{
-			SGMModelData sModelData = m_pModel->GetModelData(m_strName);
 			double fTimeMix = osg::clampTo(
 				(fTimeSinceMoveStart - RUN_FADE_TIME) / (m_fMoveDuration - RUN_FADE_TIME * 2),
 				0.0f, 1.0f);
-			osg::Vec3d vPosNow = CGMKit::Mix(m_vLastDestiPos, m_vDestinationPos, fTimeMix);
-			sModelData.vPos = SGMVector3(vPosNow.x(), vPosNow.y(), vPosNow.z());
-			m_pModel->Edit(m_strName, sModelData);
+			// 模型节点由Apply修改
+			SGMCharacterFrame& sFrame = m_frameBuffer[m_iBackFrame];
+			sFrame.vPos = CGMKit::Mix(m_vLastDestiPos, m_vDestinationPos, fTimeMix);
+			sFrame.bMoved = true;
 		}
 	}
 }
@@ -789,6 +873,47 @@ void CGMCharacter::_UpdateLookAnimation(const double dDeltaTime)
 	}
 }
 
+void CGMCharacter::_UpdateViseme(const double dDeltaTime)
+{
+	const std::string& strAA = m_strMorphAnimNameVec.at(EA_MORPH_AA);
+	const std::string& strOO = m_strMorphAnimNameVec.at(EA_MORPH_OO);
+	// 没有分析结果，或者生气时，交还给_InnerUpdateLip
+	if (!m_bMusicOn || !m_sViseme.bValid || m_fAngry >= 0.9)
+	{
+		if (m_bVisemeOn)
+		{
+			GM_ANIMATION.SetAnimationWeight(m_strName, 0.0f, strAA);
+			GM_ANIMATION.SetAnimationWeight(m_strName, 0.0f, strOO);
+			m_fVisemeAA = 0.0f;
+			m_fVisemeOO = 0.0f;
+			m_bVisemeOn = false;
+		}
+		return;
+	}
+	m_bVisemeOn = true;
+
+	// “啊”“哦”是只播放一次的变形动画，张嘴时重新播放，权重跟随声音
+	if ((1.0f - m_sViseme.fClosed) > VISEME_OPEN_THRESHOLD && !GM_ANIMATION.IsAnimationPlaying(m_strName, strAA))
+	{
+		const float fDuration = fmin(0.4f, fmax(0.15f, 0.5f * m_fMusicBeatTime));
+		GM_ANIMATION.SetAnimationDuration(m_strName, fDuration, strAA);
+		GM_ANIMATION.SetAnimationDuration(m_strName, fDuration, strOO);
+		GM_ANIMATION.SetAnimationPlay(m_strName, strAA);
+		GM_ANIMATION.SetAnimationPlay(m_strName, strOO);
+	}
+
+	if (std::abs(m_sViseme.fAA - m_fVisemeAA) > VISEME_WEIGHT_STEP)
+	{
+		m_fVisemeAA = m_sViseme.fAA;
+		GM_ANIMATION.SetAnimationWeight(m_strName, m_fVisemeAA, strAA);
+	}
+	if (std::abs(m_sViseme.fOO - m_fVisemeOO) > VISEME_WEIGHT_STEP)
+	{
+		m_fVisemeOO = m_sViseme.fOO;
+		GM_ANIMATION.SetAnimationWeight(m_strName, m_fVisemeOO, strOO);
+	}
+}
+
 void CGMCharacter::_UpdateArmAnimation(const double dDeltaTime)
 {
 	if (!m_animArmR.bAnimOn && m_fArmTimeL <= m_fArmDurationL)
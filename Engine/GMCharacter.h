@@ -13,9 +13,12 @@
 
 #include "GMCommon.h"
 #include "GMKernel.h"
+#include "GMLipSync.h"
+#include "Animation/GMAnimation.h"
 
 #include <vector>
 #include <random>
+#include <memory>
 
 namespace GM
 {
@@ -136,10 +139,28 @@ namespace GM
 		EGMANIMATION_BONE eDance = EA_BONE_DANCE_1;
 	};
 
+	/*!
+	 *  @brief 一次模拟的输出，模拟线程写入后台的一份，主线程在更新遍历之前应用前台的一份
+	 */
+	struct SGMCharacterFrame
+	{
+		/** @brief 清空，保留命令的容量 */
+		inline void Clear()
+		{
+			animCommandVec.clear();
+			bMoved = false;
+		}
+
+		std::vector<SGMAnimationCommand> animCommandVec;		//!< 按调用顺序录制的动画命令
+		osg::Vec3d vPos = osg::Vec3d(0, 0, 0);					//!< 角色的新位置，单位：cm
+		bool bMoved = false;									//!< 本次模拟是否移动了角色
+	};
+
 	/*************************************************************************
 	 Class
 	*************************************************************************/
 	class CGMModel;
+	struct SGMMusicGrid;
 
 	/*!
 	 *  @class CGMCharacter，系统单位：厘米
@@ -156,17 +177,29 @@ namespace GM
 
 		/** @brief 初始化 */
 		bool Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData, CGMModel* pModel);
-		/** @brief 更新 */
+		/**
+		* @brief 更新角色逻辑，可以在模拟线程中调用
+		* 不直接修改动画和场景，结果写入后台的SGMCharacterFrame，由Apply生效
+		* 调用期间主线程不能执行更新遍历，也不能修改角色的状态
+		*/
 		bool Update(double dDeltaTime);
+		/** @brief 交换前后台，在主线程中、更新遍历之前应用最近一次Update的结果 */
+		void Apply();
 		/** @brief 更新(在主相机更新姿态之后) */
 		bool UpdatePost(double dDeltaTime);
 
 		/**
-		* @brief 创建角色的
+		* @brief 创建角色
+		* 同一个资源创建的多个角色共享网格与动画数据，只有姿态和状态是各自的
 		* @param strName: 角色在场景中的名称
+		* @param strAssetName: 角色资源名称，为空则与strName相同
+		* @param vPos: 角色的初始位置，单位：cm
 		* @return bool 成功OK，失败Fail，角色不存在则返回NotExist
 		*/
-		bool CreateCharacter(const std::string& strName);
+		bool CreateCharacter(const std::string& strName, const std::string& strAssetName = "",
+			const osg::Vec3d& vPos = osg::Vec3d(0, 0, 0));
+		/** @brief 角色在场景中的名称 */
+		inline const std::string& GetName() const { return m_strName; }
 
 		/**
 		* @brief 开启“欢迎效果”
@@ -192,7 +225,7 @@ namespace GM
 			{
 				m_vLastDestiPos = m_vDestinationPos;
 				m_vDestinationPos = vDestinationPos;
-				m_fStartMoveTime = osg::Timer::instance()->time_s();
+				m_fStartMoveTime = m_fSyncTime;
 			}
 		}
 
@@ -203,6 +236,11 @@ namespace GM
 		void SetMusicEnable(bool bEnable);
 		inline bool GetMusicEnable() const { return m_bMusicOn; }
 		/**
+		* @brief 设置随机种子，录制和回放时使用，同一个资源的角色仍然按名称区分
+		* @param iSeed: 随机种子
+		*/
+		void SetRandomSeed(const uint32_t iSeed);
+		/**
 		* @brief 设置音频的总时长，单位：ms
 		* @param iDuration: 音频的总时长
 		*/
@@ -212,6 +250,16 @@ namespace GM
 		* @param iTime: 音频的播放位置
 		*/
 		void SetMusicCurrentTime(int iTime);
+		/**
+		* @brief 设置当前音频的节拍网格，舞蹈动作按网格中的小节和能量安排
+		* @param pGrid: 离线分析得到的节拍网格，nullptr则使用默认的120BPM
+		*/
+		void SetMusicGrid(std::shared_ptr<const SGMMusicGrid> pGrid);
+		/**
+		* @brief 设置和正在听到的声音对齐的口型，每帧调用
+		* @param sViseme: 音频模块实时分析得到的口型
+		*/
+		inline void SetViseme(const SGMViseme& sViseme) { m_sViseme = sViseme; }
 
 	private:
 		/**
@@ -230,6 +278,8 @@ namespace GM
 		void _ChangePose(const double dDeltaTime);
 		/** @brief 改变舞蹈动作 */
 		void _ChangeDance(const double dDeltaTime);
+		/** @brief 根据节拍网格安排舞蹈动作的顺序 */
+		void _ScheduleDance();
 		/** @brief 改变手部状态 */
 		void _ChangeArm(const double dDeltaTime);
 		/** @brief 改变注视方向 */
@@ -249,6 +299,8 @@ namespace GM
 		void _UpdateLookAnimation(const double dDeltaTime);
 		/** @brief 每帧更新手部动画 */
 		void _UpdateArmAnimation(const double dDeltaTime);
+		/** @brief 每帧让口型跟随声音 */
+		void _UpdateViseme(const double dDeltaTime);
 
 		/** @brief 每帧更新转头动画的过渡状态 */
 		void _UpdateLookAt(const double dDeltaTime);
@@ -325,6 +377,15 @@ namespace GM
 		float m_fFastTurnDuration = 0.5f;						//!< 快速转头周期，单位：秒
 		float m_fTurnMixTime = 0.0f;							//!< 当前转头动画混合所经过的时间，单位：秒
 
+		double m_fInnerDeltaTime = 0.0;							//!< 距离上一次间隔更新的时间，单位：秒
+		double m_fBlinkTime = 0.0;								//!< 距离上一次眨眼的时间，单位：秒
+		double m_fBlinkInterval = 2.0;							//!< 下一次眨眼的间隔，单位：秒
+		double m_fMorphIdleTime = 0.0;							//!< 距离上一次口型idle动画的时间，单位：秒
+		double m_fMorphIdleInterval = 2.0;						//!< 下一次口型idle动画的间隔，单位：秒
+		double m_fLookAroundTime = 0.0;							//!< 四处张望时，当前朝向经过的时间，单位：秒
+		float m_fWaveSumTime = 0.0f;							//!< 目标挥舞的时间，单位：秒
+		int m_iEyeSaccadeCount = 0;								//!< 眼球随机转动的计数
+
 		float m_fTargetHeading = 0.0f;							//!< 眼睛偏航角，左正右负，单位：°
 		float m_fTargetPitch = 0.0f;							//!< 眼睛俯仰角，上正下负，单位：°
 
@@ -380,15 +441,23 @@ namespace GM
 		float m_fMusicPhraseTime = 8.0f;						//!< 音乐的乐段（4小节），单位：秒
 		float m_fMusicDuration = 1.0f;							//!< 音乐的总时长，单位：秒
 		int m_iBarCount = -1;									//!< 小节编号，从0开始，默认-1
+		std::shared_ptr<const SGMMusicGrid> m_pMusicGrid;		//!< 当前音频的节拍网格
+		SGMViseme m_sViseme;									//!< 音频模块分析得到的口型
+		float m_fVisemeAA = 0.0f;								//!< 已经设置给“啊”口型的权重
+		float m_fVisemeOO = 0.0f;								//!< 已经设置给“哦”口型的权重
+		bool m_bVisemeOn = false;								//!< 口型是否正在跟随声音
 
 		float m_fDeltaVelocity = 0;								//!< 目标点的速度差，单位：cm/s
 		osg::Vec3d m_vTargetWorldPos = osg::Vec3d(0,-30,0);		//!< 目标点的世界空间坐标，单位：cm
 		osg::Vec3d m_vTargetLastWorldPos = osg::Vec3d(0, -30, 0);//!< 目标点上一次指定的世界空间坐标，单位：cm
 		osg::Vec3d m_vTargetLastVelocity = osg::Vec3d(0, 0, 0);	//!< 目标点上一次的速度，单位：cm/s
 
-		float m_fStartMoveTime = 0.0f;							//!< 开始移动的时间，单位：秒
+		double m_fStartMoveTime = 0.0;							//!< 开始移动的时间（角色自身的时钟），单位：秒
 		float m_fMoveDuration = 2.0f;							//!< 移动的持续时间，单位：秒
 		osg::Vec3d m_vDestinationPos = osg::Vec3d(0, 0, 0);		//!< 终点坐标，单位：cm
 		osg::Vec3d m_vLastDestiPos = osg::Vec3d(0, 0, 0);		//!< 上一个终点坐标，单位：cm
+
+		SGMCharacterFrame m_frameBuffer[2];						//!< 模拟结果的双缓冲
+		int m_iBackFrame = 0;									//!< Update写入的那一份
 	};
 }	// GM
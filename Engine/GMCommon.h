@@ -53,6 +53,7 @@ namespace GM
 		EGMRENDER_QUALITY				eRenderQuality = EGMRENDER_NORMAL;		//!< 画质模式
 		float							fFovy = 20.0f;							//!< 相机的垂直FOV，单位：°
 		float							fVolume = 0.5f;							//!< 音量
+		int								iCrossfade = 0;							//!< 自动切歌时的交叉淡入淡出时长，单位：ms，0表示无缝衔接
 		int								iScreenWidth = 1920;					//!< 屏幕宽度，单位：像素
 		int								iScreenHeight = 1080;					//!< 屏幕高度，单位：像素
 		bool							bWallpaper = true;						//!< 是否变成“桌面壁纸”
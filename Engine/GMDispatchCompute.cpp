@@ -0,0 +1,299 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMDispatchCompute.cpp
+/// @brief		Galaxy-Music Engine - GMDispatchCompute
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2023.06.20
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMDispatchCompute.h"
+#include <osg/GLExtensions>
+#include <osg/BufferIndexBinding>
+#include <osg/buffered_value>
+#include <map>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+// 计算pass之间可能用到的所有屏障位，都屏障过的写入不再记录
+#define COMPUTE_ALL_READ_BITS	(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT \
+	| GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT)
+
+/*************************************************************************
+Structs
+*************************************************************************/
+
+typedef void (GL_APIENTRY * PFNGMDISPATCHCOMPUTEINDIRECT)(GLintptr indirect);
+
+/*!
+*  @struct SGMComputeContext
+*  @brief 每个图形上下文的计算状态，只在这个上下文的绘制线程中访问
+*/
+struct SGMComputeContext
+{
+	std::map<const void*, GLbitfield>	writeMap;							//!< 还没有完全屏障的写入，值是已经屏障过的位
+	PFNGMDISPATCHCOMPUTEINDIRECT		fnDispatchIndirect = nullptr;		//!< glDispatchComputeIndirect
+	bool								bLoaded = false;					//!< 是否已经查询过扩展函数
+};
+
+static osg::buffered_object<SGMComputeContext> s_contextBuffer;
+
+/*************************************************************************
+Class
+*************************************************************************/
+
+/*!
+*  @class CGMComputeCullCallback
+*  @brief 不执行的pass在剔除阶段跳过，不进入渲染箱，也就不会应用它的状态集
+*/
+class CGMComputeCullCallback : public osg::DrawableCullCallback
+{
+public:
+	virtual bool cull(osg::NodeVisitor*, osg::Drawable* drawable, osg::RenderInfo*) const
+	{
+		const CGMDispatchCompute* pCompute = static_cast<const CGMDispatchCompute*>(drawable);
+		return !pCompute->getDispatch();
+	}
+};
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+/** @brief 读取一种资源之前需要的屏障位 */
+static inline GLbitfield ReadBarrierBit(const EGMCOMPUTE_RESOURCE eType)
+{
+	switch (eType)
+	{
+	case EGMCOMPUTE_IMAGE:
+		return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+	case EGMCOMPUTE_TEXTURE:
+		return GL_TEXTURE_FETCH_BARRIER_BIT;
+	case EGMCOMPUTE_SSBO:
+		return GL_SHADER_STORAGE_BARRIER_BIT;
+	case EGMCOMPUTE_INDIRECT:
+		return GL_COMMAND_BARRIER_BIT;
+	default:
+		return 0;
+	}
+}
+
+/** @brief 资源的键：纹理用自身，缓冲用BufferObject，同一个缓冲作为SSBO写、作为间接参数读时是同一个键 */
+static inline const void* ResourceKey(const osg::Object* pObject)
+{
+	const osg::BufferData* pData = dynamic_cast<const osg::BufferData*>(pObject);
+	if (pData && pData->getBufferObject()) return pData->getBufferObject();
+	return pObject;
+}
+
+/** @brief 插入屏障，所有记录的写入都屏障过这些位 */
+static void InsertBarrier(const osg::GLExtensions* pExt, SGMComputeContext& sContext, const GLbitfield iBits)
+{
+	if (!iBits) return;
+	pExt->glMemoryBarrier(iBits);
+	for (auto itr = sContext.writeMap.begin(); itr != sContext.writeMap.end();)
+	{
+		itr->second |= iBits;
+		if (COMPUTE_ALL_READ_BITS == (itr->second & COMPUTE_ALL_READ_BITS))
+			itr = sContext.writeMap.erase(itr);
+		else
+			++itr;
+	}
+}
+
+/*************************************************************************
+CGMDispatchCompute Methods
+*************************************************************************/
+
+CGMDispatchCompute::CGMDispatchCompute(GLint numGroupsX, GLint numGroupsY, GLint numGroupsZ) :
+	Drawable(),
+	_numGroupsX(numGroupsX), _numGroupsY(numGroupsY), _numGroupsZ(numGroupsZ),
+	_indirectOffset(0), _bDispatch(false), _bDirty(false), _bOnce(true)
+{
+	setUseDisplayList(false);
+	setUseVertexBufferObjects(true);
+	setCullCallback(new CGMComputeCullCallback());
+}
+
+CGMDispatchCompute::CGMDispatchCompute(const CGMDispatchCompute& o, const osg::CopyOp& copyop) :
+	Drawable(o, copyop),
+	_numGroupsX(o._numGroupsX), _numGroupsY(o._numGroupsY), _numGroupsZ(o._numGroupsZ),
+	_resources(o._resources), _indirect(o._indirect), _indirectOffset(o._indirectOffset),
+	_bDispatch(o._bDispatch), _bDirty(o._bDirty), _bOnce(o._bOnce)
+{
+	setUseDisplayList(false);
+	setUseVertexBufferObjects(true);
+	setCullCallback(new CGMComputeCullCallback());
+}
+
+void CGMDispatchCompute::drawImplementation(osg::RenderInfo& renderInfo) const
+{
+	if (!_bDispatch) return;
+
+	osg::State& state = *renderInfo.getState();
+	const osg::GLExtensions* pExt = state.get<osg::GLExtensions>();
+	if (!_barrierBefore(state)) return;
+
+	if (_indirect.valid())
+	{
+		SGMComputeContext& sContext = s_contextBuffer[state.getContextID()];
+		osg::GLBufferObject* pGLBuffer = _indirect->getBufferObject()
+			? _indirect->getBufferObject()->getOrCreateGLBufferObject(state.getContextID()) : nullptr;
+		if (!pGLBuffer) return;
+		if (pGLBuffer->isDirty()) pGLBuffer->compileBuffer();
+
+		pExt->glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, pGLBuffer->getGLObjectID());
+		sContext.fnDispatchIndirect(GLintptr(pGLBuffer->getOffset(_indirect->getBufferIndex())) + _indirectOffset);
+		pExt->glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+	}
+	else
+	{
+		if (_numGroupsX <= 0 || _numGroupsY <= 0 || _numGroupsZ <= 0) return;
+		pExt->glDispatchCompute(_numGroupsX, _numGroupsY, _numGroupsZ);
+	}
+
+	_recordWrites(state);
+	if (_bOnce)
+	{
+		_bDispatch = false;//保证只执行一次
+		_bDirty = true;
+	}
+}
+
+void CGMDispatchCompute::addImage(const unsigned int unit, osg::Texture* pTex, const EGMCOMPUTE_ACCESS eAccess, const GLenum format,
+	const int level, const bool layered, const int layer, const GLbitfield iConsumer)
+{
+	if (!pTex) return;
+
+	osg::BindImageTexture::Access eBindAccess = osg::BindImageTexture::READ_WRITE;
+	if (EGMCOMPUTE_READ == eAccess) eBindAccess = osg::BindImageTexture::READ_ONLY;
+	else if (EGMCOMPUTE_WRITE == eAccess) eBindAccess = osg::BindImageTexture::WRITE_ONLY;
+	getOrCreateStateSet()->setAttributeAndModes(new osg::BindImageTexture(unit, pTex, eBindAccess, format, level, layered, layer));
+	_declare(pTex, EGMCOMPUTE_IMAGE, eAccess, iConsumer);
+}
+
+void CGMDispatchCompute::addTexture(const unsigned int unit, osg::Texture* pTex)
+{
+	if (!pTex) return;
+
+	getOrCreateStateSet()->setTextureAttributeAndModes(unit, pTex);
+	_declare(pTex, EGMCOMPUTE_TEXTURE, EGMCOMPUTE_READ, 0);
+}
+
+void CGMDispatchCompute::addStorageBuffer(const unsigned int binding, osg::BufferData* pData, const EGMCOMPUTE_ACCESS eAccess, const GLbitfield iConsumer)
+{
+	if (!pData) return;
+
+	if (!pData->getBufferObject()) pData->setBufferObject(new osg::VertexBufferObject());
+	getOrCreateStateSet()->setAttributeAndModes(
+		new osg::ShaderStorageBufferBinding(binding, pData, 0, pData->getTotalDataSize()));
+	_declare(pData, EGMCOMPUTE_SSBO, eAccess, iConsumer);
+}
+
+void CGMDispatchCompute::setIndirect(osg::BufferData* pData, const GLintptr iOffset)
+{
+	// 先去掉之前声明的参数缓冲
+	for (auto itr = _resources.begin(); itr != _resources.end(); ++itr)
+	{
+		if (EGMCOMPUTE_INDIRECT == itr->eType)
+		{
+			_resources.erase(itr);
+			break;
+		}
+	}
+
+	_indirect = pData;
+	_indirectOffset = iOffset;
+	if (pData)
+	{
+		// 参数缓冲也会作为SSBO被写入，要在绘制前上传到GPU
+		if (!pData->getBufferObject()) pData->setBufferObject(new osg::VertexBufferObject());
+		_declare(pData, EGMCOMPUTE_INDIRECT, EGMCOMPUTE_READ, 0);
+	}
+}
+
+void CGMDispatchCompute::_declare(osg::Object* pObject, const EGMCOMPUTE_RESOURCE eType, const EGMCOMPUTE_ACCESS eAccess, const GLbitfield iConsumer)
+{
+	for (auto& itr : _resources)
+	{
+		if (itr.pObject.get() == pObject && itr.eType == eType)
+		{
+			itr.eAccess = EGMCOMPUTE_ACCESS(itr.eAccess | eAccess);
+			itr.iConsumer |= iConsumer;
+			return;
+		}
+	}
+
+	SGMComputeResource sResource;
+	sResource.pObject = pObject;
+	sResource.eType = eType;
+	sResource.eAccess = eAccess;
+	sResource.iConsumer = iConsumer;
+	_resources.push_back(sResource);
+}
+
+bool CGMDispatchCompute::_barrierBefore(osg::State& state) const
+{
+	const osg::GLExtensions* pExt = state.get<osg::GLExtensions>();
+	SGMComputeContext& sContext = s_contextBuffer[state.getContextID()];
+	if (!sContext.bLoaded)
+	{
+		osg::setGLExtensionFuncPtr(sContext.fnDispatchIndirect, "glDispatchComputeIndirect");
+		sContext.bLoaded = true;
+	}
+	if (_indirect.valid() && !sContext.fnDispatchIndirect) return false;
+	if (sContext.writeMap.empty()) return true;
+
+	// 读之前要屏障前面的写入，写之前也要，否则两次写入的顺序不确定
+	GLbitfield iBits = 0;
+	for (auto& itr : _resources)
+	{
+		auto itrWrite = sContext.writeMap.find(ResourceKey(itr.pObject.get()));
+		if (sContext.writeMap.end() == itrWrite) continue;
+		const GLbitfield iNeed = ReadBarrierBit(itr.eType);
+		if (!(itrWrite->second & iNeed)) iBits |= iNeed;
+	}
+	InsertBarrier(pExt, sContext, iBits);
+	return true;
+}
+
+void CGMDispatchCompute::_recordWrites(osg::State& state) const
+{
+	SGMComputeContext& sContext = s_contextBuffer[state.getContextID()];
+	GLbitfield iConsumer = 0;
+	for (auto& itr : _resources)
+	{
+		if (!(itr.eAccess & EGMCOMPUTE_WRITE)) continue;
+		sContext.writeMap[ResourceKey(itr.pObject.get())] = 0;
+		iConsumer |= itr.iConsumer;
+	}
+	// 计算pass之外的使用者不知道这里的写入，只能在dispatch之后立即屏障
+	InsertBarrier(state.get<osg::GLExtensions>(), sContext, iConsumer);
+}
+
+/*************************************************************************
+CGMComputeGraph Methods
+*************************************************************************/
+
+CGMComputeGraph::CGMComputeGraph(const int iBinBase) : osg::Geode(), _binBase(iBinBase)
+{
+	// 计算pass没有包围盒
+	setCullingActive(false);
+}
+
+bool CGMComputeGraph::addPass(CGMDispatchCompute* pPass)
+{
+	if (!pPass) return false;
+
+	const int iOrder = _binBase + int(getNumDrawables());
+	pPass->setCullingActive(false);
+	pPass->getOrCreateStateSet()->setRenderBinDetails(iOrder, "RenderBin");
+	return addDrawable(pPass);
+}
@@ -12,9 +12,33 @@
 #pragma once
 
 #include <osg/Drawable>
+#include <osg/Geode>
 #include <osg/Image>
 #include <osg/Camera>
-#include <osgDB/WriteFile>
+#include <osg/Texture>
+#include <osg/BufferObject>
+#include <osg/BindImageTexture>
+#include <vector>
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#ifndef GL_DISPATCH_INDIRECT_BUFFER
+#define GL_DISPATCH_INDIRECT_BUFFER				0x90EE
+#endif
+#ifndef GL_TEXTURE_FETCH_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT			0x00000008
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT		0x00000020
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT					0x00000040
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT			0x00002000
+#endif
 
 namespace GM
 {
@@ -22,72 +46,59 @@ namespace GM
 	Enums
 	*************************************************************************/
 
+	// 计算pass对资源的访问方式
+	enum EGMCOMPUTE_ACCESS
+	{
+		EGMCOMPUTE_READ = 1,				// 只读
+		EGMCOMPUTE_WRITE = 2,				// 只写
+		EGMCOMPUTE_READ_WRITE = 3			// 读写
+	};
+
+	// 计算pass使用的资源类型，决定读之前需要的内存屏障
+	enum EGMCOMPUTE_RESOURCE
+	{
+		EGMCOMPUTE_IMAGE,					// 图像单元，imageLoad/imageStore
+		EGMCOMPUTE_TEXTURE,					// 纹理采样
+		EGMCOMPUTE_SSBO,					// 着色器存储缓冲
+		EGMCOMPUTE_INDIRECT					// 间接dispatch的参数缓冲
+	};
+
 	/*************************************************************************
 	Structs
 	*************************************************************************/
 
+	/*!
+	*  @struct SGMComputeResource
+	*  @brief 计算pass声明的一个资源
+	*/
+	struct SGMComputeResource
+	{
+		osg::ref_ptr<osg::Object>		pObject;								//!< 纹理或者缓冲对象，也是追踪写入的键
+		EGMCOMPUTE_RESOURCE				eType = EGMCOMPUTE_IMAGE;				//!< 资源类型
+		EGMCOMPUTE_ACCESS				eAccess = EGMCOMPUTE_READ;				//!< 访问方式
+		GLbitfield						iConsumer = 0;							//!< 写入后计算pass之外的使用方式，例如GL_TEXTURE_FETCH_BARRIER_BIT
+	};
+
 	/*************************************************************************
 	Class
 	*************************************************************************/
 
-	/** Wrapper around glDispatchCompute.*/
+	/*!
+	*  @class CGMDispatchCompute
+	*  @brief 一个计算pass：glDispatchCompute或者glDispatchComputeIndirect
+	*  @brief 声明读写的图像、纹理和SSBO，同一个上下文中所有pass共享写入记录，
+	*  @brief 只有读到还没有屏障过的写入时才插入glMemoryBarrier，位只包含实际的读取方式
+	*  @brief 不执行时在剔除阶段就跳过，不会切换程序和绑定
+	*/
 	class CGMDispatchCompute : public osg::Drawable
 	{
 	public:
-		CGMDispatchCompute(GLint numGroupsX = 0, GLint numGroupsY = 0, GLint numGroupsZ = 0) :
-			Drawable(),
-			_numGroupsX(numGroupsX), _numGroupsY(numGroupsY), _numGroupsZ(numGroupsZ),
-			_bDispatch(false), _bDirty(false), _bOnce(true)
-		{
-			setUseDisplayList(false);
-			setUseVertexBufferObjects(true);
-		}
+		CGMDispatchCompute(GLint numGroupsX = 0, GLint numGroupsY = 0, GLint numGroupsZ = 0);
+		CGMDispatchCompute(const CGMDispatchCompute& o, const osg::CopyOp& copyop = osg::CopyOp::SHALLOW_COPY);
 
-		CGMDispatchCompute(const CGMDispatchCompute&o, const osg::CopyOp& copyop) :
-			Drawable(o, copyop),
-			_numGroupsX(o._numGroupsX), _numGroupsY(o._numGroupsY), _numGroupsZ(o._numGroupsZ),
-			_bDispatch(o._bDispatch),  _bDirty(o._bDirty), _bOnce(o._bOnce)
-		{
-			setUseDisplayList(false);
-			setUseVertexBufferObjects(true);
-		}
+		META_Node(GM, CGMDispatchCompute);
 
-		virtual void drawImplementation(osg::RenderInfo& renderInfo) const
-		{
-			if (_bDispatch)
-			{
-				for (auto iter : _textures)
-				{
-					osg::Texture* tex = dynamic_cast<osg::Texture*>(iter.second);
-					if (tex != NULL)
-					{
-						tex->dirtyTextureParameters();
-					}
-					renderInfo.getState()->applyTextureAttribute(iter.first, iter.second);
-				}
-
-				for (auto iter : _images)
-				{
-					osg::Texture* tex = dynamic_cast<osg::Texture*>(iter.second);
-					if (tex == NULL)
-					{
-						continue;
-					}
-					osg::Image* img = tex->getImage(0);
-					if (img != NULL)
-					{
-						img->dirty();
-					}
-				}
-
-				renderInfo.getState()->get<osg::GLExtensions>()->glDispatchCompute(_numGroupsX, _numGroupsY, _numGroupsZ);
-				if (_bOnce)
-				{
-					_bDispatch = false;//保证只执行一次
-					_bDirty = true;
-				}
-			}
-		}
+		virtual void drawImplementation(osg::RenderInfo& renderInfo) const;
 
 		/** Set compute shader work groups */
 		inline void setComputeGroups(const GLint numGroupsX, const GLint numGroupsY, const GLint numGroupsZ)
@@ -109,6 +120,10 @@ namespace GM
 		{
 			_bDispatch = bEnabled;
 		}
+		inline bool getDispatch() const
+		{
+			return _bDispatch;
+		}
 
 		inline void setDirty(bool bDirty)
 		{
@@ -124,56 +139,83 @@ namespace GM
 			_bOnce = bOnce;
 		}
 
-		inline std::map<int, osg::StateAttribute*>& GetTextureMap() { return _textures; }
-		inline std::map<int, osg::StateAttribute*>& GetImageMap() { return _images; }
+		/**
+		* @brief 绑定图像单元并声明访问方式
+		* @param unit: 图像单元
+		* @param pTex: 纹理
+		* @param eAccess: 访问方式
+		* @param format: 图像格式，0表示使用纹理的内部格式
+		* @param level, layered, layer: 同glBindImageTexture
+		* @param iConsumer: 写入后在计算pass之外的使用方式，0表示只给后面的计算pass使用
+		*/
+		void addImage(const unsigned int unit, osg::Texture* pTex, const EGMCOMPUTE_ACCESS eAccess, const GLenum format = 0,
+			const int level = 0, const bool layered = false, const int layer = 0, const GLbitfield iConsumer = 0);
+		/**
+		* @brief 绑定只读的采样纹理
+		* @param unit: 纹理单元
+		* @param pTex: 纹理
+		*/
+		void addTexture(const unsigned int unit, osg::Texture* pTex);
+		/**
+		* @brief 绑定着色器存储缓冲并声明访问方式
+		* @param binding: 绑定点，对应glsl中的binding
+		* @param pData: 缓冲数据，它的BufferObject是追踪写入的键
+		* @param eAccess: 访问方式
+		* @param iConsumer: 写入后在计算pass之外的使用方式，例如GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+		*/
+		void addStorageBuffer(const unsigned int binding, osg::BufferData* pData, const EGMCOMPUTE_ACCESS eAccess, const GLbitfield iConsumer = 0);
+		/**
+		* @brief 使用glDispatchComputeIndirect，组数从缓冲中读取，可以由前面的pass在GPU上写入
+		* @param pData: 存放3个GLuint的缓冲数据，nullptr表示恢复直接dispatch
+		* @param iOffset: 参数在缓冲中的字节偏移
+		*/
+		void setIndirect(osg::BufferData* pData, const GLintptr iOffset = 0);
+
+		/** @brief 获取声明的资源 */
+		inline const std::vector<SGMComputeResource>& getResources() const { return _resources; }
+
+	protected:
+		virtual ~CGMDispatchCompute() {}
+
+		/** @brief 声明资源，同一个对象重复声明时合并访问方式 */
+		void _declare(osg::Object* pObject, const EGMCOMPUTE_RESOURCE eType, const EGMCOMPUTE_ACCESS eAccess, const GLbitfield iConsumer);
+		/** @brief 按读写记录插入屏障，返回false表示不能执行 */
+		bool _barrierBefore(osg::State& state) const;
+		/** @brief 记录本次的写入，有外部使用方式时立即插入屏障 */
+		void _recordWrites(osg::State& state) const;
 
 	protected:
 		GLint _numGroupsX, _numGroupsY, _numGroupsZ;
 
-		std::map<int, osg::StateAttribute*> _textures;
-		std::map<int, osg::StateAttribute*> _images;
+		std::vector<SGMComputeResource> _resources;
+		osg::ref_ptr<osg::BufferData> _indirect;
+		GLintptr _indirectOffset;
 		mutable bool _bDispatch;
 		mutable bool _bDirty;
 		bool _bOnce;// 只计算一次
 	};
 
-	class CReadPixelFinishCallback : public osg::Camera::DrawCallback
+	/*!
+	*  @class CGMComputeGraph
+	*  @brief 按添加顺序执行的一组计算pass
+	*  @brief 渲染箱默认按状态排序，会打乱pass之间的依赖，这里给每个pass分配递增的渲染箱序号
+	*/
+	class CGMComputeGraph : public osg::Geode
 	{
 	public:
-		CReadPixelFinishCallback(osg::Image* pImg)
-			:_pImage(pImg), _bWritten(false), _bReady(false), _path("")
-		{}
-
-		virtual void operator() (osg::RenderInfo& renderInfo) const
-		{
-			if (_bReady && !_bWritten)
-			{
-				osgDB::writeImageFile(*(_pImage.get()), _path);
-				_bWritten = true;
-			}
-		}
-
-		void SetWritten(bool bWritten)
-		{
-			_bWritten = bWritten;
-		}
-		bool GetWritten()
-		{
-			return _bWritten;
-		}
-		void SetReady(bool bReady)
-		{
-			_bReady = bReady;
-		}
-		void SetPath(const std::string &path)
-		{
-			_path = path;
-		}
+		/**
+		* @param iBinBase: 第一个pass的渲染箱序号，之后依次加1
+		*/
+		CGMComputeGraph(const int iBinBase = 0);
+
+		/**
+		* @brief 在最后添加一个pass
+		* @param pPass: 计算pass
+		* @return bool 成功true
+		*/
+		bool addPass(CGMDispatchCompute* pPass);
 
 	private:
-		mutable bool					_bWritten;				// 贴图已经写入磁盘
-		bool							_bReady;				// 贴图已经准备好，可以写入磁盘
-		osg::ref_ptr<osg::Image>		_pImage;
-		std::string						_path;
+		int _binBase;
 	};
-}	// GM
\ No newline at end of file
+}	// GM
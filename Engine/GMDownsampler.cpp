@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMDownsampler.cpp
+/// @brief		Galaxy-Music Engine - GMDownsampler
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMDownsampler.h"
+#include "GMKit.h"
+#include <osg/Texture2D>
+#include <osg/TextureCubeMap>
+#include <osg/Viewport>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define DOWNSAMPLE_TILE				64			// 每个工作组处理的第0层区块边长，单位：像素
+#define DOWNSAMPLE_MAX_SIZE			4096		// 第0层的最大边长，第6层不超过一个区块时最后一个工作组才能处理完
+
+/*************************************************************************
+CGMDownsampler Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMDownsampler::CGMDownsampler()
+{
+}
+
+/** @brief 析构 */
+CGMDownsampler::~CGMDownsampler()
+{
+	if (m_pCamera.valid())
+	{
+		// 相机可能还在场景中，从所有父节点上摘下
+		while (m_pCamera->getNumParents() > 0)
+		{
+			m_pCamera->getParent(0)->removeChild(m_pCamera.get());
+		}
+	}
+}
+
+/** @brief 初始化 */
+bool CGMDownsampler::Init(osg::Texture* pTex, const std::string& strShaderPath,
+	const osg::Camera::RenderOrder eOrder, const int iOrderNum)
+{
+	if (!pTex || m_pTexture.valid()) return false;
+
+	m_bCube = (nullptr != dynamic_cast<osg::TextureCubeMap*>(pTex));
+	if (!m_bCube && !dynamic_cast<osg::Texture2D*>(pTex)) return false;
+	const GLint iFormat = pTex->getInternalFormat();
+	if (GL_RGBA8 != iFormat && GL_RGBA16F_ARB != iFormat) return false;
+
+	m_pTexture = pTex;
+	m_eImageFormat = iFormat;
+	m_strShaderPath = strShaderPath;
+	// 第0层以外的内容全部由计算着色器写入，不能让驱动再生成
+	m_pTexture->setUseHardwareMipMapGeneration(false);
+
+	m_pCamera = new osg::Camera;
+	m_pCamera->setName("DownsampleCamera");
+	m_pCamera->setRenderOrder(eOrder, iOrderNum);
+	m_pCamera->setClearMask(0);
+	m_pCamera->setReferenceFrame(osg::Camera::ABSOLUTE_RF);
+	m_pCamera->setAllowEventFocus(false);
+	m_pCamera->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR);
+	m_pCamera->setCullingActive(false);
+
+	m_pGraph = new CGMComputeGraph();
+	m_pCamera->addChild(m_pGraph.get());
+
+	// 6个切片的计数器，最后完成的工作组清零，每次dispatch都从0开始
+	m_pCounter = new osg::UIntArray(6);
+	for (auto& itr : *m_pCounter) itr = 0;
+
+	Resize(pTex->getTextureWidth(), pTex->getTextureHeight());
+	return true;
+}
+
+/** @brief 纹理尺寸修改后调用 */
+void CGMDownsampler::Resize(const int iWidth, const int iHeight)
+{
+	if (!m_pTexture.valid() || iWidth <= 0 || iHeight <= 0) return;
+	if (iWidth == m_iWidth && iHeight == m_iHeight && m_pPass.valid()) return;
+
+	m_iWidth = iWidth;
+	m_iHeight = iHeight;
+	if (m_bCube)
+		static_cast<osg::TextureCubeMap*>(m_pTexture.get())->setTextureSize(iWidth, iHeight);
+	else
+		static_cast<osg::Texture2D*>(m_pTexture.get())->setTextureSize(iWidth, iHeight);
+
+	// 完整的层数，受图像单元数量限制
+	int iMaxSize = (iWidth > iHeight) ? iWidth : iHeight;
+	int iLevelNum = 1;
+	while ((iMaxSize >> iLevelNum) > 0) iLevelNum++;
+	m_iLevelNum = (iLevelNum < GM_DOWNSAMPLE_MAX_LEVEL + 1) ? iLevelNum : (GM_DOWNSAMPLE_MAX_LEVEL + 1);
+	// 用glTexStorage分配不可变的存储，图像单元才能绑定到每一层
+	m_pTexture->setNumMipmapLevels(m_iLevelNum);
+	m_pTexture->dirtyTextureObject();
+
+	m_pCamera->setViewport(0, 0, iWidth, iHeight);
+	_CreatePass();
+}
+
+/** @brief 开关 */
+void CGMDownsampler::SetEnable(const bool bEnable)
+{
+	m_bEnable = bEnable;
+	if (m_pPass.valid()) m_pPass->setDispatch(bEnable);
+}
+
+void CGMDownsampler::_CreatePass()
+{
+	if (m_pPass.valid())
+	{
+		m_pGraph->removeDrawable(m_pPass.get());
+		m_pPass = nullptr;
+	}
+	if (m_iLevelNum < 2 || m_iWidth > DOWNSAMPLE_MAX_SIZE || m_iHeight > DOWNSAMPLE_MAX_SIZE) return;
+
+	const int iGroupX = (m_iWidth + DOWNSAMPLE_TILE - 1) / DOWNSAMPLE_TILE;
+	const int iGroupY = (m_iHeight + DOWNSAMPLE_TILE - 1) / DOWNSAMPLE_TILE;
+	m_pPass = new CGMDispatchCompute(iGroupX, iGroupY, m_bCube ? 6 : 1);
+	m_pPass->setOnce(false);
+	m_pPass->setDispatch(m_bEnable);
+	m_pPass->setDataVariance(osg::Object::DYNAMIC);
+
+	// 第0层只读，其余层写入后由片元着色器采样
+	const int iOutput = m_iLevelNum - 1;
+	m_pPass->addImage(0, m_pTexture.get(), EGMCOMPUTE_READ, m_eImageFormat, 0, m_bCube, 0);
+	for (int i = 1; i <= iOutput; i++)
+	{
+		// 第6层由其他工作组写入、最后一个工作组读取
+		const EGMCOMPUTE_ACCESS eAccess = (6 == i && iOutput > 6) ? EGMCOMPUTE_READ_WRITE : EGMCOMPUTE_WRITE;
+		m_pPass->addImage(i, m_pTexture.get(), eAccess, m_eImageFormat, i, m_bCube, 0, GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+	m_pPass->addStorageBuffer(0, m_pCounter.get(), EGMCOMPUTE_READ_WRITE);
+
+	osg::StateSet* pStateSet = m_pPass->getOrCreateStateSet();
+	pStateSet->addUniform(new osg::Uniform("mipCount", iOutput));
+	pStateSet->addUniform(new osg::Uniform("groupNum", iGroupX * iGroupY));
+	if (m_bCube) pStateSet->setDefine("MIP_CUBE");
+	if (GL_RGBA16F_ARB == m_eImageFormat) pStateSet->setDefine("MIP_RGBA16F");
+	CGMKit::LoadComputeShader(pStateSet, m_strShaderPath + "Downsample.comp");
+
+	m_pGraph->addPass(m_pPass.get());
+}
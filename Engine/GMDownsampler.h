@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMDownsampler.h
+/// @brief		Galaxy-Music Engine - GMDownsampler
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMDispatchCompute.h"
+#include <osg/Camera>
+#include <osg/Array>
+#include <string>
+
+namespace GM
+{
+	/*************************************************************************
+	 Macro Defines
+	*************************************************************************/
+	#define GM_DOWNSAMPLE_MAX_LEVEL			7		// 一次dispatch最多生成的层数，第0层和7层输出正好占满8个图像单元
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMDownsampler
+	*  @brief 单次dispatch生成整条mipmap链，参考AMD的SPD：
+	*  @brief 每个工作组在共享内存中把第0层的64x64区块逐级缩小到第6层，
+	*  @brief 每个切片最后完成的工作组（用原子计数器判断）再把第6层缩小到第7层
+	*  @brief 支持Texture2D和TextureCubeMap（6个面在同一次dispatch中），内部格式为GL_RGBA8或者GL_RGBA16F
+	*  @brief 计算pass放在一个只做计算的相机中，用相机的渲染次序放到写入纹理的相机之后、使用者之前
+	*/
+	class CGMDownsampler
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMDownsampler();
+		/** @brief 析构 */
+		~CGMDownsampler();
+
+		/**
+		* @brief 初始化，为纹理分配完整的mipmap
+		* @param pTex: 需要生成mipmap的纹理，尺寸要先设置好，只使用第0层，边长不超过4096
+		* @param strShaderPath: 着色器目录，其中有Downsample.comp
+		* @param eOrder: 相机的渲染次序，PRE_RENDER或者POST_RENDER
+		* @param iOrderNum: 同一次序中的序号
+		* @return bool 成功true，纹理类型或者格式不支持返回false
+		*/
+		bool Init(osg::Texture* pTex, const std::string& strShaderPath,
+			const osg::Camera::RenderOrder eOrder, const int iOrderNum);
+		/**
+		* @brief 纹理尺寸修改后调用，重新分配mipmap并重建计算pass
+		* @param iWidth, iHeight: 第0层的新尺寸
+		*/
+		void Resize(const int iWidth, const int iHeight);
+		/** @brief 开关，关闭时计算pass在剔除阶段就跳过 */
+		void SetEnable(const bool bEnable);
+		/** @brief 只做计算的相机，由使用者添加到场景中 */
+		inline osg::Camera* GetCamera() const { return m_pCamera.get(); }
+		/** @brief 生成后纹理的总层数，包括第0层 */
+		inline int GetLevelNum() const { return m_iLevelNum; }
+
+	private:
+		/** @brief 按当前尺寸创建计算pass */
+		void _CreatePass();
+
+		// 变量
+	private:
+		osg::ref_ptr<osg::Texture>				m_pTexture;						//!< 需要生成mipmap的纹理
+		osg::ref_ptr<osg::Camera>				m_pCamera;						//!< 只做计算的相机
+		osg::ref_ptr<CGMComputeGraph>			m_pGraph;						//!< 计算节点
+		osg::ref_ptr<CGMDispatchCompute>		m_pPass;						//!< 唯一的计算pass
+		osg::ref_ptr<osg::UIntArray>			m_pCounter;						//!< 每个切片完成的工作组数量，最后一个工作组清零
+		std::string								m_strShaderPath;				//!< 着色器目录
+		GLenum									m_eImageFormat = GL_RGBA8;		//!< 图像单元的格式
+		int										m_iWidth = 0;					//!< 第0层宽度
+		int										m_iHeight = 0;					//!< 第0层高度
+		int										m_iLevelNum = 1;				//!< 总层数，包括第0层
+		bool									m_bCube = false;				//!< 是否是cubemap
+		bool									m_bEnable = true;				//!< 开关
+	};
+}	// GM
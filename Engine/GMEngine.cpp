@@ -21,12 +21,24 @@
 #include "GMCharacter.h"
 #include "GMLight.h"
 #include "GMAudio.h"
+#include "GMMusicAnalyzer.h"
+#include "GMMediaLibrary.h"
+#include "GMScene.h"
+#include "GMCapture.h"
+#include "GMVectorOps.h"
+#include "GMThreadPool.h"
+#include "GMSimulation.h"
+#include "GMScheduler.h"
+#include "GMPassCache.h"
 #include "Animation/GMAnimation.h"
 #include "osgQt/GraphicsWindowQt.h"
 #include <osgViewer/ViewerEventHandlers>
 #include <QtCore/QTimer>
 
 #include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
 
 using namespace GM;
 
@@ -34,10 +46,19 @@ using namespace GM;
 Global Constants
 *************************************************************************/
 static const std::string g_strGMConfigFile = "Everlasting.cfg";	//!< 配置文件名
+static const std::string g_strGMSceneFile = "Everlasting.scene";	//!< 场景文件名
 
 /*************************************************************************
  Macro Defines
 *************************************************************************/
+#define BENCH_WARMUP_FRAMES			60			// 性能测试每个阶段的预热帧数
+#define BENCH_MEASURE_FRAMES		600			// 性能测试每个阶段的统计帧数
+#define BENCH_GPU_STATS_DELAY		3			// GPU计时结果滞后的帧数
+#define CROWD_SPACING				80.0		// 群演之间的间距，单位：cm
+#define CROWD_ROW_NUM				10			// 群演每排的人数
+#define REPLAY_GRID_TIMEOUT			30.0		// 回放时等待节拍网格的最长时间，单位：秒
+#define EXPORT_OPEN_TIMEOUT			10.0		// 导出时等待音频打开的最长时间，单位：秒
+#define ENGINE_INNER_STEP			0.1			// 间隔更新的时间，单位：秒
 
 /*************************************************************************
  CGMEngine Methods
@@ -75,7 +96,6 @@ CGMEngine& CGMEngine::getSingleton(void)
 /** @brief 构造 */
 CGMEngine::CGMEngine()
 {
-	Init();
 }
 
 /** @brief 析构 */
@@ -85,7 +105,7 @@ CGMEngine::~CGMEngine()
 }
 
 /** @brief 初始化 */
-bool CGMEngine::Init()
+bool CGMEngine::Init(const EGMAUDIO_BACKEND eAudioBackend)
 {
 	if (m_bInit) return true;
 
@@ -94,10 +114,20 @@ bool CGMEngine::Init()
 
 	//!< 内核数据
 	m_pKernelData = new SGMKernelData();
+	m_pRecorder = new CGMRecorder();
+	// 各模块的间隔更新都注册在调度器中，由Update统一推进
+	m_pScheduler = new CGMScheduler();
+	m_pKernelData->pScheduler = m_pScheduler;
+	m_pScheduler->AddPeriodic(ENGINE_INNER_STEP, [this](double fElapsed) {
+		if (m_bRendering) _InnerUpdate(fElapsed);
+	});
 
 	GM_Root = new osg::Group();
 	GM_View = new osgViewer::View();
 	GM_View->setSceneData(GM_Root);
+	// 背景、前景和阴影相机创建时注册到这里
+	m_pPassCache = new CGMPassCache();
+	m_pKernelData->pPassCache = m_pPassCache;
 
 	GM_LIGHT.Init(m_pKernelData, m_pConfigData);
 
@@ -119,18 +149,30 @@ bool CGMEngine::Init()
 	// 初始化前景相关节点
 	_InitForeground();
 
+	m_pCapture = new CGMCapture();
+	m_pCapture->Init(m_pConfigData);
+	m_pCapture->AddTarget("scene", m_pSceneTex.get());
+	m_pCapture->AddTarget("background", m_pBackgroundTex.get());
+	m_pCapture->AddTarget("foreground", m_pForegroundTex.get());
+
 	m_pManipulator = new CGMBaseManipulator();
 	m_pTerrain = new CGMTerrain();
 	m_pModel = new CGMModel();
 	m_pCharacter = new CGMCharacter();
+	m_pSimulation = new CGMSimulation();
 	m_pAudio = new CGMAudio();
+	m_pMusicAnalyzer = new CGMMusicAnalyzer();
+	m_pMediaLibrary = new CGMMediaLibrary();
 	m_pPost = new CGMPost();
+	m_pScene = new CGMScene();
 
 	GM_UNIFORM.Init(m_pKernelData, m_pConfigData);
 	m_pTerrain->Init(m_pKernelData, m_pConfigData);
 	m_pModel->Init(m_pKernelData, m_pConfigData);
 	m_pCharacter->Init(m_pKernelData, m_pConfigData, m_pModel);
-	m_pAudio->Init(m_pConfigData);
+	m_pAudio->Init(m_pConfigData, m_pScheduler, eAudioBackend);
+	m_pMusicAnalyzer->Init(m_pConfigData);
+	m_pMediaLibrary->Init(m_pConfigData);
 	m_pPost->Init(m_pKernelData, m_pConfigData);
 
 	GM_View->getCamera()->setCullMask(GM_MAIN_MASK);
@@ -145,25 +187,11 @@ bool CGMEngine::Init()
 
 	GM_View->addEventHandler(new ResizeEventHandler(this));
 
-	SLightData sMainLight;
-	sMainLight.strName = "mainLight";
-	sMainLight.eType = EGMLIGHT_SOURCE_DIRECTIONAL;
-	sMainLight.vDir = osg::Vec4d(-1.0, 2.0, -1.0, 0.0);
-	sMainLight.fLuminous = 2e3f;
-	sMainLight.bShadow = true;
-	GM_LIGHT.Add(sMainLight);
-
-	// 加载背景模型
-	SGMModelData sData = SGMModelData();
-	sData.strName = "Bacdground";
-	sData.strFilePath = "Background.FBX";
-	sData.iEntRenderBin = 0;
-	sData.eMaterial = EGM_MATERIAL_Background;
-	sData.bCastShadow = false;
-	m_pModel->Add(sData);
-
-	// 创建角色模型
-	m_pCharacter->CreateCharacter("MIGI");
+	// 用户修改过的场景直接从文件恢复，不再执行创建场景的代码
+	if (!_LoadScene())
+	{
+		_CreateScene();
+	}
 
 	return true;
 }
@@ -172,6 +200,12 @@ bool CGMEngine::Init()
 void CGMEngine::Release()
 {
 	setlocale(LC_ALL, "C");
+	// 先停下渲染线程，执行完界面线程转交的调用
+	if (m_pViewWidget)
+	{
+		m_pViewWidget->StopRenderThread();
+		m_pViewWidget = nullptr;
+	}
 	if (GM_Viewer.valid())
 	{
 		GM_Viewer->stopThreading();
@@ -182,11 +216,32 @@ void CGMEngine::Release()
 	GM_UNIFORM.Release();
 	GM_ANIMATION.Release();
 
+	StopRecord();
+	GM_DELETE(m_pRecorder);
+	// 等待已经读回的截图写完
+	GM_DELETE(m_pCapture);
+
+	// 扫描和分析线程还在用BASS解码，要先于音频模块退出
+	GM_DELETE(m_pMediaLibrary);
+	GM_DELETE(m_pMusicAnalyzer);
 	GM_DELETE(m_pAudio);
+	// 先等模拟线程退出，再释放它读写的角色
+	GM_DELETE(m_pSimulation);
 	GM_DELETE(m_pCharacter);
+	for (auto& itr : m_pCrowdVector)
+	{
+		GM_DELETE(itr);
+	}
+	m_pCrowdVector.clear();
 	GM_DELETE(m_pTerrain);
 	GM_DELETE(m_pModel);
 	GM_DELETE(m_pPost);
+	GM_DELETE(m_pScene);
+	// 各模块在析构时删除自己的任务
+	GM_DELETE(m_pScheduler);
+	GM_DELETE(m_pPassCache);
+	// 各模块都退出后再结束工作线程
+	GM_THREADPOOL.Release();
 
 	GM_DELETE(m_pConfigData);
 	GM_DELETE(m_pKernelData);
@@ -198,6 +253,9 @@ bool CGMEngine::Update()
 {
 	if (!m_bInit)
 		return false;
+	// 渲染线程开启后，界面线程的定时器不再驱动帧循环
+	if (_IsOutsideRenderThread())
+		return true;
 
 	if (GM_Viewer->done())
 		return true;
@@ -207,37 +265,81 @@ bool CGMEngine::Update()
 		double timeCurrFrame = osg::Timer::instance()->time_s();
 		double dDeltaTime = timeCurrFrame - m_dTimeLastFrame; //单位:秒
 		m_dTimeLastFrame = timeCurrFrame;
-
-		static double s_fConstantStep = 0.1;		//!< 等间隔更新的时间,单位s
-		static double s_fDeltaStep = 0.0;			//!< 单位s
-		if (s_fDeltaStep > s_fConstantStep)
+		// 固定步长时按仿真时间推进，动画和画面与运行速度无关
+		if (m_fFixedStep > 0.0)
 		{
-			if (m_bRendering)
-				_InnerUpdate(s_fDeltaStep);
-			s_fDeltaStep = 0.0;
+			dDeltaTime = m_fFixedStep;
+			m_dSimulationTime += m_fFixedStep;
 		}
-		s_fDeltaStep += dDeltaTime;
+		// 回放时先执行到时间的调用，和录制时在同一帧生效
+		if (m_pRecorder->IsReplaying())
+			_Replay();
+		osg::Timer* pTimer = osg::Timer::instance();
+		osg::Timer_t tStage = pTimer->tick();
+
+		// 执行到期的定时任务
+		m_pScheduler->Advance(dDeltaTime);
 
 		m_pAudio->Update(dDeltaTime);
+		if (m_pAudio->GetAudioSerial() != m_iAudioSerial)
+		{
+			_OnAudioChanged();
+		}
+		m_sFrameTiming.fAudio = pTimer->delta_s(tStage, pTimer->tick());
 		if (m_bRendering)
 		{
+			tStage = pTimer->tick();
 			GM_LIGHT.Update(dDeltaTime);
 
 			GM_UNIFORM.Update(dDeltaTime);
 			m_pPost->Update(dDeltaTime);
 			m_pTerrain->Update(dDeltaTime);
 			m_pModel->Update(dDeltaTime);
-			m_pCharacter->Update(dDeltaTime);
-
-			GM_Viewer->advance(USE_REFERENCE_TIME);
+			osg::Timer_t tCharacterStart = osg::Timer::instance()->tick();
+			m_sFrameTiming.fModule = pTimer->delta_s(tStage, tCharacterStart);
+			// 口型按已经播放出去的帧数取，和听到的声音对齐
+			_SetViseme(m_pAudio->GetViseme());
+			// 先应用上一帧绘制期间模拟的结果，没有开启并行模拟时在这里模拟本帧
+			_ApplyCharacters();
+			if (!m_pSimulation->GetEnable())
+			{
+				_SimulateCharacters(dDeltaTime);
+				_ApplyCharacters();
+			}
+			double fCPUTime = osg::Timer::instance()->delta_s(tCharacterStart, osg::Timer::instance()->tick());
+			m_sFrameTiming.fCharacter = fCPUTime;
+
+			tStage = pTimer->tick();
+			GM_Viewer->advance((m_fFixedStep > 0.0) ? m_dSimulationTime : USE_REFERENCE_TIME);
 			GM_Viewer->eventTraversal();
+			// 骨骼、蒙皮和变形动画都在更新遍历中计算
+			osg::Timer_t tUpdateStart = osg::Timer::instance()->tick();
+			m_sFrameTiming.fEvent = pTimer->delta_s(tStage, tUpdateStart);
 			GM_Viewer->updateTraversal();
+			m_sFrameTiming.fUpdate = osg::Timer::instance()->delta_s(tUpdateStart, osg::Timer::instance()->tick());
+			fCPUTime += m_sFrameTiming.fUpdate;
 
 			// 在主相机改变位置后再更新
+			tStage = pTimer->tick();
 			_UpdateLater(dDeltaTime);
+			m_sFrameTiming.fLater = pTimer->delta_s(tStage, pTimer->tick());
 
+			// 下一帧的角色逻辑与剔除、绘制重叠，这期间主线程不修改角色和动画
+			if (m_pSimulation->GetEnable())
+				m_pSimulation->Launch([this, dDeltaTime]() { _SimulateCharacters(dDeltaTime); });
+
+			tStage = pTimer->tick();
 			GM_Viewer->renderingTraversals();
+			m_pPassCache->Restore();
+			m_sFrameTiming.fRendering = pTimer->delta_s(tStage, pTimer->tick());
+			// 模拟比绘制慢时，主线程在这里等待
+			fCPUTime += m_pSimulation->Wait();
+
+			if (m_sBenchmark.bRunning)
+				_UpdateBenchmark(fCPUTime);
 		}
+		if (m_pRecorder->IsRecording() || m_pRecorder->IsReplaying())
+			m_fRecordTime += dDeltaTime;
 	}
 	return true;
 }
@@ -257,12 +359,28 @@ bool CGMEngine::Load()
 /** @brief 保存 */
 bool CGMEngine::Save()
 {
-	m_pModel->Save();
-	return false;
+	if (!m_bInit) return false;
+	if (_Marshal([this]() { Save(); })) return true;
+
+	SGMSceneData sScene;
+	m_pModel->Save(sScene);
+	GM_LIGHT.Save(sScene);
+	sScene.characterVec.push_back(m_pCharacter->GetName());
+	for (auto& itr : m_pCrowdVector)
+	{
+		sScene.characterVec.push_back(itr->GetName());
+	}
+	// 只有位置等数据变化时，只重写变化的记录
+	return m_pScene->Save(g_strGMSceneFile, sScene);
 }
 
 void CGMEngine::ResizeScreen(const int iW, const int iH)
 {
+	SGMRecordEvent sEvent(EGMRECORD_RESIZE);
+	sEvent.iValue = iW;
+	sEvent.iValue2 = iH;
+	_Record(sEvent);
+
 	m_pConfigData->iScreenWidth = iW;
 	m_pConfigData->iScreenHeight = iH;
 
@@ -284,6 +402,9 @@ void CGMEngine::ResizeScreen(const int iW, const int iH)
 		m_pKernelData->pBackgroundCam->resize(iW, iH);
 	if (m_pKernelData->pForegroundCam.valid())
 		m_pKernelData->pForegroundCam->resize(iW, iH);
+	// 纹理重新分配后内容无效
+	if (m_pPassCache)
+		m_pPassCache->Dirty();
 	if (m_pPost)
 		m_pPost->ResizeScreen(iW, iH);
 
@@ -293,6 +414,13 @@ void CGMEngine::ResizeScreen(const int iW, const int iH)
 
 void CGMEngine::SetLookTargetPos(const SGMVector2f& vTargetScreenPos)
 {
+	if (_Marshal([this, vTargetScreenPos]() { SetLookTargetPos(vTargetScreenPos); })) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_LOOK_TARGET);
+	sEvent.fValue[0] = vTargetScreenPos.x;
+	sEvent.fValue[1] = vTargetScreenPos.y;
+	_Record(sEvent);
+
 	osg::Vec2f vTargetScreePos(vTargetScreenPos.x, vTargetScreenPos.y);
 
 	double fovy, aspectRatio, zNear, zFar;
@@ -309,11 +437,71 @@ void CGMEngine::SetLookTargetPos(const SGMVector2f& vTargetScreenPos)
 	vTargetWorldPos.x() += (vTargetScreePos.x() / m_pConfigData->iScreenWidth - 0.5) * 2 * fHalfH * aspectRatio;
 	vTargetWorldPos.z() += (vTargetScreePos.y() / m_pConfigData->iScreenHeight-0.5) * 2 * fHalfH;
 	m_pCharacter->SetLookTargetPos(vTargetWorldPos);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetLookTargetPos(vTargetWorldPos);
+	}
 }
 
 void CGMEngine::SetDestination(const SGMVector3& vDestinationPos)
 {
-	m_pCharacter->SetDestination(osg::Vec3d(vDestinationPos.x, vDestinationPos.y, vDestinationPos.z));
+	if (_Marshal([this, vDestinationPos]() { SetDestination(vDestinationPos); })) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_DESTINATION);
+	sEvent.fValue[0] = vDestinationPos.x;
+	sEvent.fValue[1] = vDestinationPos.y;
+	sEvent.fValue[2] = vDestinationPos.z;
+	_Record(sEvent);
+
+	m_pCharacter->SetDestination(GM2OSG(vDestinationPos));
+}
+
+void CGMEngine::SetParallelSimulation(const bool bEnable)
+{
+	if (_Marshal([this, bEnable]() { SetParallelSimulation(bEnable); })) return;
+	if (!m_bInit) return;
+
+	m_pSimulation->SetEnable(bEnable);
+}
+
+void CGMEngine::SetPassCache(const bool bEnable)
+{
+	if (_Marshal([this, bEnable]() { SetPassCache(bEnable); })) return;
+	if (!m_bInit) return;
+
+	m_pPassCache->SetEnable(bEnable);
+}
+
+void CGMEngine::SetRendering(const bool bEnable)
+{
+	if (_Marshal([this, bEnable]() { SetRendering(bEnable); })) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_RENDERING);
+	sEvent.iValue = bEnable ? 1 : 0;
+	_Record(sEvent);
+
+	m_bRendering = bEnable;
+}
+
+bool CGMEngine::GetRendering() const
+{
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.bRendering;
+	}
+	return m_bRendering;
+}
+
+double CGMEngine::GetIdleTime() const
+{
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.fIdleTime;
+	}
+	if (!m_bInit || m_bRendering) return 0.0;
+	return m_pScheduler->GetTimeToNext();
 }
 
 double CGMEngine::GetElapsedTimeSeconds() const
@@ -323,32 +511,44 @@ double CGMEngine::GetElapsedTimeSeconds() const
 
 bool CGMEngine::Play()
 {
+	if (_Marshal([this]() { Play(); })) return true;
+
+	_Record(SGMRecordEvent(EGMRECORD_PLAY));
+
 	m_bAudioOver = false;
 	std::wstring wstrCurrentFile = m_pAudio->GetCurrentAudio();
 	if (L"" == wstrCurrentFile)
 	{
-		wstrCurrentFile = L"The Minions - Y.M.C.A.mp3";
-		m_pAudio->SetCurrentAudio(wstrCurrentFile);
-		m_pCharacter->SetMusicDuration(m_pAudio->GetAudioDuration());
+		// 从媒体库中选第一首，第一次启动、还没有索引时用自带的歌曲
+		wstrCurrentFile = (EGMA_MOD_RANDOM == m_ePlayMode) ? m_pMediaLibrary->GetRandom(L"") : m_pMediaLibrary->GetNext(L"");
+		if (L"" == wstrCurrentFile)
+			wstrCurrentFile = L"The Minions - Y.M.C.A.mp3";
+		return _PlayAudio(wstrCurrentFile);
 	}
 	m_pAudio->AudioControl(EGMA_CMD_PLAY);
-	m_pCharacter->SetMusicEnable(true);
+	_SetMusicEnable(true);
 	return true;
 }
 
 /** @brief 暂停 */
 bool CGMEngine::Pause()
 {
+	if (_Marshal([this]() { Pause(); })) return true;
+
+	_Record(SGMRecordEvent(EGMRECORD_PAUSE));
 	m_pAudio->AudioControl(EGMA_CMD_PAUSE);
-	m_pCharacter->SetMusicEnable(false);
+	_SetMusicEnable(false);
 	return true;
 }
 
 /** @brief 停止 */
 bool CGMEngine::Stop()
 {
+	if (_Marshal([this]() { Stop(); })) return true;
+
+	_Record(SGMRecordEvent(EGMRECORD_STOP));
 	m_pAudio->AudioControl(EGMA_CMD_STOP);
-	m_pCharacter->SetMusicEnable(false);
+	_SetMusicEnable(false);
 
 	return true;
 }
@@ -356,6 +556,9 @@ bool CGMEngine::Stop()
 /** @brief 下一首 */
 bool CGMEngine::Next()
 {
+	if (_Marshal([this]() { Next(); })) return true;
+
+	_Record(SGMRecordEvent(EGMRECORD_NEXT));
 	m_bAudioOver = false;
 	_Next(m_ePlayMode);
 
@@ -364,68 +567,420 @@ bool CGMEngine::Next()
 
 bool CGMEngine::SetVolume(const float fVolume)
 {
+	if (_Marshal([this, fVolume]() { SetVolume(fVolume); })) return true;
+
+	SGMRecordEvent sEvent(EGMRECORD_VOLUME);
+	sEvent.fValue[0] = fVolume;
+	_Record(sEvent);
+
 	return m_pAudio->SetVolume(osg::clampBetween(fVolume, 0.0f, 1.0f));
 }
 
 float CGMEngine::GetVolume() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.fVolume;
+	}
 	return m_pAudio->GetVolume();
 }
 
 bool CGMEngine::SetPlayMode(EGMA_MODE eMode)
 {
-	m_ePlayMode = eMode;
+	if (_Marshal([this, eMode]() { SetPlayMode(eMode); })) return true;
+
+	SGMRecordEvent sEvent(EGMRECORD_PLAY_MODE);
+	sEvent.iValue = eMode;
+	_Record(sEvent);
+
+	if (m_ePlayMode != eMode)
+	{
+		m_ePlayMode = eMode;
+		// 预读的下一首跟着播放模式变
+		if (L"" != m_pAudio->GetCurrentAudio())
+		{
+			m_strNextAudio = _GetNextAudio(m_ePlayMode);
+			m_pAudio->PrefetchAudio(m_strNextAudio);
+		}
+	}
 	return true;
 }
 
 std::wstring CGMEngine::GetAudioName() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.strAudioName;
+	}
 	return m_pAudio->GetCurrentAudio();
 }
 
 bool CGMEngine::SetAudioCurrentTime(const int iTime)
 {
-	m_pCharacter->SetMusicCurrentTime(iTime);
+	if (_Marshal([this, iTime]() { SetAudioCurrentTime(iTime); })) return true;
+
+	SGMRecordEvent sEvent(EGMRECORD_AUDIO_TIME);
+	sEvent.iValue = iTime;
+	_Record(sEvent);
+
+	_SetMusicCurrentTime(iTime);
 	return m_pAudio->SetAudioCurrentTime(iTime);
 }
 
 int CGMEngine::GetAudioCurrentTime() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.iAudioCurrentTime;
+	}
 	return m_pAudio->GetAudioCurrentTime();
 }
 
 int CGMEngine::GetAudioDuration() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.iAudioDuration;
+	}
 	return m_pAudio->GetAudioDuration();
 }
 
 bool CGMEngine::IsAudioOver() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.bAudioOver;
+	}
 	return m_pAudio->IsAudioOver();
 }
 
+float CGMEngine::GetAudioSwitchLatency() const
+{
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.fSwitchLatency;
+	}
+	return m_pAudio->GetSwitchLatency();
+}
+
 void CGMEngine::Welcome()
 {
+	if (_Marshal([this]() { Welcome(); })) return;
 	m_pAudio->Welcome();
 }
 
 bool CGMEngine::IsWelcomeFinished() const
 {
+	if (_IsOutsideRenderThread())
+	{
+		std::lock_guard<std::mutex> lock(m_mutexStatus);
+		return m_sStatus.bWelcomeFinished;
+	}
 	return m_pAudio->IsWelcomeFinished();
 }
 
+bool CGMEngine::AddCharacter(const std::string& strName, const SGMVector3& vPos)
+{
+	if (!m_bInit || !m_pCharacter) return false;
+	if (strName == m_pCharacter->GetName()) return false;
+	for (auto& itr : m_pCrowdVector)
+	{
+		if (strName == itr->GetName()) return false;
+	}
+
+	SGMRecordEvent sEvent(EGMRECORD_ADD_CHARACTER);
+	sEvent.strValue = strName;
+	sEvent.fValue[0] = vPos.x;
+	sEvent.fValue[1] = vPos.y;
+	sEvent.fValue[2] = vPos.z;
+	_Record(sEvent);
+
+	CGMCharacter* pCharacter = GM_NEW(CGMCharacter);
+	pCharacter->Init(m_pKernelData, m_pConfigData, m_pModel);
+	// 与主角使用同一个资源，网格和动画数据是共享的
+	if (!pCharacter->CreateCharacter(strName, m_pCharacter->GetName(), GM2OSG(vPos)))
+	{
+		GM_DELETE(pCharacter);
+		return false;
+	}
+	// 录制和回放时，新角色的随机数也要可以重复
+	if (m_pRecorder->IsRecording() || m_pRecorder->IsReplaying())
+		pCharacter->SetRandomSeed(m_iRandomSeed);
+	pCharacter->SetMusicDuration(m_iMusicDuration);
+	pCharacter->SetMusicGrid(m_pMusicGrid);
+	pCharacter->SetMusicEnable(m_pCharacter->GetMusicEnable());
+	m_pCrowdVector.push_back(pCharacter);
+	return true;
+}
+
+void CGMEngine::StartCharacterBenchmark(const std::string& strResultFile)
+{
+	if (!m_bInit || m_sBenchmark.bRunning) return;
+
+	m_sBenchmark = SGMCharacterBenchmark();
+	m_sBenchmark.bRunning = true;
+	m_sBenchmark.strResultFile = strResultFile;
+	m_sBenchmark.strResult = "dancers\tcpu_ms/frame\tgpu_ms/frame\tcpu_ms/dancer\tgpu_ms/dancer\n";
+
+	// 打开GPU计时
+	osg::Stats* pStats = GM_View->getCamera()->getStats();
+	if (pStats) pStats->collectStats("gpu", true);
+
+	_SetMusicEnable(true);
+}
+
+bool CGMEngine::StartRecord(const std::string& strFile)
+{
+	if (!m_bInit) return false;
+
+	std::random_device rd;
+	const uint32_t iSeed = rd();
+	if (!m_pRecorder->StartRecord(strFile, iSeed, m_pConfigData->iScreenWidth, m_pConfigData->iScreenHeight))
+		return false;
+	SetRandomSeed(iSeed);
+	m_fRecordTime = 0.0;
+
+	// 录制开始前角色已经拿到的音频输入，回放时要先恢复
+	SGMRecordEvent sEnable(EGMRECORD_MUSIC_ENABLE);
+	sEnable.iValue = m_pCharacter->GetMusicEnable() ? 1 : 0;
+	_Record(sEnable);
+	SGMRecordEvent sDuration(EGMRECORD_MUSIC_DURATION);
+	sDuration.iValue = m_iMusicDuration;
+	_Record(sDuration);
+	SGMRecordEvent sGrid(EGMRECORD_MUSIC_GRID);
+	sGrid.wstrValue = m_strGridAudio;
+	sGrid.iValue = m_pMusicGrid ? 1 : 0;
+	_Record(sGrid);
+	_SetMusicCurrentTime(m_pAudio->GetAudioCurrentTime());
+	return true;
+}
+
+void CGMEngine::StopRecord()
+{
+	if (!m_pRecorder || !m_pRecorder->IsRecording()) return;
+	m_pRecorder->StopRecord(uint32_t(m_fRecordTime * 1e3 + 0.5));
+}
+
+bool CGMEngine::StartReplay(const std::string& strFile)
+{
+	if (!m_bInit || !m_pRecorder->StartReplay(strFile)) return false;
+
+	SetRandomSeed(m_pRecorder->GetSeed());
+	m_vReplayScreen = SGMVector2i(m_pRecorder->GetWidth(), m_pRecorder->GetHeight());
+	m_sRecordViseme = SGMRecordEvent();
+	m_fRecordTime = 0.0;
+	return true;
+}
+
+void CGMEngine::SetRandomSeed(const uint32_t iSeed)
+{
+	m_iRandomSeed = iSeed;
+	m_pCharacter->SetRandomSeed(iSeed);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetRandomSeed(iSeed);
+	}
+	m_pMediaLibrary->SetSeed(iSeed);
+}
+
+bool CGMEngine::Capture(const std::string& strFile, const std::string& strTarget)
+{
+	if (!m_bInit) return false;
+	if (_Marshal([this, strFile, strTarget]() { Capture(strFile, strTarget); })) return true;
+	return m_pCapture->Capture(strTarget, strFile);
+}
+
 CGMViewWidget* CGMEngine::CreateViewWidget(QWidget* parent)
 {
-	GM_Viewer = new CGMViewWidget(GM_View, parent);
+	CGMViewWidget* pViewWidget = new CGMViewWidget(GM_View, parent);
+	GM_Viewer = pViewWidget;
+	m_pViewWidget = pViewWidget;
 	m_pPost->CreatePost(m_pSceneTex.get(), m_pBackgroundTex.get(), m_pForegroundTex.get());
+	// 后期相机最后绘制，这时所有渲染目标和最终画面都已经完成
+	m_pCapture->Attach(m_pPost->GetPostCamera());
 	if (EGMRENDER_LOW != m_pConfigData->eRenderQuality)
 	{
 		//m_pPost->SetVolumeEnable(true, m_pGalaxy->GetTAATex());
 	}
-	return GM_Viewer.get();
+	return pViewWidget;
+}
+
+bool CGMEngine::SetRenderThread(const bool bEnable, const double fFrameTime)
+{
+	if (!m_bInit || !m_pViewWidget) return false;
+	if (!bEnable)
+	{
+		m_pViewWidget->StopRenderThread();
+		return true;
+	}
+	// 壁纸模式会把视口挂到桌面窗口下，重建的GL上下文不能跨线程使用
+	if (m_pConfigData->bWallpaper) return false;
+	if (m_pViewWidget->IsRenderThreadRunning()) return true;
+
+	// 开启前先发布一次，界面线程在第一帧结束前也能读到状态
+	_PublishStatus();
+	return m_pViewWidget->StartRenderThread([this]() {
+		Update();
+		_PublishStatus();
+		return GetIdleTime();
+	}, fFrameTime);
+}
+
+bool CGMEngine::CreateHeadlessViewer(const int iWidth, const int iHeight)
+{
+	if (!m_bInit || GM_Viewer.valid()) return false;
+
+	osg::ref_ptr<osg::GraphicsContext::Traits> traits = new osg::GraphicsContext::Traits;
+	traits->x = 0;
+	traits->y = 0;
+	traits->width = iWidth;
+	traits->height = iHeight;
+	traits->windowDecoration = false;
+	// 单缓冲，画完一帧后可以直接从前缓冲读取画面
+	traits->doubleBuffer = false;
+	traits->pbuffer = true;
+	traits->alpha = osg::DisplaySettings::instance()->getMinimumNumAlphaBits();
+	traits->sharedContext = 0;
+	osg::ref_ptr<osg::GraphicsContext> pGC = osg::GraphicsContext::createGraphicsContext(traits.get());
+	if (!pGC.valid()) return false;
+
+	osg::Camera* pMainCam = GM_View->getCamera();
+	pMainCam->setGraphicsContext(pGC.get());
+	pMainCam->setViewport(new osg::Viewport(0, 0, iWidth, iHeight));
+	pMainCam->setDrawBuffer(GL_FRONT);
+	pMainCam->setReadBuffer(GL_FRONT);
+
+	GM_Viewer = new osgViewer::CompositeViewer;
+	GM_Viewer->setThreadingModel(osgViewer::CompositeViewer::SingleThreaded);
+	GM_Viewer->setKeyEventSetsDone(0);
+	GM_Viewer->setQuitEventSetsDone(false);
+	GM_Viewer->addView(GM_View);
+	GM_Viewer->realize();
+	if (!GM_Viewer->isRealized()) return false;
+
+	m_pPost->CreatePost(m_pSceneTex.get(), m_pBackgroundTex.get(), m_pForegroundTex.get());
+	m_pCapture->Attach(m_pPost->GetPostCamera());
+	// 没有窗口就没有RESIZE事件，这里主动调整到pbuffer的尺寸
+	if (iWidth != m_pConfigData->iScreenWidth || iHeight != m_pConfigData->iScreenHeight)
+	{
+		ResizeScreen(iWidth, iHeight);
+	}
+	return true;
+}
+
+bool CGMEngine::PrepareExport(const std::wstring& wstrAudioFile)
+{
+	if (!m_bInit || L"" == wstrAudioFile) return false;
+
+	m_pAudio->SkipWelcome();
+	if (!_PlayAudio(wstrAudioFile)) return false;
+
+	// 音频在后台打开，打开后才会切换过去，切换后第一次推进输出时从第0帧开始发声
+	osg::Timer_t tStart = osg::Timer::instance()->tick();
+	while (m_pAudio->IsSwitchPending())
+	{
+		if (osg::Timer::instance()->delta_s(tStart, osg::Timer::instance()->tick()) > EXPORT_OPEN_TIMEOUT) return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		m_pAudio->Update(0.0);
+	}
+	// 打不开的文件也会清掉等待标志，由调用者在第一帧后检查当前音频
+
+	// 第一帧发声时就要用到节拍，不能等后台分析完再补上，分析失败时角色不跟随节拍
+	_WaitMusicGrid(wstrAudioFile);
+	return true;
+}
+
+void CGMEngine::AdvanceAudio(const double fSeconds)
+{
+	m_pAudio->AdvanceOutput(fSeconds);
 }
 
 /** @brief 加载配置 */
+bool CGMEngine::_LoadScene()
+{
+	SGMSceneData sScene;
+	if (!m_pScene->Load(g_strGMSceneFile, sScene)) return false;
+
+	// 先检查角色，恢复到一半发现错误就没法回到默认场景了
+	if (sScene.characterVec.empty()) return false;
+	std::map<std::string, const SGMModelData*> characterMap;
+	for (auto& itr : sScene.characterVec)
+	{
+		characterMap[itr] = nullptr;
+	}
+	for (auto& itr : sScene.modelVec)
+	{
+		auto itrCharacter = characterMap.find(itr.strName);
+		if (characterMap.end() != itrCharacter) itrCharacter->second = &itr;
+	}
+	for (auto& itr : characterMap)
+	{
+		if (!itr.second) return false;
+	}
+
+	// 模型资源在后台线程中读取，同时恢复灯光
+	m_pModel->Preload(sScene.modelVec);
+	for (auto& itr : sScene.lightVec)
+	{
+		GM_LIGHT.Add(itr);
+	}
+	for (auto& itr : sScene.modelVec)
+	{
+		if (characterMap.end() == characterMap.find(itr.strName))
+			m_pModel->Add(itr);
+	}
+
+	// 角色的模型由角色模块添加，资源名称就是去掉扩展名的文件名
+	const SGMModelData* pMain = characterMap.at(sScene.characterVec.front());
+	const std::string strAsset = pMain->strFilePath.substr(0, pMain->strFilePath.find_last_of('.'));
+	if (!m_pCharacter->CreateCharacter(pMain->strName, strAsset, GM2OSG(pMain->vPos)))
+	{
+		// 主角的资源读取失败，撤销已经恢复的灯光和模型，由调用者创建默认场景
+		for (auto& itr : sScene.modelVec)
+		{
+			m_pModel->Remove(itr.strName);
+		}
+		GM_LIGHT.Clear();
+		return false;
+	}
+	for (size_t i = 1; i < sScene.characterVec.size(); i++)
+	{
+		AddCharacter(sScene.characterVec[i], characterMap.at(sScene.characterVec[i])->vPos);
+	}
+	return true;
+}
+
+void CGMEngine::_CreateScene()
+{
+	SLightData sMainLight;
+	sMainLight.strName = "mainLight";
+	sMainLight.eType = EGMLIGHT_SOURCE_DIRECTIONAL;
+	sMainLight.vDir = osg::Vec4d(-1.0, 2.0, -1.0, 0.0);
+	sMainLight.fLuminous = 2e3f;
+	sMainLight.bShadow = true;
+	GM_LIGHT.Add(sMainLight);
+
+	// 加载背景模型
+	SGMModelData sData = SGMModelData();
+	sData.strName = "Bacdground";
+	sData.strFilePath = "Background.FBX";
+	sData.iEntRenderBin = 0;
+	sData.eMaterial = EGM_MATERIAL_Background;
+	sData.bCastShadow = false;
+	m_pModel->Add(sData);
+
+	// 创建角色模型
+	m_pCharacter->CreateCharacter("MIGI");
+
+	Save();
+}
+
 bool CGMEngine::_LoadConfig()
 {
 	m_pConfigData = new SGMConfigData;
@@ -434,14 +989,15 @@ bool CGMEngine::_LoadConfig()
 	if(!hXML.Load(g_strGMConfigFile, "Config"))
 		return false;
 
-	// 解析系统配置
+	// 解析系统配置，没有的属性保持默认值
 	CGMXmlNode sNode = hXML.GetChild("System");
-
-	m_pConfigData->strCorePath = sNode.GetPropStr("corePath", m_pConfigData->strCorePath.c_str());
-	m_pConfigData->strMediaPath = sNode.GetPropWStr("mediaPath", m_pConfigData->strMediaPath.c_str());
-	m_pConfigData->eRenderQuality = EGMRENDER_QUALITY(sNode.GetPropInt("renderQuality", m_pConfigData->eRenderQuality));
-	m_pConfigData->fFovy = sNode.GetPropFloat("fovy", m_pConfigData->fFovy);
-	m_pConfigData->bWallpaper = sNode.GetPropBool("wallpaper", m_pConfigData->bWallpaper);
+	sNode.GetProps({
+		{ "corePath", &m_pConfigData->strCorePath },
+		{ "mediaPath", &m_pConfigData->strMediaPath },
+		{ "renderQuality", &m_pConfigData->eRenderQuality },
+		{ "fovy", &m_pConfigData->fFovy },
+		{ "crossfade", &m_pConfigData->iCrossfade },
+		{ "wallpaper", &m_pConfigData->bWallpaper } });
 
 	return true;
 }
@@ -477,6 +1033,7 @@ void CGMEngine::_InitBackground()
 		2.0, 2e4);
 	m_pKernelData->pBackgroundCam->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR);
 	GM_Root->addChild(m_pKernelData->pBackgroundCam.get());
+	m_pPassCache->Add(m_pKernelData->pBackgroundCam.get());
 }
 
 void CGMEngine::_InitForeground()
@@ -510,6 +1067,7 @@ void CGMEngine::_InitForeground()
 		2.0, 2e4);
 	m_pKernelData->pForegroundCam->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR);
 	GM_Root->addChild(m_pKernelData->pForegroundCam.get());
+	m_pPassCache->Add(m_pKernelData->pForegroundCam.get());
 }
 
 void CGMEngine::_Next(const EGMA_MODE eMode)
@@ -523,50 +1081,22 @@ void CGMEngine::_Next(const EGMA_MODE eMode)
 		m_pAudio->AudioControl(EGMA_CMD_PLAY);
 	}
 	break;
-	//case EGMA_MOD_CIRCLE:
-	//{
-	//	m_pAudio->AudioControl(EGMA_CMD_CLOSE);
-
-	//	int iMaxNum = m_pDataManager->GetAudioNum();
-	//	unsigned int iNext = (m_pDataManager->GetUID() + 1) % iMaxNum;// wrong to do
-	//	wstrCurrentFile = m_pDataManager->FindAudio(iNext);
-
-	//	m_pAudio->SetCurrentAudio(wstrCurrentFile);
-	//	m_pAudio->AudioControl(EGMA_CMD_OPEN);
-	//	m_pAudio->AudioControl(EGMA_CMD_PLAY);
-
-	//	SGMGalaxyCoord vGC = m_pDataManager->GetGalaxyCoord(wstrCurrentFile);
-	//	double fWorldX, fWorldY;
-	//	_GalaxyCoord2World(vGC.x, vGC.y, fWorldX, fWorldY);
-	//	m_pGalaxy->SetCurrentStar(osg::Vec3f(fWorldX, fWorldY, 0.0f), wstrCurrentFile);
-	//}
-	//break;
-	//case EGMA_MOD_RANDOM:
-	//{
-	//	m_pAudio->AudioControl(EGMA_CMD_CLOSE);
-
-	//	int iMaxNum = m_pDataManager->GetAudioNum();
-	//	std::uniform_int_distribution<> iPseudoNoise(0, iMaxNum-1);
-	//	int iNext = iPseudoNoise(m_iRandom);
-	//	wstrCurrentFile = m_pDataManager->FindAudio(iNext);
-	//	while (L"" == wstrCurrentFile)
-	//	{
-	//		iNext = iPseudoNoise(m_iRandom);
-	//		wstrCurrentFile = m_pDataManager->FindAudio(iNext);
-	//	}
-	//	m_pAudio->SetCurrentAudio(wstrCurrentFile);
-	//	m_pAudio->AudioControl(EGMA_CMD_OPEN);
-	//	m_pAudio->AudioControl(EGMA_CMD_PLAY);
-
-	//	SGMGalaxyCoord vGC = m_pDataManager->GetGalaxyCoord(wstrCurrentFile);
-	//	double fWorldX, fWorldY;
-	//	_GalaxyCoord2World(vGC.x, vGC.y, fWorldX, fWorldY);
-	//	m_pGalaxy->SetCurrentStar(osg::Vec3f(fWorldX, fWorldY, 0.0f), wstrCurrentFile);
-	//}
-	//break;
+	case EGMA_MOD_CIRCLE:
+	case EGMA_MOD_RANDOM:
+	{
+		// 优先用已经预读好的那一首，切换时不用等待磁盘
+		wstrCurrentFile = (L"" != m_strNextAudio) ? m_strNextAudio : _GetNextAudio(eMode);
+		_PlayAudio(wstrCurrentFile);
+	}
+	break;
 	case EGMA_MOD_ORDER:
 	{
-		m_pAudio->AudioControl(EGMA_CMD_CLOSE);
+		// 顺序播放到列表末尾就停止
+		wstrCurrentFile = (L"" != m_strNextAudio) ? m_strNextAudio : _GetNextAudio(eMode);
+		if (!_PlayAudio(wstrCurrentFile))
+		{
+			m_pAudio->AudioControl(EGMA_CMD_CLOSE);
+		}
 	}
 	break;
 	default:
@@ -577,20 +1107,426 @@ void CGMEngine::_Next(const EGMA_MODE eMode)
 	}
 }
 
+bool CGMEngine::_PlayAudio(const std::wstring& wstrAudioFile)
+{
+	if (L"" == wstrAudioFile) return false;
+	if (!m_pAudio->SetCurrentAudio(wstrAudioFile)) return false;
+	m_strNextAudio = L"";
+
+	// 在后台分析节拍，有缓存时几乎立即完成
+	m_pMusicAnalyzer->Request(m_pAudio->GetAudioPath(wstrAudioFile));
+
+	m_pAudio->AudioControl(EGMA_CMD_PLAY);
+	_SetMusicEnable(true);
+	return true;
+}
+
+std::wstring CGMEngine::_GetNextAudio(const EGMA_MODE eMode)
+{
+	const std::wstring wstrCurrentFile = m_pAudio->GetCurrentAudio();
+	switch (eMode)
+	{
+	case EGMA_MOD_SINGLE:
+		return wstrCurrentFile;
+	case EGMA_MOD_CIRCLE:
+		return m_pMediaLibrary->GetNext(wstrCurrentFile);
+	case EGMA_MOD_RANDOM:
+		return m_pMediaLibrary->GetRandom(wstrCurrentFile);
+	case EGMA_MOD_ORDER:
+		return m_pMediaLibrary->GetNext(wstrCurrentFile, false);
+	default:
+		return L"";
+	}
+}
+
+void CGMEngine::_OnAudioChanged()
+{
+	m_iAudioSerial = m_pAudio->GetAudioSerial();
+	const std::wstring wstrCurrentFile = m_pAudio->GetCurrentAudio();
+	if (L"" == wstrCurrentFile) return;
+
+	m_bAudioOver = false;
+	_SetMusicDuration(m_pAudio->GetAudioDuration());
+	_SetMusicCurrentTime(0);
+
+	// 自动切过来的音频还没有分析过
+	m_pMusicAnalyzer->Request(m_pAudio->GetAudioPath(wstrCurrentFile));
+	_UpdateMusicGrid();
+
+	// 当前这首播放的同时，在后台打开下一首
+	m_strNextAudio = _GetNextAudio(m_ePlayMode);
+	m_pAudio->PrefetchAudio(m_strNextAudio);
+	if (L"" != m_strNextAudio)
+		m_pMusicAnalyzer->Request(m_pAudio->GetAudioPath(m_strNextAudio));
+}
+
+void CGMEngine::_SetMusicEnable(const bool bEnable)
+{
+	if (!_AcceptInput()) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_MUSIC_ENABLE);
+	sEvent.iValue = bEnable ? 1 : 0;
+	_Record(sEvent);
+
+	m_pCharacter->SetMusicEnable(bEnable);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetMusicEnable(bEnable);
+	}
+}
+
+void CGMEngine::_SetMusicDuration(const int iDuration)
+{
+	if (!_AcceptInput()) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_MUSIC_DURATION);
+	sEvent.iValue = iDuration;
+	_Record(sEvent);
+
+	m_iMusicDuration = iDuration;
+	m_pCharacter->SetMusicDuration(iDuration);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetMusicDuration(iDuration);
+	}
+}
+
+void CGMEngine::_SetMusicCurrentTime(const int iTime)
+{
+	if (!_AcceptInput()) return;
+
+	SGMRecordEvent sEvent(EGMRECORD_MUSIC_TIME);
+	sEvent.iValue = iTime;
+	_Record(sEvent);
+
+	m_pCharacter->SetMusicCurrentTime(iTime);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetMusicCurrentTime(iTime);
+	}
+}
+
+void CGMEngine::_SetMusicGrid(std::shared_ptr<const SGMMusicGrid> pGrid, const std::wstring& wstrFile)
+{
+	if (!_AcceptInput()) return;
+
+	// 回放时按文件名重新分析，日志里只记录有没有网格
+	SGMRecordEvent sEvent(EGMRECORD_MUSIC_GRID);
+	sEvent.wstrValue = wstrFile;
+	sEvent.iValue = pGrid ? 1 : 0;
+	_Record(sEvent);
+
+	m_pMusicGrid = pGrid;
+	m_pCharacter->SetMusicGrid(m_pMusicGrid);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetMusicGrid(m_pMusicGrid);
+	}
+}
+
+void CGMEngine::_SetViseme(const SGMViseme& sViseme)
+{
+	if (!_AcceptInput()) return;
+
+	// 口型每帧都会取，只在变化时录制
+	SGMRecordEvent sEvent(EGMRECORD_VISEME);
+	sEvent.fValue[0] = sViseme.fAA;
+	sEvent.fValue[1] = sViseme.fOO;
+	sEvent.fValue[2] = sViseme.fClosed;
+	sEvent.iValue = sViseme.bValid ? 1 : 0;
+	if (sEvent.iValue != m_sRecordViseme.iValue || sEvent.fValue[0] != m_sRecordViseme.fValue[0]
+		|| sEvent.fValue[1] != m_sRecordViseme.fValue[1] || sEvent.fValue[2] != m_sRecordViseme.fValue[2])
+	{
+		_Record(sEvent);
+		m_sRecordViseme = sEvent;
+	}
+
+	m_pCharacter->SetViseme(sViseme);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->SetViseme(sViseme);
+	}
+}
+
+void CGMEngine::_Record(SGMRecordEvent sEvent)
+{
+	if (!m_pRecorder || !m_pRecorder->IsRecording()) return;
+
+	sEvent.iTime = uint32_t(m_fRecordTime * 1e3 + 0.5);
+	m_pRecorder->Record(sEvent);
+}
+
+void CGMEngine::_Replay()
+{
+	const uint32_t iTime = uint32_t(m_fRecordTime * 1e3 + 0.5);
+	SGMRecordEvent sEvent;
+	while (m_pRecorder->PopEvent(iTime, sEvent))
+	{
+		switch (sEvent.eType)
+		{
+		case EGMRECORD_LOOK_TARGET:
+		{
+			// 录制和回放的屏幕尺寸可能不同，按比例换算
+			const double fScaleX = double(m_pConfigData->iScreenWidth) / fmax(1.0, double(m_vReplayScreen.x));
+			const double fScaleY = double(m_pConfigData->iScreenHeight) / fmax(1.0, double(m_vReplayScreen.y));
+			SetLookTargetPos(SGMVector2f(float(sEvent.fValue[0] * fScaleX), float(sEvent.fValue[1] * fScaleY)));
+		}
+		break;
+		case EGMRECORD_DESTINATION:
+			SetDestination(SGMVector3(sEvent.fValue[0], sEvent.fValue[1], sEvent.fValue[2]));
+			break;
+		case EGMRECORD_PLAY:
+			Play();
+			break;
+		case EGMRECORD_PAUSE:
+			Pause();
+			break;
+		case EGMRECORD_STOP:
+			Stop();
+			break;
+		case EGMRECORD_NEXT:
+			Next();
+			break;
+		case EGMRECORD_VOLUME:
+			SetVolume(float(sEvent.fValue[0]));
+			break;
+		case EGMRECORD_PLAY_MODE:
+			SetPlayMode(EGMA_MODE(sEvent.iValue));
+			break;
+		case EGMRECORD_AUDIO_TIME:
+			SetAudioCurrentTime(sEvent.iValue);
+			break;
+		case EGMRECORD_RENDERING:
+			SetRendering(0 != sEvent.iValue);
+			break;
+		case EGMRECORD_RESIZE:
+			m_vReplayScreen = SGMVector2i(sEvent.iValue, sEvent.iValue2);
+			break;
+		case EGMRECORD_ADD_CHARACTER:
+			AddCharacter(sEvent.strValue, SGMVector3(sEvent.fValue[0], sEvent.fValue[1], sEvent.fValue[2]));
+			break;
+		case EGMRECORD_MUSIC_ENABLE:
+			m_bReplayInput = true;
+			_SetMusicEnable(0 != sEvent.iValue);
+			break;
+		case EGMRECORD_MUSIC_DURATION:
+			m_bReplayInput = true;
+			_SetMusicDuration(sEvent.iValue);
+			break;
+		case EGMRECORD_MUSIC_TIME:
+			m_bReplayInput = true;
+			_SetMusicCurrentTime(sEvent.iValue);
+			break;
+		case EGMRECORD_MUSIC_GRID:
+			m_bReplayInput = true;
+			_SetMusicGrid(sEvent.iValue ? _WaitMusicGrid(sEvent.wstrValue) : nullptr, sEvent.wstrValue);
+			break;
+		case EGMRECORD_VISEME:
+		{
+			SGMViseme sViseme;
+			sViseme.fAA = float(sEvent.fValue[0]);
+			sViseme.fOO = float(sEvent.fValue[1]);
+			sViseme.fClosed = float(sEvent.fValue[2]);
+			sViseme.bValid = (0 != sEvent.iValue);
+			m_bReplayInput = true;
+			_SetViseme(sViseme);
+		}
+		break;
+		default:
+			break;
+		}
+		m_bReplayInput = false;
+	}
+}
+
+std::shared_ptr<const SGMMusicGrid> CGMEngine::_WaitMusicGrid(const std::wstring& wstrFile)
+{
+	const std::wstring wstrPath = m_pAudio->GetAudioPath(wstrFile);
+	m_pMusicAnalyzer->Request(wstrPath);
+
+	// 有缓存时几乎立即完成，没有缓存时要等分析线程，分析失败时立即返回
+	osg::Timer_t tStart = osg::Timer::instance()->tick();
+	std::shared_ptr<const SGMMusicGrid> pGrid;
+	while (!m_pMusicAnalyzer->GetGrid(wstrPath, pGrid)
+		&& osg::Timer::instance()->delta_s(tStart, osg::Timer::instance()->tick()) < REPLAY_GRID_TIMEOUT)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return pGrid;
+}
+
+bool CGMEngine::_Marshal(std::function<void()> fCommand)
+{
+	return m_pViewWidget && m_pViewWidget->PostCommand(std::move(fCommand));
+}
+
+bool CGMEngine::_IsOutsideRenderThread() const
+{
+	return m_pViewWidget && m_pViewWidget->IsRenderThreadRunning() && !m_pViewWidget->IsRenderThread();
+}
+
+void CGMEngine::_PublishStatus()
+{
+	SGMEngineStatus sStatus;
+	sStatus.strAudioName = m_pAudio->GetCurrentAudio();
+	sStatus.iAudioCurrentTime = m_pAudio->GetAudioCurrentTime();
+	sStatus.iAudioDuration = m_pAudio->GetAudioDuration();
+	sStatus.fVolume = m_pAudio->GetVolume();
+	sStatus.fSwitchLatency = m_pAudio->GetSwitchLatency();
+	sStatus.bAudioOver = m_pAudio->IsAudioOver();
+	sStatus.bWelcomeFinished = m_pAudio->IsWelcomeFinished();
+	sStatus.bRendering = m_bRendering;
+	sStatus.fIdleTime = GetIdleTime();
+
+	std::lock_guard<std::mutex> lock(m_mutexStatus);
+	m_sStatus = std::move(sStatus);
+}
+
+void CGMEngine::_UpdateBenchmark(const double fCPUTime)
+{
+	SGMCharacterBenchmark& sBench = m_sBenchmark;
+	const int iCount = sBench.iCountVec.at(sBench.iStage);
+
+	// 先把角色数量补齐，主角算第一个
+	int iNum = 1 + int(m_pCrowdVector.size());
+	if (iNum < iCount)
+	{
+		while (iNum < iCount)
+		{
+			int iIndex = iNum - 1;
+			SGMVector3 vPos(
+				(iIndex % CROWD_ROW_NUM - (CROWD_ROW_NUM - 1) * 0.5) * CROWD_SPACING,
+				(iIndex / CROWD_ROW_NUM + 1) * CROWD_SPACING,
+				0.0);
+			const std::string strName = "Dancer_" + std::to_string(iIndex);
+			if (!AddCharacter(strName, vPos)) break;
+			sBench.strCrowdVec.push_back(strName);
+			iNum++;
+		}
+		_SetMusicEnable(true);
+		sBench.iFrame = 0;
+		return;
+	}
+
+	sBench.iFrame++;
+	if (sBench.iFrame <= BENCH_WARMUP_FRAMES) return;
+
+	sBench.fCPUTime += fCPUTime;
+	// GPU计时要等几帧后才能取到
+	osg::Stats* pStats = GM_View->getCamera()->getStats();
+	unsigned int iFrameNum = GM_Viewer->getViewerFrameStamp()->getFrameNumber();
+	double fGPUTime = 0.0;
+	if (pStats && iFrameNum > BENCH_GPU_STATS_DELAY
+		&& pStats->getAttribute(iFrameNum - BENCH_GPU_STATS_DELAY, "GPU draw time taken", fGPUTime))
+	{
+		sBench.fGPUTime += fGPUTime;
+		sBench.iGPUFrame++;
+	}
+
+	if (sBench.iFrame < BENCH_WARMUP_FRAMES + BENCH_MEASURE_FRAMES) return;
+
+	// 记录本阶段的结果
+	double fCPU = 1e3 * sBench.fCPUTime / BENCH_MEASURE_FRAMES;
+	double fGPU = sBench.iGPUFrame ? (1e3 * sBench.fGPUTime / sBench.iGPUFrame) : 0.0;
+	sBench.strResult += std::to_string(iNum) + "\t" + std::to_string(fCPU) + "\t" + std::to_string(fGPU)
+		+ "\t" + std::to_string(fCPU / iNum) + "\t" + std::to_string(fGPU / iNum) + "\n";
+
+	sBench.iStage++;
+	sBench.iFrame = 0;
+	sBench.fCPUTime = 0.0;
+	sBench.fGPUTime = 0.0;
+	sBench.iGPUFrame = 0;
+	if (sBench.iStage < int(sBench.iCountVec.size())) return;
+
+	// 全部结束
+	sBench.bRunning = false;
+	std::ofstream fOut(sBench.strResultFile);
+	if (fOut.is_open())
+	{
+		fOut << sBench.strResult;
+		fOut.close();
+	}
+	// 测试添加的群演不能留在场景里，否则关闭时会被保存
+	for (auto& itr : sBench.strCrowdVec)
+	{
+		_RemoveCharacter(itr);
+	}
+	sBench.strCrowdVec.clear();
+}
+
+bool CGMEngine::_RemoveCharacter(const std::string& strName)
+{
+	for (auto itr = m_pCrowdVector.begin(); itr != m_pCrowdVector.end(); itr++)
+	{
+		if (strName != (*itr)->GetName()) continue;
+
+		m_pModel->Remove(strName);
+		GM_DELETE(*itr);
+		m_pCrowdVector.erase(itr);
+		return true;
+	}
+	return false;
+}
+
 void CGMEngine::_InnerUpdate(const float updateStep)
 {
+	_UpdateMusicGrid();
+
 	// 由于可能在同一帧内出现先设置开启音乐后又设置关闭音乐的情况
 	// 所以在这里需要两次判断音乐是否结束
 	if (m_pAudio->IsAudioOver())
 	{
 		if (m_bAudioOver && m_pCharacter->GetMusicEnable())
 		{
-			m_pCharacter->SetMusicEnable(false);
+			_SetMusicEnable(false);
 		}
 		m_bAudioOver = true;
 	}
 }
 
+void CGMEngine::_UpdateMusicGrid()
+{
+	std::wstring wstrCurrentFile = m_pAudio->GetCurrentAudio();
+	if (wstrCurrentFile == m_strGridAudio) return;
+
+	// 换歌后、分析完成前，角色使用默认的节拍
+	std::shared_ptr<const SGMMusicGrid> pGrid;
+	const bool bDone = m_pMusicAnalyzer->GetGrid(m_pAudio->GetAudioPath(wstrCurrentFile), pGrid);
+	if (pGrid || m_pMusicGrid)
+	{
+		_SetMusicGrid(pGrid, wstrCurrentFile);
+	}
+	// 分析失败时也不再每帧查询，角色一直使用默认的节拍
+	if (!bDone) return;
+	m_strGridAudio = wstrCurrentFile;
+	if (pGrid)
+		m_pMediaLibrary->SetBPM(wstrCurrentFile, pGrid->fBPM);
+}
+
+void CGMEngine::_SimulateCharacters(const double dDeltaTime)
+{
+	osg::Timer_t tStart = osg::Timer::instance()->tick();
+	m_pCharacter->Update(dDeltaTime);
+	// 每个角色只读写自己的状态，动画命令录制在各自的缓冲中，群演可以并行
+	GM_THREADPOOL.ParallelFor(0, int(m_pCrowdVector.size()), [this, dDeltaTime](int iBegin, int iEnd)
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_pCrowdVector.at(i)->Update(dDeltaTime);
+		}
+	});
+	m_sFrameTiming.fSimulation = osg::Timer::instance()->delta_s(tStart, osg::Timer::instance()->tick());
+}
+
+void CGMEngine::_ApplyCharacters()
+{
+	m_pCharacter->Apply();
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->Apply();
+	}
+}
+
 bool CGMEngine::_UpdateLater(const double dDeltaTime)
 {
 	// background camera
@@ -612,6 +1548,12 @@ bool CGMEngine::_UpdateLater(const double dDeltaTime)
 	m_pTerrain->UpdatePost(dDeltaTime);
 	m_pModel->UpdatePost(dDeltaTime);
 	m_pCharacter->UpdatePost(dDeltaTime);
+	for (auto& itr : m_pCrowdVector)
+	{
+		itr->UpdatePost(dDeltaTime);
+	}
 
+	// 所有模块都更新完之后，才能判断RTT pass的输入是否变化
+	m_pPassCache->Update();
 	return true;
 }
\ No newline at end of file
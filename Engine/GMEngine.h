@@ -13,7 +13,12 @@
 #pragma once
 #include "GMCommon.h"
 #include "GMKernel.h"
+#include "GMRecorder.h"
+#include "GMAudioBackend.h"
 #include <random>
+#include <memory>
+#include <mutex>
+#include <functional>
 
 /*************************************************************************
 Class
@@ -43,6 +48,56 @@ namespace GM
 	/*************************************************************************
 	Structs
 	*************************************************************************/
+	/*!
+	*  @struct SGMCharacterBenchmark
+	*  @brief 角色性能测试的状态
+	*/
+	struct SGMCharacterBenchmark
+	{
+		bool bRunning = false;							//!< 是否正在测试
+		int iStage = 0;									//!< 当前阶段，即iCountVec中的序号
+		int iFrame = 0;									//!< 当前阶段经过的帧数
+		int iGPUFrame = 0;								//!< 当前阶段取到GPU计时的帧数
+		double fCPUTime = 0.0;							//!< 当前阶段角色与动画更新的CPU时间，单位：秒
+		double fGPUTime = 0.0;							//!< 当前阶段的GPU绘制时间，单位：秒
+		std::vector<int> iCountVec = { 1, 10, 50 };		//!< 每个阶段的角色数量
+		std::string strResultFile = "";					//!< 结果文件路径
+		std::string strResult = "";						//!< 结果
+		std::vector<std::string> strCrowdVec;			//!< 测试添加的群演名称，结束时删除，不写入场景
+	};
+
+	/*!
+	*  @struct SGMFrameTiming
+	*  @brief 最近一帧各阶段的CPU耗时，单位：秒
+	*/
+	struct SGMFrameTiming
+	{
+		double fAudio = 0.0;							//!< 音频模块更新
+		double fModule = 0.0;							//!< 灯光、统一变量、后期、地形、模型更新
+		double fCharacter = 0.0;						//!< 角色与群演更新，并行模拟时只包括应用结果
+		double fSimulation = 0.0;						//!< 角色与群演的逻辑，并行模拟时在工作线程中与绘制重叠
+		double fEvent = 0.0;							//!< 事件遍历
+		double fUpdate = 0.0;							//!< 更新遍历，包括骨骼、蒙皮和变形动画
+		double fLater = 0.0;							//!< 主相机改变位置后的更新
+		double fRendering = 0.0;						//!< 剔除和绘制遍历
+	};
+
+	/*!
+	*  @struct SGMEngineStatus
+	*  @brief 渲染线程每帧结束时发布的状态，界面线程只读这份拷贝
+	*/
+	struct SGMEngineStatus
+	{
+		std::wstring strAudioName = L"";				//!< 当前音频文件名称
+		int iAudioCurrentTime = 0;						//!< 音频的播放位置，单位：ms
+		int iAudioDuration = 0;							//!< 音频的总时长，单位：ms
+		float fVolume = 0.0f;							//!< 音量，0.0-1.0
+		float fSwitchLatency = 0.0f;					//!< 最近一次切歌的延迟，单位：ms
+		bool bAudioOver = false;						//!< 音频是否播放完毕
+		bool bWelcomeFinished = false;					//!< “欢迎效果”是否结束
+		bool bRendering = true;							//!< 是否渲染
+		double fIdleTime = 0.0;							//!< 帧循环可以睡眠的时间，单位：秒
+	};
 
 	/*************************************************************************
 	Class
@@ -54,6 +109,15 @@ namespace GM
 	class CGMCharacter;
 	class CGMBaseManipulator;
 	class CGMAudio;
+	class CGMMusicAnalyzer;
+	class CGMMediaLibrary;
+	class CGMScene;
+	class CGMCapture;
+	class CGMSimulation;
+	class CGMScheduler;
+	class CGMPassCache;
+	struct SGMMusicGrid;
+	struct SGMViseme;
 
 	/*!
 	*  @class CGMEngine
@@ -72,8 +136,11 @@ namespace GM
 		/** @brief 获取单例 */
 		static CGMEngine& getSingleton(void);
 
-		/** @brief 初始化 */
-		bool Init();
+		/**
+		* @brief 初始化
+		* @param eAudioBackend: 音频后端，无界面模式使用文件后端，不需要声卡，离线导出使用导出后端
+		*/
+		bool Init(const EGMAUDIO_BACKEND eAudioBackend = EGMAUDIO_BACKEND_BASS);
 		/** @brief 释放 */
 		void Release();
 		/** @brief 更新 */
@@ -105,9 +172,15 @@ namespace GM
 		*  关闭是为了最小化时不浪费显卡资源
 		* @param bEnable: 是否开启渲染
 		*/
-		inline void SetRendering(const bool bEnable){ m_bRendering = bEnable;}
+		void SetRendering(const bool bEnable);
 		/* @brief 是否开启渲染 */
-		inline bool GetRendering() const{ return m_bRendering;}
+		bool GetRendering() const;
+		/**
+		* @brief 帧循环在下一次Update之前可以睡眠的时间
+		* 渲染时每帧都要更新，返回0；不渲染时返回距离下一个定时任务到期的时间
+		* @return double 单位：秒
+		*/
+		double GetIdleTime() const;
 		/* @brief 是否变成桌面背景 */
 		inline bool IsWallpaper() const { return m_pConfigData->bWallpaper; }
 
@@ -169,6 +242,11 @@ namespace GM
 		* @return bool 完毕返回true，未完毕返回false
 		*/
 		bool IsAudioOver() const;
+		/**
+		* @brief 获取最近一次切歌的延迟，单位：ms
+		* @return float: 手动切歌时为从请求到发声的时间，自动切歌时为两首之间的静音时长
+		*/
+		float GetAudioSwitchLatency() const;
 
 		/**
 		* @brief 开启“欢迎效果”
@@ -181,8 +259,110 @@ namespace GM
 		*/
 		bool IsWelcomeFinished() const;
 
+		/**
+		* @brief 添加一个与主角共享资源的角色（群演），共享网格与动画数据，只有姿态和状态是各自的
+		* @param strName: 角色在场景中的名称
+		* @param vPos: 角色的位置，单位：cm
+		* @return bool 成功true，失败false
+		*/
+		bool AddCharacter(const std::string& strName, const SGMVector3& vPos);
+		/**
+		* @brief 开始角色性能测试
+		* 依次让场景中有1、10、50个角色跳舞，统计每帧和每个角色的CPU、GPU开销
+		* @param strResultFile: 结果文件路径
+		*/
+		void StartCharacterBenchmark(const std::string& strResultFile = "CharacterBenchmark.txt");
+		/** @brief 角色性能测试是否正在进行 */
+		inline bool IsBenchmarkRunning() const { return m_sBenchmark.bRunning; }
+
+		/**
+		* @brief 开始录制引擎接口的调用和角色从音频模块得到的输入
+		* 同时用新的随机种子重置角色和媒体库的随机数，回放时使用同样的种子
+		* @param strFile: 日志文件路径
+		* @return bool 成功true，失败false
+		*/
+		bool StartRecord(const std::string& strFile);
+		/** @brief 结束录制，释放时也会自动结束 */
+		void StopRecord();
+		/**
+		* @brief 开始回放，之后每次Update先执行到时间的调用
+		* 回放期间角色只接受日志中的音频输入，与声卡和音频解码的快慢无关
+		* 配合 SetFixedTimeStep 使用，每次回放的结果完全相同
+		* @param strFile: 日志文件路径
+		* @return bool 成功true，文件不存在或者损坏返回false
+		*/
+		bool StartReplay(const std::string& strFile);
+		/** @brief 回放是否结束 */
+		inline bool IsReplayFinished() const { return !m_pRecorder->IsReplaying() || m_pRecorder->IsReplayFinished(); }
+		/** @brief 回放日志的总时长，单位：秒 */
+		inline double GetReplayDuration() const { return m_pRecorder->GetDuration() * 1e-3; }
+		/**
+		* @brief 设置角色和媒体库的随机种子
+		* @param iSeed: 随机种子
+		*/
+		void SetRandomSeed(const uint32_t iSeed);
+
+		/**
+		* @brief 截图，立即返回，一两帧后读回，在后台线程编码写入文件，不会卡住画面
+		* @param strFile: 图片文件路径，扩展名决定格式
+		* @param strTarget: 截图的对象，"screen"为最终画面，"scene"、"background"、"foreground"为对应的渲染目标
+		* @return bool 请求成功true，对象不存在返回false
+		*/
+		bool Capture(const std::string& strFile, const std::string& strTarget = "screen");
+
 		/** @brief 创建视口(QT:QWidget) */
 		CGMViewWidget* CreateViewWidget(QWidget* parent);
+		/**
+		* @brief 开启或关闭渲染线程，只能在界面线程中调用，桌面壁纸模式不支持
+		* 开启后Update在渲染线程中按固定的帧间隔执行，界面线程调用Update直接返回，
+		* 界面线程对引擎接口的调用转交给渲染线程，在下一帧之前执行，查询接口返回上一帧结束时的状态
+		* @param bEnable: 开启或关闭
+		* @param fFrameTime: 帧间隔，单位：秒，0表示由垂直同步控制帧率
+		* @return bool 成功true，没有视口或者壁纸模式返回false
+		*/
+		bool SetRenderThread(const bool bEnable, const double fFrameTime = 0.03);
+		/**
+		* @brief 开启或关闭并行模拟：第N帧剔除和绘制的同时，在工作线程中计算第N+1帧的角色逻辑和动画权重
+		* 开启后角色对输入的响应晚一帧，骨骼和蒙皮仍然在更新遍历中计算
+		* 录制和回放要使用相同的设置，画面才能一致
+		* @param bEnable: 开启或关闭
+		*/
+		void SetParallelSimulation(const bool bEnable);
+		/**
+		* @brief 开启或关闭RTT pass的缓存：相机和子图都没有变化的背景、前景和阴影pass跳过绘制，继续使用上一次的纹理
+		* @param bEnable: 开启或关闭，默认开启
+		*/
+		void SetPassCache(const bool bEnable);
+		/**
+		* @brief 无界面模式下创建离屏视口，渲染到单缓冲的pbuffer
+		* @param iWidth, iHeight: pbuffer的尺寸，单位：像素
+		* @return bool 成功true，驱动不支持pbuffer时返回false
+		*/
+		bool CreateHeadlessViewer(const int iWidth, const int iHeight);
+		/**
+		* @brief 设置固定时间步长，每次Update都按这个步长推进，不再读取真实时间
+		* 用于性能测试和画面比对，保证每次运行的结果相同
+		* @param fStep: 步长，单位：秒，小于等于0表示使用真实时间
+		*/
+		inline void SetFixedTimeStep(const double fStep) { m_fFixedStep = fStep; }
+		/**
+		* @brief 离线导出前的准备：跳过欢迎效果，切到指定的音频并等它发声，等待节拍分析完成
+		* 只能在Init(EGMAUDIO_BACKEND_EXPORT)之后、第一次Update之前调用
+		* @param wstrAudioFile: 音频文件名称，例如：xxx.mp3
+		* @return bool 成功true，文件打不开返回false
+		*/
+		bool PrepareExport(const std::wstring& wstrAudioFile);
+		/**
+		* @brief 离线导出时推进音频输出，每帧Update之前调用一次，步长和SetFixedTimeStep相同
+		* @param fSeconds: 推进的时长，单位：秒
+		*/
+		void AdvanceAudio(const double fSeconds);
+		/** @brief 获取异步截图模块 */
+		inline CGMCapture* GetCapture() const { return m_pCapture; }
+		/** @brief 获取最近一帧各阶段的CPU耗时 */
+		inline const SGMFrameTiming& GetFrameTiming() const { return m_sFrameTiming; }
+		/** @brief 获取主视口 */
+		inline osgViewer::View* GetView() const { return GM_View.get(); }
 
 	private:
 		/**
@@ -190,6 +370,13 @@ namespace GM
 		*/
 		bool _LoadConfig();
 		/**
+		* @brief 从场景文件恢复模型、灯光和角色，模型资源在后台线程中读取
+		* @return bool 成功true，没有场景文件或者文件损坏返回false
+		*/
+		bool _LoadScene();
+		/** @brief 没有场景文件时，创建默认场景并保存 */
+		void _CreateScene();
+		/**
 		* @brief 初始化背景相关节点
 		*/
 		void _InitBackground();
@@ -202,12 +389,82 @@ namespace GM
 		*/
 		void _Next(const EGMA_MODE eMode);
 		/**
+		* @brief 打开并播放某首音频，音频在后台打开，发声后由_OnAudioChanged通知角色
+		* @param wstrAudioFile: 音频文件名，相对于音乐目录
+		* @return bool 成功true，失败false
+		*/
+		bool _PlayAudio(const std::wstring& wstrAudioFile);
+		/**
+		* @brief 根据播放模式选出下一首
+		* @param eMode: 播放模式
+		* @return std::wstring 下一首的文件名，没有则返回L""
+		*/
+		std::wstring _GetNextAudio(const EGMA_MODE eMode);
+		/** @brief 新的音频开始发声后，所有角色的音乐时间从头开始，并预读下一首 */
+		void _OnAudioChanged();
+		/**
 		* @brief 间隔更新，一秒钟更新10次
 		* @param updateStep 两次间隔更新的时间差，单位s
 		*/
 		void _InnerUpdate(const float updateStep);
+		/** @brief 当前音频的节拍网格分析完成后，交给所有角色 */
+		void _UpdateMusicGrid();
 		/** @brief 更新(在主相机更新姿态之后) */
 		bool _UpdateLater(const double dDeltaTime);
+		/** @brief 开启/关闭所有角色的音乐 */
+		void _SetMusicEnable(const bool bEnable);
+		/** @brief 设置所有角色的音频总时长，单位：ms */
+		void _SetMusicDuration(const int iDuration);
+		/** @brief 设置所有角色的音频播放位置，单位：ms */
+		void _SetMusicCurrentTime(const int iTime);
+		/**
+		* @brief 把节拍网格交给所有角色
+		* @param pGrid: 节拍网格，空表示使用默认节拍
+		* @param wstrFile: 网格对应的音频文件名
+		*/
+		void _SetMusicGrid(std::shared_ptr<const SGMMusicGrid> pGrid, const std::wstring& wstrFile);
+		/** @brief 把口型交给所有角色 */
+		void _SetViseme(const SGMViseme& sViseme);
+		/**
+		* @brief 角色是否接受来自音频模块的实时输入
+		* 回放时只接受日志中的输入，实时的输入被忽略
+		*/
+		inline bool _AcceptInput() const { return !m_pRecorder->IsReplaying() || m_bReplayInput; }
+		/** @brief 录制时写入一个事件，时间为当前的录制时间 */
+		void _Record(SGMRecordEvent sEvent);
+		/** @brief 回放时执行所有到时间的事件 */
+		void _Replay();
+		/**
+		* @brief 回放时等待后台线程分析出节拍网格，保证和录制时在同一帧拿到网格
+		* @param wstrFile: 音频文件名
+		* @return 节拍网格，分析失败或者超时返回空
+		*/
+		std::shared_ptr<const SGMMusicGrid> _WaitMusicGrid(const std::wstring& wstrFile);
+		/**
+		* @brief 每帧更新角色性能测试
+		* @param fCPUTime: 本帧角色与动画更新的CPU时间，单位：秒
+		*/
+		void _UpdateBenchmark(const double fCPUTime);
+		/**
+		* @brief 删除一个群演，只能在模拟线程空闲时调用
+		* @param strName: 角色在场景中的名称
+		* @return bool 成功true，不存在false
+		*/
+		bool _RemoveCharacter(const std::string& strName);
+		/** @brief 模拟主角和群演的逻辑，结果写入各自的后台缓冲 */
+		void _SimulateCharacters(const double dDeltaTime);
+		/** @brief 应用主角和群演最近一次模拟的结果 */
+		void _ApplyCharacters();
+		/**
+		* @brief 渲染线程开启时，如果当前不在渲染线程中，把调用转交给渲染线程
+		* @param fCommand: 调用
+		* @return bool 已经转交true，调用者直接返回；否则false，调用者继续执行
+		*/
+		bool _Marshal(std::function<void()> fCommand);
+		/** @brief 渲染线程开启并且当前不在渲染线程中 */
+		bool _IsOutsideRenderThread() const;
+		/** @brief 渲染线程每帧结束时发布状态 */
+		void _PublishStatus();
 
 		// 变量
 	private:
@@ -220,12 +477,38 @@ namespace GM
 		bool								m_bRendering = true;			//!< 是否渲染
 		bool								m_bAudioOver = false;			//!< 音频是否结束
 		double								m_dTimeLastFrame = 0.0;			//!< 上一帧时间
+		double								m_fFixedStep = 0.0;				//!< 固定时间步长，单位：秒，0表示使用真实时间
+		double								m_dSimulationTime = 0.0;		//!< 固定时间步长下累计的仿真时间，单位：秒
+		SGMFrameTiming						m_sFrameTiming;					//!< 最近一帧各阶段的CPU耗时
+		CGMRecorder*						m_pRecorder = nullptr;			//!< 录制和回放
+		double								m_fRecordTime = 0.0;			//!< 从开始录制或者回放算起的时间，单位：秒
+		bool								m_bReplayInput = false;			//!< 正在执行回放的事件
+		uint32_t							m_iRandomSeed = 0;				//!< 录制或者回放使用的随机种子
+		SGMRecordEvent						m_sRecordViseme;				//!< 最近一次录制的口型，只在变化时录制
+		SGMVector2i							m_vReplayScreen;				//!< 回放时录制一方的屏幕尺寸，用于换算屏幕坐标
+		int									m_iMusicDuration = 0;			//!< 角色正在使用的音频总时长，单位：ms
 
 		CGMTerrain*							m_pTerrain = nullptr;			//!< 地形模块
 		CGMModel*							m_pModel = nullptr;				//!< 模型模块
 		CGMCharacter*						m_pCharacter = nullptr;			//!< 角色模块
+		std::vector<CGMCharacter*>			m_pCrowdVector;					//!< 群演，与主角共享资源的其他角色
+		CGMSimulation*						m_pSimulation = nullptr;		//!< 模拟阶段，与绘制重叠
+		CGMScheduler*						m_pScheduler = nullptr;			//!< 定时任务调度器
+		CGMPassCache*						m_pPassCache = nullptr;			//!< RTT pass的变化检测
+		SGMCharacterBenchmark				m_sBenchmark;					//!< 角色性能测试
 		CGMAudio*							m_pAudio = nullptr;				//!< 音频模块
+		CGMMusicAnalyzer*					m_pMusicAnalyzer = nullptr;		//!< 后台节拍分析
+		CGMMediaLibrary*					m_pMediaLibrary = nullptr;		//!< 媒体库
+		std::shared_ptr<const SGMMusicGrid>	m_pMusicGrid;					//!< 当前音频的节拍网格
+		std::wstring						m_strGridAudio = L"";			//!< 节拍网格对应的音频文件名
+		std::wstring						m_strNextAudio = L"";			//!< 已经交给音频模块预读的下一首
+		int									m_iAudioSerial = -1;			//!< 角色正在跟随的音频序号
 		CGMPost*							m_pPost = nullptr;				//!< 后期模块
+		CGMScene*							m_pScene = nullptr;				//!< 场景文件
+		CGMCapture*							m_pCapture = nullptr;			//!< 异步截图
+		CGMViewWidget*						m_pViewWidget = nullptr;		//!< 界面模式的视口，无界面模式为空
+		SGMEngineStatus						m_sStatus;						//!< 渲染线程发布的状态
+		mutable std::mutex					m_mutexStatus;					//!< 保护m_sStatus
 
 		EGMA_MODE							m_ePlayMode = EGMA_MOD_SINGLE;	//!< 当前播放模式
 		osg::ref_ptr<osg::Texture2D>		m_pSceneTex = nullptr;			//!< 主场景颜色图
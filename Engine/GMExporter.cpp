@@ -0,0 +1,378 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMExporter.cpp
+/// @brief		Galaxy-Music Engine - GMExporter
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMExporter.h"
+#include "GMEngine.h"
+#include "GMCapture.h"
+#include <osgDB/WriteFile>
+#include <osgDB/FileUtils>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+ Macro Defines
+*************************************************************************/
+
+#define EXPORT_MAX_ENCODING			8			// 读回后等待编码的最大帧数，超过时主线程等待，内存不会无限增长
+
+/*************************************************************************
+ Class
+*************************************************************************/
+
+/*!
+*  @class CGMExportSink
+*  @brief 视频文件的写入端，在截图的后台线程中转换格式
+*  @brief 两个后台线程完成的顺序不一定，Y4M和RAW的帧先按序号暂存，轮到时再写入
+*/
+class CGMExportSink
+{
+public:
+	/**
+	* @brief 打开视频文件
+	* @param sOption: 导出参数
+	* @return bool 成功true，文件打不开返回false
+	*/
+	bool Open(const SGMExportOption& sOption)
+	{
+		m_eFormat = sOption.eFormat;
+		m_strOutput = sOption.strOutput;
+		m_iWidth = sOption.iWidth;
+		m_iHeight = sOption.iHeight;
+		if (EGMEXPORT_PNG == m_eFormat)
+		{
+			return osgDB::makeDirectory(m_strOutput);
+		}
+
+		osgDB::makeDirectoryForFile(m_strOutput);
+		m_fOut.open(m_strOutput, std::ios::binary);
+		if (!m_fOut.is_open()) return false;
+		if (EGMEXPORT_Y4M == m_eFormat)
+		{
+			// C420jpeg：全范围的BT.601，色度取2x2像素的中心
+			m_fOut << "YUV4MPEG2 W" << m_iWidth << " H" << m_iHeight << " F" << sOption.iFPS << ":1 Ip A1:1 C420jpeg\n";
+		}
+		return bool(m_fOut);
+	}
+
+	/**
+	* @brief 写入一帧，在截图的后台线程中调用
+	* @param iIndex: 帧序号，从0开始
+	* @param pImage: 读回的画面，RGBA，自下而上
+	*/
+	void Push(const int iIndex, const osg::Image* pImage)
+	{
+		if (!pImage || pImage->s() != m_iWidth || pImage->t() != m_iHeight
+			|| GL_RGBA != pImage->getPixelFormat() || GL_UNSIGNED_BYTE != pImage->getDataType())
+		{
+			std::cout << "Export: frame " << iIndex << " has wrong size or format" << std::endl;
+			return;
+		}
+
+		if (EGMEXPORT_PNG == m_eFormat)
+		{
+			char szName[32];
+			snprintf(szName, sizeof(szName), "/frame_%06d.png", iIndex);
+			if (osgDB::writeImageFile(*pImage, m_strOutput + szName))
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_iWritten++;
+			}
+			else
+			{
+				std::cout << "Export: can not write " << m_strOutput + szName << std::endl;
+			}
+			return;
+		}
+
+		std::vector<unsigned char> vFrame;
+		if (EGMEXPORT_Y4M == m_eFormat)
+			_ToYUV420(pImage, vFrame);
+		else
+			_ToRGBA(pImage, vFrame);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_frameMap[iIndex].swap(vFrame);
+		auto itr = m_frameMap.find(m_iNext);
+		while (m_frameMap.end() != itr)
+		{
+			if (EGMEXPORT_Y4M == m_eFormat) m_fOut << "FRAME\n";
+			m_fOut.write(reinterpret_cast<const char*>(itr->second.data()), std::streamsize(itr->second.size()));
+			if (m_fOut) m_iWritten++;
+			m_frameMap.erase(itr);
+			itr = m_frameMap.find(++m_iNext);
+		}
+	}
+
+	/**
+	* @brief 关闭文件
+	* @return int 按顺序写入的帧数，中间缺了一帧时后面的帧都不会写入
+	*/
+	int Close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_fOut.is_open()) m_fOut.close();
+		m_frameMap.clear();
+		return m_iWritten;
+	}
+
+private:
+	/** @brief RGBA，翻转成自上而下 */
+	void _ToRGBA(const osg::Image* pImage, std::vector<unsigned char>& vFrame) const
+	{
+		const size_t iRow = size_t(m_iWidth) * 4;
+		vFrame.resize(iRow * m_iHeight);
+		for (int y = 0; y < m_iHeight; y++)
+		{
+			memcpy(&vFrame[iRow * y], pImage->data(0, m_iHeight - 1 - y), iRow);
+		}
+	}
+
+	/** @brief 全范围的BT.601 YUV420，翻转成自上而下，定点数计算 */
+	void _ToYUV420(const osg::Image* pImage, std::vector<unsigned char>& vFrame) const
+	{
+		const int iW = m_iWidth;
+		const int iH = m_iHeight;
+		const size_t iLuma = size_t(iW) * iH;
+		const size_t iChroma = iLuma / 4;
+		vFrame.resize(iLuma + 2 * iChroma);
+		unsigned char* pY = vFrame.data();
+		unsigned char* pU = pY + iLuma;
+		unsigned char* pV = pU + iChroma;
+
+		for (int y = 0; y < iH; y += 2)
+		{
+			const unsigned char* pRow0 = pImage->data(0, iH - 1 - y);
+			const unsigned char* pRow1 = pImage->data(0, iH - 2 - y);
+			unsigned char* pY0 = pY + size_t(y) * iW;
+			unsigned char* pY1 = pY0 + iW;
+			for (int x = 0; x < iW; x += 2)
+			{
+				const unsigned char* p[4] = { pRow0 + 4 * x, pRow0 + 4 * x + 4, pRow1 + 4 * x, pRow1 + 4 * x + 4 };
+				int iR = 0, iG = 0, iB = 0;
+				for (int k = 0; k < 4; k++)
+				{
+					iR += p[k][0];
+					iG += p[k][1];
+					iB += p[k][2];
+				}
+				pY0[x] = _Luma(p[0]);
+				pY0[x + 1] = _Luma(p[1]);
+				pY1[x] = _Luma(p[2]);
+				pY1[x + 1] = _Luma(p[3]);
+
+				// 4个像素的和，系数再除以4，加上偏移保证右移前是正数，不加舍入项，满幅时不会溢出
+				const size_t iC = size_t(y / 2) * (iW / 2) + x / 2;
+				pU[iC] = static_cast<unsigned char>((-43 * iR - 85 * iG + 128 * iB + (128 << 10)) >> 10);
+				pV[iC] = static_cast<unsigned char>((128 * iR - 107 * iG - 21 * iB + (128 << 10)) >> 10);
+			}
+		}
+	}
+
+	/** @brief 亮度 */
+	static inline unsigned char _Luma(const unsigned char* p)
+	{
+		return static_cast<unsigned char>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+	}
+
+private:
+	EGMEXPORT_FORMAT								m_eFormat = EGMEXPORT_Y4M;
+	std::string										m_strOutput = "";
+	int												m_iWidth = 0;
+	int												m_iHeight = 0;
+	std::mutex										m_mutex;
+	std::ofstream									m_fOut;
+	std::map<int, std::vector<unsigned char>>		m_frameMap;			//!< 提前完成、还没轮到写入的帧
+	int												m_iNext = 0;		//!< 下一个要写入的帧序号
+	int												m_iWritten = 0;		//!< 已经写入的帧数
+};
+
+/*************************************************************************
+ CGMExporter Methods
+*************************************************************************/
+
+bool CGMExporter::ParseArgs(int argc, char** argv, SGMExportOption& sOption)
+{
+	bool bOutput = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string strArg = argv[i];
+		if (i + 1 >= argc)
+		{
+			continue;
+		}
+		else if ("--export" == strArg)
+		{
+			sOption.strAudio = argv[++i];
+		}
+		else if ("--duration" == strArg)
+		{
+			sOption.fDuration = std::atof(argv[++i]);
+		}
+		else if ("--fps" == strArg)
+		{
+			sOption.iFPS = std::atoi(argv[++i]);
+		}
+		else if ("--width" == strArg)
+		{
+			sOption.iWidth = std::atoi(argv[++i]);
+		}
+		else if ("--height" == strArg)
+		{
+			sOption.iHeight = std::atoi(argv[++i]);
+		}
+		else if ("--format" == strArg)
+		{
+			const std::string strFormat = argv[++i];
+			if ("y4m" == strFormat)
+				sOption.eFormat = EGMEXPORT_Y4M;
+			else if ("raw" == strFormat)
+				sOption.eFormat = EGMEXPORT_RAW;
+			else if ("png" == strFormat)
+				sOption.eFormat = EGMEXPORT_PNG;
+			else
+				return false;
+		}
+		else if ("--output" == strArg)
+		{
+			sOption.strOutput = argv[++i];
+			bOutput = true;
+		}
+	}
+	// 没有指定输出时，按格式换一个默认名称
+	if (!bOutput)
+	{
+		if (EGMEXPORT_RAW == sOption.eFormat) sOption.strOutput = "Export.rgba";
+		else if (EGMEXPORT_PNG == sOption.eFormat) sOption.strOutput = "Export";
+	}
+
+	// YUV420的色度是2x2采样，宽高都要是偶数
+	return !sOption.strAudio.empty() && sOption.fDuration >= 0.0
+		&& (30 == sOption.iFPS || 60 == sOption.iFPS)
+		&& sOption.iWidth > 0 && sOption.iHeight > 0
+		&& (EGMEXPORT_Y4M != sOption.eFormat || (0 == sOption.iWidth % 2 && 0 == sOption.iHeight % 2))
+		&& !sOption.strOutput.empty();
+}
+
+int CGMExporter::Run(const SGMExportOption& sOption)
+{
+#if defined(_WIN32)
+	std::wstring wstrAudio(MultiByteToWideChar(CP_ACP, 0, sOption.strAudio.c_str(), -1, nullptr, 0), L'\0');
+	MultiByteToWideChar(CP_ACP, 0, sOption.strAudio.c_str(), -1, &wstrAudio[0], int(wstrAudio.size()));
+	wstrAudio.resize(wcslen(wstrAudio.c_str()));
+#else
+	const std::wstring wstrAudio(sOption.strAudio.begin(), sOption.strAudio.end());
+#endif
+	const double fStep = 1.0 / sOption.iFPS;
+
+	if (!GM_ENGINE.Init(EGMAUDIO_BACKEND_EXPORT))
+	{
+		std::cout << "Export: engine init failed" << std::endl;
+		return 1;
+	}
+	if (!GM_ENGINE.CreateHeadlessViewer(sOption.iWidth, sOption.iHeight))
+	{
+		std::cout << "Export: offscreen pbuffer is not supported by the OpenGL driver" << std::endl;
+		GM_ENGINE.Release();
+		return 1;
+	}
+	GM_ENGINE.SetFixedTimeStep(fStep);
+	if (!GM_ENGINE.PrepareExport(wstrAudio))
+	{
+		std::cout << "Export: can not open audio " << sOption.strAudio << std::endl;
+		GM_ENGINE.Release();
+		return 1;
+	}
+
+	CGMExportSink sink;
+	if (!sink.Open(sOption))
+	{
+		std::cout << "Export: can not open " << sOption.strOutput << std::endl;
+		GM_ENGINE.Release();
+		return 1;
+	}
+
+	// 截图请求要在Update之前发出，本帧绘制结束时读取
+	CGMCapture* pCapture = GM_ENGINE.GetCapture();
+	pCapture->SetFrameExact(true);
+	osg::Timer* pTimer = osg::Timer::instance();
+	osg::Timer_t tStart = pTimer->tick();
+	int iTotal = 1;
+	int iCaptured = 0;
+	bool bStarted = true;
+	for (int i = 0; i < iTotal; i++)
+	{
+		// 编码跟不上时等待，不丢帧
+		while (pCapture->GetEncodingNum() > EXPORT_MAX_ENCODING)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		if (pCapture->Capture(CAPTURE_TARGET_SCREEN, [&sink, i](osg::Image* pImage) { sink.Push(i, pImage); }))
+			iCaptured++;
+		GM_ENGINE.AdvanceAudio(fStep);
+		GM_ENGINE.Update();
+
+		if (0 == i)
+		{
+			// 第一帧之后音频已经发声，时长才有效
+			if (wstrAudio != GM_ENGINE.GetAudioName())
+			{
+				std::cout << "Export: audio " << sOption.strAudio << " did not start" << std::endl;
+				bStarted = false;
+				break;
+			}
+			const double fAudio = 1e-3 * GM_ENGINE.GetAudioDuration();
+			const double fDuration = (sOption.fDuration > 0.0) ? fmin(sOption.fDuration, fAudio) : fAudio;
+			iTotal = int(fmax(1.0, std::ceil(fDuration * sOption.iFPS - 1e-6)));
+		}
+		if (0 == (i + 1) % sOption.iFPS)
+		{
+			std::cout << "Export: " << i + 1 << "/" << iTotal << " frames, "
+				<< (i + 1) / pTimer->delta_s(tStart, pTimer->tick()) << " fps" << std::endl;
+		}
+	}
+
+	// 最后一帧之后不会再有绘制，多画一帧（不截取）收取所有的读取，再等后台线程写完
+	pCapture->Flush();
+	GM_ENGINE.Update();
+	while (pCapture->GetPendingNum() > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	const int iWritten = sink.Close();
+	const double fTime = pTimer->delta_s(tStart, pTimer->tick());
+	GM_ENGINE.Release();
+
+	std::cout << "Export: " << iWritten << "/" << iTotal << " frames written to " << sOption.strOutput
+		<< " in " << fTime << " s" << std::endl;
+	if (EGMEXPORT_RAW == sOption.eFormat)
+	{
+		std::cout << "Export: rawvideo rgba " << sOption.iWidth << "x" << sOption.iHeight
+			<< " " << sOption.iFPS << " fps" << std::endl;
+	}
+	if (!bStarted || iWritten <= 0) return 1;
+	return (iWritten == iTotal && iCaptured == iTotal) ? 0 : 2;
+}
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMExporter.h
+/// @brief		Galaxy-Music Engine - GMExporter
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+
+namespace GM
+{
+	/*************************************************************************
+	 Enums
+	*************************************************************************/
+
+	// 导出的视频格式
+	enum EGMEXPORT_FORMAT
+	{
+		EGMEXPORT_Y4M,			// YUV4MPEG2，YUV420全范围，播放器和ffmpeg都能直接读
+		EGMEXPORT_RAW,			// 没有文件头的RGBA，自上而下逐行存放
+		EGMEXPORT_PNG			// PNG序列，每帧一个文件
+	};
+
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMExportOption
+	*  @brief 离线导出视频的参数，都可以用命令行参数修改
+	*/
+	struct SGMExportOption
+	{
+		std::string			strAudio = "";							//!< 音频文件名称，在媒体库的音频目录下，--export
+		double				fDuration = 0.0;						//!< 导出的时长，单位：秒，0表示整首，--duration
+		int					iFPS = 60;								//!< 帧率，30或者60，--fps
+		int					iWidth = 1920;							//!< 画面宽度，--width
+		int					iHeight = 1080;							//!< 画面高度，--height
+		EGMEXPORT_FORMAT	eFormat = EGMEXPORT_Y4M;				//!< 视频格式，y4m、raw或者png，--format
+		std::string			strOutput = "Export.y4m";				//!< 视频文件，PNG序列时是目录，--output
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMExporter
+	*  @brief 离线导出视频：引擎渲染到离屏pbuffer，按1/帧率的固定步长推进，
+	*  @brief 音频输出也由导出程序推进，画面、节拍和口型与实时速度无关，
+	*  @brief 每帧通过异步截图读回，后台线程按帧序写入视频文件，不会丢帧
+	*  @brief 只输出画面，音轨用原始音频文件另外合成
+	*/
+	class CGMExporter
+	{
+		// 函数
+	public:
+		/**
+		* @brief 解析命令行参数，没有出现的参数保持默认值
+		* @param argc, argv: main函数的参数
+		* @param sOption: 输出，导出参数
+		* @return bool 成功true，参数的值无效返回false
+		*/
+		static bool ParseArgs(int argc, char** argv, SGMExportOption& sOption);
+		/**
+		* @brief 导出视频
+		* @param sOption: 导出参数
+		* @return int 进程返回值，0成功，1初始化、打开音频或者写文件失败，2有帧没有写入
+		*/
+		static int Run(const SGMExportOption& sOption);
+	};
+}	// GM
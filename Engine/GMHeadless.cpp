@@ -0,0 +1,517 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMHeadless.cpp
+/// @brief		Galaxy-Music Engine - GMHeadless
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMHeadless.h"
+#include "GMEngine.h"
+#include "GMNodeVisitor.h"
+#include <osg/GLExtensions>
+#include <osg/FrameBufferObject>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+#include <osgDB/FileNameUtils>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+ Macro Defines
+*************************************************************************/
+
+#define HEADLESS_STATS_DELAY		3			// osg统计结果滞后的帧数
+#define HEADLESS_QUERY_LATENCY		4			// GPU时间戳查询结果滞后的帧数
+
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP				0x8E28
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT				0x8866
+#endif
+
+/*************************************************************************
+ Class
+*************************************************************************/
+
+/*!
+*  @class CGMPassTimer
+*  @brief 用GPU时间戳记录每个相机（即每个渲染pass）的绘制时间
+*  @brief 相机开始绘制和结束绘制时各写一个时间戳，几帧之后再取结果，不会让CPU等待GPU
+*/
+class CGMPassTimer : public osg::Referenced
+{
+public:
+	/** @brief 一个pass的查询对象，按帧号轮流使用 */
+	struct SGMPassQuery
+	{
+		std::string					strName = "";
+		osg::ref_ptr<osg::Camera>	pCamera;
+		GLuint						iBegin[HEADLESS_QUERY_LATENCY] = { 0 };
+		GLuint						iEnd[HEADLESS_QUERY_LATENCY] = { 0 };
+		int							iFrame[HEADLESS_QUERY_LATENCY] = { -1, -1, -1, -1 };
+		bool						bEnded[HEADLESS_QUERY_LATENCY] = { false };
+		bool						bCreated = false;
+		std::vector<std::pair<unsigned int, double>>	resultVec;		//!< 帧号，耗时（毫秒）
+	};
+
+	/** @brief 写时间戳的回调 */
+	class CGMStampCallback : public osg::Camera::DrawCallback
+	{
+	public:
+		CGMStampCallback(CGMPassTimer* pTimer, const size_t iPass, const bool bEnd)
+			: m_pTimer(pTimer), m_iPass(iPass), m_bEnd(bEnd)
+		{}
+
+		virtual void operator() (osg::RenderInfo& renderInfo) const
+		{
+			m_pTimer->Stamp(renderInfo, m_iPass, m_bEnd);
+		}
+
+	private:
+		CGMPassTimer*		m_pTimer;
+		size_t				m_iPass;
+		bool				m_bEnd;
+	};
+
+	/**
+	* @brief 给相机挂上时间戳回调，已经有绘制回调的相机跳过，避免覆盖引擎自己的回调
+	* @param pCamera: 相机
+	* @param strName: pass的名称
+	*/
+	void Attach(osg::Camera* pCamera, const std::string& strName)
+	{
+		if (!pCamera || pCamera->getInitialDrawCallback() || pCamera->getFinalDrawCallback()) return;
+		for (auto& itr : m_passVec)
+		{
+			if (itr.pCamera.get() == pCamera) return;
+		}
+
+		SGMPassQuery sPass;
+		sPass.strName = strName;
+		sPass.pCamera = pCamera;
+		m_passVec.push_back(sPass);
+		pCamera->setInitialDrawCallback(new CGMStampCallback(this, m_passVec.size() - 1, false));
+		pCamera->setFinalDrawCallback(new CGMStampCallback(this, m_passVec.size() - 1, true));
+	}
+
+	/** @brief 取下所有回调 */
+	void Detach()
+	{
+		for (auto& itr : m_passVec)
+		{
+			itr.pCamera->setInitialDrawCallback(nullptr);
+			itr.pCamera->setFinalDrawCallback(nullptr);
+		}
+	}
+
+	/** @brief 在绘制线程中写时间戳，同时取回同一槽位上一轮的结果 */
+	void Stamp(osg::RenderInfo& renderInfo, const size_t iPass, const bool bEnd)
+	{
+		osg::State* pState = renderInfo.getState();
+		const osg::GLExtensions* pExt = pState->get<osg::GLExtensions>();
+		if (!pExt || !pExt->isARBTimerQuerySupported || !pState->getFrameStamp()) return;
+
+		SGMPassQuery& sPass = m_passVec[iPass];
+		if (!sPass.bCreated)
+		{
+			pExt->glGenQueries(HEADLESS_QUERY_LATENCY, sPass.iBegin);
+			pExt->glGenQueries(HEADLESS_QUERY_LATENCY, sPass.iEnd);
+			sPass.bCreated = true;
+		}
+
+		const int iFrame = int(pState->getFrameStamp()->getFrameNumber());
+		const int iSlot = iFrame % HEADLESS_QUERY_LATENCY;
+		if (bEnd)
+		{
+			if (iFrame != sPass.iFrame[iSlot]) return;
+			pExt->glQueryCounter(sPass.iEnd[iSlot], GL_TIMESTAMP);
+			sPass.bEnded[iSlot] = true;
+			return;
+		}
+
+		if (sPass.iFrame[iSlot] >= 0 && sPass.bEnded[iSlot])
+		{
+			GLuint64 iBeginTime = 0;
+			GLuint64 iEndTime = 0;
+			pExt->glGetQueryObjectui64v(sPass.iBegin[iSlot], GL_QUERY_RESULT, &iBeginTime);
+			pExt->glGetQueryObjectui64v(sPass.iEnd[iSlot], GL_QUERY_RESULT, &iEndTime);
+			if (iEndTime >= iBeginTime)
+			{
+				sPass.resultVec.push_back(std::make_pair(
+					static_cast<unsigned int>(sPass.iFrame[iSlot]), 1e-6 * double(iEndTime - iBeginTime)));
+			}
+		}
+		pExt->glQueryCounter(sPass.iBegin[iSlot], GL_TIMESTAMP);
+		sPass.iFrame[iSlot] = iFrame;
+		sPass.bEnded[iSlot] = false;
+	}
+
+	/** @brief 获取所有pass */
+	inline const std::vector<SGMPassQuery>& GetPasses() const { return m_passVec; }
+
+private:
+	std::vector<SGMPassQuery>		m_passVec;
+};
+
+/*************************************************************************
+ Global Functions
+*************************************************************************/
+
+/**
+* @brief 写一组耗时的统计值：平均值、分位数和最大值，分位数按最近秩计算
+* @param fOut: 输出流
+* @param vData: 耗时，单位：毫秒
+*/
+static void WriteSummary(std::ostream& fOut, std::vector<double> vData)
+{
+	if (vData.empty())
+	{
+		fOut << "null";
+		return;
+	}
+	std::sort(vData.begin(), vData.end());
+	double fSum = 0.0;
+	for (auto& itr : vData) fSum += itr;
+
+	auto Percentile = [&vData](const double fP)
+	{
+		size_t iRank = size_t(std::ceil(fP * vData.size()));
+		return vData[min(vData.size(), max(size_t(1), iRank)) - 1];
+	};
+
+	fOut << "{ \"count\": " << vData.size()
+		<< ", \"mean\": " << fSum / vData.size()
+		<< ", \"p50\": " << Percentile(0.5)
+		<< ", \"p90\": " << Percentile(0.9)
+		<< ", \"p95\": " << Percentile(0.95)
+		<< ", \"p99\": " << Percentile(0.99)
+		<< ", \"max\": " << vData.back() << " }";
+}
+
+/** @brief JSON字符串转义 */
+static std::string JsonString(const std::string& str)
+{
+	std::string strOut = "\"";
+	for (auto& c : str)
+	{
+		if ('"' == c || '\\' == c) strOut += '\\';
+		if (static_cast<unsigned char>(c) < 0x20) continue;
+		strOut += c;
+	}
+	return strOut + "\"";
+}
+
+/*************************************************************************
+ CGMHeadless Methods
+*************************************************************************/
+
+bool CGMHeadless::ParseArgs(int argc, char** argv, SGMHeadlessOption& sOption)
+{
+	bool bFrames = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string strArg = argv[i];
+		const bool bHasValue = (i + 1 < argc);
+		if ("--update-golden" == strArg)
+		{
+			sOption.bUpdateGolden = true;
+		}
+		else if (!bHasValue)
+		{
+			continue;
+		}
+		else if ("--frames" == strArg)
+		{
+			sOption.iFrames = std::atoi(argv[++i]);
+			bFrames = true;
+		}
+		else if ("--warmup" == strArg)
+		{
+			sOption.iWarmup = std::atoi(argv[++i]);
+		}
+		else if ("--step" == strArg)
+		{
+			sOption.fStep = std::atof(argv[++i]);
+		}
+		else if ("--width" == strArg)
+		{
+			sOption.iWidth = std::atoi(argv[++i]);
+		}
+		else if ("--height" == strArg)
+		{
+			sOption.iHeight = std::atoi(argv[++i]);
+		}
+		else if ("--output" == strArg)
+		{
+			sOption.strOutput = argv[++i];
+		}
+		else if ("--golden" == strArg)
+		{
+			sOption.strGolden = argv[++i];
+		}
+		else if ("--tolerance" == strArg)
+		{
+			sOption.iTolerance = std::atoi(argv[++i]);
+		}
+		else if ("--replay" == strArg)
+		{
+			sOption.strReplay = argv[++i];
+		}
+	}
+	// 回放时没有指定帧数，就一直运行到日志结束
+	if (!sOption.strReplay.empty() && !bFrames)
+		sOption.iFrames = 0;
+
+	return (sOption.iFrames > 0 || (0 == sOption.iFrames && !sOption.strReplay.empty())) && sOption.iWarmup >= 0 && sOption.fStep > 0.0
+		&& sOption.iWidth > 0 && sOption.iHeight > 0
+		&& sOption.iTolerance >= 0 && sOption.iTolerance <= 255
+		&& !sOption.strOutput.empty();
+}
+
+int CGMHeadless::Run(const SGMHeadlessOption& sOption)
+{
+	osg::Timer* pTimer = osg::Timer::instance();
+
+	// 加载时间：引擎初始化（配置、场景和模型资源），离屏视口和后期，第一帧（着色器编译和纹理上传）
+	osg::Timer_t tStart = pTimer->tick();
+	if (!GM_ENGINE.Init(EGMAUDIO_BACKEND_FILE))
+	{
+		std::cout << "Headless: engine init failed" << std::endl;
+		return 1;
+	}
+	const double fInitTime = pTimer->delta_m(tStart, pTimer->tick());
+
+	tStart = pTimer->tick();
+	if (!GM_ENGINE.CreateHeadlessViewer(sOption.iWidth, sOption.iHeight))
+	{
+		std::cout << "Headless: offscreen pbuffer is not supported by the OpenGL driver" << std::endl;
+		GM_ENGINE.Release();
+		return 1;
+	}
+	const double fViewerTime = pTimer->delta_m(tStart, pTimer->tick());
+	GM_ENGINE.SetFixedTimeStep(sOption.fStep);
+
+	osgViewer::View* pView = GM_ENGINE.GetView();
+	osg::Camera* pMainCam = pView->getCamera();
+	osg::Stats* pStats = pMainCam->getStats();
+	if (pStats)
+	{
+		pStats->collectStats("rendering", true);
+		pStats->collectStats("gpu", true);
+	}
+
+	tStart = pTimer->tick();
+	GM_ENGINE.Update();
+	const double fFirstFrameTime = pTimer->delta_m(tStart, pTimer->tick());
+
+	// 第一帧之后场景里的相机都已经创建，给每个相机挂上GPU时间戳
+	osg::ref_ptr<CGMPassTimer> pPassTimer = new CGMPassTimer();
+	pPassTimer->Attach(pMainCam, pMainCam->getName().empty() ? "mainCamera" : pMainCam->getName());
+	CGMMultiNodeVisitor<osg::Camera> cameraVisitor;
+	pView->getSceneData()->accept(cameraVisitor);
+	for (auto& itr : cameraVisitor.GetResult())
+	{
+		pPassTimer->Attach(itr, itr->getName().empty() ? ("camera_" + std::to_string(pPassTimer->GetPasses().size())) : itr->getName());
+	}
+
+	std::vector<double> frameVec;
+	std::vector<double> audioVec, moduleVec, characterVec, eventVec, updateVec, laterVec, renderingVec;
+	std::vector<double> cullVec, drawVec, gpuVec;
+	unsigned int iMeasureFrame = 0;
+	const bool bUntilReplayEnd = (0 == sOption.iFrames);
+	for (int i = 0; bUntilReplayEnd ? (i <= sOption.iWarmup || !GM_ENGINE.IsReplayFinished()) : (i < sOption.iWarmup + sOption.iFrames); i++)
+	{
+		if (i == sOption.iWarmup)
+		{
+			iMeasureFrame = pView->getFrameStamp()->getFrameNumber() + 1;
+			// 预热之后再回放，统计的帧和日志从同一时刻开始
+			if (!sOption.strReplay.empty() && !GM_ENGINE.StartReplay(sOption.strReplay))
+			{
+				std::cout << "Headless: can not load replay file " << sOption.strReplay << std::endl;
+				pPassTimer->Detach();
+				GM_ENGINE.Release();
+				return 1;
+			}
+		}
+
+		osg::Timer_t tFrame = pTimer->tick();
+		GM_ENGINE.Update();
+		const double fFrameTime = pTimer->delta_m(tFrame, pTimer->tick());
+		if (i < sOption.iWarmup) continue;
+
+		frameVec.push_back(fFrameTime);
+		const SGMFrameTiming& sTiming = GM_ENGINE.GetFrameTiming();
+		audioVec.push_back(1e3 * sTiming.fAudio);
+		moduleVec.push_back(1e3 * sTiming.fModule);
+		characterVec.push_back(1e3 * sTiming.fCharacter);
+		eventVec.push_back(1e3 * sTiming.fEvent);
+		updateVec.push_back(1e3 * sTiming.fUpdate);
+		laterVec.push_back(1e3 * sTiming.fLater);
+		renderingVec.push_back(1e3 * sTiming.fRendering);
+
+		// osg的剔除、绘制和GPU计时要等几帧后才能取到
+		const unsigned int iFrameNum = pView->getFrameStamp()->getFrameNumber();
+		if (pStats && iFrameNum >= iMeasureFrame + HEADLESS_STATS_DELAY)
+		{
+			const unsigned int iStatsFrame = iFrameNum - HEADLESS_STATS_DELAY;
+			double fValue = 0.0;
+			if (pStats->getAttribute(iStatsFrame, "Cull traversal time taken", fValue)) cullVec.push_back(1e3 * fValue);
+			if (pStats->getAttribute(iStatsFrame, "Draw traversal time taken", fValue)) drawVec.push_back(1e3 * fValue);
+			if (pStats->getAttribute(iStatsFrame, "GPU draw time taken", fValue)) gpuVec.push_back(1e3 * fValue);
+		}
+	}
+	pPassTimer->Detach();
+
+	// 读取最后一帧的画面，单缓冲的pbuffer画完后前缓冲就是结果
+	std::string strGoldenStatus = "";
+	int iDiffPixels = 0;
+	int iMaxDiff = 0;
+	if (!sOption.strGolden.empty())
+	{
+		osg::ref_ptr<osg::Image> pImage = new osg::Image();
+		osg::GraphicsContext* pGC = pMainCam->getGraphicsContext();
+		pGC->makeCurrent();
+		const osg::GLExtensions* pExt = pGC->getState()->get<osg::GLExtensions>();
+		if (pExt && pExt->isFrameBufferObjectSupported)
+			pExt->glBindFramebuffer(GL_FRAMEBUFFER_EXT, 0);
+		glReadBuffer(GL_FRONT);
+		pImage->readPixels(0, 0, sOption.iWidth, sOption.iHeight, GL_RGBA, GL_UNSIGNED_BYTE);
+		pGC->releaseContext();
+
+		osg::ref_ptr<osg::Image> pGolden = sOption.bUpdateGolden ? nullptr : osgDB::readImageFile(sOption.strGolden);
+		if (!pGolden.valid())
+		{
+			strGoldenStatus = osgDB::writeImageFile(*pImage, sOption.strGolden) ? "written" : "write_failed";
+		}
+		else if (pGolden->s() != pImage->s() || pGolden->t() != pImage->t()
+			|| GL_RGBA != pGolden->getPixelFormat() || GL_UNSIGNED_BYTE != pGolden->getDataType())
+		{
+			strGoldenStatus = "format_mismatch";
+		}
+		else
+		{
+			const unsigned char* pA = pImage->data();
+			const unsigned char* pB = pGolden->data();
+			const size_t iPixels = size_t(pImage->s()) * pImage->t();
+			for (size_t p = 0; p < iPixels; p++)
+			{
+				int iPixelDiff = 0;
+				for (int c = 0; c < 4; c++)
+				{
+					iPixelDiff = max(iPixelDiff, std::abs(int(pA[4 * p + c]) - int(pB[4 * p + c])));
+				}
+				iMaxDiff = max(iMaxDiff, iPixelDiff);
+				if (iPixelDiff > sOption.iTolerance) iDiffPixels++;
+			}
+			strGoldenStatus = iDiffPixels ? "mismatch" : "match";
+		}
+		// 不一致时保存本次画面，方便对比
+		if ("match" != strGoldenStatus && "written" != strGoldenStatus)
+		{
+			const std::string strActual = osgDB::getNameLessExtension(sOption.strGolden) + "_actual."
+				+ osgDB::getFileExtension(sOption.strGolden);
+			osgDB::writeImageFile(*pImage, strActual);
+		}
+	}
+
+	std::ofstream fOut(sOption.strOutput);
+	if (fOut.is_open())
+	{
+		fOut << std::fixed << std::setprecision(4);
+		fOut << "{\n";
+		fOut << "  \"frames\": " << frameVec.size() << ",\n";
+		fOut << "  \"replay\": " << (sOption.strReplay.empty() ? std::string("null") : JsonString(sOption.strReplay)) << ",\n";
+		fOut << "  \"warmup\": " << sOption.iWarmup << ",\n";
+		fOut << "  \"step_s\": " << sOption.fStep << ",\n";
+		fOut << "  \"width\": " << sOption.iWidth << ",\n";
+		fOut << "  \"height\": " << sOption.iHeight << ",\n";
+		fOut << "  \"load_ms\": { \"engine_init\": " << fInitTime
+			<< ", \"viewer\": " << fViewerTime
+			<< ", \"first_frame\": " << fFirstFrameTime << " },\n";
+		fOut << "  \"peak_memory_mb\": " << double(_PeakMemory()) / (1024.0 * 1024.0) << ",\n";
+		fOut << "  \"frame_ms\": "; WriteSummary(fOut, frameVec); fOut << ",\n";
+		fOut << "  \"cpu_ms\": {\n";
+		fOut << "    \"audio\": "; WriteSummary(fOut, audioVec); fOut << ",\n";
+		fOut << "    \"module\": "; WriteSummary(fOut, moduleVec); fOut << ",\n";
+		fOut << "    \"character\": "; WriteSummary(fOut, characterVec); fOut << ",\n";
+		fOut << "    \"event\": "; WriteSummary(fOut, eventVec); fOut << ",\n";
+		fOut << "    \"update\": "; WriteSummary(fOut, updateVec); fOut << ",\n";
+		fOut << "    \"later\": "; WriteSummary(fOut, laterVec); fOut << ",\n";
+		fOut << "    \"rendering\": "; WriteSummary(fOut, renderingVec); fOut << "\n";
+		fOut << "  },\n";
+		fOut << "  \"viewer_ms\": {\n";
+		fOut << "    \"cull\": "; WriteSummary(fOut, cullVec); fOut << ",\n";
+		fOut << "    \"draw\": "; WriteSummary(fOut, drawVec); fOut << ",\n";
+		fOut << "    \"gpu\": "; WriteSummary(fOut, gpuVec); fOut << "\n";
+		fOut << "  },\n";
+		fOut << "  \"gpu_pass_ms\": {";
+		const std::vector<CGMPassTimer::SGMPassQuery>& vPass = pPassTimer->GetPasses();
+		for (size_t i = 0; i < vPass.size(); i++)
+		{
+			std::vector<double> vTime;
+			for (auto& itr : vPass[i].resultVec)
+			{
+				if (itr.first >= iMeasureFrame) vTime.push_back(itr.second);
+			}
+			fOut << (i ? ",\n    " : "\n    ") << JsonString(vPass[i].strName) << ": ";
+			WriteSummary(fOut, vTime);
+		}
+		fOut << (vPass.empty() ? "},\n" : "\n  },\n");
+		if (sOption.strGolden.empty())
+		{
+			fOut << "  \"golden\": null\n";
+		}
+		else
+		{
+			fOut << "  \"golden\": { \"file\": " << JsonString(sOption.strGolden)
+				<< ", \"status\": " << JsonString(strGoldenStatus)
+				<< ", \"tolerance\": " << sOption.iTolerance
+				<< ", \"diff_pixels\": " << iDiffPixels
+				<< ", \"max_diff\": " << iMaxDiff << " }\n";
+		}
+		fOut << "}\n";
+		fOut.close();
+	}
+
+	GM_ENGINE.Release();
+
+	if (!fOut) return 1;
+	if ("mismatch" == strGoldenStatus || "format_mismatch" == strGoldenStatus || "write_failed" == strGoldenStatus) return 2;
+	return 0;
+}
+
+size_t CGMHeadless::_PeakMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS sCounters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &sCounters, sizeof(sCounters)))
+		return sCounters.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage sUsage;
+	if (0 == getrusage(RUSAGE_SELF, &sUsage))
+		return size_t(sUsage.ru_maxrss) * 1024;
+	return 0;
+#endif
+}
@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMHeadless.h
+/// @brief		Galaxy-Music Engine - GMHeadless
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMHeadlessOption
+	*  @brief 无界面性能测试的参数，都可以用命令行参数修改
+	*/
+	struct SGMHeadlessOption
+	{
+		int				iFrames = 600;								//!< 统计的帧数，0表示回放到日志结束，--frames
+		int				iWarmup = 60;								//!< 统计前的预热帧数，--warmup
+		double			fStep = 1.0 / 60.0;							//!< 固定时间步长，单位：秒，--step
+		int				iWidth = 1280;								//!< 离屏画面宽度，--width
+		int				iHeight = 720;								//!< 离屏画面高度，--height
+		std::string		strOutput = "HeadlessBenchmark.json";		//!< 结果文件，--output
+		std::string		strGolden = "";								//!< 基准画面，为空不比对，--golden
+		bool			bUpdateGolden = false;						//!< 用本次画面覆盖基准画面，--update-golden
+		int				iTolerance = 0;								//!< 每个通道允许的最大差值，0-255，--tolerance
+		std::string		strReplay = "";								//!< 预热后回放的输入日志，为空不回放，--replay
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMHeadless
+	*  @brief 无界面的性能测试：不需要Qt窗口和Steam，引擎渲染到离屏pbuffer，
+	*  @brief 按固定步长运行指定帧数，输出帧时间分位数、各阶段耗时、内存峰值和加载时间的JSON，
+	*  @brief 可以和基准画面逐像素比对，验证优化没有改变画面
+	*/
+	class CGMHeadless
+	{
+		// 函数
+	public:
+		/**
+		* @brief 解析命令行参数，没有出现的参数保持默认值
+		* @param argc, argv: main函数的参数
+		* @param sOption: 输出，测试参数
+		* @return bool 成功true，参数的值无效返回false
+		*/
+		static bool ParseArgs(int argc, char** argv, SGMHeadlessOption& sOption);
+		/**
+		* @brief 运行测试并写结果文件
+		* @param sOption: 测试参数
+		* @return int 进程返回值，0成功，1初始化或者写文件失败，2画面和基准不一致
+		*/
+		static int Run(const SGMHeadlessOption& sOption);
+
+	private:
+		/** @brief 当前进程的内存峰值，单位：字节，不支持的平台返回0 */
+		static size_t _PeakMemory();
+	};
+}	// GM
@@ -26,6 +26,9 @@ namespace GM
 	/*************************************************************************
 	 Struct
 	*************************************************************************/
+	class CGMScheduler;
+	class CGMPassCache;
+
 	/*!
 	 *  @struct SGMKernelData
 	 *  @brief 内核数据
@@ -35,9 +38,11 @@ namespace GM
 		bool										bInited = false;	//!< 是否初始化
 		osg::ref_ptr<osg::Group>					vRoot;				//!< 根节点
 		osg::ref_ptr<osgViewer::View>				vView;				//!< 视口
-		osg::ref_ptr<CGMViewWidget>					vViewer;			//!< 视口管理器
+		osg::ref_ptr<osgViewer::CompositeViewer>	vViewer;			//!< 视口管理器，界面模式是CGMViewWidget，无界面模式是离屏的CompositeViewer
 		osg::ref_ptr<osg::Camera>					pBackgroundCam;		//!< 背景RTT相机
 		osg::ref_ptr<osg::Camera>					pForegroundCam;		//!< 前景RTT相机
+		CGMScheduler*								pScheduler = nullptr;	//!< 引擎的定时任务调度器，在主线程中推进
+		CGMPassCache*								pPassCache = nullptr;	//!< RTT pass的变化检测，输入不变的pass跳过绘制
 	};
 
 }	// GM
@@ -13,9 +13,250 @@
 #include "GMKit.h"
 #include "GMDispatchCompute.h"
 #include <osgDB/ReadFile>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define GM_KIT_F16C
+#endif
 
 using namespace GM;
 
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#ifndef GL_RG
+#define GL_RG						0x8227
+#endif
+#ifndef GL_BGR
+#define GL_BGR						0x80E0
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA						0x80E1
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT				0x140B
+#endif
+
+#define KIT_BENCH_REPEAT			20			// 性能测试每种运算的重复次数
+#define KIT_BENCH_HALF_NUM			(1 << 20)	// 性能测试转换的浮点数数量
+#define KIT_BENCH_IMAGE_SIZE		512			// 性能测试图片的边长
+#define KIT_BENCH_GRID_SIZE			256			// 性能测试采样网格的边长
+
+/*************************************************************************
+Structs
+*************************************************************************/
+
+/*!
+ *  @struct SGMSampleGrid
+ *  @brief 批量采样的规则网格
+ */
+struct SGMSampleGrid
+{
+	float fX0;					//!< 第一个采样点的x坐标
+	float fY0;					//!< 第一个采样点的y坐标
+	float fStepX;				//!< 相邻采样点的x间隔
+	float fStepY;				//!< 相邻采样点的y间隔
+	int iNumX;					//!< 每行的采样点数量
+	int iNumY;					//!< 每列的采样点数量
+	bool bLinear;				//!< 是否双线性插值
+};
+
+/*!
+ *  @struct SGMSampleTap
+ *  @brief 一行或者一列采样点在图片上的位置，和CGMKit::GetImageColor的取整规则相同
+ */
+struct SGMSampleTap
+{
+	unsigned int i0 = 0;		//!< 临近值的像素，或者双线性插值的第一个像素
+	unsigned int i1 = 0;		//!< 双线性插值的第二个像素
+	float fDelta = 0.0f;		//!< 双线性插值的系数
+	bool bValid = false;		//!< 坐标是否在[0,1]之内
+};
+
+/** @brief 通道的读取方式，和osg::Image::getColor相同，整数按最大值归一化 */
+struct SGMChannelU8
+{
+	typedef unsigned char type;
+	static inline float Read(const type v) { return static_cast<float>(v) * (1.0f / 255.0f); }
+};
+struct SGMChannelU16
+{
+	typedef unsigned short type;
+	static inline float Read(const type v) { return static_cast<float>(v) * (1.0f / 65535.0f); }
+};
+struct SGMChannelHalf
+{
+	typedef unsigned short type;
+	static inline float Read(const type v) { return CGMKit::Half_2_Float(v); }
+};
+struct SGMChannelF32
+{
+	typedef float type;
+	static inline float Read(const type v) { return v; }
+};
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+/** @brief 读取一个像素，通道的排列和缺省值与osg::Image::getColor相同 */
+template<typename TChannel, GLenum eFormat>
+static inline osg::Vec4f ReadPixel(const typename TChannel::type* p)
+{
+	switch (eFormat)
+	{
+	case GL_LUMINANCE:
+	{
+		const float fL = TChannel::Read(p[0]);
+		return osg::Vec4f(fL, fL, fL, 1.0f);
+	}
+	case GL_ALPHA:
+		return osg::Vec4f(1.0f, 1.0f, 1.0f, TChannel::Read(p[0]));
+	case GL_RED:
+		return osg::Vec4f(TChannel::Read(p[0]), 1.0f, 1.0f, 1.0f);
+	case GL_RG:
+		return osg::Vec4f(TChannel::Read(p[0]), TChannel::Read(p[1]), 1.0f, 1.0f);
+	case GL_LUMINANCE_ALPHA:
+	{
+		const float fL = TChannel::Read(p[0]);
+		return osg::Vec4f(fL, fL, fL, TChannel::Read(p[1]));
+	}
+	case GL_RGB:
+		return osg::Vec4f(TChannel::Read(p[0]), TChannel::Read(p[1]), TChannel::Read(p[2]), 1.0f);
+	case GL_RGBA:
+		return osg::Vec4f(TChannel::Read(p[0]), TChannel::Read(p[1]), TChannel::Read(p[2]), TChannel::Read(p[3]));
+	case GL_BGR:
+		return osg::Vec4f(TChannel::Read(p[2]), TChannel::Read(p[1]), TChannel::Read(p[0]), 1.0f);
+	case GL_BGRA:
+		return osg::Vec4f(TChannel::Read(p[2]), TChannel::Read(p[1]), TChannel::Read(p[0]), TChannel::Read(p[3]));
+	default:
+		return osg::Vec4f(1.0f, 1.0f, 1.0f, 1.0f);
+	}
+}
+
+/** @brief 计算一行或者一列采样点在图片上的位置 */
+static void ComputeTaps(const float fStart, const float fStep, const int iNum, const unsigned int iSize,
+	const bool bLinear, std::vector<SGMSampleTap>& tapVec)
+{
+	tapVec.resize(iNum);
+	for (int i = 0; i < iNum; i++)
+	{
+		const float fCoord = fStart + i * fStep;
+		SGMSampleTap& sTap = tapVec[i];
+		sTap.bValid = (fCoord >= 0 && fCoord <= 1);
+		if (!sTap.bValid) continue;
+
+		const float fPixel = fmax(0.0f, fCoord * iSize - 0.5f);
+		const unsigned int iPixel = static_cast<unsigned int>(fPixel);
+		sTap.fDelta = fPixel - iPixel;
+		if (bLinear)
+		{
+			sTap.i0 = iPixel;
+			sTap.i1 = osg::minimum(iSize - 1, iPixel + 1);
+		}
+		else
+		{
+			sTap.i0 = osg::minimum(iSize - 1, iPixel + ((sTap.fDelta > 0.5f) ? 1 : 0));
+			sTap.i1 = sTap.i0;
+		}
+	}
+}
+
+/** @brief 按像素格式和数据类型特化的网格采样 */
+template<typename TChannel, GLenum eFormat, int iChannels>
+static void SampleGrid(const osg::Image* pImg, const SGMSampleGrid& sGrid, osg::Vec4f* pOut)
+{
+	typedef typename TChannel::type T;
+	std::vector<SGMSampleTap> tapXVec;
+	std::vector<SGMSampleTap> tapYVec;
+	ComputeTaps(sGrid.fX0, sGrid.fStepX, sGrid.iNumX, pImg->s(), sGrid.bLinear, tapXVec);
+	ComputeTaps(sGrid.fY0, sGrid.fStepY, sGrid.iNumY, pImg->t(), sGrid.bLinear, tapYVec);
+
+	for (int j = 0; j < sGrid.iNumY; j++)
+	{
+		osg::Vec4f* pOutRow = pOut + size_t(j) * sGrid.iNumX;
+		const SGMSampleTap& sTapY = tapYVec[j];
+		if (!sTapY.bValid)
+		{
+			std::fill(pOutRow, pOutRow + sGrid.iNumX, osg::Vec4f(0, 0, 0, 0));
+			continue;
+		}
+
+		const T* pRow0 = reinterpret_cast<const T*>(pImg->data(0, sTapY.i0));
+		const T* pRow1 = reinterpret_cast<const T*>(pImg->data(0, sTapY.i1));
+		for (int i = 0; i < sGrid.iNumX; i++)
+		{
+			const SGMSampleTap& sTapX = tapXVec[i];
+			if (!sTapX.bValid)
+			{
+				pOutRow[i] = osg::Vec4f(0, 0, 0, 0);
+			}
+			else if (sGrid.bLinear) // 双线性插值
+			{
+				const osg::Vec4f vValue00 = ReadPixel<TChannel, eFormat>(pRow0 + sTapX.i0 * iChannels);
+				const osg::Vec4f vValue10 = ReadPixel<TChannel, eFormat>(pRow0 + sTapX.i1 * iChannels);
+				const osg::Vec4f vValue01 = ReadPixel<TChannel, eFormat>(pRow1 + sTapX.i0 * iChannels);
+				const osg::Vec4f vValue11 = ReadPixel<TChannel, eFormat>(pRow1 + sTapX.i1 * iChannels);
+				pOutRow[i] = CGMKit::Mix(
+					CGMKit::Mix(vValue00, vValue10, sTapX.fDelta),
+					CGMKit::Mix(vValue01, vValue11, sTapX.fDelta),
+					sTapY.fDelta);
+			}
+			else // 临近值
+			{
+				pOutRow[i] = ReadPixel<TChannel, eFormat>(pRow0 + sTapX.i0 * iChannels);
+			}
+		}
+	}
+}
+
+/**
+* @brief 按像素格式分派
+* @return bool 支持这种像素格式返回true
+*/
+template<typename TChannel>
+static bool SampleGridFormat(const osg::Image* pImg, const SGMSampleGrid& sGrid, osg::Vec4f* pOut)
+{
+	switch (pImg->getPixelFormat())
+	{
+	case GL_DEPTH_COMPONENT:
+	case GL_LUMINANCE:			SampleGrid<TChannel, GL_LUMINANCE, 1>(pImg, sGrid, pOut); return true;
+	case GL_ALPHA:				SampleGrid<TChannel, GL_ALPHA, 1>(pImg, sGrid, pOut); return true;
+	case GL_RED:				SampleGrid<TChannel, GL_RED, 1>(pImg, sGrid, pOut); return true;
+	case GL_RG:					SampleGrid<TChannel, GL_RG, 2>(pImg, sGrid, pOut); return true;
+	case GL_LUMINANCE_ALPHA:	SampleGrid<TChannel, GL_LUMINANCE_ALPHA, 2>(pImg, sGrid, pOut); return true;
+	case GL_RGB:				SampleGrid<TChannel, GL_RGB, 3>(pImg, sGrid, pOut); return true;
+	case GL_RGBA:				SampleGrid<TChannel, GL_RGBA, 4>(pImg, sGrid, pOut); return true;
+	case GL_BGR:				SampleGrid<TChannel, GL_BGR, 3>(pImg, sGrid, pOut); return true;
+	case GL_BGRA:				SampleGrid<TChannel, GL_BGRA, 4>(pImg, sGrid, pOut); return true;
+	default:					return false;
+	}
+}
+
+/** @brief 计时，单位：ms */
+template<typename F>
+static double Measure(F func)
+{
+	const auto tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < KIT_BENCH_REPEAT; i++)
+	{
+		func();
+	}
+	const auto tEnd = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+}
+
+/*************************************************************************
+CGMKit Methods
+*************************************************************************/
+
 std::map<std::string, osg::ref_ptr<osg::Program>>	CGMKit::_pProgramMap;
 
 bool CGMKit::LoadShader(
@@ -94,7 +335,8 @@ bool CGMKit::LoadShaderWithCommonFrag(osg::StateSet * pStateSet,
 	const std::string & fragFilePath,
 	const std::string & fragCommonFilePath,
 	const bool bForceUpdate,
-	const bool bPixelLighting)
+	const bool bPixelLighting,
+	const std::string & vertCommonFilePath)
 {
 	std::string shaderName = GetProgramName(vertFilePath, fragFilePath);
 	osg::StateAttribute::GLModeValue value = osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE;
@@ -126,6 +368,12 @@ bool CGMKit::LoadShaderWithCommonFrag(osg::StateSet * pStateSet,
 	osg::Shader* pVertShader = new osg::Shader;
 	pVertShader->setType(osg::Shader::VERTEX);
 	std::string vertOut = _ReadShaderFile(vertFilePath);
+
+	if ("" != vertCommonFilePath)
+	{
+		std::string vertCommonOut = _ReadShaderFile(vertCommonFilePath);
+		vertOut = vertCommonOut + vertOut;
+	}
 	pVertShader->setShaderSource(vertOut);
 
 	osg::Shader* pFragShader = new osg::Shader;
@@ -274,8 +522,12 @@ bool CGMKit::AddImageTexture(CGMDispatchCompute* pCompute, osg::Texture* pTex, c
 	if (!pStateSet) return false;
 
 	pStateSet->addUniform(new osg::Uniform(texName, unit));
-	pStateSet->setAttributeAndModes(new osg::BindImageTexture(unit, pTex, access, format, level, layered, layer));
-	pCompute->GetTextureMap().insert(std::make_pair(unit, pTex));
+	EGMCOMPUTE_ACCESS eAccess = EGMCOMPUTE_READ_WRITE;
+	if (osg::BindImageTexture::READ_ONLY == access) eAccess = EGMCOMPUTE_READ;
+	else if (osg::BindImageTexture::WRITE_ONLY == access) eAccess = EGMCOMPUTE_WRITE;
+	// 写入的图像之后一般会被采样，dispatch后屏障纹理读取
+	pCompute->addImage(unit, pTex, eAccess, format, level, layered, layer,
+		(eAccess & EGMCOMPUTE_WRITE) ? GL_TEXTURE_FETCH_BARRIER_BIT : 0);
 
 	return true;
 }
@@ -331,6 +583,159 @@ unsigned short CGMKit::Float_2_Half(const float x)
 	return (b & 0x80000000) >> 16 | (e > 112) * ((((e - 112) << 10) & 0x7C00) | m >> 13) | ((e < 113) & (e > 101)) * ((((0x007FF000 + m) >> (125 - e)) + 1) >> 1) | (e > 143) * 0x7FFF; // sign : normalized : denormalized : saturate
 }
 
+void CGMKit::GetImageColors(const osg::Image* pImg, const float fX0, const float fY0, const float fStepX, const float fStepY,
+	const int iNumX, const int iNumY, osg::Vec4f* pOut, const bool bLinear)
+{
+	if (iNumX <= 0 || iNumY <= 0 || !pOut) return;
+
+	const SGMSampleGrid sGrid = { fX0, fY0, fStepX, fStepY, iNumX, iNumY, bLinear };
+	bool bDone = false;
+	if (pImg && pImg->data() && pImg->s() > 0 && pImg->t() > 0)
+	{
+		switch (pImg->getDataType())
+		{
+		case GL_UNSIGNED_BYTE:	bDone = SampleGridFormat<SGMChannelU8>(pImg, sGrid, pOut); break;
+		case GL_UNSIGNED_SHORT:	bDone = SampleGridFormat<SGMChannelU16>(pImg, sGrid, pOut); break;
+		case GL_HALF_FLOAT:		bDone = SampleGridFormat<SGMChannelHalf>(pImg, sGrid, pOut); break;
+		case GL_FLOAT:			bDone = SampleGridFormat<SGMChannelF32>(pImg, sGrid, pOut); break;
+		default:				break;
+		}
+	}
+	if (bDone) return;
+
+	// 不支持的格式逐点采样
+	for (int j = 0; j < iNumY; j++)
+	{
+		for (int i = 0; i < iNumX; i++)
+		{
+			pOut[size_t(j) * iNumX + i] = GetImageColor(pImg, fX0 + i * fStepX, fY0 + j * fStepY, bLinear);
+		}
+	}
+}
+
+void CGMKit::Half_2_Float(const unsigned short* pIn, float* pOut, const size_t iNum)
+{
+	size_t i = 0;
+#ifdef GM_KIT_F16C
+	static const bool s_bF16C = _HasF16C();
+	if (s_bF16C)
+	{
+		for (; i + 4 <= iNum; i += 4)
+		{
+			const __m128i vHalf = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pIn + i));
+			_mm_storeu_ps(pOut + i, _mm_cvtph_ps(vHalf));
+		}
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pOut[i] = Half_2_Float(pIn[i]);
+	}
+}
+
+void CGMKit::Float_2_Half(const float* pIn, unsigned short* pOut, const size_t iNum)
+{
+	size_t i = 0;
+#ifdef GM_KIT_F16C
+	static const bool s_bF16C = _HasF16C();
+	if (s_bF16C)
+	{
+		for (; i + 4 <= iNum; i += 4)
+		{
+			const __m128i vHalf = _mm_cvtps_ph(_mm_loadu_ps(pIn + i), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(pOut + i), vHalf);
+		}
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pOut[i] = Float_2_Half(pIn[i]);
+	}
+}
+
+bool CGMKit::Benchmark(const std::string& strResultFile)
+{
+	std::ostringstream ssResult;
+	ssResult << "op\tcount\tscalar_ms\tbulk_ms\tspeedup\n";
+	auto Report = [&ssResult](const char* szName, const int iCount, const double fScalar, const double fBulk)
+	{
+		ssResult << szName << "\t" << iCount * KIT_BENCH_REPEAT << "\t"
+			<< fScalar << "\t" << fBulk << "\t" << fScalar / fmax(fBulk, 1e-6) << "\n";
+	};
+
+	// 半精度转换
+	std::vector<float> fDataVec(KIT_BENCH_HALF_NUM);
+	std::vector<float> fOutVec(KIT_BENCH_HALF_NUM);
+	std::vector<unsigned short> iHalfVec(KIT_BENCH_HALF_NUM);
+	for (int i = 0; i < KIT_BENCH_HALF_NUM; i++)
+	{
+		fDataVec[i] = std::sin(i * 1e-3f) * 100.0f;
+	}
+	Report("float_2_half", KIT_BENCH_HALF_NUM,
+		Measure([&]() {
+			for (int i = 0; i < KIT_BENCH_HALF_NUM; i++)
+			{
+				iHalfVec[i] = Float_2_Half(fDataVec[i]);
+			}
+		}),
+		Measure([&]() { Float_2_Half(fDataVec.data(), iHalfVec.data(), KIT_BENCH_HALF_NUM); }));
+	Report("half_2_float", KIT_BENCH_HALF_NUM,
+		Measure([&]() {
+			for (int i = 0; i < KIT_BENCH_HALF_NUM; i++)
+			{
+				fOutVec[i] = Half_2_Float(iHalfVec[i]);
+			}
+		}),
+		Measure([&]() { Half_2_Float(iHalfVec.data(), fOutVec.data(), KIT_BENCH_HALF_NUM); }));
+
+	// 图片采样：颜色图和高度图
+	osg::ref_ptr<osg::Image> pColorImg = new osg::Image;
+	pColorImg->allocateImage(KIT_BENCH_IMAGE_SIZE, KIT_BENCH_IMAGE_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+	osg::ref_ptr<osg::Image> pHeightImg = new osg::Image;
+	pHeightImg->allocateImage(KIT_BENCH_IMAGE_SIZE, KIT_BENCH_IMAGE_SIZE, 1, GL_LUMINANCE, GL_FLOAT);
+	unsigned char* pColor = pColorImg->data();
+	float* pHeight = reinterpret_cast<float*>(pHeightImg->data());
+	for (int i = 0; i < KIT_BENCH_IMAGE_SIZE * KIT_BENCH_IMAGE_SIZE; i++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			pColor[i * 4 + c] = static_cast<unsigned char>((i * (c + 1) * 37) & 0xFF);
+		}
+		pHeight[i] = std::sin(i * 1e-2f);
+	}
+
+	const int iGridNum = KIT_BENCH_GRID_SIZE * KIT_BENCH_GRID_SIZE;
+	const float fStep = 1.0f / KIT_BENCH_GRID_SIZE;
+	std::vector<osg::Vec4f> vColorVec(iGridNum);
+	struct SGMBenchImage { const char* szName; const osg::Image* pImg; bool bLinear; };
+	const SGMBenchImage sImageArray[] = {
+		{ "sample_rgba8_nearest", pColorImg.get(), false },
+		{ "sample_rgba8_linear", pColorImg.get(), true },
+		{ "sample_height32f_linear", pHeightImg.get(), true } };
+	for (const SGMBenchImage& sImage : sImageArray)
+	{
+		Report(sImage.szName, iGridNum,
+			Measure([&]() {
+				for (int j = 0; j < KIT_BENCH_GRID_SIZE; j++)
+				{
+					for (int i = 0; i < KIT_BENCH_GRID_SIZE; i++)
+					{
+						vColorVec[j * KIT_BENCH_GRID_SIZE + i] = GetImageColor(sImage.pImg, i * fStep, j * fStep, sImage.bLinear);
+					}
+				}
+			}),
+			Measure([&]() {
+				GetImageColors(sImage.pImg, 0.0f, 0.0f, fStep, fStep,
+					KIT_BENCH_GRID_SIZE, KIT_BENCH_GRID_SIZE, vColorVec.data(), sImage.bLinear);
+			}));
+	}
+
+	std::ofstream outFile(strResultFile);
+	if (!outFile.is_open()) return false;
+	outFile << ssResult.str();
+	return outFile.good();
+}
+
 /** Replaces all the instances of "sub" with "other" in "s". */
 std::string& CGMKit::_ReplaceIn(std::string& s, const std::string& sub, const std::string& other)
 {
@@ -389,6 +794,20 @@ osg::Program* CGMKit::GetProgram(const std::string& strProgramName)
 	return nullptr;
 }
 
+bool CGMKit::_HasF16C()
+{
+#ifdef GM_KIT_F16C
+	int iInfo[4] = { 0 };
+	__cpuid(iInfo, 1);
+	const bool bF16C = 0 != (iInfo[2] & (1 << 29));
+	const bool bOSXSave = 0 != (iInfo[2] & (1 << 27));
+	// F16C是VEX编码的指令，还需要操作系统保存AVX寄存器
+	return bF16C && bOSXSave && (0x6 == (_xgetbv(0) & 0x6));
+#else
+	return false;
+#endif
+}
+
 std::string CGMKit::_ReadShaderFile(const std::string& filePath)
 {
 	FILE* vertStream = fopen(filePath.data(), "rb");
@@ -57,6 +57,7 @@ namespace GM
         * @param fragCommonFilePath:	the optional common fragment file path
         * @param shaderName:			name of shader
         * @param bPixelLighting:		be pixel lighting(for tangent & binormal)
+        * @param vertCommonFilePath:	the optional common vertex file path
         * @return bool:					成功为true，否则false
         */
         static bool LoadShaderWithCommonFrag(
@@ -65,7 +66,8 @@ namespace GM
             const std::string& fragFilePath,
             const std::string& fragCommonFilePath,
             const bool bForceUpdate = false,
-            const bool bPixelLighting = false);
+            const bool bPixelLighting = false,
+            const std::string& vertCommonFilePath = "");
 
         /**
         * @brief 加载shader
@@ -132,6 +134,24 @@ namespace GM
             const osg::Image* pImg,
             const float fX, const float fY,
             const bool bLinear = false);
+        /**
+        * @brief 批量获取图片上一个规则网格的RGBA通道值，每个点的结果和GetImageColor相同
+        * 按像素格式和数据类型特化，直接读取像素，不再逐点调用osg::Image::getColor
+        * 另外支持GL_HALF_FLOAT，其他不支持的格式逐点调用GetImageColor
+        * @param pImg:				图片指针
+        * @param fX0, fY0:			第一个采样点的图像坐标,[0,1]
+        * @param fStepX, fStepY:	相邻采样点的坐标间隔
+        * @param iNumX, iNumY:		网格每行、每列的采样点数量
+        * @param pOut:				输出，iNumX*iNumY个RGBA通道值，按行存放
+        * @param bLinear:			是否双线性插值，true = 双线性，false = 临近值
+        */
+        static void GetImageColors(
+            const osg::Image* pImg,
+            const float fX0, const float fY0,
+            const float fStepX, const float fStepY,
+            const int iNumX, const int iNumY,
+            osg::Vec4f* pOut,
+            const bool bLinear = false);
 
         /**
         * @brief 根据输入的着色器路径名称，自动生成program的名字
@@ -160,6 +180,30 @@ namespace GM
         * @return unsigned short：	16F
         */
         static unsigned short Float_2_Half(const float x);
+        /**
+        * @brief 批量 16F 转 32F，CPU支持F16C时一次转换4个
+        * F16C把指数全1当作无穷大和NaN，只有这些值的结果和标量版本不同
+        * @param pIn:		16F
+        * @param pOut:		32F
+        * @param iNum:		数量
+        */
+        static void Half_2_Float(const unsigned short* pIn, float* pOut, const size_t iNum);
+        /**
+        * @brief 批量 32F 转 16F，CPU支持F16C时一次转换4个
+        * F16C按IEEE舍入到最近的偶数，超出范围时得到无穷大，
+        * 只有正好在两个16F中间的值和超出±65504的值结果和标量版本不同
+        * @param pIn:		32F
+        * @param pOut:		16F
+        * @param iNum:		数量
+        */
+        static void Float_2_Half(const float* pIn, unsigned short* pOut, const size_t iNum);
+
+        /**
+        * @brief 性能测试，比较逐个转换、逐点采样和批量接口的耗时
+        * @param strResultFile:		结果文件路径
+        * @return bool:				成功为true，写文件失败为false
+        */
+        static bool Benchmark(const std::string& strResultFile = "KitBenchmark.txt");
 
         /**
         * @brief 混合函数,参考 glsl 中的 mix(a,b,x)
@@ -196,6 +240,8 @@ namespace GM
         /** Replaces all the instances of "sub" with "other" in "s". */
         static std::string& _ReplaceIn(std::string& s, const std::string& sub, const std::string& other);
         static std::string _ReadShaderFile(const std::string& filePath);
+        /** @brief CPU和操作系统是否支持F16C指令 */
+        static bool _HasF16C();
 
         inline static unsigned int AsUint(const float x) { return *(unsigned int*)&x; }
         inline static float AsFloat(const unsigned int x) { return *(float*)&x; }
@@ -10,6 +10,8 @@
 /// @date		2024.10.21
 //////////////////////////////////////////////////////////////////////////
 #include "GMLight.h"
+#include "GMScene.h"
+#include "GMPassCache.h"
 
 #include <osg/Texture2D>
 #include <osg/CullFace>
@@ -191,6 +193,17 @@ bool CGMLight::Find(SLightData& sData)
 	return false;
 }
 
+bool CGMLight::Save(SGMSceneData& sScene) const
+{
+	sScene.lightVec.clear();
+	sScene.lightVec.reserve(m_mapLight.size());
+	for (auto& itr : m_mapLight)
+	{
+		sScene.lightVec.push_back(itr.second);
+	}
+	return true;
+}
+
 bool CGMLight::SetLightEnable(osg::Node* pNode, bool bEnable)
 {
 	osg::StateSet* pSS = pNode->getStateSet();
@@ -282,4 +295,7 @@ void CGMLight::_InitShadow()
 	pShadowSS->setAttributeAndModes(new osg::CullFace(osg::CullFace::FRONT), iValue);
 
 	GM_Root->addChild(m_pShadowCamera.get());
+	// 灯光和投射阴影的模型都不动时，阴影贴图不用重绘
+	if (m_pKernelData->pPassCache)
+		m_pKernelData->pPassCache->Add(m_pShadowCamera.get());
 }
\ No newline at end of file
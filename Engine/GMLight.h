@@ -140,6 +140,8 @@ namespace GM
 	 Class
 	*************************************************************************/
 
+	struct SGMSceneData;
+
 	/*!
 	 *  @brief GM Light Module
 	 */
@@ -179,6 +181,12 @@ namespace GM
 		* @return bool:		是否找到该名称的灯光
 		*/
 		bool Find(SLightData& sData);
+		/**
+		* @brief 保存，把所有灯光的数据按名称顺序写入场景
+		* @param sScene:	输出，场景内容
+		* @return bool:		成功返回true，失败返回false
+		*/
+		bool Save(SGMSceneData& sScene) const;
 
 		/**
 		* @brief 设置多光源光照
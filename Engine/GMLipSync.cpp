@@ -0,0 +1,267 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMLipSync.cpp
+/// @brief		Galaxy-Music Engine - GMLipSync
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.24
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMLipSync.h"
+#include "GMCommon.h"
+#include "GMSpectrum.h"
+#include <cmath>
+#include <chrono>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define LIP_RING_BLOCKS				512			// 队列能存放的块数，大约3秒
+#define LIP_FFT_SIZE				1024		// FFT窗口大小，单位：采样
+#define LIP_HOP_SIZE				512			// 相邻两帧的间隔，单位：采样
+#define LIP_IDLE_SLEEP				4			// 没有数据时分析线程的休眠时间，单位：ms
+#define LIP_STALE_FRAMES			8192		// 结果比播放位置早这么多帧就不再使用
+#define LIP_SILENCE_DB				-80.0f		// 低于这个能量就认为是静音，单位：dB
+#define LIP_MIN_RANGE_DB			12.0f		// 峰值和底噪之间的最小动态范围，单位：dB
+#define LIP_PEAK_FALL				6.0f		// 峰值每秒下降的分贝数
+#define LIP_FLOOR_RISE				3.0f		// 底噪每秒上升的分贝数
+#define LIP_ATTACK_TIME				0.02f		// 张嘴的平滑时间，单位：s
+#define LIP_RELEASE_TIME			0.08f		// 闭嘴的平滑时间，单位：s
+#define LIP_ROUND_TIME				0.06f		// 圆唇程度的平滑时间，单位：s
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+static inline float Saturate(const float f)
+{
+	return fmin(1.0f, fmax(0.0f, f));
+}
+
+static inline uint64_t PackUnorm(const float f, const int iShift)
+{
+	return uint64_t(Saturate(f) * 65535.0f + 0.5f) << iShift;
+}
+
+static inline float UnpackUnorm(const uint64_t i, const int iShift)
+{
+	return float((i >> iShift) & 0xFFFF) / 65535.0f;
+}
+
+/*************************************************************************
+CGMLipSync Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMLipSync::CGMLipSync() : m_blockRing(LIP_RING_BLOCKS)
+{
+}
+
+/** @brief 析构 */
+CGMLipSync::~CGMLipSync()
+{
+	Release();
+}
+
+/** @brief 初始化 */
+bool CGMLipSync::Init()
+{
+	m_pSpectrum = new CGMSpectrum(LIP_FFT_SIZE);
+	m_powerVec.resize(LIP_FFT_SIZE / 2 + 1, 0.0f);
+	m_sampleVec.reserve(LIP_FFT_SIZE + LIP_BLOCK_FRAMES);
+
+	m_bExit = false;
+	m_thread = std::thread(&CGMLipSync::_Run, this);
+	return true;
+}
+
+/** @brief 释放 */
+void CGMLipSync::Release()
+{
+	m_bExit = true;
+	if (m_thread.joinable()) m_thread.join();
+	GM_DELETE(m_pSpectrum);
+}
+
+void CGMLipSync::Push(const float* pData, const int iFrames, const int iChannels, const int iSampleRate, const long long iFrame)
+{
+	if (iChannels <= 0) return;
+	const float fScale = 1.0f / iChannels;
+	int iDone = 0;
+	while (iDone < iFrames)
+	{
+		// 分析线程跟不上时直接丢弃，分析线程发现帧序号不连续会重新开始
+		SGMLipBlock* pBlock = m_blockRing.BeginPush();
+		if (!pBlock) return;
+
+		const int iNum = min(iFrames - iDone, LIP_BLOCK_FRAMES);
+		const float* pIn = pData + size_t(iDone) * iChannels;
+		for (int i = 0; i < iNum; i++)
+		{
+			float fSum = 0.0f;
+			for (int c = 0; c < iChannels; c++)
+			{
+				fSum += pIn[i * iChannels + c];
+			}
+			pBlock->fData[i] = fSum * fScale;
+		}
+		pBlock->iFrame = iFrame + iDone;
+		pBlock->iFrames = iNum;
+		pBlock->iSampleRate = iSampleRate;
+		m_blockRing.EndPush();
+		m_iPushed++;
+		iDone += iNum;
+	}
+}
+
+SGMViseme CGMLipSync::GetViseme(const long long iPlayedFrame) const
+{
+	SGMViseme sViseme;
+	const unsigned int iNum = m_iResultNum.load(std::memory_order_acquire);
+	const unsigned int iCount = min(iNum, static_cast<unsigned int>(LIP_RESULT_NUM));
+	// 从最新的往前找，第一个不晚于播放位置的就是现在听到的
+	for (unsigned int j = 0; j < iCount; j++)
+	{
+		const SGMLipResult& sResult = m_resultArray[(iNum - 1 - j) % LIP_RESULT_NUM];
+		const long long iFrame = sResult.iFrame.load(std::memory_order_acquire);
+		const uint64_t iPacked = sResult.iPacked.load(std::memory_order_acquire);
+		if (iFrame < 0 || iFrame != sResult.iFrame.load(std::memory_order_acquire)) continue;
+		if (iFrame > iPlayedFrame) continue;
+		if (iPlayedFrame - iFrame > LIP_STALE_FRAMES) break;
+
+		sViseme.fAA = UnpackUnorm(iPacked, 0);
+		sViseme.fOO = UnpackUnorm(iPacked, 16);
+		sViseme.fClosed = UnpackUnorm(iPacked, 32);
+		sViseme.bValid = true;
+		break;
+	}
+	return sViseme;
+}
+
+void CGMLipSync::_Run()
+{
+	while (!m_bExit)
+	{
+		const SGMLipBlock* pBlock = m_blockRing.Front();
+		if (!pBlock)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(LIP_IDLE_SLEEP));
+			continue;
+		}
+
+		// 采样率变了，或者中间丢了数据，就重新开始
+		if (pBlock->iSampleRate != m_iSampleRate
+			|| m_iSampleFrame + static_cast<long long>(m_sampleVec.size()) != pBlock->iFrame)
+		{
+			m_sampleVec.clear();
+			m_iSampleFrame = pBlock->iFrame;
+			if (pBlock->iSampleRate != m_iSampleRate)
+			{
+				m_iSampleRate = pBlock->iSampleRate;
+				m_fPeak = 0.0f;
+				m_fFloor = 0.0f;
+			}
+		}
+		m_sampleVec.insert(m_sampleVec.end(), pBlock->fData, pBlock->fData + pBlock->iFrames);
+		m_blockRing.Pop();
+
+		while (m_sampleVec.size() >= LIP_FFT_SIZE)
+		{
+			m_pSpectrum->Power(m_sampleVec.data(), m_powerVec.data());
+			_Analyze(m_powerVec.data(), m_iSampleRate, m_iSampleFrame + LIP_FFT_SIZE / 2);
+			m_sampleVec.erase(m_sampleVec.begin(), m_sampleVec.begin() + LIP_HOP_SIZE);
+			m_iSampleFrame += LIP_HOP_SIZE;
+		}
+		m_iAnalyzed++;
+	}
+}
+
+void CGMLipSync::WaitIdle() const
+{
+	while (!m_bExit && m_iAnalyzed < m_iPushed)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void CGMLipSync::_Analyze(const float* pPower, const int iSampleRate, const long long iFrame)
+{
+	const float fBinHz = float(iSampleRate) / LIP_FFT_SIZE;
+	const float fHop = float(LIP_HOP_SIZE) / iSampleRate;
+	auto Bin = [fBinHz](const float fHz) { return int(fHz / fBinHz + 0.5f); };
+
+	// 人声的第一共振峰：“哦”在250-500Hz，“啊”在500-1000Hz，第二共振峰在1000-3000Hz
+	const int iStart = Bin(250.0f);
+	const int iMid = Bin(500.0f);
+	const int iHigh = Bin(1000.0f);
+	const int iEnd = min(Bin(3000.0f), LIP_FFT_SIZE / 2);
+	float fVocal = 0.0f;
+	float fLowF1 = 0.0f;
+	float fHighF1 = 0.0f;
+	float fCentroid = 0.0f;
+	float fLogSum = 0.0f;
+	for (int k = iStart; k <= iEnd; k++)
+	{
+		fVocal += pPower[k];
+		if (k < iMid)
+			fLowF1 += pPower[k];
+		else if (k < iHigh)
+			fHighF1 += pPower[k];
+		fCentroid += pPower[k] * k * fBinHz;
+		fLogSum += std::log(pPower[k] + 1e-12f);
+	}
+	const int iBins = iEnd - iStart + 1;
+	fCentroid /= fmax(fVocal, 1e-12f);
+
+	// 谱平坦度：元音是谐波，很不平坦；鼓和噪声接近平坦
+	const float fFlatness = std::exp(fLogSum / iBins) / fmax(fVocal / iBins, 1e-12f);
+	const float fVoiced = Saturate((0.45f - fFlatness) / 0.35f);
+
+	// 用峰值和底噪做自动增益，不受音量和歌曲响度的影响
+	const float fNorm = float(LIP_FFT_SIZE) * float(LIP_FFT_SIZE);
+	const float fDB = 10.0f * std::log10(fVocal / fNorm + 1e-12f);
+	if (0.0f == m_fPeak && 0.0f == m_fFloor)
+	{
+		m_fPeak = fDB;
+		m_fFloor = fDB - LIP_MIN_RANGE_DB;
+	}
+	m_fPeak = fmax(fDB, m_fPeak - LIP_PEAK_FALL * fHop);
+	m_fFloor = fmin(fDB, m_fFloor + LIP_FLOOR_RISE * fHop);
+	const float fRange = fmax(LIP_MIN_RANGE_DB, m_fPeak - m_fFloor);
+	float fOpen = Saturate(((fDB - (m_fPeak - fRange)) / fRange - 0.35f) / 0.65f);
+	if (fDB < LIP_SILENCE_DB) fOpen = 0.0f;
+	fOpen *= 0.35f + 0.65f * fVoiced;
+
+	// 第一共振峰越低、第二共振峰越弱，嘴越圆
+	const float fLowRatio = fLowF1 / fmax(fLowF1 + fHighF1, 1e-12f);
+	const float fRound = Saturate(0.5f * (1500.0f - fCentroid) / 900.0f + 0.5f * (fLowRatio - 0.3f) / 0.5f);
+
+	const float fOpenTime = (fOpen > m_fOpen) ? LIP_ATTACK_TIME : LIP_RELEASE_TIME;
+	m_fOpen += (fOpen - m_fOpen) * (1.0f - std::exp(-fHop / fOpenTime));
+	if (fOpen > 0.0f)
+		m_fRound += (fRound - m_fRound) * (1.0f - std::exp(-fHop / LIP_ROUND_TIME));
+
+	SGMViseme sViseme;
+	sViseme.fAA = m_fOpen * (1.0f - m_fRound);
+	sViseme.fOO = m_fOpen * m_fRound;
+	sViseme.fClosed = 1.0f - m_fOpen;
+	sViseme.bValid = true;
+	_Publish(sViseme, iFrame);
+}
+
+void CGMLipSync::_Publish(const SGMViseme& sViseme, const long long iFrame)
+{
+	const unsigned int iNum = m_iResultNum.load(std::memory_order_relaxed);
+	SGMLipResult& sResult = m_resultArray[iNum % LIP_RESULT_NUM];
+	sResult.iFrame.store(-1, std::memory_order_release);
+	sResult.iPacked.store(PackUnorm(sViseme.fAA, 0) | PackUnorm(sViseme.fOO, 16) | PackUnorm(sViseme.fClosed, 32),
+		std::memory_order_release);
+	sResult.iFrame.store(iFrame, std::memory_order_release);
+	m_iResultNum.store(iNum + 1, std::memory_order_release);
+}
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMLipSync.h
+/// @brief		Galaxy-Music Engine - GMLipSync
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.24
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMRingBuffer.h"
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+namespace GM
+{
+	/*************************************************************************
+	Macro Defines
+	*************************************************************************/
+
+	#define LIP_BLOCK_FRAMES				256				// 混音线程每次推送的最大帧数
+	#define LIP_RESULT_NUM					128				// 保存的分析结果数量，要覆盖输出缓冲的延迟
+
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMViseme
+	 *  @brief 口型权重，三者之和为1
+	 */
+	struct SGMViseme
+	{
+		SGMViseme() {}
+
+		float							fAA = 0.0f;					//!< 张大嘴的“啊”
+		float							fOO = 0.0f;					//!< 圆嘴的“哦”
+		float							fClosed = 1.0f;				//!< 闭嘴
+		bool							bValid = false;				//!< 是否有分析结果，没有时角色用默认口型
+	};
+
+	/*!
+	 *  @struct SGMLipBlock
+	 *  @brief 混音线程推送给分析线程的一块单声道采样
+	 */
+	struct SGMLipBlock
+	{
+		long long						iFrame = 0;					//!< 第一帧在输出流上的序号
+		int								iFrames = 0;				//!< 帧数
+		int								iSampleRate = 44100;		//!< 采样率
+		float							fData[LIP_BLOCK_FRAMES];	//!< 单声道采样
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	class CGMSpectrum;
+
+	/*!
+	*  @class CGMLipSync
+	*  @brief 根据正在播放的音频实时计算口型
+	*  @brief 混音线程把采样推入无锁队列，分析线程做FFT，计算人声频段的能量和共振峰特征，
+	*  @brief 结果带着输出流上的帧序号发布，主线程按已经播放的帧数无锁读取，和听到的声音对齐
+	*/
+	class CGMLipSync
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMLipSync();
+		/** @brief 析构 */
+		~CGMLipSync();
+
+		/** @brief 初始化，启动分析线程 */
+		bool Init();
+		/** @brief 释放，等待分析线程退出 */
+		void Release();
+
+		/**
+		* @brief 推送混音后的采样，只能在混音线程中调用，队列满时丢弃
+		* @param pData: 交错排列的采样
+		* @param iFrames: 帧数
+		* @param iChannels: 声道数
+		* @param iSampleRate: 采样率
+		* @param iFrame: 第一帧在输出流上的序号
+		*/
+		void Push(const float* pData, const int iFrames, const int iChannels, const int iSampleRate, const long long iFrame);
+		/**
+		* @brief 获取某个时刻的口型，可以在任意线程中调用
+		* @param iPlayedFrame: 已经播放出去的帧数
+		* @return SGMViseme 不晚于这一帧的最新结果
+		*/
+		SGMViseme GetViseme(const long long iPlayedFrame) const;
+		/**
+		* @brief 等待分析线程处理完已经推送的采样，离线导出时保证每帧的口型都是确定的
+		* 实时播放时不要调用
+		*/
+		void WaitIdle() const;
+
+	private:
+		/** @brief 分析线程 */
+		void _Run();
+		/**
+		* @brief 分析一帧
+		* @param pPower: 功率谱
+		* @param iSampleRate: 采样率
+		* @param iFrame: 这一帧中心在输出流上的序号
+		*/
+		void _Analyze(const float* pPower, const int iSampleRate, const long long iFrame);
+		/**
+		* @brief 发布一个结果
+		* @param sViseme: 口型
+		* @param iFrame: 对应的帧序号
+		*/
+		void _Publish(const SGMViseme& sViseme, const long long iFrame);
+
+		// 变量
+	private:
+		/*!
+		 *  @struct SGMLipResult
+		 *  @brief 发布的结果，写之前先把帧序号置为-1，读的前后帧序号一致才算有效
+		 */
+		struct SGMLipResult
+		{
+			std::atomic<long long>		iFrame{ -1 };				//!< 对应的帧序号
+			std::atomic<uint64_t>		iPacked{ 0 };				//!< 打包成16位定点数的权重
+		};
+
+		CGMRingBuffer<SGMLipBlock>		m_blockRing;				//!< 混音线程 -> 分析线程
+		SGMLipResult					m_resultArray[LIP_RESULT_NUM];	//!< 分析线程 -> 主线程
+		std::atomic<unsigned int>		m_iResultNum{ 0 };			//!< 已经发布的结果数量
+		std::thread						m_thread;					//!< 分析线程
+		std::atomic<bool>				m_bExit{ false };			//!< 分析线程退出标志
+		std::atomic<long long>			m_iPushed{ 0 };				//!< 已经推送的块数
+		std::atomic<long long>			m_iAnalyzed{ 0 };			//!< 已经分析完的块数
+
+		CGMSpectrum*					m_pSpectrum = nullptr;		//!< FFT
+		std::vector<float>				m_sampleVec;				//!< 还没分析的采样
+		std::vector<float>				m_powerVec;					//!< 功率谱
+		long long						m_iSampleFrame = -1;		//!< m_sampleVec第一个采样的帧序号
+		int								m_iSampleRate = 0;			//!< 当前采样率
+		float							m_fPeak = 0.0f;				//!< 人声能量的峰值跟踪
+		float							m_fFloor = 0.0f;			//!< 人声能量的底噪跟踪
+		float							m_fOpen = 0.0f;				//!< 平滑后的张嘴程度
+		float							m_fRound = 0.0f;			//!< 平滑后的圆唇程度
+	};
+}	// GM
@@ -14,25 +14,19 @@
 #include "GMCommonUniform.h"
 #include "GMLight.h"
 #include "GMKit.h"
-#include "GMDispatchCompute.h"
+#include "GMDownsampler.h"
+#include "GMProbeBaker.h"
 
-#include <osg/TextureCubeMap>
 #include <osgDB/ReadFile>
 #include <osgDB/WriteFile>
 #include <osgDB/FileUtils>
 
-#include <thread>
-#include <ppl.h>
 
 using namespace GM;
 
 /*************************************************************************
 Macro Defines
 *************************************************************************/
-#define PROBE_CUBESIZE					256		// probe的cubemap图片尺寸，单位：像素
-#define PROBE_MIPMAP_NUM				5		// probe的mipmap最大层级数
-#define PROBE_MIPMAP_BIN				10		// 生成probe第1级mipmap的renderbin
-#define PROBE_COPY_BIN					20		// 将不同层的图片copy到cubemap的不同mipmap的renderbin
 
 /*************************************************************************
 Global Constants
@@ -140,6 +134,7 @@ CGMMaterial::CGMMaterial():
 
 CGMMaterial::~CGMMaterial()
 {
+	GM_DELETE(m_pSSSDownsampler);
 }
 
 bool CGMMaterial::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData)
@@ -151,11 +146,6 @@ bool CGMMaterial::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData)
 	m_pDDSOptions = new osgDB::Options("dds_flip");
 	std::string strTexPath = m_pConfigData->strCorePath + m_strDefTexPath;
 
-	// 临时功能
-	//std::string strInputFilePath = strTexPath + "small_empty_room_3_8k.hdr";
-	//std::string strOutputFilePath = strTexPath + "env_probe.dds";
-	//_CreateProbe(strInputFilePath, strOutputFilePath);
-
 	// 初始化默认的各个材质的贴图，用于补齐纹理单元
 	// 白色贴图
 	osg::ref_ptr<osg::Texture2D> pWhiteTex = new osg::Texture2D;
@@ -257,6 +247,10 @@ bool CGMMaterial::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData)
 	m_pEnvProbeTex->setFilter(osg::Texture2D::MAG_FILTER, osg::Texture2D::LINEAR);// 改成LINEAR_MIPMAP_LINEAR会报错
 	m_pEnvProbeTex->setWrap(osg::Texture2D::WRAP_S, osg::Texture2D::REPEAT);
 	m_pEnvProbeTex->setWrap(osg::Texture2D::WRAP_T, osg::Texture2D::REPEAT);
+	// 环境漫反射辐照度
+	m_pEnvIrradianceUniform = new osg::Uniform(osg::Uniform::FLOAT_VEC3, "envIrradiance", 9);
+	m_pEnvIrradianceWeightUniform = new osg::Uniform("envIrradianceWeight", 0.0f);
+	_CreateProbe();
 
 	_InitSSSBlur();
 
@@ -287,6 +281,8 @@ bool CGMMaterial::UpdatePost(double dDeltaTime)
 void CGMMaterial::ResizeScreen(const int width, const int height)
 {
 	m_pSSSBlurCamera->resize(width/2, height/2);
+	if (m_pSSSDownsampler)
+		m_pSSSDownsampler->Resize(width/2, height/2);
 }
 
 void CGMMaterial::SetPBRMaterial(osg::Node* pNode)
@@ -317,6 +313,8 @@ void CGMMaterial::SetPBRMaterial(osg::Node* pNode)
 	_PlusUnitUsed(iChannel);
 	// 环境探针贴图
 	CGMKit::AddTexture(pStateSet.get(), m_pEnvProbeTex.get(), "texEnvProbe", iChannel++);
+	pStateSet->addUniform(m_pEnvIrradianceUniform.get());
+	pStateSet->addUniform(m_pEnvIrradianceWeightUniform.get());
 	_PlusUnitUsed(iChannel);
 
 	// 添加shader
@@ -328,6 +326,8 @@ void CGMMaterial::SetPBRMaterial(osg::Node* pNode)
 
 void CGMMaterial::SetHumanMaterial(osg::Node* pNode)
 {
+	// 眼睛的变换节点只记录当前这个人物的
+	m_pEyeTransVector.clear();
 	HumanVisitor cHumanVisitor(this);
 	pNode->accept(cHumanVisitor);
 
@@ -367,6 +367,8 @@ void CGMMaterial::SetSSSMaterial(osg::Node* pNode)
 	_PlusUnitUsed(iChannel);
 	// 环境探针贴图
 	CGMKit::AddTexture(pStateSet.get(), m_pEnvProbeTex.get(), "texEnvProbe", iChannel++);
+	pStateSet->addUniform(m_pEnvIrradianceUniform.get());
+	pStateSet->addUniform(m_pEnvIrradianceWeightUniform.get());
 	_PlusUnitUsed(iChannel);
 	// SSS blur贴图
 	CGMKit::AddTexture(pStateSet.get(), m_pSSSBlurTexture.get(), "texSSSBlur", iChannel++);
@@ -383,6 +385,8 @@ void CGMMaterial::SetSSSMaterial(osg::Node* pNode)
 	if (!GM_Root->containsNode(m_pSSSBlurCamera.get()))
 	{
 		GM_Root->addChild(m_pSSSBlurCamera.get());
+		if (m_pSSSDownsampler)
+			GM_Root->addChild(m_pSSSDownsampler->GetCamera());
 	}
 }
 
@@ -398,6 +402,8 @@ void CGMMaterial::SetEyeMaterial(osg::Node* pNode)
 	_PlusUnitUsed(iChannel);
 	// 环境探针贴图
 	CGMKit::AddTexture(pStateSet.get(), m_pEnvProbeTex.get(), "texEnvProbe", iChannel++);
+	pStateSet->addUniform(m_pEnvIrradianceUniform.get());
+	pStateSet->addUniform(m_pEnvIrradianceWeightUniform.get());
 	_PlusUnitUsed(iChannel);
 
 	// 添加shader
@@ -436,7 +442,8 @@ void CGMMaterial::SetShader(osg::StateSet* pSS, EGMMaterial eMaterial)
 			strShaderPath + "GMPBR.vert",
 			strShaderPath + "GMPBR.frag",
 			strShaderPath + "GMCommon.frag",
-			true, true);
+			true, true,
+			strShaderPath + "GMCommon.vert");
 	}
 	break;
 	case EGM_MATERIAL_SSS:
@@ -445,7 +452,8 @@ void CGMMaterial::SetShader(osg::StateSet* pSS, EGMMaterial eMaterial)
 			strShaderPath + "GMSSS.vert",
 			strShaderPath + "GMSSS.frag",
 			strShaderPath + "GMCommon.frag",
-			true, true);
+			true, true,
+			strShaderPath + "GMCommon.vert");
 	}
 	break;
 	case EGM_MATERIAL_Eye:
@@ -454,7 +462,8 @@ void CGMMaterial::SetShader(osg::StateSet* pSS, EGMMaterial eMaterial)
 			strShaderPath + "GMEye.vert",
 			strShaderPath + "GMEye.frag",
 			strShaderPath + "GMCommon.frag",
-			true, true);
+			true, true,
+			strShaderPath + "GMCommon.vert");
 	}
 	break;
 	case EGM_MATERIAL_Background:
@@ -463,7 +472,8 @@ void CGMMaterial::SetShader(osg::StateSet* pSS, EGMMaterial eMaterial)
 			strShaderPath + "GMBackground.vert",
 			strShaderPath + "GMBackground.frag",
 			strShaderPath + "GMCommon.frag",
-			true);
+			true, false,
+			strShaderPath + "GMCommon.vert");
 	}
 	break;
 	default:
@@ -488,8 +498,9 @@ void CGMMaterial::_InitSSSBlur()
 	int iH = m_pConfigData->iScreenHeight/2;
 	m_pSSSBlurTexture = new osg::Texture2D;
 	m_pSSSBlurTexture->setTextureSize(iW, iH);
-	m_pSSSBlurTexture->setInternalFormat(GL_RGB8);
-	m_pSSSBlurTexture->setSourceFormat(GL_RGB);
+	// 图像单元不支持rgb8，用rgba8，清屏的alpha为1，与原来的rgb8一致
+	m_pSSSBlurTexture->setInternalFormat(GL_RGBA8);
+	m_pSSSBlurTexture->setSourceFormat(GL_RGBA);
 	m_pSSSBlurTexture->setSourceType(GL_UNSIGNED_BYTE);
 	m_pSSSBlurTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
 	m_pSSSBlurTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
@@ -503,7 +514,7 @@ void CGMMaterial::_InitSSSBlur()
 	m_pSSSBlurCamera->setCullMask(GM_SSS_MASK);
 	m_pSSSBlurCamera->setReferenceFrame(osg::Transform::ABSOLUTE_RF_INHERIT_VIEWPOINT);
 	m_pSSSBlurCamera->setClearMask(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	m_pSSSBlurCamera->setClearColor(osg::Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+	m_pSSSBlurCamera->setClearColor(osg::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
 	m_pSSSBlurCamera->setViewport(0, 0, iW, iH);
 	m_pSSSBlurCamera->setRenderOrder(osg::Camera::PRE_RENDER, 0);
 	m_pSSSBlurCamera->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);
@@ -522,4 +533,44 @@ void CGMMaterial::_InitSSSBlur()
 	pSSSBlurStateSet->setTextureAttributeAndModes(SHADOW_TEX_UNIT, GM_LIGHT.GetShadowMap(), iValue);
 	pSSSBlurStateSet->addUniform(new osg::Uniform("texShadow", SHADOW_TEX_UNIT), iValue);
 	pSSSBlurStateSet->addUniform(GM_LIGHT.GetView2ShadowMatrixUniform());
+
+	// 模糊相机之后生成mipmap，SSS材质直接采样第1层
+	m_pSSSDownsampler = new CGMDownsampler();
+	if (m_pSSSDownsampler->Init(m_pSSSBlurTexture.get(), m_pConfigData->strCorePath + "Shaders/PostShader/",
+		osg::Camera::PRE_RENDER, 10))
+	{
+		m_pSSSBlurTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR_MIPMAP_LINEAR);
+	}
+	else
+	{
+		GM_DELETE(m_pSSSDownsampler);
+	}
+}
+
+bool CGMMaterial::_CreateProbe()
+{
+	// 使用Environment目录中的第一个.hdr
+	std::wstring strEnvPath = m_pConfigData->strMediaPath + L"Environment/";
+	std::wstring strFind = strEnvPath + L"*.hdr";
+	WIN32_FIND_DATAW sData;
+	HANDLE hFind = FindFirstFileExW(strFind.c_str(), FindExInfoBasic, &sData,
+		FindExSearchNameMatch, nullptr, 0);
+	if (INVALID_HANDLE_VALUE == hFind) return false;
+	std::wstring strHDR = strEnvPath + sData.cFileName;
+	FindClose(hFind);
+
+	CGMProbeBaker cBaker;
+	if (!cBaker.Bake(strHDR, m_pConfigData->strMediaPath + L"Cache/")) return false;
+
+	m_pEnvProbeTex->setImage(cBaker.GetProbeImage());
+	m_pEnvProbeTex->setInternalFormat(GL_RGBA8);
+	m_pEnvProbeTex->setSourceFormat(GL_RGBA);
+	m_pEnvProbeTex->setSourceType(GL_UNSIGNED_BYTE);
+	const std::vector<osg::Vec3f>& vIrradiance = cBaker.GetIrradiance();
+	for (unsigned int i = 0; i < vIrradiance.size(); i++)
+	{
+		m_pEnvIrradianceUniform->setElement(i, vIrradiance[i]);
+	}
+	m_pEnvIrradianceWeightUniform->set(1.0f);
+	return true;
 }
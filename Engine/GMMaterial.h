@@ -28,7 +28,7 @@ namespace GM
 	/*************************************************************************
 	Class
 	*************************************************************************/
-	class CGMDispatchCompute;
+	class CGMDownsampler;
 
 	/*!
 	*  @Class CGMMaterial
@@ -104,6 +104,12 @@ namespace GM
 		bool _PlusUnitUsed(int& iUnit);
 		/** @brief 初始化 SSS 模糊相机 */
 		void _InitSSSBlur();
+		/**
+		* @brief 用媒体库Environment目录中的第一个.hdr全景图烘焙环境探针，替换默认的探针贴图
+		* @brief 烘焙结果缓存在媒体库的Cache目录，源文件不变时直接读取
+		* @return bool 烘焙或者读取缓存成功true，没有.hdr时返回false，保持默认探针
+		*/
+		bool _CreateProbe();
 
 	// 变量
 	private:
@@ -124,14 +130,14 @@ namespace GM
 		osg::ref_ptr<osg::Texture2D>			m_pSandTex;						//!< 沙地贴图
 		osg::ref_ptr<osg::Texture2D>			m_pSkinDetailNormTex;			//!< 皮肤细节法线贴图
 		osg::ref_ptr<osg::Texture2D>			m_pEnvProbeTex;					//!< 环境探针贴图
-
-		std::vector<osg::ref_ptr<osg::TextureCubeMap>> m_pCubeMapVector;		//!< cubemap数组，6个方向6层level
-		std::vector<osg::ref_ptr<CGMDispatchCompute>> m_pMipmapComputeVec;		//!< 生成自定义mipmap的计算着色器节点
+		osg::ref_ptr<osg::Uniform>				m_pEnvIrradianceUniform;		//!< 环境漫反射辐照度的9个球谐系数
+		osg::ref_ptr<osg::Uniform>				m_pEnvIrradianceWeightUniform;	//!< 球谐辐照度的权重，没有烘焙时为0，使用原来的渐变环境光
 
 		std::vector<osg::ref_ptr<osg::Transform>>	m_pEyeTransVector;			//!< 眼睛的变幻节点
 
 		osg::ref_ptr<osg::Camera>				m_pSSSBlurCamera;				//!< SSS 模糊相机
 		osg::ref_ptr<osg::Texture2D>			m_pSSSBlurTexture;				//!< SSS 模糊贴图
+		CGMDownsampler*							m_pSSSDownsampler = nullptr;	//!< 生成SSS 模糊贴图的mipmap
 	};
 
 }	// GM
@@ -0,0 +1,531 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMMediaLibrary.cpp
+/// @brief		Galaxy-Music Engine - GMMediaLibrary
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.14
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMMediaLibrary.h"
+#include "bass.h"
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <direct.h>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define LIBRARY_INDEX_VERSION		1			// 索引文件版本
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+// 是否是BASS可以直接解码的音频文件
+static bool IsAudioFile(const wchar_t* szName)
+{
+	static const wchar_t* s_szExt[] = { L".mp3", L".mp2", L".mp1", L".ogg", L".wav", L".aif", L".aiff" };
+	const wchar_t* szDot = wcsrchr(szName, L'.');
+	if (!szDot) return false;
+	for (auto szExt : s_szExt)
+	{
+		if (0 == _wcsicmp(szDot, szExt)) return true;
+	}
+	return false;
+}
+
+// 多字节字符串转宽字符串
+static std::wstring ToWString(const char* szText, const int iLen, const UINT iCodePage)
+{
+	if (iLen <= 0) return L"";
+	int iNum = MultiByteToWideChar(iCodePage, 0, szText, iLen, nullptr, 0);
+	std::wstring strOut(iNum, L'\0');
+	MultiByteToWideChar(iCodePage, 0, szText, iLen, &strOut[0], iNum);
+	return strOut;
+}
+
+// 去掉末尾的'\0'和空格
+static std::wstring TrimTag(std::wstring strText)
+{
+	size_t iEnd = strText.find_last_not_of(std::wstring(L" \0", 2));
+	return (std::wstring::npos == iEnd) ? L"" : strText.substr(0, iEnd + 1);
+}
+
+// 解码ID3v2的文本帧，第一个字节是编码方式
+static std::wstring ID3v2Text(const unsigned char* pData, const int iSize)
+{
+	if (iSize <= 1) return L"";
+	const unsigned char iEncoding = pData[0];
+	const unsigned char* p = pData + 1;
+	int iLen = iSize - 1;
+	switch (iEncoding)
+	{
+	case 0:	// ISO-8859-1
+		return TrimTag(ToWString((const char*)p, iLen, 28591));
+	case 3:	// UTF-8
+		return TrimTag(ToWString((const char*)p, iLen, CP_UTF8));
+	case 1:	// UTF-16，带BOM
+	case 2:	// UTF-16BE
+	{
+		bool bBigEndian = (2 == iEncoding);
+		if (iLen >= 2 && 1 == iEncoding)
+		{
+			bBigEndian = (0xFE == p[0] && 0xFF == p[1]);
+			if ((0xFE == p[0] && 0xFF == p[1]) || (0xFF == p[0] && 0xFE == p[1]))
+			{
+				p += 2;
+				iLen -= 2;
+			}
+		}
+		std::wstring strOut;
+		for (int i = 0; i + 1 < iLen; i += 2)
+		{
+			wchar_t c = bBigEndian ? wchar_t((p[i] << 8) | p[i + 1]) : wchar_t(p[i] | (p[i + 1] << 8));
+			strOut.push_back(c);
+		}
+		return TrimTag(strOut);
+	}
+	default:
+		return L"";
+	}
+}
+
+// 从ID3v2标签中读取标题和艺术家
+static void ParseID3v2(const unsigned char* pTag, SGMAudioInfo& sInfo)
+{
+	if (!pTag || 0 != memcmp(pTag, "ID3", 3)) return;
+	const int iVersion = pTag[3];
+	const int iTagSize = (pTag[6] << 21) | (pTag[7] << 14) | (pTag[8] << 7) | pTag[9];
+	int iPos = 10;
+	// 跳过扩展头，大小来自文件，不能相信
+	if (iVersion >= 3 && (pTag[5] & 0x40))
+	{
+		if (iPos + 4 > 10 + iTagSize) return;
+		const unsigned char* pExt = pTag + iPos;
+		const unsigned int iExtSize = (4 == iVersion)
+			? ((unsigned(pExt[0]) << 21) | (unsigned(pExt[1]) << 14) | (unsigned(pExt[2]) << 7) | unsigned(pExt[3]))
+			: (((unsigned(pExt[0]) << 24) | (unsigned(pExt[1]) << 16) | (unsigned(pExt[2]) << 8) | unsigned(pExt[3])) + 4u);
+		if (0 == iExtSize || iExtSize > unsigned(10 + iTagSize - iPos)) return;
+		iPos += int(iExtSize);
+	}
+
+	const int iIDLen = (2 == iVersion) ? 3 : 4;
+	const int iHeadLen = (2 == iVersion) ? 6 : 10;
+	while (iPos + iHeadLen <= 10 + iTagSize)
+	{
+		const unsigned char* pFrame = pTag + iPos;
+		if (0 == pFrame[0]) break;	// 填充区
+
+		unsigned int iSize = 0;
+		if (2 == iVersion)
+			iSize = (unsigned(pFrame[3]) << 16) | (unsigned(pFrame[4]) << 8) | unsigned(pFrame[5]);
+		else if (4 == iVersion)
+			iSize = (unsigned(pFrame[4]) << 21) | (unsigned(pFrame[5]) << 14) | (unsigned(pFrame[6]) << 7) | unsigned(pFrame[7]);
+		else
+			iSize = (unsigned(pFrame[4]) << 24) | (unsigned(pFrame[5]) << 16) | (unsigned(pFrame[6]) << 8) | unsigned(pFrame[7]);
+		if (0 == iSize || iSize > unsigned(10 + iTagSize - iPos - iHeadLen)) break;
+		const int iFrameSize = int(iSize);
+
+		const unsigned char* pData = pFrame + iHeadLen;
+		if (0 == memcmp(pFrame, (2 == iVersion) ? "TT2" : "TIT2", iIDLen))
+			sInfo.strTitle = ID3v2Text(pData, iFrameSize);
+		else if (0 == memcmp(pFrame, (2 == iVersion) ? "TP1" : "TPE1", iIDLen))
+			sInfo.strArtist = ID3v2Text(pData, iFrameSize);
+
+		iPos += iHeadLen + iFrameSize;
+	}
+}
+
+// 从OGG的注释中读取标题和艺术家，格式为一串"KEY=VALUE\0"，以两个'\0'结束
+static void ParseOggComment(const char* szTag, SGMAudioInfo& sInfo)
+{
+	if (!szTag) return;
+	while (*szTag)
+	{
+		const int iLen = int(strlen(szTag));
+		if (0 == _strnicmp(szTag, "TITLE=", 6))
+			sInfo.strTitle = ToWString(szTag + 6, iLen - 6, CP_UTF8);
+		else if (0 == _strnicmp(szTag, "ARTIST=", 7))
+			sInfo.strArtist = ToWString(szTag + 7, iLen - 7, CP_UTF8);
+		szTag += iLen + 1;
+	}
+}
+
+static void WriteWString(std::ofstream& fOut, const std::wstring& str)
+{
+	unsigned int iLen = static_cast<unsigned int>(str.size());
+	fOut.write((const char*)&iLen, sizeof(iLen));
+	if (iLen) fOut.write((const char*)str.data(), iLen * sizeof(wchar_t));
+}
+
+static bool ReadWString(std::ifstream& fIn, std::wstring& str)
+{
+	unsigned int iLen = 0;
+	fIn.read((char*)&iLen, sizeof(iLen));
+	if (!fIn || iLen > 4096) return false;
+	str.resize(iLen);
+	if (iLen) fIn.read((char*)&str[0], iLen * sizeof(wchar_t));
+	return bool(fIn);
+}
+
+/*************************************************************************
+CGMMediaLibrary Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMMediaLibrary::CGMMediaLibrary()
+{
+	m_iRandom.seed(unsigned(std::chrono::system_clock::now().time_since_epoch().count()));
+}
+
+/** @brief 析构 */
+CGMMediaLibrary::~CGMMediaLibrary()
+{
+	Release();
+}
+
+/** @brief 初始化 */
+bool CGMMediaLibrary::Init(SGMConfigData* pConfigData)
+{
+	m_pConfigData = pConfigData;
+	m_bExit = false;
+
+	// 先用上次的索引，启动后立即可以选歌
+	_LoadIndex();
+	Rescan();
+	return true;
+}
+
+/** @brief 释放 */
+void CGMMediaLibrary::Release()
+{
+	m_bExit = true;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+
+	bool bDirty = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		bDirty = m_bDirty;
+	}
+	if (bDirty && m_pConfigData) _SaveIndex();
+}
+
+void CGMMediaLibrary::Rescan()
+{
+	if (m_bScanning || m_bExit) return;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+	m_bScanning = true;
+	m_thread = std::thread(&CGMMediaLibrary::_Scan, this);
+}
+
+int CGMMediaLibrary::GetAudioNum() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return int(m_playVec.size());
+}
+
+std::wstring CGMMediaLibrary::GetNext(const std::wstring& strCurrent, const bool bLoop) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_playVec.empty()) return L"";
+
+	int iPos = -1;
+	auto itr = m_indexMap.find(strCurrent);
+	if (itr != m_indexMap.end())
+	{
+		iPos = m_playPosVec.at(itr->second);
+	}
+	if (iPos < 0) return m_audioVec.at(m_playVec.front()).strName;
+
+	iPos++;
+	if (iPos >= int(m_playVec.size()))
+	{
+		if (!bLoop) return L"";
+		iPos = 0;
+	}
+	return m_audioVec.at(m_playVec.at(iPos)).strName;
+}
+
+std::wstring CGMMediaLibrary::GetRandom(const std::wstring& strCurrent)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const int iNum = int(m_playVec.size());
+	if (0 == iNum) return L"";
+	if (1 == iNum) return m_audioVec.at(m_playVec.front()).strName;
+
+	int iCurrentPos = -1;
+	auto itr = m_indexMap.find(strCurrent);
+	if (itr != m_indexMap.end())
+	{
+		iCurrentPos = m_playPosVec.at(itr->second);
+	}
+
+	// 当前这首在列表中时，从其余的里面选，并跳过当前这首
+	if (iCurrentPos < 0)
+	{
+		std::uniform_int_distribution<> iPseudoNoise(0, iNum - 1);
+		return m_audioVec.at(m_playVec.at(iPseudoNoise(m_iRandom))).strName;
+	}
+	std::uniform_int_distribution<> iPseudoNoise(0, iNum - 2);
+	int iPos = iPseudoNoise(m_iRandom);
+	if (iPos >= iCurrentPos) iPos++;
+	return m_audioVec.at(m_playVec.at(iPos)).strName;
+}
+
+bool CGMMediaLibrary::GetAudioInfo(const std::wstring& strName, SGMAudioInfo& sInfo) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto itr = m_indexMap.find(strName);
+	if (itr == m_indexMap.end()) return false;
+	sInfo = m_audioVec.at(itr->second);
+	return true;
+}
+
+void CGMMediaLibrary::SetBPM(const std::wstring& strName, const float fBPM)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto itr = m_indexMap.find(strName);
+	if (itr == m_indexMap.end()) return;
+	SGMAudioInfo& sInfo = m_audioVec.at(itr->second);
+	if (sInfo.fBPM == fBPM) return;
+	sInfo.fBPM = fBPM;
+	m_bDirty = true;
+}
+
+void CGMMediaLibrary::_Scan()
+{
+	std::vector<SGMAudioInfo> vAudio;
+	_ListDir(L"", vAudio);
+	if (m_bExit)
+	{
+		m_bScanning = false;
+		return;
+	}
+	std::sort(vAudio.begin(), vAudio.end(),
+		[](const SGMAudioInfo& a, const SGMAudioInfo& b) { return a.strName < b.strName; });
+
+	// 大小和修改时间都没变的文件，直接使用索引中的信息
+	std::vector<int> vProbe;
+	bool bChanged = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		bChanged = (vAudio.size() != m_audioVec.size());
+		for (int i = 0; i < int(vAudio.size()); i++)
+		{
+			auto itr = m_indexMap.find(vAudio[i].strName);
+			if (itr != m_indexMap.end())
+			{
+				const SGMAudioInfo& sOld = m_audioVec.at(itr->second);
+				if (sOld.iSize == vAudio[i].iSize && sOld.iMTime == vAudio[i].iMTime)
+				{
+					vAudio[i] = sOld;
+					continue;
+				}
+			}
+			vProbe.push_back(i);
+		}
+	}
+
+	if (!bChanged && vProbe.empty())
+	{
+		m_bScanning = false;
+		return;
+	}
+
+	// 新文件还没有时长和标签，但已经可以选歌了
+	_Publish(vAudio);
+	for (int i : vProbe)
+	{
+		if (m_bExit) break;
+		_Probe(vAudio[i]);
+	}
+	if (!m_bExit)
+	{
+		_Publish(vAudio);
+		_SaveIndex();
+	}
+	m_bScanning = false;
+}
+
+void CGMMediaLibrary::_ListDir(const std::wstring& strDir, std::vector<SGMAudioInfo>& vAudio) const
+{
+	std::wstring strFind = m_pConfigData->strMediaPath + m_strAudioPath + strDir + L"*";
+	WIN32_FIND_DATAW sData;
+	HANDLE hFind = FindFirstFileExW(strFind.c_str(), FindExInfoBasic, &sData,
+		FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+	if (INVALID_HANDLE_VALUE == hFind) return;
+
+	do
+	{
+		if (m_bExit) break;
+		if (L'.' == sData.cFileName[0]) continue;
+
+		if (sData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			_ListDir(strDir + sData.cFileName + L"/", vAudio);
+		}
+		else if (IsAudioFile(sData.cFileName))
+		{
+			SGMAudioInfo sInfo;
+			sInfo.strName = strDir + sData.cFileName;
+			sInfo.iSize = (static_cast<unsigned long long>(sData.nFileSizeHigh) << 32) | sData.nFileSizeLow;
+			sInfo.iMTime = (static_cast<unsigned long long>(sData.ftLastWriteTime.dwHighDateTime) << 32) | sData.ftLastWriteTime.dwLowDateTime;
+			vAudio.push_back(sInfo);
+		}
+	} while (FindNextFileW(hFind, &sData));
+	FindClose(hFind);
+}
+
+void CGMMediaLibrary::_Probe(SGMAudioInfo& sInfo) const
+{
+	// 标题默认为不带扩展名的文件名
+	size_t iSlash = sInfo.strName.find_last_of(L"/");
+	std::wstring strFileName = (std::wstring::npos == iSlash) ? sInfo.strName : sInfo.strName.substr(iSlash + 1);
+	sInfo.strTitle = strFileName.substr(0, strFileName.find_last_of(L"."));
+	sInfo.strArtist = L"";
+	sInfo.fBPM = 0.0f;
+
+	std::wstring strFile = m_pConfigData->strMediaPath + m_strAudioPath + sInfo.strName;
+	HSTREAM hStream = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0, BASS_STREAM_DECODE);
+	if (!hStream)
+	{
+		sInfo.iDuration = -1;
+		return;
+	}
+
+	QWORD length_bytes = BASS_ChannelGetLength(hStream, BASS_POS_BYTE);
+	double length_sec = BASS_ChannelBytes2Seconds(hStream, length_bytes);
+	sInfo.iDuration = static_cast<int>(std::fmax(0.0, length_sec) * 1000);
+
+	SGMAudioInfo sTag;
+	ParseID3v2((const unsigned char*)BASS_ChannelGetTags(hStream, BASS_TAG_ID3V2), sTag);
+	if (L"" == sTag.strTitle)
+	{
+		const TAG_ID3* pID3 = (const TAG_ID3*)BASS_ChannelGetTags(hStream, BASS_TAG_ID3);
+		if (pID3)
+		{
+			sTag.strTitle = TrimTag(ToWString(pID3->title, int(strnlen(pID3->title, 30)), CP_ACP));
+			sTag.strArtist = TrimTag(ToWString(pID3->artist, int(strnlen(pID3->artist, 30)), CP_ACP));
+		}
+	}
+	if (L"" == sTag.strTitle)
+	{
+		ParseOggComment(BASS_ChannelGetTags(hStream, BASS_TAG_OGG), sTag);
+	}
+	BASS_StreamFree(hStream);
+
+	if (L"" != sTag.strTitle) sInfo.strTitle = sTag.strTitle;
+	sInfo.strArtist = sTag.strArtist;
+}
+
+void CGMMediaLibrary::_Publish(std::vector<SGMAudioInfo> vAudio)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// 扫描期间分析完成的速度不能丢
+	for (const auto& itr : m_indexMap)
+	{
+		const SGMAudioInfo& sOld = m_audioVec.at(itr.second);
+		if (sOld.fBPM <= 0.0f) continue;
+		auto itrNew = std::lower_bound(vAudio.begin(), vAudio.end(), sOld.strName,
+			[](const SGMAudioInfo& a, const std::wstring& b) { return a.strName < b; });
+		if (itrNew != vAudio.end() && itrNew->strName == sOld.strName
+			&& itrNew->iSize == sOld.iSize && itrNew->iMTime == sOld.iMTime && itrNew->fBPM <= 0.0f)
+		{
+			itrNew->fBPM = sOld.fBPM;
+		}
+	}
+
+	m_audioVec.swap(vAudio);
+	m_playVec.clear();
+	m_playPosVec.assign(m_audioVec.size(), -1);
+	m_indexMap.clear();
+	m_indexMap.reserve(m_audioVec.size());
+	for (int i = 0; i < int(m_audioVec.size()); i++)
+	{
+		m_indexMap[m_audioVec[i].strName] = i;
+		if (m_audioVec[i].iDuration < 0) continue;
+		m_playPosVec[i] = int(m_playVec.size());
+		m_playVec.push_back(i);
+	}
+}
+
+bool CGMMediaLibrary::_LoadIndex()
+{
+	std::ifstream fIn(m_pConfigData->strMediaPath + m_strIndexFile, std::ios::binary);
+	if (!fIn.is_open()) return false;
+
+	char szMagic[4] = { 0 };
+	int iVersion = 0;
+	unsigned int iNum = 0;
+	fIn.read(szMagic, 4);
+	fIn.read((char*)&iVersion, sizeof(int));
+	fIn.read((char*)&iNum, sizeof(iNum));
+	if (!fIn || 0 != memcmp(szMagic, "GMML", 4) || LIBRARY_INDEX_VERSION != iVersion) return false;
+
+	std::vector<SGMAudioInfo> vAudio;
+	vAudio.reserve(iNum);
+	for (unsigned int i = 0; i < iNum; i++)
+	{
+		SGMAudioInfo sInfo;
+		if (!ReadWString(fIn, sInfo.strName) || !ReadWString(fIn, sInfo.strTitle) || !ReadWString(fIn, sInfo.strArtist))
+			return false;
+		fIn.read((char*)&sInfo.iSize, sizeof(sInfo.iSize));
+		fIn.read((char*)&sInfo.iMTime, sizeof(sInfo.iMTime));
+		fIn.read((char*)&sInfo.iDuration, sizeof(sInfo.iDuration));
+		fIn.read((char*)&sInfo.fBPM, sizeof(sInfo.fBPM));
+		if (!fIn) return false;
+		vAudio.push_back(sInfo);
+	}
+	std::sort(vAudio.begin(), vAudio.end(),
+		[](const SGMAudioInfo& a, const SGMAudioInfo& b) { return a.strName < b.strName; });
+
+	_Publish(vAudio);
+	return true;
+}
+
+bool CGMMediaLibrary::_SaveIndex()
+{
+	std::vector<SGMAudioInfo> vAudio;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		vAudio = m_audioVec;
+		m_bDirty = false;
+	}
+
+	std::wstring strFile = m_pConfigData->strMediaPath + m_strIndexFile;
+	_wmkdir(strFile.substr(0, strFile.find_last_of(L"/") + 1).c_str());
+	std::ofstream fOut(strFile, std::ios::binary | std::ios::trunc);
+	if (!fOut.is_open()) return false;
+
+	int iVersion = LIBRARY_INDEX_VERSION;
+	unsigned int iNum = static_cast<unsigned int>(vAudio.size());
+	fOut.write("GMML", 4);
+	fOut.write((const char*)&iVersion, sizeof(int));
+	fOut.write((const char*)&iNum, sizeof(iNum));
+	for (const auto& sInfo : vAudio)
+	{
+		WriteWString(fOut, sInfo.strName);
+		WriteWString(fOut, sInfo.strTitle);
+		WriteWString(fOut, sInfo.strArtist);
+		fOut.write((const char*)&sInfo.iSize, sizeof(sInfo.iSize));
+		fOut.write((const char*)&sInfo.iMTime, sizeof(sInfo.iMTime));
+		fOut.write((const char*)&sInfo.iDuration, sizeof(sInfo.iDuration));
+		fOut.write((const char*)&sInfo.fBPM, sizeof(sInfo.fBPM));
+	}
+	fOut.close();
+	return !fOut.fail();
+}
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMMediaLibrary.h
+/// @brief		Galaxy-Music Engine - GMMediaLibrary
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.14
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMCommon.h"
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <random>
+
+namespace GM
+{
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMAudioInfo
+	 *  @brief 媒体库中一首音频的信息
+	 */
+	struct SGMAudioInfo
+	{
+		SGMAudioInfo() {}
+
+		std::wstring					strName = L"";				//!< 相对于音乐目录的文件名，例如：xxx/xxx.mp3
+		std::wstring					strTitle = L"";				//!< 标题，没有标签时为文件名
+		std::wstring					strArtist = L"";			//!< 艺术家
+		unsigned long long				iSize = 0;					//!< 文件大小，单位：字节
+		unsigned long long				iMTime = 0;					//!< 文件修改时间
+		int								iDuration = 0;				//!< 时长，单位：ms，-1表示无法播放
+		float							fBPM = 0.0f;				//!< 节拍分析得到的速度，0表示还没有分析
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMMediaLibrary
+	*  @brief 音乐目录的索引，启动时读取磁盘上的索引，在后台线程中按文件大小和修改时间增量扫描
+	*  @brief 选择下一首、随机一首都是O(1)
+	*/
+	class CGMMediaLibrary
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMMediaLibrary();
+		/** @brief 析构 */
+		~CGMMediaLibrary();
+
+		/** @brief 初始化，读取索引并开始后台扫描 */
+		bool Init(SGMConfigData* pConfigData);
+		/** @brief 释放，等待后台扫描退出，有修改则保存索引 */
+		void Release();
+		/** @brief 重新扫描音乐目录，上一次扫描还没结束时忽略 */
+		void Rescan();
+
+		/** @brief 可以播放的音频数量 */
+		int GetAudioNum() const;
+		/**
+		* @brief 获取列表中的下一首
+		* @param strCurrent: 当前音频文件名，为空或者不在列表中时返回第一首
+		* @param bLoop: 到列表末尾时是否回到第一首
+		* @return std::wstring 下一首的文件名，没有则返回L""
+		*/
+		std::wstring GetNext(const std::wstring& strCurrent, const bool bLoop = true) const;
+		/**
+		* @brief 随机获取一首，列表多于一首时不会和当前的重复
+		* @param strCurrent: 当前音频文件名
+		* @return std::wstring 文件名，没有则返回L""
+		*/
+		std::wstring GetRandom(const std::wstring& strCurrent);
+		/**
+		* @brief 获取某首音频的信息
+		* @param strName: 音频文件名
+		* @param sInfo: 输出的信息
+		* @return bool 在媒体库中则返回true
+		*/
+		bool GetAudioInfo(const std::wstring& strName, SGMAudioInfo& sInfo) const;
+		/**
+		* @brief 记录节拍分析的结果
+		* @param strName: 音频文件名
+		* @param fBPM: 速度
+		*/
+		void SetBPM(const std::wstring& strName, const float fBPM);
+		/**
+		* @brief 设置随机播放的随机种子，录制和回放时使用
+		* @param iSeed: 随机种子
+		*/
+		inline void SetSeed(const uint32_t iSeed) { m_iRandom.seed(iSeed); }
+
+	private:
+		/** @brief 后台扫描 */
+		void _Scan();
+		/**
+		* @brief 递归列出目录下的音频文件，只读取文件大小和修改时间
+		* @param strDir: 相对于音乐目录的子目录，例如：L"" 或 L"xxx/"
+		* @param vAudio: 输出的音频列表
+		*/
+		void _ListDir(const std::wstring& strDir, std::vector<SGMAudioInfo>& vAudio) const;
+		/**
+		* @brief 打开音频文件，读取时长和标签
+		* @param sInfo: 音频信息，strName必须有效
+		*/
+		void _Probe(SGMAudioInfo& sInfo) const;
+		/**
+		* @brief 替换当前列表，并重建查找表
+		* @param vAudio: 新的音频列表，按文件名排序
+		*/
+		void _Publish(std::vector<SGMAudioInfo> vAudio);
+		/** @brief 读取索引 */
+		bool _LoadIndex();
+		/** @brief 保存索引 */
+		bool _SaveIndex();
+
+		// 变量
+	private:
+		SGMConfigData*						m_pConfigData = nullptr;				//!< 配置数据
+		std::wstring						m_strAudioPath = L"Music/";				//!< 音乐存放路径
+		std::wstring						m_strIndexFile = L"Cache/Library.idx";	//!< 索引文件
+
+		std::thread							m_thread;								//!< 后台扫描线程
+		std::atomic<bool>					m_bExit{ false };						//!< 后台线程退出标志
+		std::atomic<bool>					m_bScanning{ false };					//!< 是否正在扫描
+		mutable std::mutex					m_mutex;								//!< 保护下面的列表
+		std::vector<SGMAudioInfo>			m_audioVec;								//!< 所有音频，按文件名排序
+		std::vector<int>					m_playVec;								//!< 可以播放的音频在m_audioVec中的序号
+		std::vector<int>					m_playPosVec;							//!< 音频在m_playVec中的位置，不能播放的为-1
+		std::unordered_map<std::wstring, int> m_indexMap;							//!< 文件名 -> 在m_audioVec中的序号
+		std::default_random_engine			m_iRandom;								//!< 随机值
+		bool								m_bDirty = false;						//!< 索引是否需要保存
+	};
+}	// GM
@@ -14,7 +14,11 @@
 #include "GMCommonUniform.h"
 #include "GMLight.h"
 #include "GMKit.h"
+#include "GMScene.h"
 #include "GMTangentSpaceGenerator.h"
+#include "GMVertexQuantizer.h"
+#include "GMVectorOps.h"
+#include "GMScheduler.h"
 #include "Animation/GMAnimation.h"
 #include "Cipher/HydroCipher.h"
 
@@ -26,13 +30,17 @@
 #include <osg/AlphaFunc>
 #include <osg/BlendFunc>
 #include <osg/CullFace>
+#include <osg/Notify>
 #include <osgDB/ReadFile>
+#include <osgAnimation/RigGeometry>
+#include <osgAnimation/MorphGeometry>
 
 using namespace GM;
 
 /*************************************************************************
 Global Constants
 *************************************************************************/
+#define MODEL_INNER_STEP			0.1			// 间隔更新的时间，单位：秒
 
 namespace GM
 {
@@ -53,6 +61,10 @@ namespace GM
 		}
 		void generateTangentArray(osg::Geometry* geom)
 		{
+			// 同一个资源的实例共享切线数组，已经生成过就不再生成
+			// 压缩顶点格式后只剩7号属性（打包的切线），所以只检查它
+			if (geom->getVertexAttribArray(7)) return;
+
 			osg::ref_ptr<CGMTangentSpaceGenerator> tsg = new CGMTangentSpaceGenerator;
 			tsg->generate(geom);
 			geom->setVertexAttribArray(6, tsg->getTangentArray());
@@ -61,6 +73,51 @@ namespace GM
 			geom->setVertexAttribBinding(7, osg::Geometry::BIND_PER_VERTEX);
 		}
 	};
+
+	/*
+	*  @brief 实例访问器，克隆后让实例拥有会被每帧改写的顶点数组
+	*  变形动画会直接改写顶点和法线，所以这两个数组不能在实例之间共享
+	*/
+	class InstanceArrayVisitor : public osg::NodeVisitor
+	{
+	public:
+		InstanceArrayVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+		void apply(osg::Node& node) { traverse(node); }
+		void apply(osg::Geode& node)
+		{
+			for (unsigned int i = 0; i < node.getNumDrawables(); ++i)
+			{
+				osg::Drawable* pDrawable = node.getDrawable(i);
+				osgAnimation::RigGeometry* pRig = dynamic_cast<osgAnimation::RigGeometry*>(pDrawable);
+				if (pRig)
+				{
+					// 蒙皮的源几何体如果是变形几何体，则需要一份实例自己的
+					osgAnimation::MorphGeometry* pMorph = dynamic_cast<osgAnimation::MorphGeometry*>(pRig->getSourceGeometry());
+					if (pMorph)
+					{
+						osg::ref_ptr<osgAnimation::MorphGeometry> pMorphCopy = new osgAnimation::MorphGeometry(*pMorph, osg::CopyOp::SHALLOW_COPY);
+						_CopyDeformedArrays(pMorphCopy.get());
+						pRig->setSourceGeometry(pMorphCopy.get());
+					}
+					continue;
+				}
+
+				osgAnimation::MorphGeometry* pMorph = dynamic_cast<osgAnimation::MorphGeometry*>(pDrawable);
+				if (pMorph) _CopyDeformedArrays(pMorph);
+			}
+			traverse(node);
+		}
+
+	private:
+		void _CopyDeformedArrays(osg::Geometry* pGeom)
+		{
+			if (pGeom->getVertexArray())
+				pGeom->setVertexArray(osg::clone(pGeom->getVertexArray(), osg::CopyOp::DEEP_COPY_ALL));
+			if (pGeom->getNormalArray())
+				pGeom->setNormalArray(osg::clone(pGeom->getNormalArray(), osg::CopyOp::DEEP_COPY_ALL), osg::Array::BIND_PER_VERTEX);
+		}
+	};
 }
 
 /*************************************************************************
@@ -76,6 +133,9 @@ CGMModel::CGMModel()
 /** @brief 析构 */
 CGMModel::~CGMModel()
 {
+	if (m_iInnerTask) m_pKernelData->pScheduler->Remove(m_iInnerTask);
+	// 等待后台读取结束
+	m_pPreloadMap.clear();
 	delete m_pMaterial;
 }
 
@@ -84,6 +144,8 @@ bool CGMModel::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData)
 {
 	m_pKernelData = pKernelData;
 	m_pConfigData = pConfigData;
+	m_iInnerTask = m_pKernelData->pScheduler->AddPeriodic(MODEL_INNER_STEP,
+		[this](double fElapsed) { _InnerUpdate(fElapsed); }, EGMTASK_PRIORITY_LOW);
 
 	m_pRootNode = new osg::Group;
 	GM_Root->addChild(m_pRootNode.get());
@@ -101,6 +163,8 @@ bool CGMModel::Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData)
 
 	m_pMaterial->Init(pKernelData, pConfigData);
 	m_pDDSOptions = new osgDB::Options("dds_flip");
+	// 半透明模型导入时不按遮挡重排三角形，以免改变混合结果
+	m_pTransparentOptions = new osgDB::Options("dds_flip Transparent");
 	return true;
 }
 
@@ -115,8 +179,14 @@ bool CGMModel::Load()
 }
 
 /** @brief 保存 */
-bool CGMModel::Save()
+bool CGMModel::Save(SGMSceneData& sScene) const
 {
+	sScene.modelVec.clear();
+	sScene.modelVec.reserve(m_pModelDataMap.size());
+	for (auto& itr : m_pModelDataMap)
+	{
+		sScene.modelVec.push_back(itr.second);
+	}
 	return true;
 }
 
@@ -129,15 +199,6 @@ bool CGMModel::Reset()
 
 bool CGMModel::Update(double dDeltaTime)
 {
-	static double fConstantStep = 0.1;
-	static double fDeltaStep = 0.0;
-	if (fDeltaStep > fConstantStep)
-	{
-		_InnerUpdate(fDeltaStep);
-		fDeltaStep = 0.0;
-	}
-	fDeltaStep += dDeltaTime;
-
 	return true;
 }
 
@@ -147,6 +208,17 @@ bool CGMModel::UpdatePost(double dDeltaTime)
 	return true;
 }
 
+void CGMModel::Preload(const std::vector<SGMModelData>& vData)
+{
+	for (auto& itr : vData)
+	{
+		const std::string strKey = _AssetKey(itr);
+		if (m_pAssetMap.end() != m_pAssetMap.find(strKey)) continue;
+		if (m_pPreloadMap.end() != m_pPreloadMap.find(strKey)) continue;
+		m_pPreloadMap[strKey] = std::async(std::launch::async, &CGMModel::_ReadAsset, this, itr);
+	}
+}
+
 bool CGMModel::Add(const SGMModelData& sData)
 {
 	if (m_pModelDataMap.end() != m_pModelDataMap.find(sData.strName))
@@ -155,61 +227,36 @@ bool CGMModel::Add(const SGMModelData& sData)
 		return false;
 	}
 
-	std::string strRealFilePath = m_pConfigData->strCorePath + m_strDefModelPath + sData.strFilePath;
-	// 如果是CIP文件则使用HydroCipher解密
-	if (sData.strFilePath.find(".CIP") != std::string::npos)
-	{
-		// CIP文件需要解密
-		auto cipher = HydroCipher::create(AlgorithmType::XOR);
-		std::vector<uint8_t> key(32, 0xD5C9);
+	// 同一个文件只读取一次，之后的模型都是它的实例
+	osg::Node* pAsset = _LoadAsset(sData);
+	if (!pAsset) return false;
+	osg::ref_ptr<osg::Node> pNode = _CreateInstance(pAsset);
+
+	osg::ref_ptr<osg::PositionAttitudeTransform> pTransform = new osg::PositionAttitudeTransform;
+	// 设置模型的初始位置、旋转和缩放
+	pTransform->setAttitude(osg::Quat(
+		osg::DegreesToRadians(sData.vOri.x), osg::Vec3f(1, 0, 0),
+		osg::DegreesToRadians(sData.vOri.y), osg::Vec3f(0, 1, 0),
+		osg::DegreesToRadians(sData.vOri.z), osg::Vec3f(0, 0, 1)));
+	pTransform->setPosition(GM2OSG(sData.vPos));
+	pTransform->setScale(GM2OSG(sData.vScale));
+
+	pTransform->addChild(pNode.get());
+	// 设置阴影
+	if (sData.bCastShadow)
+		pTransform->setNodeMask(GM_MAIN_MASK | GM_SHADOW_CAST_MASK);
+	else
+		pTransform->setNodeMask(GM_MAIN_MASK);
 
-		std::string strCipherFilePath = strRealFilePath;
-		strRealFilePath = m_pConfigData->strCorePath + m_strDefModelPath + sData.strName + ".GMM";
-		if (!cipher->decrypt(strCipherFilePath, strRealFilePath, key))
-		{
-			return false; // 解密失败
-		}
-	}
-	// 加载模型
-	osg::ref_ptr<osg::Node> pNode = osgDB::readNodeFile(strRealFilePath, m_pDDSOptions);// 保证dds纹理的正确加载
-	if (pNode.valid())
-	{
-		osg::ref_ptr<osg::PositionAttitudeTransform> pTransform = new osg::PositionAttitudeTransform;
-		// 设置模型的初始位置、旋转和缩放
-		pTransform->setAttitude(osg::Quat(
-			osg::DegreesToRadians(sData.vOri.x), osg::Vec3f(1, 0, 0),
-			osg::DegreesToRadians(sData.vOri.y), osg::Vec3f(0, 1, 0),
-			osg::DegreesToRadians(sData.vOri.z), osg::Vec3f(0, 0, 1)));
-		pTransform->setPosition(osg::Vec3f(sData.vPos.x, sData.vPos.y, sData.vPos.z));
-		pTransform->setScale(osg::Vec3f(sData.vScale.x, sData.vScale.y, sData.vScale.z));
-
-		pTransform->addChild(pNode.get());
-		// 设置阴影
-		if (sData.bCastShadow)
-			pTransform->setNodeMask(GM_MAIN_MASK | GM_SHADOW_CAST_MASK);
-		else
-			pTransform->setNodeMask(GM_MAIN_MASK);
-
-		if(!m_pRootNode->containsNode(pTransform.get()))
-			m_pRootNode->addChild(pTransform.get());
-
-		m_pModelDataMap[sData.strName] = sData;
-		m_pTransMap[sData.strName] = pTransform;
-
-		// 设置材质
-		_SetMaterial(pTransform.get(), sData);
-
-		// 如果是加密文件且加载成功，则删除解密后的模型文件，防止泄露
-		if (sData.strFilePath.find(".CIP") != std::string::npos)
-		{
-			if (std::remove(strRealFilePath.c_str()) != 0)
-			{
-				return false; // 删除失败
-			}
-		}
-		return true;
-	}
-	return false;
+	if(!m_pRootNode->containsNode(pTransform.get()))
+		m_pRootNode->addChild(pTransform.get());
+
+	m_pModelDataMap[sData.strName] = sData;
+	m_pTransMap[sData.strName] = pTransform;
+
+	// 设置材质
+	_SetMaterial(pTransform.get(), sData);
+	return true;
 }
 
 bool CGMModel::Edit(const std::string& strOldName, SGMModelData& sNewData)
@@ -235,8 +282,8 @@ bool CGMModel::Edit(const std::string& strOldName, SGMModelData& sNewData)
 			osg::DegreesToRadians(sNewData.vOri.x), osg::Vec3f(1, 0, 0),
 			osg::DegreesToRadians(sNewData.vOri.y), osg::Vec3f(0, 1, 0),
 			osg::DegreesToRadians(sNewData.vOri.z), osg::Vec3f(0, 0, 1)));
-		pTransform->setPosition(osg::Vec3f(sNewData.vPos.x, sNewData.vPos.y, sNewData.vPos.z));
-		pTransform->setScale(osg::Vec3f(sNewData.vScale.x, sNewData.vScale.y, sNewData.vScale.z));
+		pTransform->setPosition(GM2OSG(sNewData.vPos));
+		pTransform->setScale(GM2OSG(sNewData.vScale));
 	}
 	if (m_pModelDataMap[strOldName].eMaterial != sNewData.eMaterial)
 	{
@@ -260,6 +307,19 @@ bool CGMModel::Edit(const std::string& strOldName, SGMModelData& sNewData)
 	return true;
 }
 
+bool CGMModel::Remove(const std::string& strName)
+{
+	auto itr = m_pTransMap.find(strName);
+	if (m_pTransMap.end() == itr) return false;
+
+	GM_ANIMATION.RemoveAnimation(strName);
+	m_pRootNode->removeChild(itr->second.get());
+	m_pTransMap.erase(itr);
+	m_pModelDataMap.erase(strName);
+	m_pEyeTransMap.erase(strName);
+	return true;
+}
+
 void CGMModel::ResizeScreen(const int width, const int height)
 {
 	m_pMaterial->ResizeScreen(width, height);
@@ -283,7 +343,7 @@ bool CGMModel::_SetMaterial(osg::Node* pNode, const SGMModelData& sData)
 	case EGM_MATERIAL_Human:
 	{
 		m_pMaterial->SetHumanMaterial(pNode);
-		m_pMaterial->GetEyeTransform(m_pEyeTransVector);
+		m_pMaterial->GetEyeTransform(m_pEyeTransMap[sData.strName]);
 	}
 	break;
 	case EGM_MATERIAL_SSS:
@@ -388,6 +448,98 @@ osg::Node* CGMModel::_GetNode(const std::string& strName) const
 	return nullptr;
 }
 
+osg::Node* CGMModel::_LoadAsset(const SGMModelData& sData)
+{
+	const std::string strKey = _AssetKey(sData);
+	auto itr = m_pAssetMap.find(strKey);
+	if (m_pAssetMap.end() != itr) return itr->second.get();
+
+	// 已经在后台读取的，等待读取完成
+	osg::ref_ptr<osg::Node> pNode;
+	auto itrPreload = m_pPreloadMap.find(strKey);
+	if (m_pPreloadMap.end() != itrPreload)
+	{
+		pNode = itrPreload->second.get();
+		m_pPreloadMap.erase(itrPreload);
+	}
+	else
+	{
+		pNode = _ReadAsset(sData);
+	}
+	if (!pNode.valid()) return nullptr;
+
+	m_pAssetMap[strKey] = pNode;
+	return pNode.get();
+}
+
+std::string CGMModel::_AssetKey(const SGMModelData& sData) const
+{
+	// 半透明模型导入时三角形顺序不同，和不透明的模型分开读取
+	if (EGM_BLEND_Transparent == sData.eBlend) return sData.strFilePath + "|Transparent";
+	return sData.strFilePath;
+}
+
+osg::ref_ptr<osg::Node> CGMModel::_ReadAsset(const SGMModelData& sData) const
+{
+	std::string strRealFilePath = m_pConfigData->strCorePath + m_strDefModelPath + sData.strFilePath;
+	const bool bCipher = (sData.strFilePath.find(".CIP") != std::string::npos);
+	// 如果是CIP文件则使用HydroCipher解密
+	if (bCipher)
+	{
+		// CIP文件需要解密
+		auto cipher = HydroCipher::create(AlgorithmType::XOR);
+		std::vector<uint8_t> key(32, 0xD5C9);
+
+		std::string strCipherFilePath = strRealFilePath;
+		strRealFilePath = m_pConfigData->strCorePath + m_strDefModelPath + sData.strName + ".GMM";
+		if (!cipher->decrypt(strCipherFilePath, strRealFilePath, key))
+		{
+			return nullptr; // 解密失败
+		}
+	}
+	// 加载模型
+	osg::ref_ptr<osg::Node> pNode = osgDB::readNodeFile(strRealFilePath,
+		(EGM_BLEND_Transparent == sData.eBlend) ? m_pTransparentOptions : m_pDDSOptions);// 保证dds纹理的正确加载
+
+	// 如果是加密文件，则删除解密后的模型文件，防止泄露
+	if (bCipher && std::remove(strRealFilePath.c_str()) != 0)
+	{
+		return nullptr; // 删除失败
+	}
+	if (!pNode.valid()) return nullptr;
+
+	// 切线只和网格有关，在资源上生成一次，所有实例共享
+	ComputeTangentVisitor ctv;
+	pNode->accept(ctv);
+
+	// 压缩顶点格式，解码参数放在资源根节点上，所有实例共享
+	if (sData.bQuantize)
+	{
+		CGMVertexQuantizer hQuantizer;
+		if (hQuantizer.Quantize(pNode.get()))
+		{
+			const SGMQuantizeStats& sStats = hQuantizer.GetStats();
+			OSG_INFO << "CGMModel: " << sData.strFilePath << " vertex data "
+				<< sStats.iBytesBefore / 1024 << " KB -> " << sStats.iBytesAfter / 1024 << " KB" << std::endl;
+		}
+	}
+	return pNode;
+}
+
+osg::Node* CGMModel::_CreateInstance(osg::Node* pAsset)
+{
+	// 节点、绘制体和回调是每个实例自己的（骨骼姿态、蒙皮结果都存在这里）
+	// 顶点、索引、纹理和状态集不拷贝，所有实例共享
+	osg::Node* pInstance = osg::clone(pAsset, osg::CopyOp(
+		osg::CopyOp::DEEP_COPY_NODES |
+		osg::CopyOp::DEEP_COPY_DRAWABLES |
+		osg::CopyOp::DEEP_COPY_CALLBACKS));
+
+	InstanceArrayVisitor iav;
+	pInstance->accept(iav);
+	return pInstance;
+}
+
 void CGMModel::_InnerUpdate(const double dDeltaTime)
 {
 }
\ No newline at end of file
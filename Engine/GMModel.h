@@ -15,6 +15,7 @@
 #include "GMKernel.h"
 
 #include <osg/Texture2D>
+#include <future>
 
 namespace GM
 {
@@ -31,6 +32,7 @@ namespace GM
 	*************************************************************************/
 
 	class CGMMaterial;
+	struct SGMSceneData;
 
 	/*!
 	 *  @class CGMModel，系统单位：厘米
@@ -49,14 +51,24 @@ namespace GM
 		bool Init(SGMKernelData* pKernelData, SGMConfigData* pConfigData);
 		/** @brief 加载 */
 		bool Load();
-		/** @brief 保存 */
-		bool Save();
+		/**
+		* @brief 保存，把所有模型的数据按名称顺序写入场景
+		* @param sScene: 输出，场景内容
+		* @return bool 成功true，失败false
+		*/
+		bool Save(SGMSceneData& sScene) const;
 		/** @brief 重置 */
 		bool Reset();
 		/** @brief 更新 */
 		bool Update(double dDeltaTime);
 		/** @brief 更新(在主相机更新姿态之后) */
 		bool UpdatePost(double dDeltaTime);
+		/**
+		* @brief 在后台线程中预读模型资源，之后Add同一个文件时直接使用
+		* 每个文件一个线程，恢复场景时可以同时做其他事情
+		* @param vData: 将要添加的模型
+		*/
+		void Preload(const std::vector<SGMModelData>& vData);
 		/** @brief 添加模型 */
 		bool Add(const SGMModelData& sData);
 		/**
@@ -67,6 +79,12 @@ namespace GM
 		*/
 		bool Edit(const std::string& strOldName, SGMModelData& sNewData);
 		/**
+		* @brief 删除模型，同时关闭它的动画，资源仍然保留给其他实例
+		* @param strName: 模型在场景中的名称
+		* @return bool 成功true，不存在false
+		*/
+		bool Remove(const std::string& strName);
+		/**
 		* @brief 修改屏幕尺寸时调用此函数
 		* @param width: 屏幕宽度
 		* @param height: 屏幕高度
@@ -99,11 +117,16 @@ namespace GM
 		osg::PositionAttitudeTransform* GetPositionAttitudeTransform(const std::string& strName) const;
 		/**
 		* @brief 获取眼睛的变幻节点的vector
+		* @param strName 模型名称
 		* @param v: 有则返回节点指针的vector
 		*/
-		void GetEyeTransform(std::vector<osg::ref_ptr<osg::Transform>>& v) const
+		void GetEyeTransform(const std::string& strName, std::vector<osg::ref_ptr<osg::Transform>>& v) const
 		{
-			v = m_pEyeTransVector;
+			auto itr = m_pEyeTransMap.find(strName);
+			if (m_pEyeTransMap.end() != itr)
+				v = itr->second;
+			else
+				v.clear();
 		}
 	private:
 		/**
@@ -120,6 +143,31 @@ namespace GM
 		* @return osg::Node* 模型节点指针
 		*/
 		osg::Node* _GetNode(const std::string& strName) const;
+		/**
+		* @brief 读取模型资源，同一个文件只读取一次，半透明的模型另外读取一次
+		* @param sData 模型信息
+		* @return osg::Node* 模型资源的节点指针（不加入场景，只用于创建实例），失败返回nullptr
+		*/
+		osg::Node* _LoadAsset(const SGMModelData& sData);
+		/**
+		* @brief 模型资源的key，半透明模型的资源单独读取
+		* @param sData 模型信息
+		* @return std::string 文件路径，半透明模型加上后缀
+		*/
+		std::string _AssetKey(const SGMModelData& sData) const;
+		/**
+		* @brief 从磁盘读取模型资源并生成切线，不修改成员变量，可以在任意线程中调用
+		* @param sData 模型信息
+		* @return osg::ref_ptr<osg::Node> 模型资源的节点，失败返回nullptr
+		*/
+		osg::ref_ptr<osg::Node> _ReadAsset(const SGMModelData& sData) const;
+		/**
+		* @brief 用模型资源创建一个实例
+		* 实例拥有自己的节点、绘制体、回调与动画通道，共享顶点、索引、纹理、状态集和关键帧
+		* @param pAsset 模型资源的节点指针
+		* @return osg::Node* 实例的节点指针
+		*/
+		osg::Node* _CreateInstance(osg::Node* pAsset);
 
 		void _InnerUpdate(const double dDeltaTime);
 
@@ -127,6 +175,7 @@ namespace GM
 	private:
 		SGMKernelData* m_pKernelData = nullptr;					//!< 内核数据
 		SGMConfigData* m_pConfigData = nullptr;					//!< 配置数据
+		unsigned int m_iInnerTask = 0;							//!< 间隔更新的任务编号
 
 		osg::ref_ptr<osg::Group>			m_pRootNode = nullptr;
 		std::map<std::string, SGMModelData>	m_pModelDataMap;	//!< 模型数据map
@@ -138,9 +187,15 @@ namespace GM
 		std::string							m_strDefModelPath = "Models/";
 		//!< dds的纹理操作
 		osg::ref_ptr<osgDB::Options>		m_pDDSOptions;
+		//!< 半透明模型的读取选项，导入时不按遮挡重排三角形
+		osg::ref_ptr<osgDB::Options>		m_pTransparentOptions;
 		//!< 材质管理器
 		CGMMaterial*						m_pMaterial = nullptr;
-		//!< 人类材质的模型上的所有眼睛的变幻节点
-		std::vector<osg::ref_ptr<osg::Transform>> m_pEyeTransVector;
+		//!< 已加载的模型资源，key见_AssetKey，多个实例共享其中不变的数据
+		std::map<std::string, osg::ref_ptr<osg::Node>> m_pAssetMap;
+		//!< 正在后台读取的模型资源，key见_AssetKey
+		std::map<std::string, std::future<osg::ref_ptr<osg::Node>>> m_pPreloadMap;
+		//!< 人类材质的模型上的所有眼睛的变幻节点，key是模型名称
+		std::map<std::string, std::vector<osg::ref_ptr<osg::Transform>>> m_pEyeTransMap;
 	};
 }	// GM
@@ -0,0 +1,542 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMMusicAnalyzer.cpp
+/// @brief		Galaxy-Music Engine - GMMusicAnalyzer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.10
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMMusicAnalyzer.h"
+#include "GMSpectrum.h"
+#include "bass.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <direct.h>
+#include <osg/Math>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GM_BEAT_SSE 1
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define BEAT_FFT_SIZE				1024		// FFT窗口大小，单位：采样
+#define BEAT_HOP_SIZE				512			// 相邻两帧的间隔，单位：采样
+#define BEAT_ONSET_COMPRESS			100.0f		// 频谱对数压缩系数
+#define BEAT_MIN_BPM				60.0		// 速度估计的下限
+#define BEAT_MAX_BPM				200.0		// 速度估计的上限
+#define BEAT_PRIOR_BPM				120.0		// 速度的先验中心
+#define BEAT_PRIOR_OCTAVE			1.0			// 速度先验的标准差，单位：倍频程
+#define BEAT_TIGHTNESS				100.0		// 拍子间隔偏离速度时的惩罚系数
+#define BEAT_ENERGY_STEP			0.1			// 能量曲线的采样间隔，单位：秒
+#define BEAT_CACHE_VERSION			1			// 缓存文件版本，分析算法改变时需要增加
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+// 两个数组的点积
+static float DotProduct(const float* pA, const float* pB, const int iNum)
+{
+	int i = 0;
+	float fSum = 0.0f;
+#ifdef GM_BEAT_SSE
+	__m128 vSum = _mm_setzero_ps();
+	for (; i + 4 <= iNum; i += 4)
+	{
+		vSum = _mm_add_ps(vSum, _mm_mul_ps(_mm_loadu_ps(pA + i), _mm_loadu_ps(pB + i)));
+	}
+	float fLane[4];
+	_mm_storeu_ps(fLane, vSum);
+	fSum = (fLane[0] + fLane[1]) + (fLane[2] + fLane[3]);
+#endif
+	for (; i < iNum; i++)
+	{
+		fSum += pA[i] * pB[i];
+	}
+	return fSum;
+}
+
+static void WriteVec(std::ofstream& fOut, const std::vector<float>& vec)
+{
+	int iNum = int(vec.size());
+	fOut.write((const char*)&iNum, sizeof(int));
+	if (iNum) fOut.write((const char*)vec.data(), iNum * sizeof(float));
+}
+
+static bool ReadVec(std::ifstream& fIn, std::vector<float>& vec)
+{
+	int iNum = 0;
+	fIn.read((char*)&iNum, sizeof(int));
+	if (!fIn || iNum < 0 || iNum > (1 << 24)) return false;
+	vec.resize(iNum);
+	if (iNum) fIn.read((char*)vec.data(), iNum * sizeof(float));
+	return bool(fIn);
+}
+
+/*************************************************************************
+SGMMusicGrid Methods
+*************************************************************************/
+
+int SGMMusicGrid::GetBarIndex(const float fTime) const
+{
+	return int(std::upper_bound(barVec.begin(), barVec.end(), fTime) - barVec.begin()) - 1;
+}
+
+float SGMMusicGrid::GetEnergy(const float fTime) const
+{
+	if (energyVec.empty()) return 0.0f;
+	int i = osg::clampBetween(int(fTime / fEnergyStep), 0, int(energyVec.size()) - 1);
+	return energyVec.at(i);
+}
+
+float SGMMusicGrid::GetMeanEnergy(const float fStart, const float fEnd) const
+{
+	if (energyVec.empty()) return 0.0f;
+	int iLast = int(energyVec.size()) - 1;
+	int iStart = osg::clampBetween(int(fStart / fEnergyStep), 0, iLast);
+	int iEnd = osg::clampBetween(int(fEnd / fEnergyStep), iStart, iLast);
+	float fSum = 0.0f;
+	for (int i = iStart; i <= iEnd; i++)
+	{
+		fSum += energyVec.at(i);
+	}
+	return fSum / (iEnd - iStart + 1);
+}
+
+/*************************************************************************
+CGMMusicAnalyzer Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMMusicAnalyzer::CGMMusicAnalyzer()
+{
+}
+
+/** @brief 析构 */
+CGMMusicAnalyzer::~CGMMusicAnalyzer()
+{
+	Release();
+}
+
+/** @brief 初始化 */
+bool CGMMusicAnalyzer::Init(SGMConfigData* pConfigData)
+{
+	m_pConfigData = pConfigData;
+	m_bExit = false;
+	if (!m_thread.joinable())
+	{
+		m_thread = std::thread(&CGMMusicAnalyzer::_WorkerLoop, this);
+	}
+	return true;
+}
+
+/** @brief 释放 */
+void CGMMusicAnalyzer::Release()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_condition.notify_all();
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void CGMMusicAnalyzer::Request(const std::wstring& strFile)
+{
+	if (L"" == strFile) return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_jobSet.count(strFile)) return;
+		m_jobSet.insert(strFile);
+		m_jobQueue.push_back(strFile);
+	}
+	m_condition.notify_one();
+}
+
+bool CGMMusicAnalyzer::GetGrid(const std::wstring& strFile, std::shared_ptr<const SGMMusicGrid>& pGrid)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto itr = m_gridMap.find(strFile);
+	if (itr == m_gridMap.end())
+	{
+		pGrid = nullptr;
+		return false;
+	}
+	pGrid = itr->second;
+	return true;
+}
+
+void CGMMusicAnalyzer::_WorkerLoop()
+{
+	while (true)
+	{
+		std::wstring strFile;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_bExit || !m_jobQueue.empty(); });
+			if (m_bExit) return;
+			strFile = m_jobQueue.front();
+			m_jobQueue.pop_front();
+		}
+
+		std::shared_ptr<SGMMusicGrid> pGrid = std::make_shared<SGMMusicGrid>();
+		bool bOK = _LoadOrAnalyze(strFile, *pGrid);
+		if (m_bExit) return;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_gridMap[strFile] = bOK ? pGrid : nullptr;
+	}
+}
+
+bool CGMMusicAnalyzer::_LoadOrAnalyze(const std::wstring& strFile, SGMMusicGrid& sGrid)
+{
+	std::wstring strCache = _GetCachePath(strFile);
+	if (L"" == strCache) return false;
+	if (_LoadCache(strCache, sGrid)) return true;
+
+	if (!_Analyze(strFile, sGrid)) return false;
+	_SaveCache(strCache, sGrid);
+	return true;
+}
+
+bool CGMMusicAnalyzer::_Analyze(const std::wstring& strFile, SGMMusicGrid& sGrid)
+{
+	// 解码流不会播放，可以在后台线程里使用
+	HSTREAM hStream = BASS_StreamCreateFile(FALSE, strFile.c_str(), 0, 0, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT);
+	if (!hStream) return false;
+
+	BASS_CHANNELINFO sInfo;
+	if (!BASS_ChannelGetInfo(hStream, &sInfo) || 0 == sInfo.freq)
+	{
+		BASS_StreamFree(hStream);
+		return false;
+	}
+	const int iChannels = max(1, int(sInfo.chans));
+	const double fSampleRate = sInfo.freq;
+	const double fFPS = fSampleRate / BEAT_HOP_SIZE;
+
+	CGMSpectrum sSpectrum(BEAT_FFT_SIZE);
+	const int iBins = BEAT_FFT_SIZE / 2 + 1;
+	std::vector<float> vPower(iBins, 0.0f);
+	std::vector<float> vLogLast(iBins, 0.0f);
+	std::vector<float> vOnset;					// 每一帧的频谱通量（起音强度）
+	std::vector<float> vFrameEnergy;			// 每一帧新增采样的均方根
+	std::vector<float> vMono;
+	std::vector<float> vBuffer(4096 * iChannels);
+	size_t iRead = 0;
+
+	while (!m_bExit)
+	{
+		DWORD iBytes = BASS_ChannelGetData(hStream, vBuffer.data(), DWORD(vBuffer.size() * sizeof(float)));
+		if (DWORD(-1) == iBytes || 0 == iBytes) break;
+
+		// 混合成单声道
+		int iSamples = int(iBytes / sizeof(float)) / iChannels;
+		for (int i = 0; i < iSamples; i++)
+		{
+			float fSum = 0.0f;
+			for (int c = 0; c < iChannels; c++)
+			{
+				fSum += vBuffer[i * iChannels + c];
+			}
+			vMono.push_back(fSum / iChannels);
+		}
+
+		while (vMono.size() - iRead >= BEAT_FFT_SIZE)
+		{
+			const float* pFrame = vMono.data() + iRead;
+			sSpectrum.Power(pFrame, vPower.data());
+
+			float fFlux = 0.0f;
+			for (int k = 0; k < iBins; k++)
+			{
+				float fLog = std::log1p(BEAT_ONSET_COMPRESS * std::sqrt(vPower[k]) / BEAT_FFT_SIZE);
+				fFlux += fmax(0.0f, fLog - vLogLast[k]);
+				vLogLast[k] = fLog;
+			}
+			vOnset.push_back(fFlux);
+
+			const float* pNew = pFrame + BEAT_FFT_SIZE - BEAT_HOP_SIZE;
+			vFrameEnergy.push_back(std::sqrt(DotProduct(pNew, pNew, BEAT_HOP_SIZE) / BEAT_HOP_SIZE));
+
+			iRead += BEAT_HOP_SIZE;
+		}
+		// 丢弃已经处理过的采样
+		if (iRead > 65536)
+		{
+			vMono.erase(vMono.begin(), vMono.begin() + iRead);
+			iRead = 0;
+		}
+	}
+	BASS_StreamFree(hStream);
+	if (m_bExit) return false;
+
+	const int iFrames = int(vOnset.size());
+	const int iLagMin = int(std::floor(fFPS * 60.0 / BEAT_MAX_BPM));
+	const int iLagMax = int(std::ceil(fFPS * 60.0 / BEAT_MIN_BPM));
+	if (iFrames < 4 * iLagMax) return false;
+
+	// 去掉起音强度的局部均值，只保留突变，再按标准差归一化
+	{
+		const int iHalf = int(fFPS * 0.5);
+		std::vector<double> vPrefix(iFrames + 1, 0.0);
+		for (int i = 0; i < iFrames; i++)
+		{
+			vPrefix[i + 1] = vPrefix[i] + vOnset[i];
+		}
+		std::vector<float> vDetrend(iFrames);
+		double fSum2 = 0.0;
+		for (int i = 0; i < iFrames; i++)
+		{
+			int iA = max(0, i - iHalf);
+			int iB = min(iFrames, i + iHalf + 1);
+			float fMean = float((vPrefix[iB] - vPrefix[iA]) / (iB - iA));
+			vDetrend[i] = fmax(0.0f, vOnset[i] - fMean);
+			fSum2 += vDetrend[i] * vDetrend[i];
+		}
+		float fStd = float(std::sqrt(fSum2 / iFrames));
+		if (fStd <= 0.0f) return false;
+		for (int i = 0; i < iFrames; i++)
+		{
+			vOnset[i] = vDetrend[i] / fStd;
+		}
+	}
+
+	// 自相关估计速度，用以120BPM为中心的对数高斯先验抑制倍频/半频
+	const double fPriorLag = fFPS * 60.0 / BEAT_PRIOR_BPM;
+	std::vector<double> vScore(iLagMax + 2, 0.0);
+	int iBestLag = iLagMin;
+	for (int iLag = iLagMin - 1; iLag <= iLagMax + 1; iLag++)
+	{
+		double fAC = DotProduct(vOnset.data(), vOnset.data() + iLag, iFrames - iLag) / double(iFrames - iLag);
+		double fOctave = std::log2(iLag / fPriorLag) / BEAT_PRIOR_OCTAVE;
+		vScore[iLag] = fAC * std::exp(-0.5 * fOctave * fOctave);
+		if (iLag >= iLagMin && iLag <= iLagMax && vScore[iLag] > vScore[iBestLag])
+			iBestLag = iLag;
+	}
+	// 抛物线插值得到亚帧精度的周期
+	double fPeriod = iBestLag;
+	{
+		double y0 = vScore[iBestLag - 1], y1 = vScore[iBestLag], y2 = vScore[iBestLag + 1];
+		double fDenom = y0 - 2.0 * y1 + y2;
+		if (fDenom < 0.0) fPeriod += osg::clampBetween(0.5 * (y0 - y2) / fDenom, -0.5, 0.5);
+	}
+
+	// 动态规划跟踪节拍：每一拍 = 起音强度 + 上一拍的累计得分 - 拍子间隔偏离周期的惩罚
+	std::vector<float> vCumScore(iFrames, 0.0f);
+	std::vector<int> vBack(iFrames, -1);
+	const int iSearchMin = int(std::round(fPeriod * 0.5));
+	const int iSearchMax = int(std::round(fPeriod * 2.0));
+	for (int t = 0; t < iFrames; t++)
+	{
+		float fBest = 0.0f;
+		int iBest = -1;
+		for (int iPrev = max(0, t - iSearchMax); iPrev <= t - iSearchMin; iPrev++)
+		{
+			double fRatio = std::log((t - iPrev) / fPeriod);
+			float fValue = vCumScore[iPrev] - float(BEAT_TIGHTNESS * fRatio * fRatio);
+			if (iBest < 0 || fValue > fBest)
+			{
+				fBest = fValue;
+				iBest = iPrev;
+			}
+		}
+		vCumScore[t] = vOnset[t] + (iBest >= 0 ? fBest : 0.0f);
+		vBack[t] = iBest;
+	}
+
+	// 从最后一个周期内得分最高的帧开始回溯
+	int iBeat = iFrames - 1;
+	for (int t = max(0, iFrames - int(fPeriod)); t < iFrames; t++)
+	{
+		if (vCumScore[t] > vCumScore[iBeat]) iBeat = t;
+	}
+	std::vector<int> vBeatFrame;
+	while (iBeat >= 0)
+	{
+		vBeatFrame.push_back(iBeat);
+		iBeat = vBack[iBeat];
+	}
+	std::reverse(vBeatFrame.begin(), vBeatFrame.end());
+	if (vBeatFrame.size() < MUSIC_BEATS_PER_BAR * 2) return false;
+
+	auto FrameTime = [&](int iFrame) {
+		return float((double(iFrame) * BEAT_HOP_SIZE + BEAT_FFT_SIZE * 0.5) / fSampleRate); };
+
+	sGrid = SGMMusicGrid();
+	sGrid.fBPM = float(60.0 * fFPS / fPeriod);
+	sGrid.fEnergyStep = float(BEAT_ENERGY_STEP);
+	for (int iFrame : vBeatFrame)
+	{
+		sGrid.beatVec.push_back(FrameTime(iFrame));
+	}
+
+	// 能量曲线，按95%分位数归一化
+	{
+		int iSteps = int(FrameTime(iFrames - 1) / BEAT_ENERGY_STEP) + 1;
+		std::vector<float> vSum(iSteps, 0.0f);
+		std::vector<int> vNum(iSteps, 0);
+		for (int i = 0; i < iFrames; i++)
+		{
+			int iStep = min(iSteps - 1, int(FrameTime(i) / BEAT_ENERGY_STEP));
+			vSum[iStep] += vFrameEnergy[i];
+			vNum[iStep]++;
+		}
+		sGrid.energyVec.resize(iSteps, 0.0f);
+		for (int i = 0; i < iSteps; i++)
+		{
+			if (vNum[i]) sGrid.energyVec[i] = vSum[i] / vNum[i];
+		}
+		std::vector<float> vSorted = sGrid.energyVec;
+		size_t iRank = vSorted.size() * 95 / 100;
+		std::nth_element(vSorted.begin(), vSorted.begin() + iRank, vSorted.end());
+		float fRef = vSorted[iRank];
+		for (auto& fEnergy : sGrid.energyVec)
+		{
+			fEnergy = (fRef > 0.0f) ? fmin(1.0f, fEnergy / fRef) : 0.0f;
+		}
+	}
+
+	// 强拍：起音强度之和最大的那一组拍子作为每小节的第一拍
+	{
+		int iBestPhase = 0;
+		float fBestSum = -1.0f;
+		for (int iPhase = 0; iPhase < MUSIC_BEATS_PER_BAR; iPhase++)
+		{
+			float fSum = 0.0f;
+			for (size_t i = iPhase; i < vBeatFrame.size(); i += MUSIC_BEATS_PER_BAR)
+			{
+				fSum += vOnset[vBeatFrame[i]];
+			}
+			if (fSum > fBestSum)
+			{
+				fBestSum = fSum;
+				iBestPhase = iPhase;
+			}
+		}
+		for (size_t i = iBestPhase; i < sGrid.beatVec.size(); i += MUSIC_BEATS_PER_BAR)
+		{
+			sGrid.barVec.push_back(sGrid.beatVec[i]);
+		}
+	}
+
+	// 乐段：能量上升之和最大的那一组小节作为每个乐段的第一小节
+	{
+		const int iBars = int(sGrid.barVec.size());
+		std::vector<float> vRise(iBars, 0.0f);
+		float fLast = 0.0f;
+		for (int i = 0; i < iBars; i++)
+		{
+			float fEnd = (i + 1 < iBars) ? sGrid.barVec[i + 1] : sGrid.barVec[i] + MUSIC_BEATS_PER_BAR * 60.0f / sGrid.fBPM;
+			float fEnergy = sGrid.GetMeanEnergy(sGrid.barVec[i], fEnd);
+			vRise[i] = fmax(0.0f, fEnergy - fLast);
+			fLast = fEnergy;
+		}
+		int iBestPhase = 0;
+		float fBestSum = -1.0f;
+		for (int iPhase = 0; iPhase < MUSIC_BARS_PER_PHRASE; iPhase++)
+		{
+			float fSum = 0.0f;
+			for (int i = iPhase; i < iBars; i += MUSIC_BARS_PER_PHRASE)
+			{
+				fSum += vRise[i];
+			}
+			if (fSum > fBestSum)
+			{
+				fBestSum = fSum;
+				iBestPhase = iPhase;
+			}
+		}
+		for (int i = iBestPhase; i < iBars; i += MUSIC_BARS_PER_PHRASE)
+		{
+			sGrid.phraseVec.push_back(sGrid.barVec[i]);
+		}
+	}
+
+	return true;
+}
+
+std::wstring CGMMusicAnalyzer::_GetCachePath(const std::wstring& strFile) const
+{
+	std::ifstream fIn(strFile, std::ios::binary);
+	if (!fIn.is_open()) return L"";
+
+	// FNV-1a 64位hash，文件改名或移动后依然能命中缓存
+	unsigned long long iHash = 14695981039346656037ULL;
+	std::vector<char> vChunk(1 << 16);
+	while (fIn)
+	{
+		fIn.read(vChunk.data(), vChunk.size());
+		std::streamsize iNum = fIn.gcount();
+		for (std::streamsize i = 0; i < iNum; i++)
+		{
+			iHash ^= (unsigned char)vChunk[i];
+			iHash *= 1099511628211ULL;
+		}
+	}
+
+	std::wstringstream ss;
+	ss << m_pConfigData->strMediaPath << m_strCachePath
+		<< std::hex << std::setw(16) << std::setfill(L'0') << iHash << L".beat";
+	return ss.str();
+}
+
+bool CGMMusicAnalyzer::_LoadCache(const std::wstring& strCache, SGMMusicGrid& sGrid) const
+{
+	std::ifstream fIn(strCache, std::ios::binary);
+	if (!fIn.is_open()) return false;
+
+	char szMagic[4] = { 0 };
+	int iVersion = 0;
+	fIn.read(szMagic, 4);
+	fIn.read((char*)&iVersion, sizeof(int));
+	if (!fIn || 0 != memcmp(szMagic, "GMBT", 4) || BEAT_CACHE_VERSION != iVersion) return false;
+
+	SGMMusicGrid sTmp;
+	fIn.read((char*)&sTmp.fBPM, sizeof(float));
+	fIn.read((char*)&sTmp.fEnergyStep, sizeof(float));
+	if (!fIn || sTmp.fEnergyStep <= 0.0f) return false;
+	if (!ReadVec(fIn, sTmp.beatVec) || !ReadVec(fIn, sTmp.barVec)
+		|| !ReadVec(fIn, sTmp.phraseVec) || !ReadVec(fIn, sTmp.energyVec))
+		return false;
+
+	sGrid = sTmp;
+	return true;
+}
+
+bool CGMMusicAnalyzer::_SaveCache(const std::wstring& strCache, const SGMMusicGrid& sGrid) const
+{
+	std::wstring strDir = m_pConfigData->strMediaPath + m_strCachePath;
+	_wmkdir(strDir.c_str());
+
+	std::ofstream fOut(strCache, std::ios::binary | std::ios::trunc);
+	if (!fOut.is_open()) return false;
+
+	int iVersion = BEAT_CACHE_VERSION;
+	fOut.write("GMBT", 4);
+	fOut.write((const char*)&iVersion, sizeof(int));
+	fOut.write((const char*)&sGrid.fBPM, sizeof(float));
+	fOut.write((const char*)&sGrid.fEnergyStep, sizeof(float));
+	WriteVec(fOut, sGrid.beatVec);
+	WriteVec(fOut, sGrid.barVec);
+	WriteVec(fOut, sGrid.phraseVec);
+	WriteVec(fOut, sGrid.energyVec);
+	fOut.close();
+	return !fOut.fail();
+}
@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMMusicAnalyzer.h
+/// @brief		Galaxy-Music Engine - GMMusicAnalyzer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.10
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMCommon.h"
+#include <memory>
+#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+
+namespace GM
+{
+	/*************************************************************************
+	Macro Defines
+	*************************************************************************/
+	#define MUSIC_BEATS_PER_BAR			4			// 每个小节的拍数
+	#define MUSIC_BARS_PER_PHRASE		4			// 每个乐段的小节数
+
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMMusicGrid
+	 *  @brief 离线分析得到的音乐节拍网格，时间单位：秒
+	 */
+	struct SGMMusicGrid
+	{
+		SGMMusicGrid() {}
+
+		/**
+		* @brief 获取某个时刻所在的小节编号
+		* @param fTime 音乐播放的时间，单位：秒
+		* @return int 小节编号，从0开始，第一个小节之前返回-1
+		*/
+		int GetBarIndex(const float fTime) const;
+		/**
+		* @brief 获取某个时刻的能量
+		* @param fTime 音乐播放的时间，单位：秒
+		* @return float 能量，[0.0, 1.0]
+		*/
+		float GetEnergy(const float fTime) const;
+		/**
+		* @brief 获取一段时间内的平均能量
+		* @param fStart, fEnd 起止时间，单位：秒
+		* @return float 平均能量，[0.0, 1.0]
+		*/
+		float GetMeanEnergy(const float fStart, const float fEnd) const;
+
+		float							fBPM = 120.0f;				//!< 速度，每分钟拍数
+		float							fEnergyStep = 0.1f;			//!< 能量曲线的采样间隔，单位：秒
+		std::vector<float>				beatVec;					//!< 每一拍的时间
+		std::vector<float>				barVec;						//!< 每个小节（4拍）开始的时间
+		std::vector<float>				phraseVec;					//!< 每个乐段（4小节）开始的时间
+		std::vector<float>				energyVec;					//!< 能量曲线，[0.0, 1.0]
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMMusicAnalyzer
+	*  @brief 在后台线程中解码音乐，用FFT估计起音和速度，生成节拍网格
+	*  @brief 分析结果按文件内容的hash缓存在磁盘上，每首歌只分析一次
+	*/
+	class CGMMusicAnalyzer
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMMusicAnalyzer();
+		/** @brief 析构 */
+		~CGMMusicAnalyzer();
+
+		/** @brief 初始化，启动后台分析线程 */
+		bool Init(SGMConfigData* pConfigData);
+		/** @brief 释放，等待后台分析线程退出 */
+		void Release();
+
+		/**
+		* @brief 请求分析某个音频文件，立即返回
+		* @param strFile: 音频文件的完整路径
+		*/
+		void Request(const std::wstring& strFile);
+		/**
+		* @brief 获取某个音频文件的节拍网格
+		* @param strFile: 音频文件的完整路径
+		* @param pGrid: 输出，分析成功则为网格，否则为nullptr
+		* @return bool 分析已经结束（成功或者失败）true，还没有请求或者还在分析false
+		*/
+		bool GetGrid(const std::wstring& strFile, std::shared_ptr<const SGMMusicGrid>& pGrid);
+
+	private:
+		/** @brief 后台线程 */
+		void _WorkerLoop();
+		/**
+		* @brief 读取缓存，没有缓存则分析并写入缓存
+		* @param strFile: 音频文件的完整路径
+		* @param sGrid: 输出的节拍网格
+		* @return bool 成功true，失败false
+		*/
+		bool _LoadOrAnalyze(const std::wstring& strFile, SGMMusicGrid& sGrid);
+		/**
+		* @brief 解码音频并分析
+		* @param strFile: 音频文件的完整路径
+		* @param sGrid: 输出的节拍网格
+		* @return bool 成功true，失败或者中途退出返回false
+		*/
+		bool _Analyze(const std::wstring& strFile, SGMMusicGrid& sGrid);
+		/**
+		* @brief 根据文件内容计算缓存文件路径
+		* @param strFile: 音频文件的完整路径
+		* @return std::wstring 缓存文件路径，文件打不开则返回L""
+		*/
+		std::wstring _GetCachePath(const std::wstring& strFile) const;
+		/** @brief 读取缓存 */
+		bool _LoadCache(const std::wstring& strCache, SGMMusicGrid& sGrid) const;
+		/** @brief 写入缓存 */
+		bool _SaveCache(const std::wstring& strCache, const SGMMusicGrid& sGrid) const;
+
+		// 变量
+	private:
+		SGMConfigData*						m_pConfigData = nullptr;				//!< 配置数据
+		std::wstring						m_strCachePath = L"Cache/";				//!< 分析结果的缓存路径
+
+		std::thread							m_thread;								//!< 后台分析线程
+		std::mutex							m_mutex;								//!< 保护下面的队列和结果
+		std::condition_variable				m_condition;							//!< 有新任务时唤醒后台线程
+		std::atomic<bool>					m_bExit{ false };						//!< 后台线程退出标志
+		std::deque<std::wstring>			m_jobQueue;								//!< 等待分析的文件
+		std::set<std::wstring>				m_jobSet;								//!< 已经请求过的文件
+		std::map<std::wstring, std::shared_ptr<const SGMMusicGrid>> m_gridMap;	//!< 分析结果，失败的为nullptr
+	};
+}	// GM
@@ -0,0 +1,364 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMPassCache.cpp
+/// @brief		Galaxy-Music Engine - GMPassCache
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMPassCache.h"
+#include <osg/BufferIndexBinding>
+#include <osg/Geometry>
+#include <osg/Switch>
+#include <osg/Texture>
+#include <osg/Transform>
+#include <algorithm>
+
+using namespace GM;
+
+/*************************************************************************
+CGMPassVisitor
+*************************************************************************/
+
+namespace GM
+{
+	/*!
+	*  @class CGMPassVisitor
+	*  @brief 遍历pass的子图，把影响绘制结果的数据累加到FNV-1a 64位hash中
+	*  @brief 只累加修改次数和指针的地方，不读取顶点数据，每帧遍历的开销远小于剔除和绘制
+	*/
+	class CGMPassVisitor : public osg::NodeVisitor
+	{
+	public:
+		CGMPassVisitor(std::set<const osg::Texture*>& inputSet)
+			: osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), m_inputSet(inputSet) {}
+
+		virtual void apply(osg::Node& node)
+		{
+			AddNode(node);
+			traverse(node);
+		}
+
+		virtual void apply(osg::Transform& node)
+		{
+			AddNode(node);
+			osg::Matrix mLocal;
+			node.computeLocalToWorldMatrix(mLocal, this);
+			Add(mLocal.ptr(), sizeof(osg::Matrix::value_type) * 16);
+			traverse(node);
+		}
+
+		virtual void apply(osg::Switch& node)
+		{
+			AddNode(node);
+			for (auto itr : node.getValueList())
+			{
+				const bool bValue = itr;
+				Add(&bValue, sizeof(bValue));
+			}
+			traverse(node);
+		}
+
+		virtual void apply(osg::Geometry& geom)
+		{
+			AddNode(geom);
+			AddArray(geom.getVertexArray());
+			AddArray(geom.getNormalArray());
+			AddArray(geom.getColorArray());
+			for (auto& itr : geom.getTexCoordArrayList()) AddArray(itr.get());
+			for (auto& itr : geom.getVertexAttribArrayList()) AddArray(itr.get());
+			for (auto& itr : geom.getPrimitiveSetList())
+			{
+				AddPointer(itr.get());
+				AddCount(itr->getModifiedCount());
+			}
+		}
+
+		/** @brief 节点本身和它的状态集 */
+		void AddNode(const osg::Node& node)
+		{
+			AddPointer(&node);
+			const osg::Node::NodeMask iMask = node.getNodeMask();
+			Add(&iMask, sizeof(iMask));
+			AddStateSet(node.getStateSet());
+		}
+
+		/** @brief 状态集中的模式、宏定义、uniform、缓冲区和纹理 */
+		void AddStateSet(const osg::StateSet* pStateSet)
+		{
+			if (!pStateSet) return;
+			AddPointer(pStateSet);
+			for (auto& itr : pStateSet->getModeList())
+			{
+				Add(&itr.first, sizeof(itr.first));
+				Add(&itr.second, sizeof(itr.second));
+			}
+			for (auto& itr : pStateSet->getDefineList())
+			{
+				AddString(itr.first);
+				AddString(itr.second.first);
+			}
+			// uniform每帧都可能重新set同样的值，所以累加值而不是修改次数
+			for (auto& itr : pStateSet->getUniformList())
+			{
+				AddString(itr.first);
+				const osg::Uniform* pUniform = dynamic_cast<const osg::Uniform*>(itr.second.first.get());
+				if (!pUniform)
+				{
+					AddPointer(itr.second.first.get());
+					continue;
+				}
+				AddArrayData(pUniform->getFloatArray());
+				AddArrayData(pUniform->getDoubleArray());
+				AddArrayData(pUniform->getIntArray());
+				AddArrayData(pUniform->getUIntArray());
+			}
+			for (auto& itr : pStateSet->getAttributeList())
+			{
+				AddAttribute(itr.second.first.get());
+			}
+			for (auto& itrUnit : pStateSet->getTextureAttributeList())
+			{
+				for (auto& itr : itrUnit)
+				{
+					AddAttribute(itr.second.first.get());
+				}
+			}
+		}
+
+		void AddAttribute(const osg::StateAttribute* pAttribute)
+		{
+			if (!pAttribute) return;
+			AddPointer(pAttribute);
+			if (const osg::Texture* pTex = pAttribute->asTexture())
+			{
+				m_inputSet.insert(pTex);
+				for (unsigned int i = 0; i < pTex->getNumImages(); i++)
+				{
+					const osg::Image* pImage = pTex->getImage(i);
+					if (pImage) AddCount(pImage->getModifiedCount());
+				}
+			}
+			else if (const osg::BufferIndexBinding* pBinding = dynamic_cast<const osg::BufferIndexBinding*>(pAttribute))
+			{
+				const osg::BufferData* pData = pBinding->getBufferData();
+				if (pData) AddCount(pData->getModifiedCount());
+			}
+		}
+
+		void AddArray(const osg::Array* pArray)
+		{
+			if (!pArray) return;
+			AddPointer(pArray);
+			AddCount(pArray->getModifiedCount());
+		}
+
+		void AddArrayData(const osg::Array* pArray)
+		{
+			if (pArray) Add(pArray->getDataPointer(), pArray->getTotalDataSize());
+		}
+
+		void AddString(const std::string& str) { Add(str.data(), str.size()); }
+		void AddPointer(const void* p) { Add(&p, sizeof(p)); }
+		void AddCount(const unsigned int iCount) { Add(&iCount, sizeof(iCount)); }
+
+		void Add(const void* pData, const size_t iSize)
+		{
+			const unsigned char* pByte = static_cast<const unsigned char*>(pData);
+			for (size_t i = 0; i < iSize; i++)
+			{
+				m_iHash ^= pByte[i];
+				m_iHash *= 1099511628211ULL;
+			}
+		}
+
+		inline unsigned long long GetHash() const { return m_iHash; }
+
+	private:
+		std::set<const osg::Texture*>&		m_inputSet;
+		unsigned long long					m_iHash = 14695981039346656037ULL;
+	};
+}	// GM
+
+/*************************************************************************
+CGMPassCache Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMPassCache::CGMPassCache()
+{
+}
+
+/** @brief 析构 */
+CGMPassCache::~CGMPassCache()
+{
+	Restore();
+}
+
+/** @brief 添加RTT相机 */
+void CGMPassCache::Add(osg::Camera* pCamera)
+{
+	if (!pCamera) return;
+	for (auto& itr : m_passVec)
+	{
+		if (itr.pCamera == pCamera) return;
+	}
+
+	SGMCachedPass sPass;
+	sPass.pCamera = pCamera;
+	sPass.iNodeMask = pCamera->getNodeMask();
+	m_passVec.push_back(sPass);
+}
+
+/** @brief 移除RTT相机 */
+void CGMPassCache::Remove(osg::Camera* pCamera)
+{
+	for (auto itr = m_passVec.begin(); itr != m_passVec.end(); itr++)
+	{
+		if (itr->pCamera == pCamera)
+		{
+			if (itr->bSkipped) pCamera->setNodeMask(itr->iNodeMask);
+			m_passVec.erase(itr);
+			return;
+		}
+	}
+}
+
+/** @brief 强制下一帧重绘 */
+void CGMPassCache::Dirty(osg::Camera* pCamera)
+{
+	for (auto& itr : m_passVec)
+	{
+		if (!pCamera || itr.pCamera == pCamera)
+			itr.bDirty = true;
+	}
+}
+
+/** @brief 开关 */
+void CGMPassCache::SetEnable(const bool bEnable)
+{
+	m_bEnable = bEnable;
+	if (!m_bEnable) Dirty();
+}
+
+/** @brief 每帧在剔除之前调用 */
+void CGMPassCache::Update()
+{
+	// 相机已经释放的pass直接删掉
+	m_passVec.erase(std::remove_if(m_passVec.begin(), m_passVec.end(),
+		[](const SGMCachedPass& sPass) { return !sPass.pCamera.valid(); }), m_passVec.end());
+
+	std::set<const osg::Texture*> renderedSet;
+	for (auto& itr : m_passVec)
+	{
+		osg::Camera* pCamera = itr.pCamera.get();
+		// 上一帧绘制之后已经恢复，这里就是使用者设置的节点掩码
+		itr.iNodeMask = pCamera->getNodeMask();
+		itr.bSkipped = false;
+		// 使用者关闭的pass不参与，打开时重绘
+		if (0 == itr.iNodeMask)
+		{
+			itr.bDirty = true;
+			continue;
+		}
+
+		itr.outputSet.clear();
+		for (auto& itrAttach : pCamera->getBufferAttachmentMap())
+		{
+			if (itrAttach.second._texture.valid())
+				itr.outputSet.insert(itrAttach.second._texture.get());
+		}
+
+		const unsigned long long iSignature = _Signature(itr);
+		itr.bSkipped = m_bEnable && !itr.bDirty && (iSignature == itr.iSignature);
+		itr.iSignature = iSignature;
+		itr.bDirty = false;
+		if (!itr.bSkipped)
+			renderedSet.insert(itr.outputSet.begin(), itr.outputSet.end());
+	}
+
+	// 采样了重绘纹理的pass也要重绘，直到不再有新的重绘
+	bool bChanged = true;
+	while (bChanged)
+	{
+		bChanged = false;
+		for (auto& itr : m_passVec)
+		{
+			if (!itr.bSkipped) continue;
+			for (auto& itrTex : itr.inputSet)
+			{
+				if (renderedSet.end() == renderedSet.find(itrTex)) continue;
+				itr.bSkipped = false;
+				renderedSet.insert(itr.outputSet.begin(), itr.outputSet.end());
+				bChanged = true;
+				break;
+			}
+		}
+	}
+
+	m_iSkippedNum = 0;
+	for (auto& itr : m_passVec)
+	{
+		if (itr.bSkipped) m_iSkippedNum++;
+		itr.pCamera->setNodeMask(itr.bSkipped ? 0 : itr.iNodeMask);
+	}
+}
+
+/** @brief 剔除之后调用 */
+void CGMPassCache::Restore()
+{
+	for (auto& itr : m_passVec)
+	{
+		if (itr.bSkipped && itr.pCamera.valid())
+			itr.pCamera->setNodeMask(itr.iNodeMask);
+	}
+}
+
+unsigned long long CGMPassCache::_Signature(SGMCachedPass& sPass) const
+{
+	osg::Camera* pCamera = sPass.pCamera.get();
+	sPass.inputSet.clear();
+	CGMPassVisitor hVisitor(sPass.inputSet);
+	// 和剔除时一样，只遍历相机能看到的节点
+	hVisitor.setTraversalMask(pCamera->getCullMask());
+
+	// 相机本身
+	hVisitor.Add(pCamera->getViewMatrix().ptr(), sizeof(osg::Matrix::value_type) * 16);
+	hVisitor.Add(pCamera->getProjectionMatrix().ptr(), sizeof(osg::Matrix::value_type) * 16);
+	if (const osg::Viewport* pViewport = pCamera->getViewport())
+	{
+		const double fViewport[4] = { pViewport->x(), pViewport->y(), pViewport->width(), pViewport->height() };
+		hVisitor.Add(fViewport, sizeof(fViewport));
+	}
+	const GLbitfield iClearMask = pCamera->getClearMask();
+	hVisitor.Add(&iClearMask, sizeof(iClearMask));
+	hVisitor.Add(pCamera->getClearColor().ptr(), sizeof(osg::Vec4::value_type) * 4);
+	const osg::Node::NodeMask iCullMask = pCamera->getCullMask();
+	hVisitor.Add(&iCullMask, sizeof(iCullMask));
+	hVisitor.AddStateSet(pCamera->getStateSet());
+
+	// 父路径上继承下来的状态集，相对坐标系的相机还要累加父节点的变换
+	osg::NodePathList pathList = pCamera->getParentalNodePaths();
+	if (!pathList.empty())
+	{
+		osg::NodePath& path = pathList.front();
+		path.pop_back();
+		for (auto& itr : path)
+		{
+			hVisitor.AddStateSet(itr->getStateSet());
+		}
+		if (osg::Transform::RELATIVE_RF == pCamera->getReferenceFrame())
+		{
+			const osg::Matrix mParent = osg::computeLocalToWorld(path);
+			hVisitor.Add(mParent.ptr(), sizeof(osg::Matrix::value_type) * 16);
+		}
+	}
+
+	// 子图
+	pCamera->traverse(hVisitor);
+	return hVisitor.GetHash();
+}
+
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMPassCache.h
+/// @brief		Galaxy-Music Engine - GMPassCache
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <osg/Camera>
+#include <osg/observer_ptr>
+#include <set>
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMCachedPass
+	*  @brief 一个RTT pass的缓存状态
+	*/
+	struct SGMCachedPass
+	{
+		osg::observer_ptr<osg::Camera>		pCamera;						//!< RTT相机
+		std::set<const osg::Texture*>		inputSet;						//!< 子图中用到的纹理，其他pass重绘它们时这个pass也要重绘
+		std::set<const osg::Texture*>		outputSet;						//!< 相机的输出纹理
+		unsigned long long					iSignature = 0;					//!< 上一次绘制时输入的特征值
+		osg::Node::NodeMask					iNodeMask = ~0u;				//!< 相机原来的节点掩码
+		bool								bDirty = true;					//!< 下一帧必须重绘
+		bool								bSkipped = false;				//!< 这一帧是否跳过
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMPassCache
+	*  @brief RTT pass的变化检测：每帧在更新遍历之后、剔除之前计算每个pass输入的特征值，
+	*  @brief 包括相机的视图、投影矩阵和视口，子图的节点掩码、变换矩阵、顶点数组和图元的修改次数，
+	*  @brief 以及子图和父路径上状态集中uniform的值和缓冲区的修改次数
+	*  @brief 特征值不变的pass在剔除期间把相机的节点掩码设为0，整个跳过，使用者继续采样上一次的纹理
+	*  @brief 着色器中直接使用osg_FrameTime等内置变量的pass检测不到变化，不要添加
+	*/
+	class CGMPassCache
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMPassCache();
+		/** @brief 析构，恢复被跳过的相机的节点掩码 */
+		~CGMPassCache();
+
+		/**
+		* @brief 添加RTT相机，相机要已经attach好输出纹理
+		* @param pCamera: RTT相机，不持有引用
+		*/
+		void Add(osg::Camera* pCamera);
+		/** @brief 移除RTT相机，恢复它的节点掩码 */
+		void Remove(osg::Camera* pCamera);
+		/**
+		* @brief 强制下一帧重绘，比如纹理重新分配后
+		* @param pCamera: RTT相机，nullptr表示所有相机
+		*/
+		void Dirty(osg::Camera* pCamera = nullptr);
+		/** @brief 开关，关闭时每帧都重绘 */
+		void SetEnable(const bool bEnable);
+		inline bool GetEnable() const { return m_bEnable; }
+		/** @brief 每帧在剔除之前调用，决定哪些pass跳过 */
+		void Update();
+		/**
+		* @brief 剔除之后调用，恢复被跳过的相机的节点掩码
+		* 否则下一帧的事件和更新遍历也进不了被跳过的子图，其中的动画停下后就检测不到变化
+		*/
+		void Restore();
+		/** @brief 这一帧跳过的pass数量 */
+		inline int GetSkippedNum() const { return m_iSkippedNum; }
+
+	private:
+		/** @brief 计算pass输入的特征值，同时收集子图用到的纹理 */
+		unsigned long long _Signature(SGMCachedPass& sPass) const;
+
+		// 变量
+	private:
+		std::vector<SGMCachedPass>			m_passVec;						//!< 所有pass
+		int									m_iSkippedNum = 0;				//!< 这一帧跳过的pass数量
+		bool								m_bEnable = true;				//!< 开关
+	};
+}	// GM
@@ -13,6 +13,7 @@
 #include "GMPost.h"
 #include "GMCommonUniform.h"
 #include "GMKit.h"
+#include "GMDownsampler.h"
 #include <osg/CullFace>
 
 using namespace GM;
@@ -38,6 +39,7 @@ CGMPost::CGMPost() :
 /** @brief 析构 */
 CGMPost::~CGMPost()
 {
+	GM_DELETE(m_pSceneDownsampler);
 }
 
 /** @brief 初始化 */
@@ -86,6 +88,9 @@ void CGMPost::ResizeScreen(const int width, const int height)
 		m_pPostCam->setProjectionMatrixAsOrtho2D(0, width, 0, height);
 		m_pPostCam->dirtyAttachmentMap();
 	}
+	// 主相机已经修改了场景颜色图的尺寸，这里重新分配mipmap
+	if (m_pSceneDownsampler)
+		m_pSceneDownsampler->Resize(width, height);
 
 	_ResizeScreenTriangle(width, height);
 }
@@ -137,6 +142,20 @@ bool CGMPost::CreatePost(osg::Texture* pSceneTex,
 
 	osg::ref_ptr<osg::StateSet>	pSsPost = m_pPostGeode->getOrCreateStateSet();
 	pSsPost->addUniform(GM_UNIFORM.GetScreenSize());
+
+	// 场景颜色图在主相机之后、后期相机之前生成mipmap，后期用低层级做泛光
+	m_pSceneDownsampler = new CGMDownsampler();
+	if (m_pSceneDownsampler->Init(pSceneTex, m_pConfigData->strCorePath + m_strShaderPath,
+		osg::Camera::POST_RENDER, 50))
+	{
+		pSceneTex->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR_MIPMAP_LINEAR);
+		GM_Root->addChild(m_pSceneDownsampler->GetCamera());
+		pSsPost->setDefine("BLOOM", osg::StateAttribute::ON);
+	}
+	else
+	{
+		GM_DELETE(m_pSceneDownsampler);
+	}
 	//pSsPost->setDefine("VOLUME", m_bVolume ? osg::StateAttribute::ON : osg::StateAttribute::OFF);
 
 	CGMKit::AddTexture(pSsPost.get(), pSceneTex, "sceneTex", m_iPostUnit++);
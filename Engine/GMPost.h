@@ -29,6 +29,7 @@ namespace GM
 	/*************************************************************************
 	Class
 	*************************************************************************/
+	class CGMDownsampler;
 
 	/*!
 	*  @class CGMPost
@@ -76,6 +77,8 @@ namespace GM
 		* @return bool 成功true， 失败false
 		*/
 		bool SetVolumeEnable(bool bEnabled, osg::Texture* pVolumeTex = nullptr);
+		/** @brief 获取后期相机，每帧最后绘制 */
+		inline osg::Camera* GetPostCamera() const { return m_pPostCam.get(); }
 
 	private:
 		/**
@@ -106,6 +109,7 @@ namespace GM
 		osg::ref_ptr<osg::Geode>						m_pPostGeode;					//!< 渲染节点
 
 		osg::ref_ptr<osg::Texture>						m_pVolumeTex = nullptr;			//!< 体渲染颜色图
+		CGMDownsampler*									m_pSceneDownsampler = nullptr;	//!< 场景颜色图的mipmap，用于泛光
 
 		int												m_iPostUnit = 0;				//!< 后期面板当前可用的纹理单元
 		bool											m_bVolume = false;				//!< 体渲染开关
@@ -0,0 +1,635 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMProbeBaker.cpp
+/// @brief		Galaxy-Music Engine - GMProbeBaker
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMProbeBaker.h"
+#include "GMThreadPool.h"
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <direct.h>
+#include <osg/Math>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GM_PROBE_SSE 1
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define PROBE_WIDTH					512			// 探针贴图宽度，单位：像素
+#define PROBE_HEIGHT				256			// 探针贴图高度，单位：像素
+#define PROBE_SOURCE_WIDTH			2048		// 源图像缩小后的最大宽度，单位：像素
+#define PROBE_SH_WIDTH				128			// 投影球谐系数时使用的源图像最大宽度，单位：像素
+#define PROBE_SAMPLE_NUM			64			// 每个像素的GGX重要性采样数量
+#define PROBE_ROUGHNESS_SCALE		80.0		// 与shader一致：mipmapLevel = log2(roughness*80+1)
+#define PROBE_RGBM_RANGE			16.0f		// RGBM的最大亮度，与shader一致
+#define PROBE_CACHE_VERSION			1			// 缓存版本，烘焙算法或格式修改后加1
+
+/*************************************************************************
+Global Constants
+*************************************************************************/
+
+// DDS文件头，不包括"DDS "
+static const unsigned int DDS_HEADER_SIZE = 124;
+static const unsigned int DDS_FLAGS = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000 | 0x20000;	// CAPS|HEIGHT|WIDTH|PITCH|PIXELFORMAT|MIPMAPCOUNT
+static const unsigned int DDS_PF_RGBA = 0x40 | 0x1;									// RGB|ALPHAPIXELS
+static const unsigned int DDS_CAPS = 0x8 | 0x1000 | 0x400000;						// COMPLEX|TEXTURE|MIPMAP
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+/** @brief 32位的位反转，Hammersley点集的第二维 */
+static double RadicalInverse(unsigned int i)
+{
+	i = (i << 16u) | (i >> 16u);
+	i = ((i & 0x55555555u) << 1u) | ((i & 0xAAAAAAAAu) >> 1u);
+	i = ((i & 0x33333333u) << 2u) | ((i & 0xCCCCCCCCu) >> 2u);
+	i = ((i & 0x0F0F0F0Fu) << 4u) | ((i & 0xF0F0F0F0u) >> 4u);
+	i = ((i & 0x00FF00FFu) << 8u) | ((i & 0xFF00FF00u) >> 8u);
+	return double(i) * 2.3283064365386963e-10;
+}
+
+/**
+* @brief 探针贴图上的像素中心对应的方向，与shader中ReflectEnvironment互逆
+* @brief 每个半球是一个等面积的圆盘，半径 = sqrt(1-|z|)，圆盘外的像素取圆盘边缘的方向
+*/
+static osg::Vec3f ProbeTexelDir(const int x, const int y, const int iWidth, const int iHeight)
+{
+	const float fU = (x + 0.5f) / iWidth;
+	const float fV = (y + 0.5f) / iHeight;
+	const bool bUpper = fU >= 0.5f;
+	float fA = (fU - (bUpper ? 0.75f : 0.25f)) * 4.0f;
+	float fB = (fV - 0.5f) * 2.0f;
+	float fRho2 = fA * fA + fB * fB;
+	if (fRho2 > 1.0f)
+	{
+		const float fInv = 1.0f / sqrt(fRho2);
+		fA *= fInv;
+		fB *= fInv;
+		fRho2 = 1.0f;
+	}
+	const float fAbsZ = 1.0f - fRho2;
+	const float fScaleXY = sqrt(1.0f + fAbsZ);
+	osg::Vec3f vDir(fA * fScaleXY, fB * fScaleXY, bUpper ? fAbsZ : -fAbsZ);
+	vDir.normalize();
+	return vDir;
+}
+
+/*************************************************************************
+CGMProbeBaker Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMProbeBaker::CGMProbeBaker()
+{
+}
+
+/** @brief 析构 */
+CGMProbeBaker::~CGMProbeBaker()
+{
+}
+
+/** @brief 烘焙探针 */
+bool CGMProbeBaker::Bake(const std::wstring& strHDR, const std::wstring& strCacheDir)
+{
+	std::ifstream fIn(strHDR, std::ios::binary);
+	if (!fIn.is_open()) return false;
+	std::vector<unsigned char> vFile((std::istreambuf_iterator<char>(fIn)), std::istreambuf_iterator<char>());
+	fIn.close();
+	if (vFile.empty()) return false;
+
+	// FNV-1a 64位hash，混入缓存版本，算法修改后旧的缓存自动失效
+	unsigned long long iHash = 14695981039346656037ULL;
+	for (unsigned char c : vFile)
+	{
+		iHash ^= c;
+		iHash *= 1099511628211ULL;
+	}
+	iHash ^= PROBE_CACHE_VERSION;
+	iHash *= 1099511628211ULL;
+
+	std::wstringstream ss;
+	ss << strCacheDir << std::hex << std::setw(16) << std::setfill(L'0') << iHash;
+	const std::wstring strCache = ss.str();
+	if (_LoadCache(strCache)) return true;
+
+	SGMEnvLevel sLevel;
+	if (!_DecodeHDR(vFile, sLevel)) return false;
+	vFile.clear();
+	vFile.shrink_to_fit();
+
+	m_vSource.clear();
+	m_vSource.push_back(std::move(sLevel));
+	_BuildPyramid();
+	_Prefilter();
+	_ProjectIrradiance();
+	m_vSource.clear();
+
+	_wmkdir(strCacheDir.c_str());
+	_SaveCache(strCache);
+	return true;
+}
+
+bool CGMProbeBaker::_DecodeHDR(const std::vector<unsigned char>& vFile, SGMEnvLevel& sLevel) const
+{
+	const size_t iSize = vFile.size();
+	size_t iPos = 0;
+	// 逐行读取文件头，直到空行
+	auto fnReadLine = [&vFile, iSize, &iPos](std::string& strLine) -> bool
+	{
+		strLine.clear();
+		while (iPos < iSize && '\n' != vFile[iPos])
+		{
+			strLine.push_back(char(vFile[iPos++]));
+		}
+		if (iPos >= iSize) return false;
+		iPos++;
+		return true;
+	};
+
+	std::string strLine;
+	if (!fnReadLine(strLine) || 0 != strLine.compare(0, 2, "#?")) return false;
+	while (true)
+	{
+		if (!fnReadLine(strLine)) return false;
+		if (strLine.empty()) break;
+		if (0 == strLine.compare(0, 7, "FORMAT=") && std::string::npos == strLine.find("32-bit_rle_rgbe"))
+			return false;
+	}
+	// 只支持标准方向：自上而下、自左而右
+	int iWidth = 0;
+	int iHeight = 0;
+	if (!fnReadLine(strLine) || 2 != sscanf_s(strLine.c_str(), "-Y %d +X %d", &iHeight, &iWidth)) return false;
+	if (iWidth < 2 || iHeight <= 0) return false;
+
+	// 缩小到2的幂次宽度、2:1，每个目标像素是对应源像素的平均
+	const int iMaxWidth = (iWidth < PROBE_SOURCE_WIDTH) ? iWidth : PROBE_SOURCE_WIDTH;
+	int iDstW = 2;
+	while (iDstW * 2 <= iMaxWidth) iDstW *= 2;
+	while (iDstW > 2 && iDstW / 2 > iHeight) iDstW /= 2;
+	const int iDstH = iDstW / 2;
+	sLevel.iWidth = iDstW;
+	sLevel.iHeight = iDstH;
+	sLevel.fData.assign(size_t(iDstW) * iDstH * 4, 0.0f);
+	std::vector<int> vDstX(iWidth);
+	std::vector<float> vCountX(iDstW, 0.0f);
+	std::vector<float> vCountY(iDstH, 0.0f);
+	for (int x = 0; x < iWidth; x++)
+	{
+		vDstX[x] = int((long long)x * iDstW / iWidth);
+		vCountX[vDstX[x]] += 1.0f;
+	}
+
+	std::vector<unsigned char> vRGBE(size_t(iWidth) * 4);
+	for (int y = 0; y < iHeight; y++)
+	{
+		const bool bRLE = (iWidth >= 8) && (iWidth < 0x8000) && (iPos + 4 <= iSize)
+			&& (2 == vFile[iPos]) && (2 == vFile[iPos + 1]) && (((vFile[iPos + 2] << 8) | vFile[iPos + 3]) == iWidth);
+		if (bRLE)
+		{
+			// 新式游程编码，4个通道分开存放
+			iPos += 4;
+			for (int c = 0; c < 4; c++)
+			{
+				int x = 0;
+				while (x < iWidth)
+				{
+					if (iPos >= iSize) return false;
+					int iNum = vFile[iPos++];
+					if (iNum > 128)
+					{
+						iNum -= 128;
+						if (x + iNum > iWidth || iPos >= iSize) return false;
+						const unsigned char cValue = vFile[iPos++];
+						for (int i = 0; i < iNum; i++, x++) vRGBE[x * 4 + c] = cValue;
+					}
+					else
+					{
+						if (0 == iNum || x + iNum > iWidth || iPos + iNum > iSize) return false;
+						for (int i = 0; i < iNum; i++, x++) vRGBE[x * 4 + c] = vFile[iPos++];
+					}
+				}
+			}
+		}
+		else
+		{
+			// 没有压缩的扫描线
+			if (iPos + vRGBE.size() > iSize) return false;
+			memcpy(vRGBE.data(), vFile.data() + iPos, vRGBE.size());
+			iPos += vRGBE.size();
+		}
+
+		// 文件第0行在最上方，存到最后一行
+		const int iDstY = iDstH - 1 - int((long long)y * iDstH / iHeight);
+		vCountY[iDstY] += 1.0f;
+		float* pRow = sLevel.fData.data() + size_t(iDstY) * iDstW * 4;
+		for (int x = 0; x < iWidth; x++)
+		{
+			const unsigned char* pTexel = vRGBE.data() + x * 4;
+			if (0 == pTexel[3]) continue;
+			const float fScale = float(ldexp(1.0, int(pTexel[3]) - 136));
+			float* pDst = pRow + vDstX[x] * 4;
+			pDst[0] += (pTexel[0] + 0.5f) * fScale;
+			pDst[1] += (pTexel[1] + 0.5f) * fScale;
+			pDst[2] += (pTexel[2] + 0.5f) * fScale;
+		}
+	}
+
+	// 除以每个目标像素覆盖的源像素数量
+	for (int y = 0; y < iDstH; y++)
+	{
+		float* pRow = sLevel.fData.data() + size_t(y) * iDstW * 4;
+		for (int x = 0; x < iDstW; x++)
+		{
+			const float fInvNum = 1.0f / (vCountX[x] * vCountY[y]);
+			pRow[x * 4] *= fInvNum;
+			pRow[x * 4 + 1] *= fInvNum;
+			pRow[x * 4 + 2] *= fInvNum;
+			pRow[x * 4 + 3] = 1.0f;
+		}
+	}
+	return true;
+}
+
+void CGMProbeBaker::_BuildPyramid()
+{
+	while (m_vSource.back().iHeight > 1)
+	{
+		const SGMEnvLevel& sSrc = m_vSource.back();
+		SGMEnvLevel sDst;
+		sDst.iWidth = sSrc.iWidth / 2;
+		sDst.iHeight = sSrc.iHeight / 2;
+		sDst.fData.resize(size_t(sDst.iWidth) * sDst.iHeight * 4);
+
+		const float* pSrc = sSrc.fData.data();
+		float* pDst = sDst.fData.data();
+		const int iSrcW = sSrc.iWidth;
+		const int iSrcH = sSrc.iHeight;
+		const int iDstW = sDst.iWidth;
+		GM_THREADPOOL.ParallelFor(0, sDst.iHeight, [pSrc, pDst, iSrcW, iSrcH, iDstW](int iBegin, int iEnd)
+		{
+			for (int y = iBegin; y < iEnd; y++)
+			{
+				// 两行按立体角加权，否则靠近两极的行在低分辨率层中占比过大
+				const float fCos0 = float(cos(((2 * y + 0.5) / iSrcH - 0.5) * osg::PI));
+				const float fCos1 = float(cos(((2 * y + 1.5) / iSrcH - 0.5) * osg::PI));
+				const float fW0 = 0.5f * fCos0 / (fCos0 + fCos1);
+				const float fW1 = 0.5f * fCos1 / (fCos0 + fCos1);
+
+				const float* pRow0 = pSrc + size_t(2 * y) * iSrcW * 4;
+				const float* pRow1 = pRow0 + size_t(iSrcW) * 4;
+				float* pOut = pDst + size_t(y) * iDstW * 4;
+				for (int x = 0; x < iDstW; x++)
+				{
+#ifdef GM_PROBE_SSE
+					__m128 vSum = _mm_add_ps(
+						_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pRow0 + x * 8), _mm_loadu_ps(pRow0 + x * 8 + 4)), _mm_set1_ps(fW0)),
+						_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pRow1 + x * 8), _mm_loadu_ps(pRow1 + x * 8 + 4)), _mm_set1_ps(fW1)));
+					_mm_storeu_ps(pOut + x * 4, vSum);
+#else
+					for (int c = 0; c < 4; c++)
+					{
+						pOut[x * 4 + c] = fW0 * (pRow0[x * 8 + c] + pRow0[x * 8 + 4 + c])
+							+ fW1 * (pRow1[x * 8 + c] + pRow1[x * 8 + 4 + c]);
+					}
+#endif
+				}
+			}
+		});
+		m_vSource.push_back(std::move(sDst));
+	}
+}
+
+void CGMProbeBaker::_Prefilter()
+{
+	int iLevelNum = 1;
+	size_t iTotal = size_t(PROBE_WIDTH) * PROBE_HEIGHT * 4;
+	osg::Image::MipmapDataType vOffset;
+	for (int w = PROBE_WIDTH, h = PROBE_HEIGHT; w > 1 || h > 1; iLevelNum++)
+	{
+		w = (w > 1) ? w / 2 : 1;
+		h = (h > 1) ? h / 2 : 1;
+		vOffset.push_back((unsigned int)iTotal);
+		iTotal += size_t(w) * h * 4;
+	}
+	unsigned char* pData = new unsigned char[iTotal];
+
+	// 源图像第0层像素的平均立体角
+	const double fSrcOmega = 4.0 * osg::PI / (double(m_vSource[0].iWidth) * m_vSource[0].iHeight);
+	const float fMaxLod = float(m_vSource.size() - 1);
+
+	size_t iOffset = 0;
+	int iLevelW = PROBE_WIDTH;
+	int iLevelH = PROBE_HEIGHT;
+	for (int k = 0; k < iLevelNum; k++)
+	{
+		// 与shader一致：mipmapLevel = log2(roughness*80+1)
+		const double fRoughness = fmin(1.0, (pow(2.0, k) - 1.0) / PROBE_ROUGHNESS_SCALE);
+		const double fAlpha = fRoughness * fRoughness;
+		const double fAlpha2 = fmax(fAlpha * fAlpha, 1e-12);
+		// 每个半球是半径为W/4像素的等面积圆盘，一个像素的立体角是 2π/(π*W*W/16)
+		const double fTexelOmega = 32.0 / (double(iLevelW) * iLevelW);
+		const float fLodMin = float(fmax(0.0, 0.5 * log2(fTexelOmega / fSrcOmega)));
+
+		// 以法线为z轴的切线空间中的采样方向、权重和源层级，所有像素共用
+		std::vector<osg::Vec4f> vSample;
+		if (0 == k)
+		{
+			vSample.push_back(osg::Vec4f(0.0f, 0.0f, 1.0f, fLodMin));
+		}
+		else
+		{
+			for (unsigned int i = 0; i < PROBE_SAMPLE_NUM; i++)
+			{
+				const double fPhi = 2.0 * osg::PI * i / PROBE_SAMPLE_NUM;
+				const double fE = RadicalInverse(i);
+				const double fCos2 = (1.0 - fE) / (1.0 + (fAlpha2 - 1.0) * fE);
+				const double fCosH = sqrt(fCos2);
+				const double fSinH = sqrt(fmax(0.0, 1.0 - fCos2));
+				// 视线等于法线，L = 2(N·H)H - N
+				const double fLz = 2.0 * fCos2 - 1.0;
+				if (fLz <= 0.0) continue;
+				const double fLx = 2.0 * fCosH * fSinH * cos(fPhi);
+				const double fLy = 2.0 * fCosH * fSinH * sin(fPhi);
+				// pdf(L) = D*(N·H)/(4*(V·H)) = D/4
+				const double fDenom = fCos2 * (fAlpha2 - 1.0) + 1.0;
+				const double fD = fAlpha2 / (osg::PI * fDenom * fDenom);
+				const double fSampleOmega = 4.0 / (PROBE_SAMPLE_NUM * fD);
+				const float fLod = float(fmax(double(fLodMin), 0.5 * log2(fSampleOmega / fSrcOmega) + 1.0));
+				vSample.push_back(osg::Vec4f(float(fLx), float(fLy), float(fLz), fmin(fLod, fMaxLod)));
+			}
+		}
+
+		unsigned char* pLevel = pData + iOffset;
+		const int iW = iLevelW;
+		const int iH = iLevelH;
+		GM_THREADPOOL.ParallelFor(0, iH, [this, pLevel, iW, iH, &vSample](int iBegin, int iEnd)
+		{
+			for (int y = iBegin; y < iEnd; y++)
+			{
+				for (int x = 0; x < iW; x++)
+				{
+					const osg::Vec3f vN = ProbeTexelDir(x, y, iW, iH);
+					const osg::Vec3f vUp = (fabs(vN.z()) < 0.999f) ? osg::Vec3f(0, 0, 1) : osg::Vec3f(1, 0, 0);
+					osg::Vec3f vT = vUp ^ vN;
+					vT.normalize();
+					const osg::Vec3f vB = vN ^ vT;
+
+					osg::Vec4f vSum(0, 0, 0, 0);
+					float fWeight = 0.0f;
+					for (const osg::Vec4f& vS : vSample)
+					{
+						osg::Vec3f vL = vT * vS.x() + vB * vS.y() + vN * vS.z();
+						vL.normalize();
+						vSum += _Sample(vL, vS.w()) * vS.z();
+						fWeight += vS.z();
+					}
+					const osg::Vec3f vColor = osg::Vec3f(vSum.x(), vSum.y(), vSum.z()) / fmax(fWeight, 1e-6f);
+
+					// RGBM编码：color = rgb*a*a*16
+					const float fMax = fmax(vColor.x(), fmax(vColor.y(), vColor.z()));
+					const float fM = fmin(1.0f, fmax(fMax / PROBE_RGBM_RANGE, 1e-6f));
+					const float fA = ceil(sqrt(fM) * 255.0f) / 255.0f;
+					const float fScale = 255.0f / (fA * fA * PROBE_RGBM_RANGE);
+					unsigned char* pOut = pLevel + (size_t(y) * iW + x) * 4;
+					pOut[0] = (unsigned char)fmin(255.0f, vColor.x() * fScale + 0.5f);
+					pOut[1] = (unsigned char)fmin(255.0f, vColor.y() * fScale + 0.5f);
+					pOut[2] = (unsigned char)fmin(255.0f, vColor.z() * fScale + 0.5f);
+					pOut[3] = (unsigned char)(fA * 255.0f + 0.5f);
+				}
+			}
+		});
+
+		iOffset += size_t(iLevelW) * iLevelH * 4;
+		iLevelW = (iLevelW > 1) ? iLevelW / 2 : 1;
+		iLevelH = (iLevelH > 1) ? iLevelH / 2 : 1;
+	}
+
+	m_pProbeImage = new osg::Image;
+	m_pProbeImage->setImage(PROBE_WIDTH, PROBE_HEIGHT, 1, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE,
+		pData, osg::Image::USE_NEW_DELETE);
+	m_pProbeImage->setMipmapLevels(vOffset);
+}
+
+void CGMProbeBaker::_ProjectIrradiance()
+{
+	// 使用不超过PROBE_SH_WIDTH宽的一层，球谐只有低频，足够精确
+	size_t iLevel = 0;
+	while (iLevel + 1 < m_vSource.size() && m_vSource[iLevel].iWidth > PROBE_SH_WIDTH) iLevel++;
+	const SGMEnvLevel& sLevel = m_vSource[iLevel];
+	const int iW = sLevel.iWidth;
+	const int iH = sLevel.iHeight;
+
+	// 每行单独累加，最后按行求和，结果与线程数无关
+	std::vector<double> vRowSum(size_t(iH) * 27, 0.0);
+	GM_THREADPOOL.ParallelFor(0, iH, [&sLevel, &vRowSum, iW, iH](int iBegin, int iEnd)
+	{
+		for (int y = iBegin; y < iEnd; y++)
+		{
+			const double fElev = ((y + 0.5) / iH - 0.5) * osg::PI;
+			const double fOmega = (2.0 * osg::PI / iW) * (osg::PI / iH) * cos(fElev);
+			double* pSum = vRowSum.data() + size_t(y) * 27;
+			for (int x = 0; x < iW; x++)
+			{
+				const double fAzim = ((x + 0.5) / iW - 0.5) * 2.0 * osg::PI;
+				const double fX = cos(fElev) * cos(fAzim);
+				const double fY = cos(fElev) * sin(fAzim);
+				const double fZ = sin(fElev);
+				const double fBasis[9] = { 1.0, fY, fZ, fX, fX * fY, fY * fZ, 3.0 * fZ * fZ - 1.0, fX * fZ, fX * fX - fY * fY };
+				const float* pTexel = sLevel.fData.data() + (size_t(y) * iW + x) * 4;
+				for (int i = 0; i < 9; i++)
+				{
+					const double fW = fBasis[i] * fOmega;
+					pSum[i * 3] += pTexel[0] * fW;
+					pSum[i * 3 + 1] += pTexel[1] * fW;
+					pSum[i * 3 + 2] += pTexel[2] * fW;
+				}
+			}
+		}
+	});
+
+	// 基函数的常数K，卷积核A：π, 2π/3, π/4
+	// 辐照度除以π = Σ L*K*A/π * K*poly，shader中只计算poly
+	const double fK[9] = { 0.282095, 0.488603, 0.488603, 0.488603, 1.092548, 1.092548, 0.315392, 1.092548, 0.546274 };
+	const double fA[9] = { 1.0, 2.0 / 3.0, 2.0 / 3.0, 2.0 / 3.0, 0.25, 0.25, 0.25, 0.25, 0.25 };
+	m_vIrradiance.assign(9, osg::Vec3f(0, 0, 0));
+	for (int i = 0; i < 9; i++)
+	{
+		double fSum[3] = { 0.0, 0.0, 0.0 };
+		for (int y = 0; y < iH; y++)
+		{
+			for (int c = 0; c < 3; c++) fSum[c] += vRowSum[size_t(y) * 27 + i * 3 + c];
+		}
+		const double fScale = fK[i] * fK[i] * fA[i];
+		m_vIrradiance[i].set(float(fSum[0] * fScale), float(fSum[1] * fScale), float(fSum[2] * fScale));
+	}
+}
+
+osg::Vec4f CGMProbeBaker::_Sample(const osg::Vec3f& vDir, float fLod) const
+{
+	const float fU = 0.5f + atan2(vDir.y(), vDir.x()) / float(2.0 * osg::PI);
+	const float fV = 0.5f + asin(fmax(-1.0f, fmin(1.0f, vDir.z()))) / float(osg::PI);
+
+	fLod = fmax(0.0f, fmin(fLod, float(m_vSource.size() - 1)));
+	const int iLevel0 = int(fLod);
+	const int iLevel1 = (iLevel0 + 1 < int(m_vSource.size())) ? iLevel0 + 1 : iLevel0;
+	const float fT = fLod - iLevel0;
+
+	float fColor0[4];
+	_SampleLevel(iLevel0, fU * m_vSource[iLevel0].iWidth - 0.5f, fV * m_vSource[iLevel0].iHeight - 0.5f, fColor0);
+	if (iLevel1 == iLevel0 || fT <= 0.0f)
+		return osg::Vec4f(fColor0[0], fColor0[1], fColor0[2], fColor0[3]);
+
+	float fColor1[4];
+	_SampleLevel(iLevel1, fU * m_vSource[iLevel1].iWidth - 0.5f, fV * m_vSource[iLevel1].iHeight - 0.5f, fColor1);
+	return osg::Vec4f(
+		fColor0[0] + (fColor1[0] - fColor0[0]) * fT,
+		fColor0[1] + (fColor1[1] - fColor0[1]) * fT,
+		fColor0[2] + (fColor1[2] - fColor0[2]) * fT,
+		fColor0[3] + (fColor1[3] - fColor0[3]) * fT);
+}
+
+void CGMProbeBaker::_SampleLevel(const int iLevel, const float fX, const float fY, float* pOut) const
+{
+	const SGMEnvLevel& sLevel = m_vSource[iLevel];
+	const int iW = sLevel.iWidth;
+	const int iH = sLevel.iHeight;
+
+	const float fFloorX = floor(fX);
+	const float fFloorY = floor(fY);
+	const float fTx = fX - fFloorX;
+	const float fTy = fY - fFloorY;
+	// 水平方向循环，竖直方向截断
+	int x0 = int(fFloorX) % iW;
+	if (x0 < 0) x0 += iW;
+	const int x1 = (x0 + 1 < iW) ? x0 + 1 : 0;
+	const int y0 = (fFloorY < 0.0f) ? 0 : ((int(fFloorY) < iH) ? int(fFloorY) : iH - 1);
+	const int y1 = (y0 + 1 < iH && fFloorY >= 0.0f) ? y0 + 1 : y0;
+
+	const float* p00 = sLevel.fData.data() + (size_t(y0) * iW + x0) * 4;
+	const float* p10 = sLevel.fData.data() + (size_t(y0) * iW + x1) * 4;
+	const float* p01 = sLevel.fData.data() + (size_t(y1) * iW + x0) * 4;
+	const float* p11 = sLevel.fData.data() + (size_t(y1) * iW + x1) * 4;
+	const float fW00 = (1.0f - fTx) * (1.0f - fTy);
+	const float fW10 = fTx * (1.0f - fTy);
+	const float fW01 = (1.0f - fTx) * fTy;
+	const float fW11 = fTx * fTy;
+#ifdef GM_PROBE_SSE
+	__m128 vSum = _mm_mul_ps(_mm_loadu_ps(p00), _mm_set1_ps(fW00));
+	vSum = _mm_add_ps(vSum, _mm_mul_ps(_mm_loadu_ps(p10), _mm_set1_ps(fW10)));
+	vSum = _mm_add_ps(vSum, _mm_mul_ps(_mm_loadu_ps(p01), _mm_set1_ps(fW01)));
+	vSum = _mm_add_ps(vSum, _mm_mul_ps(_mm_loadu_ps(p11), _mm_set1_ps(fW11)));
+	_mm_storeu_ps(pOut, vSum);
+#else
+	for (int c = 0; c < 4; c++)
+	{
+		pOut[c] = p00[c] * fW00 + p10[c] * fW10 + p01[c] * fW01 + p11[c] * fW11;
+	}
+#endif
+}
+
+bool CGMProbeBaker::_LoadCache(const std::wstring& strCache)
+{
+	// 辐照度
+	std::ifstream fIrr(strCache + L".irr", std::ios::binary);
+	if (!fIrr.is_open()) return false;
+	char szMagic[4] = { 0 };
+	int iVersion = 0;
+	fIrr.read(szMagic, 4);
+	fIrr.read((char*)&iVersion, sizeof(int));
+	if (!fIrr || 0 != memcmp(szMagic, "GMIR", 4) || PROBE_CACHE_VERSION != iVersion) return false;
+	std::vector<osg::Vec3f> vIrradiance(9);
+	fIrr.read((char*)vIrradiance.data(), sizeof(osg::Vec3f) * 9);
+	if (!fIrr) return false;
+
+	// 探针贴图，只接受自己写入的无压缩RGBA格式
+	std::ifstream fDDS(strCache + L".dds", std::ios::binary);
+	if (!fDDS.is_open()) return false;
+	unsigned int iHeader[32] = { 0 };
+	fDDS.read((char*)iHeader, sizeof(iHeader));
+	if (!fDDS || 0 != memcmp(iHeader, "DDS ", 4) || DDS_HEADER_SIZE != iHeader[1]
+		|| PROBE_HEIGHT != iHeader[3] || PROBE_WIDTH != iHeader[4]
+		|| DDS_PF_RGBA != iHeader[20] || 32 != iHeader[22] || 0xff != iHeader[23])
+		return false;
+
+	const int iLevelNum = int(iHeader[7]);
+	size_t iTotal = 0;
+	osg::Image::MipmapDataType vOffset;
+	for (int k = 0, w = PROBE_WIDTH, h = PROBE_HEIGHT; k < iLevelNum; k++)
+	{
+		if (k > 0) vOffset.push_back((unsigned int)iTotal);
+		iTotal += size_t(w) * h * 4;
+		w = (w > 1) ? w / 2 : 1;
+		h = (h > 1) ? h / 2 : 1;
+	}
+	if (0 == iTotal) return false;
+	unsigned char* pData = new unsigned char[iTotal];
+	fDDS.read((char*)pData, iTotal);
+	if (!fDDS)
+	{
+		delete[] pData;
+		return false;
+	}
+
+	m_pProbeImage = new osg::Image;
+	m_pProbeImage->setImage(PROBE_WIDTH, PROBE_HEIGHT, 1, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE,
+		pData, osg::Image::USE_NEW_DELETE);
+	m_pProbeImage->setMipmapLevels(vOffset);
+	m_vIrradiance = vIrradiance;
+	return true;
+}
+
+bool CGMProbeBaker::_SaveCache(const std::wstring& strCache) const
+{
+	if (!m_pProbeImage.valid() || 9 != m_vIrradiance.size()) return false;
+
+	std::ofstream fDDS(strCache + L".dds", std::ios::binary | std::ios::trunc);
+	if (!fDDS.is_open()) return false;
+	unsigned int iHeader[32] = { 0 };
+	memcpy(iHeader, "DDS ", 4);
+	iHeader[1] = DDS_HEADER_SIZE;
+	iHeader[2] = DDS_FLAGS;
+	iHeader[3] = PROBE_HEIGHT;
+	iHeader[4] = PROBE_WIDTH;
+	iHeader[5] = PROBE_WIDTH * 4;
+	iHeader[7] = m_pProbeImage->getNumMipmapLevels();
+	// 像素格式：32位，R、G、B、A依次存放
+	iHeader[19] = 32;
+	iHeader[20] = DDS_PF_RGBA;
+	iHeader[22] = 32;
+	iHeader[23] = 0x000000ff;
+	iHeader[24] = 0x0000ff00;
+	iHeader[25] = 0x00ff0000;
+	iHeader[26] = 0xff000000;
+	iHeader[27] = DDS_CAPS;
+	fDDS.write((const char*)iHeader, sizeof(iHeader));
+	fDDS.write((const char*)m_pProbeImage->data(), m_pProbeImage->getTotalSizeInBytesIncludingMipmaps());
+	fDDS.close();
+	if (fDDS.fail()) return false;
+
+	// dds写完再写辐照度，读取时以它存在为准
+	std::ofstream fIrr(strCache + L".irr", std::ios::binary | std::ios::trunc);
+	if (!fIrr.is_open()) return false;
+	int iVersion = PROBE_CACHE_VERSION;
+	fIrr.write("GMIR", 4);
+	fIrr.write((const char*)&iVersion, sizeof(int));
+	fIrr.write((const char*)m_vIrradiance.data(), sizeof(osg::Vec3f) * 9);
+	fIrr.close();
+	return !fIrr.fail();
+}
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMProbeBaker.h
+/// @brief		Galaxy-Music Engine - GMProbeBaker
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <osg/Image>
+#include <osg/Vec3f>
+#include <osg/Vec4f>
+#include <string>
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMEnvLevel
+	*  @brief 等距柱状投影的一层float4图像，行0在最下方（-z）
+	*/
+	struct SGMEnvLevel
+	{
+		int						iWidth = 0;					//!< 宽度，单位：像素
+		int						iHeight = 0;				//!< 高度，单位：像素
+		std::vector<float>		fData;						//!< RGBA，每个像素4个float
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMProbeBaker
+	*  @brief 把.hdr全景图烘焙成环境探针：每层mipmap按GGX重要性采样预过滤，
+	*  @brief 并投影出9个球谐系数的漫反射辐照度
+	*  @brief 探针是2:1的RGBM贴图，左半是z<0的半球、右半是z>=0的半球，与模型shader的ReflectEnvironment一致
+	*  @brief 结果按源文件内容的hash缓存成dds，源文件不变时直接读取缓存
+	*/
+	class CGMProbeBaker
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMProbeBaker();
+		/** @brief 析构 */
+		~CGMProbeBaker();
+
+		/**
+		* @brief 烘焙探针，缓存有效时直接读取
+		* @param strHDR: .hdr全景图，Radiance RGBE格式
+		* @param strCacheDir: 缓存目录，以"/"结尾
+		* @return bool 成功true，源文件不存在或者格式不支持返回false
+		*/
+		bool Bake(const std::wstring& strHDR, const std::wstring& strCacheDir);
+		/** @brief 探针贴图，带完整的mipmap，Bake成功后有效 */
+		inline osg::Image* GetProbeImage() const { return m_pProbeImage.get(); }
+		/**
+		* @brief 漫反射辐照度的球谐系数，已经乘上卷积核、除以π并且乘上基函数的常数
+		* @brief 顺序：1, y, z, x, xy, yz, 3z^2-1, xz, x^2-y^2
+		*/
+		inline const std::vector<osg::Vec3f>& GetIrradiance() const { return m_vIrradiance; }
+
+	private:
+		/**
+		* @brief 解码RGBE，同时缩小到不超过PROBE_SOURCE_WIDTH的2的幂次宽度
+		* @param vFile: 文件内容
+		* @param sLevel: 输出，源图像的第0层
+		* @return bool 成功true
+		*/
+		bool _DecodeHDR(const std::vector<unsigned char>& vFile, SGMEnvLevel& sLevel) const;
+		/** @brief 生成源图像的金字塔，每层宽高减半 */
+		void _BuildPyramid();
+		/** @brief 逐层预过滤，生成RGBM探针贴图 */
+		void _Prefilter();
+		/** @brief 投影球谐系数 */
+		void _ProjectIrradiance();
+		/**
+		* @brief 三线性采样源金字塔
+		* @param vDir: 单位方向
+		* @param fLod: 源金字塔的层级
+		*/
+		osg::Vec4f _Sample(const osg::Vec3f& vDir, float fLod) const;
+		/** @brief 双线性采样源金字塔的一层，水平方向循环 */
+		void _SampleLevel(const int iLevel, const float fX, const float fY, float* pOut) const;
+
+		/** @brief 读取缓存，成功true */
+		bool _LoadCache(const std::wstring& strCache);
+		/** @brief 写入缓存，成功true */
+		bool _SaveCache(const std::wstring& strCache) const;
+
+		// 变量
+	private:
+		std::vector<SGMEnvLevel>			m_vSource;				//!< 源图像的金字塔，烘焙结束后清空
+		osg::ref_ptr<osg::Image>			m_pProbeImage;			//!< 探针贴图
+		std::vector<osg::Vec3f>				m_vIrradiance;			//!< 9个球谐系数
+	};
+}	// GM
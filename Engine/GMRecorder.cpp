@@ -0,0 +1,274 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMRecorder.cpp
+/// @brief		Galaxy-Music Engine - GMRecorder
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMRecorder.h"
+#include <cstring>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define RECORD_FILE_VERSION			1			// 日志版本，事件格式改变时需要增加
+#define RECORD_MAX_STRING			4096		// 字符串的最大长度
+
+static const char g_strRecordMagic[4] = { 'G', 'M', 'R', 'L' };
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+template<typename T>
+static void Put(std::ofstream& fOut, const T& value)
+{
+	fOut.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool Get(std::ifstream& fIn, T& value)
+{
+	return bool(fIn.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/** @brief 浮点数按float保存，日志更紧凑 */
+static void PutFloats(std::ofstream& fOut, const double* pValue, const int iNum)
+{
+	for (int i = 0; i < iNum; i++) Put(fOut, static_cast<float>(pValue[i]));
+}
+
+static bool GetFloats(std::ifstream& fIn, double* pValue, const int iNum)
+{
+	for (int i = 0; i < iNum; i++)
+	{
+		float f = 0.0f;
+		if (!Get(fIn, f)) return false;
+		pValue[i] = f;
+	}
+	return true;
+}
+
+/*************************************************************************
+CGMRecorder Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMRecorder::CGMRecorder()
+{
+}
+
+/** @brief 析构 */
+CGMRecorder::~CGMRecorder()
+{
+	if (IsRecording()) m_fOut.close();
+}
+
+bool CGMRecorder::StartRecord(const std::string& strFile, const uint32_t iSeed, const int iWidth, const int iHeight)
+{
+	if (IsRecording() || IsReplaying()) return false;
+
+	m_fOut.open(strFile, std::ios::binary | std::ios::trunc);
+	if (!m_fOut.is_open()) return false;
+
+	m_iSeed = iSeed;
+	m_iWidth = iWidth;
+	m_iHeight = iHeight;
+
+	m_fOut.write(g_strRecordMagic, sizeof(g_strRecordMagic));
+	Put(m_fOut, uint32_t(RECORD_FILE_VERSION));
+	Put(m_fOut, m_iSeed);
+	Put(m_fOut, int32_t(m_iWidth));
+	Put(m_fOut, int32_t(m_iHeight));
+	return bool(m_fOut);
+}
+
+void CGMRecorder::StopRecord(const uint32_t iTime)
+{
+	if (!IsRecording()) return;
+
+	SGMRecordEvent sEnd(EGMRECORD_END);
+	sEnd.iTime = iTime;
+	_Write(sEnd);
+	m_fOut.close();
+}
+
+void CGMRecorder::Record(const SGMRecordEvent& sEvent)
+{
+	if (!IsRecording() || EGMRECORD_END == sEvent.eType) return;
+	_Write(sEvent);
+}
+
+bool CGMRecorder::StartReplay(const std::string& strFile)
+{
+	if (IsRecording() || IsReplaying()) return false;
+
+	std::ifstream fIn(strFile, std::ios::binary);
+	if (!fIn.is_open()) return false;
+
+	char strMagic[4] = { 0 };
+	uint32_t iVersion = 0;
+	int32_t iWidth = 0;
+	int32_t iHeight = 0;
+	if (!fIn.read(strMagic, sizeof(strMagic)) || 0 != memcmp(strMagic, g_strRecordMagic, sizeof(strMagic))
+		|| !Get(fIn, iVersion) || RECORD_FILE_VERSION != iVersion
+		|| !Get(fIn, m_iSeed) || !Get(fIn, iWidth) || !Get(fIn, iHeight))
+		return false;
+
+	// 异常退出时没有结束事件，读到最后一个完整的事件为止
+	std::vector<SGMRecordEvent> vEvent;
+	SGMRecordEvent sEvent;
+	while (_Read(fIn, sEvent))
+	{
+		if (!vEvent.empty() && sEvent.iTime < vEvent.back().iTime) return false;
+		vEvent.push_back(sEvent);
+		if (EGMRECORD_END == sEvent.eType) break;
+	}
+
+	m_eventVec.swap(vEvent);
+	m_iNext = 0;
+	m_iWidth = iWidth;
+	m_iHeight = iHeight;
+	m_bReplay = true;
+	return true;
+}
+
+void CGMRecorder::StopReplay()
+{
+	m_bReplay = false;
+	m_eventVec.clear();
+	m_iNext = 0;
+}
+
+bool CGMRecorder::PopEvent(const uint32_t iTime, SGMRecordEvent& sEvent)
+{
+	if (!m_bReplay || IsReplayFinished() || m_eventVec[m_iNext].iTime > iTime) return false;
+
+	sEvent = m_eventVec[m_iNext++];
+	return true;
+}
+
+uint32_t CGMRecorder::GetDuration() const
+{
+	return m_eventVec.empty() ? 0 : m_eventVec.back().iTime;
+}
+
+void CGMRecorder::_Write(const SGMRecordEvent& sEvent)
+{
+	Put(m_fOut, sEvent.iTime);
+	Put(m_fOut, uint8_t(sEvent.eType));
+	switch (sEvent.eType)
+	{
+	case EGMRECORD_LOOK_TARGET:
+		PutFloats(m_fOut, sEvent.fValue, 2);
+		break;
+	case EGMRECORD_DESTINATION:
+		for (int i = 0; i < 3; i++) Put(m_fOut, sEvent.fValue[i]);
+		break;
+	case EGMRECORD_VOLUME:
+		PutFloats(m_fOut, sEvent.fValue, 1);
+		break;
+	case EGMRECORD_PLAY_MODE:
+	case EGMRECORD_AUDIO_TIME:
+	case EGMRECORD_RENDERING:
+	case EGMRECORD_MUSIC_ENABLE:
+	case EGMRECORD_MUSIC_DURATION:
+	case EGMRECORD_MUSIC_TIME:
+		Put(m_fOut, sEvent.iValue);
+		break;
+	case EGMRECORD_RESIZE:
+		Put(m_fOut, sEvent.iValue);
+		Put(m_fOut, sEvent.iValue2);
+		break;
+	case EGMRECORD_ADD_CHARACTER:
+	{
+		const uint16_t iLen = uint16_t((sEvent.strValue.size() < RECORD_MAX_STRING) ? sEvent.strValue.size() : RECORD_MAX_STRING);
+		Put(m_fOut, iLen);
+		m_fOut.write(sEvent.strValue.data(), iLen);
+		for (int i = 0; i < 3; i++) Put(m_fOut, sEvent.fValue[i]);
+	}
+	break;
+	case EGMRECORD_MUSIC_GRID:
+	{
+		const uint16_t iLen = uint16_t((sEvent.wstrValue.size() < RECORD_MAX_STRING) ? sEvent.wstrValue.size() : RECORD_MAX_STRING);
+		Put(m_fOut, iLen);
+		for (uint16_t i = 0; i < iLen; i++) Put(m_fOut, uint16_t(sEvent.wstrValue[i]));
+		Put(m_fOut, uint8_t(sEvent.iValue ? 1 : 0));
+	}
+	break;
+	case EGMRECORD_VISEME:
+		PutFloats(m_fOut, sEvent.fValue, 3);
+		Put(m_fOut, uint8_t(sEvent.iValue ? 1 : 0));
+		break;
+	default:
+		break;
+	}
+}
+
+bool CGMRecorder::_Read(std::ifstream& fIn, SGMRecordEvent& sEvent) const
+{
+	sEvent = SGMRecordEvent();
+	uint8_t iType = 0;
+	if (!Get(fIn, sEvent.iTime) || !Get(fIn, iType) || iType > EGMRECORD_END) return false;
+	sEvent.eType = EGMRECORD_EVENT(iType);
+
+	switch (sEvent.eType)
+	{
+	case EGMRECORD_LOOK_TARGET:
+		return GetFloats(fIn, sEvent.fValue, 2);
+	case EGMRECORD_DESTINATION:
+		return Get(fIn, sEvent.fValue[0]) && Get(fIn, sEvent.fValue[1]) && Get(fIn, sEvent.fValue[2]);
+	case EGMRECORD_VOLUME:
+		return GetFloats(fIn, sEvent.fValue, 1);
+	case EGMRECORD_PLAY_MODE:
+	case EGMRECORD_AUDIO_TIME:
+	case EGMRECORD_RENDERING:
+	case EGMRECORD_MUSIC_ENABLE:
+	case EGMRECORD_MUSIC_DURATION:
+	case EGMRECORD_MUSIC_TIME:
+		return Get(fIn, sEvent.iValue);
+	case EGMRECORD_RESIZE:
+		return Get(fIn, sEvent.iValue) && Get(fIn, sEvent.iValue2);
+	case EGMRECORD_ADD_CHARACTER:
+	{
+		uint16_t iLen = 0;
+		if (!Get(fIn, iLen) || iLen > RECORD_MAX_STRING) return false;
+		sEvent.strValue.resize(iLen);
+		if (iLen && !fIn.read(&sEvent.strValue[0], iLen)) return false;
+		return Get(fIn, sEvent.fValue[0]) && Get(fIn, sEvent.fValue[1]) && Get(fIn, sEvent.fValue[2]);
+	}
+	case EGMRECORD_MUSIC_GRID:
+	{
+		uint16_t iLen = 0;
+		if (!Get(fIn, iLen) || iLen > RECORD_MAX_STRING) return false;
+		sEvent.wstrValue.resize(iLen);
+		for (uint16_t i = 0; i < iLen; i++)
+		{
+			uint16_t c = 0;
+			if (!Get(fIn, c)) return false;
+			sEvent.wstrValue[i] = wchar_t(c);
+		}
+		uint8_t iValid = 0;
+		if (!Get(fIn, iValid)) return false;
+		sEvent.iValue = iValid;
+		return true;
+	}
+	case EGMRECORD_VISEME:
+	{
+		uint8_t iValid = 0;
+		if (!GetFloats(fIn, sEvent.fValue, 3) || !Get(fIn, iValid)) return false;
+		sEvent.iValue = iValid;
+		return true;
+	}
+	default:
+		return true;
+	}
+}
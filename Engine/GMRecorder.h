@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMRecorder.h
+/// @brief		Galaxy-Music Engine - GMRecorder
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	 Enums
+	*************************************************************************/
+
+	/*!
+	 *  @enum EGMRECORD_EVENT
+	 *  @brief 日志中的事件类型，只能在末尾添加，不能改变已有的值
+	 */
+	enum EGMRECORD_EVENT
+	{
+		// 引擎接口的调用，回放时重新调用
+		EGMRECORD_LOOK_TARGET = 0,		// SetLookTargetPos，fValue[0-1]：屏幕坐标
+		EGMRECORD_DESTINATION,			// SetDestination，fValue[0-2]：目的地坐标
+		EGMRECORD_PLAY,					// Play
+		EGMRECORD_PAUSE,				// Pause
+		EGMRECORD_STOP,					// Stop
+		EGMRECORD_NEXT,					// Next
+		EGMRECORD_VOLUME,				// SetVolume，fValue[0]：音量
+		EGMRECORD_PLAY_MODE,			// SetPlayMode，iValue：播放模式
+		EGMRECORD_AUDIO_TIME,			// SetAudioCurrentTime，iValue：播放位置，单位：ms
+		EGMRECORD_RENDERING,			// SetRendering，iValue：是否渲染
+		EGMRECORD_RESIZE,				// ResizeScreen，iValue、iValue2：屏幕宽高，回放时只用于换算屏幕坐标
+		EGMRECORD_ADD_CHARACTER,		// AddCharacter，strValue：名称，fValue[0-2]：位置
+		// 音频模块交给角色的输入，回放时替代音频模块的实时状态
+		EGMRECORD_MUSIC_ENABLE,			// iValue：角色是否跟随音乐
+		EGMRECORD_MUSIC_DURATION,		// iValue：音频总时长，单位：ms
+		EGMRECORD_MUSIC_TIME,			// iValue：音频播放位置，单位：ms
+		EGMRECORD_MUSIC_GRID,			// wstrValue：音频文件名，iValue：是否有节拍网格
+		EGMRECORD_VISEME,				// fValue[0-2]：“啊”“哦”闭嘴的权重，iValue：是否有效
+		// 日志结束
+		EGMRECORD_END					// 录制结束的时间
+	};
+
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMRecordEvent
+	 *  @brief 日志中的一个事件，不同类型使用不同的字段
+	 */
+	struct SGMRecordEvent
+	{
+		SGMRecordEvent() {}
+		SGMRecordEvent(const EGMRECORD_EVENT eEventType) : eType(eEventType) {}
+
+		uint32_t					iTime = 0;						//!< 从开始录制算起的时间，单位：ms
+		EGMRECORD_EVENT				eType = EGMRECORD_END;			//!< 事件类型
+		double						fValue[3] = { 0.0, 0.0, 0.0 };	//!< 坐标、音量、口型
+		int32_t						iValue = 0;						//!< 整数或者开关
+		int32_t						iValue2 = 0;					//!< 第二个整数
+		std::string					strValue = "";					//!< 角色名称
+		std::wstring				wstrValue = L"";				//!< 音频文件名
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMRecorder
+	*  @brief 录制和回放引擎接口的调用，用于可以重复的性能分析
+	*  @brief 二进制日志：文件头（标识、版本、随机种子、屏幕尺寸）+ 按时间排序的事件
+	*  @brief 录制时每个事件立即写入文件，回放时一次读入内存，按时间依次取出
+	*/
+	class CGMRecorder
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMRecorder();
+		/** @brief 析构 */
+		~CGMRecorder();
+
+		/**
+		* @brief 开始录制
+		* @param strFile: 日志文件路径
+		* @param iSeed: 本次录制使用的随机种子
+		* @param iWidth, iHeight: 当前的屏幕尺寸，单位：像素
+		* @return bool 成功true，文件无法写入返回false
+		*/
+		bool StartRecord(const std::string& strFile, const uint32_t iSeed, const int iWidth, const int iHeight);
+		/**
+		* @brief 结束录制，写入结束事件并关闭文件
+		* @param iTime: 结束的时间，单位：ms
+		*/
+		void StopRecord(const uint32_t iTime);
+		/**
+		* @brief 写入一个事件，没有在录制时忽略
+		* @param sEvent: 事件
+		*/
+		void Record(const SGMRecordEvent& sEvent);
+
+		/**
+		* @brief 读取日志，准备回放
+		* @param strFile: 日志文件路径
+		* @return bool 成功true，文件不存在、版本不对或者内容损坏返回false
+		*/
+		bool StartReplay(const std::string& strFile);
+		/** @brief 结束回放 */
+		void StopReplay();
+		/**
+		* @brief 取出下一个到时间的事件
+		* @param iTime: 当前的回放时间，单位：ms
+		* @param sEvent: 输出，事件
+		* @return bool 取到true，没有到时间的事件返回false
+		*/
+		bool PopEvent(const uint32_t iTime, SGMRecordEvent& sEvent);
+
+		inline bool IsRecording() const { return m_fOut.is_open(); }
+		inline bool IsReplaying() const { return m_bReplay; }
+		/** @brief 回放的事件是否已经全部取出 */
+		inline bool IsReplayFinished() const { return m_iNext >= m_eventVec.size(); }
+		/** @brief 录制或者回放使用的随机种子 */
+		inline uint32_t GetSeed() const { return m_iSeed; }
+		/** @brief 录制开始时的屏幕尺寸 */
+		inline int GetWidth() const { return m_iWidth; }
+		inline int GetHeight() const { return m_iHeight; }
+		/** @brief 回放日志的总时长，单位：ms */
+		uint32_t GetDuration() const;
+
+	private:
+		/** @brief 写入一个事件 */
+		void _Write(const SGMRecordEvent& sEvent);
+		/** @brief 读取一个事件，文件结束或者内容损坏返回false */
+		bool _Read(std::ifstream& fIn, SGMRecordEvent& sEvent) const;
+
+		// 变量
+	private:
+		std::ofstream							m_fOut;						//!< 正在录制的日志文件
+		bool									m_bReplay = false;			//!< 是否正在回放
+		std::vector<SGMRecordEvent>				m_eventVec;					//!< 回放的事件
+		size_t									m_iNext = 0;				//!< 下一个回放的事件
+		uint32_t								m_iSeed = 0;				//!< 随机种子
+		int										m_iWidth = 0;				//!< 录制开始时的屏幕宽度
+		int										m_iHeight = 0;				//!< 录制开始时的屏幕高度
+	};
+}	// GM
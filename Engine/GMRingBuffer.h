@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMRingBuffer.h
+/// @brief		Galaxy-Music Engine - GMRingBuffer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.24
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace GM
+{
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMRingBuffer
+	*  @brief 单生产者单消费者的无锁环形队列，容量向上取整到2的整数次幂
+	*  @brief 元素原地写入和读取，避免在音频线程中拷贝和分配内存
+	*/
+	template<typename T>
+	class CGMRingBuffer
+	{
+		// 函数
+	public:
+		/**
+		* @brief 构造
+		* @param iCapacity: 最少能存放的元素数量
+		*/
+		explicit CGMRingBuffer(const size_t iCapacity)
+		{
+			size_t iSize = 2;
+			while (iSize < iCapacity) iSize <<= 1;
+			m_dataVec.resize(iSize);
+			m_iMask = iSize - 1;
+		}
+
+		/**
+		* @brief 生产者：获取下一个可写的元素
+		* @return T* 队列已满时返回nullptr
+		*/
+		T* BeginPush()
+		{
+			const size_t iTail = m_iTail.load(std::memory_order_relaxed);
+			if (iTail - m_iHead.load(std::memory_order_acquire) > m_iMask) return nullptr;
+			return &m_dataVec[iTail & m_iMask];
+		}
+		/** @brief 生产者：提交BeginPush返回的元素 */
+		void EndPush()
+		{
+			m_iTail.store(m_iTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/**
+		* @brief 消费者：获取最早的元素
+		* @return const T* 队列为空时返回nullptr
+		*/
+		const T* Front() const
+		{
+			const size_t iHead = m_iHead.load(std::memory_order_relaxed);
+			if (iHead == m_iTail.load(std::memory_order_acquire)) return nullptr;
+			return &m_dataVec[iHead & m_iMask];
+		}
+		/**
+		* @brief 消费者：获取最早的元素，Pop之前可以修改或者移走它
+		* @return T* 队列为空时返回nullptr
+		*/
+		T* Front()
+		{
+			const size_t iHead = m_iHead.load(std::memory_order_relaxed);
+			if (iHead == m_iTail.load(std::memory_order_acquire)) return nullptr;
+			return &m_dataVec[iHead & m_iMask];
+		}
+		/** @brief 消费者：移除Front返回的元素 */
+		void Pop()
+		{
+			m_iHead.store(m_iHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/** @brief 当前元素数量，只是一个近似值 */
+		size_t Size() const
+		{
+			return m_iTail.load(std::memory_order_acquire) - m_iHead.load(std::memory_order_acquire);
+		}
+
+		// 变量
+	private:
+		std::vector<T>					m_dataVec;					//!< 元素
+		size_t							m_iMask = 0;				//!< 容量-1
+		char							m_szPad0[64];				//!< 让读写位置各占一条缓存行，避免伪共享
+		std::atomic<size_t>				m_iHead{ 0 };				//!< 消费者读取的位置
+		char							m_szPad1[64];
+		std::atomic<size_t>				m_iTail{ 0 };				//!< 生产者写入的位置
+		char							m_szPad2[64];
+	};
+}	// GM
@@ -0,0 +1,399 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMScene.cpp
+/// @brief		Galaxy-Music Engine - GMScene
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.25
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMScene.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define SCENE_FILE_VERSION			1			// 场景文件版本，记录格式改变时需要增加
+#define SCENE_HEADER_SIZE			36			// 文件头的字节数
+#define SCENE_MAX_STRING			4096		// 字符串的最大长度
+#define SCENE_FLAG_SHADOW			0x1			// 投射阴影（模型）或者产生阴影（灯光）
+#define SCENE_FLAG_QUANTIZE			0x2			// 压缩顶点格式（模型）
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+/** @brief FNV-1a校验码 */
+static uint32_t Checksum(const void* pData, const size_t iSize, uint32_t iHash = 2166136261u)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(pData);
+	for (size_t i = 0; i < iSize; i++)
+	{
+		iHash ^= p[i];
+		iHash *= 16777619u;
+	}
+	return iHash;
+}
+
+/** @brief 记录的最后4个字节是校验码 */
+template<typename T>
+static void Seal(T& sRecord)
+{
+	sRecord.iChecksum = Checksum(&sRecord, sizeof(T) - sizeof(uint32_t));
+}
+
+template<typename T>
+static bool IsSealed(const T& sRecord)
+{
+	return sRecord.iChecksum == Checksum(&sRecord, sizeof(T) - sizeof(uint32_t));
+}
+
+template<typename T>
+static void AppendRecords(std::vector<char>& vBuffer, const std::vector<T>& vRecord)
+{
+	if (vRecord.empty()) return;
+	const char* p = reinterpret_cast<const char*>(vRecord.data());
+	vBuffer.insert(vBuffer.end(), p, p + vRecord.size() * sizeof(T));
+}
+
+template<typename T>
+static bool ReadRecords(const std::vector<char>& vBuffer, size_t& iPos, const uint32_t iNum, std::vector<T>& vRecord)
+{
+	if (vBuffer.size() - iPos < size_t(iNum) * sizeof(T)) return false;
+	vRecord.resize(iNum);
+	if (iNum) memcpy(vRecord.data(), vBuffer.data() + iPos, size_t(iNum) * sizeof(T));
+	iPos += size_t(iNum) * sizeof(T);
+	for (const T& sRecord : vRecord)
+	{
+		if (!IsSealed(sRecord)) return false;
+	}
+	return true;
+}
+
+/*************************************************************************
+CGMScene Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMScene::CGMScene()
+{
+	static_assert(sizeof(SGMModelRecord) == 104, "model record must be packed");
+	static_assert(sizeof(SGMLightRecord) == 104, "light record must be packed");
+	static_assert(sizeof(SGMCharacterRecord) == 8, "character record must be packed");
+}
+
+/** @brief 析构 */
+CGMScene::~CGMScene()
+{
+}
+
+bool CGMScene::Load(const std::string& strFile, SGMSceneData& sData)
+{
+	m_strFile.clear();
+
+	// 整个文件一次读入内存再解析
+	std::ifstream fIn(strFile, std::ios::binary | std::ios::ate);
+	if (!fIn.is_open()) return false;
+	const std::streamoff iFileSize = fIn.tellg();
+	if (iFileSize < SCENE_HEADER_SIZE) return false;
+	std::vector<char> vBuffer(static_cast<size_t>(iFileSize));
+	fIn.seekg(0);
+	fIn.read(vBuffer.data(), iFileSize);
+	if (!fIn) return false;
+
+	uint32_t iHeader[8] = { 0 };
+	memcpy(iHeader, vBuffer.data() + 4, sizeof(iHeader));
+	const uint32_t iVersion = iHeader[0];
+	const uint32_t iStringNum = iHeader[1];
+	const uint32_t iStringBytes = iHeader[2];
+	const uint32_t iModelNum = iHeader[3];
+	const uint32_t iLightNum = iHeader[4];
+	const uint32_t iCharacterNum = iHeader[5];
+	const uint32_t iStringChecksum = iHeader[6];
+	const uint32_t iHeaderChecksum = iHeader[7];
+	if (0 != memcmp(vBuffer.data(), "GMSC", 4)
+		|| SCENE_FILE_VERSION != iVersion
+		|| iHeaderChecksum != Checksum(vBuffer.data(), SCENE_HEADER_SIZE - sizeof(uint32_t)))
+		return false;
+
+	// 字符串表
+	size_t iPos = SCENE_HEADER_SIZE;
+	if (vBuffer.size() - iPos < iStringBytes
+		|| iStringChecksum != Checksum(vBuffer.data() + iPos, iStringBytes))
+		return false;
+	_ClearString();
+	const size_t iStringEnd = iPos + iStringBytes;
+	for (uint32_t i = 0; i < iStringNum; i++)
+	{
+		uint32_t iLen = 0;
+		if (iStringEnd - iPos < sizeof(iLen)) return false;
+		memcpy(&iLen, vBuffer.data() + iPos, sizeof(iLen));
+		iPos += sizeof(iLen);
+		if (iLen > SCENE_MAX_STRING || iStringEnd - iPos < iLen) return false;
+		_String(std::string(vBuffer.data() + iPos, iLen));
+		iPos += iLen;
+	}
+	if (iPos != iStringEnd || m_stringVec.size() != iStringNum) return false;
+
+	// 定长记录
+	if (!ReadRecords(vBuffer, iPos, iModelNum, m_modelVec)
+		|| !ReadRecords(vBuffer, iPos, iLightNum, m_lightVec)
+		|| !ReadRecords(vBuffer, iPos, iCharacterNum, m_characterVec))
+		return false;
+
+	// 解码
+	SGMSceneData sScene;
+	sScene.modelVec.reserve(iModelNum);
+	for (const auto& sRecord : m_modelVec)
+	{
+		if (sRecord.iName >= iStringNum || sRecord.iFile >= iStringNum) return false;
+		SGMModelData sModel;
+		sModel.strName = m_stringVec[sRecord.iName];
+		sModel.strFilePath = m_stringVec[sRecord.iFile];
+		sModel.vPos = SGMVector3(sRecord.vPos[0], sRecord.vPos[1], sRecord.vPos[2]);
+		sModel.vOri = SGMVector3(sRecord.vOri[0], sRecord.vOri[1], sRecord.vOri[2]);
+		sModel.vScale = SGMVector3(sRecord.vScale[0], sRecord.vScale[1], sRecord.vScale[2]);
+		sModel.iEntRenderBin = sRecord.iRenderBin;
+		sModel.eMaterial = EGMMaterial(sRecord.iMaterial);
+		sModel.eBlend = EGMBlend(sRecord.iBlend);
+		sModel.bCastShadow = (0 != (sRecord.iFlags & SCENE_FLAG_SHADOW));
+		sModel.bQuantize = (0 != (sRecord.iFlags & SCENE_FLAG_QUANTIZE));
+		sScene.modelVec.push_back(sModel);
+	}
+	sScene.lightVec.reserve(iLightNum);
+	for (const auto& sRecord : m_lightVec)
+	{
+		if (sRecord.iName >= iStringNum) return false;
+		SLightData sLight;
+		sLight.strName = m_stringVec[sRecord.iName];
+		sLight.eType = EGMLIGHT_SOURCE(sRecord.iType);
+		sLight.vPos = osg::Vec4d(sRecord.vPos[0], sRecord.vPos[1], sRecord.vPos[2], sRecord.vPos[3]);
+		sLight.vDir = osg::Vec4d(sRecord.vDir[0], sRecord.vDir[1], sRecord.vDir[2], sRecord.vDir[3]);
+		sLight.vColor = osg::Vec3(sRecord.vColor[0], sRecord.vColor[1], sRecord.vColor[2]);
+		sLight.fLuminous = sRecord.fLuminous;
+		sLight.fAngle = sRecord.fAngle;
+		sLight.fSpotExponent = sRecord.fSpotExponent;
+		sLight.bShadow = (0 != (sRecord.iFlags & SCENE_FLAG_SHADOW));
+		sScene.lightVec.push_back(sLight);
+	}
+	sScene.characterVec.reserve(iCharacterNum);
+	for (const auto& sRecord : m_characterVec)
+	{
+		if (sRecord.iName >= iStringNum) return false;
+		sScene.characterVec.push_back(m_stringVec[sRecord.iName]);
+	}
+
+	sData = std::move(sScene);
+	m_strFile = strFile;
+	return true;
+}
+
+bool CGMScene::Save(const std::string& strFile, const SGMSceneData& sData)
+{
+	std::vector<SGMModelRecord> vModel;
+	std::vector<SGMLightRecord> vLight;
+	std::vector<SGMCharacterRecord> vCharacter;
+	const bool bNewString = _Encode(sData, vModel, vLight, vCharacter);
+
+	// 字符串表和记录数量都没变，文件布局不变，只重写变化的记录
+	if (!bNewString && strFile == m_strFile
+		&& vModel.size() == m_modelVec.size()
+		&& vLight.size() == m_lightVec.size()
+		&& vCharacter.size() == m_characterVec.size()
+		&& _WriteChanged(strFile, vModel, vLight, vCharacter))
+	{
+		m_modelVec.swap(vModel);
+		m_lightVec.swap(vLight);
+		m_characterVec.swap(vCharacter);
+		return true;
+	}
+
+	// 整体重写时重建字符串表，去掉不再使用的字符串
+	_ClearString();
+	_Encode(sData, m_modelVec, m_lightVec, m_characterVec);
+	if (!_WriteAll(strFile))
+	{
+		m_strFile.clear();
+		return false;
+	}
+	m_strFile = strFile;
+	return true;
+}
+
+bool CGMScene::_Encode(const SGMSceneData& sData,
+	std::vector<SGMModelRecord>& vModel,
+	std::vector<SGMLightRecord>& vLight,
+	std::vector<SGMCharacterRecord>& vCharacter)
+{
+	const size_t iStringNum = m_stringVec.size();
+
+	vModel.clear();
+	vModel.reserve(sData.modelVec.size());
+	for (const auto& sModel : sData.modelVec)
+	{
+		SGMModelRecord sRecord = {};
+		sRecord.iName = _String(sModel.strName);
+		sRecord.iFile = _String(sModel.strFilePath);
+		sRecord.vPos[0] = sModel.vPos.x; sRecord.vPos[1] = sModel.vPos.y; sRecord.vPos[2] = sModel.vPos.z;
+		sRecord.vOri[0] = sModel.vOri.x; sRecord.vOri[1] = sModel.vOri.y; sRecord.vOri[2] = sModel.vOri.z;
+		sRecord.vScale[0] = sModel.vScale.x; sRecord.vScale[1] = sModel.vScale.y; sRecord.vScale[2] = sModel.vScale.z;
+		sRecord.iRenderBin = sModel.iEntRenderBin;
+		sRecord.iMaterial = sModel.eMaterial;
+		sRecord.iBlend = sModel.eBlend;
+		sRecord.iFlags = (sModel.bCastShadow ? SCENE_FLAG_SHADOW : 0) | (sModel.bQuantize ? SCENE_FLAG_QUANTIZE : 0);
+		Seal(sRecord);
+		vModel.push_back(sRecord);
+	}
+
+	vLight.clear();
+	vLight.reserve(sData.lightVec.size());
+	for (const auto& sLight : sData.lightVec)
+	{
+		SGMLightRecord sRecord = {};
+		sRecord.iName = _String(sLight.strName);
+		sRecord.iType = sLight.eType;
+		for (int i = 0; i < 4; i++)
+		{
+			sRecord.vPos[i] = sLight.vPos[i];
+			sRecord.vDir[i] = sLight.vDir[i];
+		}
+		for (int i = 0; i < 3; i++)
+		{
+			sRecord.vColor[i] = sLight.vColor[i];
+		}
+		sRecord.fLuminous = sLight.fLuminous;
+		sRecord.fAngle = sLight.fAngle;
+		sRecord.fSpotExponent = sLight.fSpotExponent;
+		sRecord.iFlags = sLight.bShadow ? SCENE_FLAG_SHADOW : 0;
+		Seal(sRecord);
+		vLight.push_back(sRecord);
+	}
+
+	vCharacter.clear();
+	vCharacter.reserve(sData.characterVec.size());
+	for (const auto& strName : sData.characterVec)
+	{
+		SGMCharacterRecord sRecord = {};
+		sRecord.iName = _String(strName);
+		Seal(sRecord);
+		vCharacter.push_back(sRecord);
+	}
+
+	return m_stringVec.size() != iStringNum;
+}
+
+uint32_t CGMScene::_String(const std::string& str)
+{
+	auto itr = m_stringMap.find(str);
+	if (m_stringMap.end() != itr) return itr->second;
+
+	const uint32_t iIndex = static_cast<uint32_t>(m_stringVec.size());
+	m_stringVec.push_back(str.substr(0, SCENE_MAX_STRING));
+	m_stringMap[str] = iIndex;
+	return iIndex;
+}
+
+void CGMScene::_ClearString()
+{
+	m_stringVec.clear();
+	m_stringMap.clear();
+}
+
+bool CGMScene::_WriteAll(const std::string& strFile) const
+{
+	std::vector<char> vBuffer(SCENE_HEADER_SIZE, 0);
+	vBuffer.reserve(SCENE_HEADER_SIZE + _StringBytes()
+		+ m_modelVec.size() * sizeof(SGMModelRecord)
+		+ m_lightVec.size() * sizeof(SGMLightRecord)
+		+ m_characterVec.size() * sizeof(SGMCharacterRecord));
+
+	for (const auto& str : m_stringVec)
+	{
+		const uint32_t iLen = static_cast<uint32_t>(str.size());
+		const char* p = reinterpret_cast<const char*>(&iLen);
+		vBuffer.insert(vBuffer.end(), p, p + sizeof(iLen));
+		vBuffer.insert(vBuffer.end(), str.begin(), str.end());
+	}
+	const uint32_t iStringBytes = static_cast<uint32_t>(vBuffer.size() - SCENE_HEADER_SIZE);
+	AppendRecords(vBuffer, m_modelVec);
+	AppendRecords(vBuffer, m_lightVec);
+	AppendRecords(vBuffer, m_characterVec);
+
+	const uint32_t iHeader[7] = {
+		SCENE_FILE_VERSION,
+		static_cast<uint32_t>(m_stringVec.size()),
+		iStringBytes,
+		static_cast<uint32_t>(m_modelVec.size()),
+		static_cast<uint32_t>(m_lightVec.size()),
+		static_cast<uint32_t>(m_characterVec.size()),
+		Checksum(vBuffer.data() + SCENE_HEADER_SIZE, iStringBytes) };
+	memcpy(vBuffer.data(), "GMSC", 4);
+	memcpy(vBuffer.data() + 4, iHeader, sizeof(iHeader));
+	const uint32_t iHeaderChecksum = Checksum(vBuffer.data(), SCENE_HEADER_SIZE - sizeof(uint32_t));
+	memcpy(vBuffer.data() + SCENE_HEADER_SIZE - sizeof(uint32_t), &iHeaderChecksum, sizeof(uint32_t));
+
+	// 先写临时文件，写到一半退出也不会破坏原来的场景
+	const std::string strTemp = strFile + ".tmp";
+	{
+		std::ofstream fOut(strTemp, std::ios::binary | std::ios::trunc);
+		if (!fOut.is_open()) return false;
+		fOut.write(vBuffer.data(), vBuffer.size());
+		fOut.close();
+		if (fOut.fail()) return false;
+	}
+	std::remove(strFile.c_str());
+	return 0 == std::rename(strTemp.c_str(), strFile.c_str());
+}
+
+bool CGMScene::_WriteChanged(const std::string& strFile,
+	const std::vector<SGMModelRecord>& vModel,
+	const std::vector<SGMLightRecord>& vLight,
+	const std::vector<SGMCharacterRecord>& vCharacter) const
+{
+	const bool bModel = !vModel.empty() && (0 != memcmp(vModel.data(), m_modelVec.data(), vModel.size() * sizeof(SGMModelRecord)));
+	const bool bLight = !vLight.empty() && (0 != memcmp(vLight.data(), m_lightVec.data(), vLight.size() * sizeof(SGMLightRecord)));
+	const bool bCharacter = !vCharacter.empty()
+		&& (0 != memcmp(vCharacter.data(), m_characterVec.data(), vCharacter.size() * sizeof(SGMCharacterRecord)));
+	if (!bModel && !bLight && !bCharacter) return true;
+
+	std::fstream fFile(strFile, std::ios::binary | std::ios::in | std::ios::out);
+	if (!fFile.is_open()) return false;
+
+	std::streamoff iOffset = SCENE_HEADER_SIZE + static_cast<std::streamoff>(_StringBytes());
+	auto WriteChanged = [&fFile, &iOffset](const char* pNew, const char* pOld, const size_t iNum, const size_t iSize)
+	{
+		for (size_t i = 0; i < iNum; i++)
+		{
+			if (0 == memcmp(pNew + i * iSize, pOld + i * iSize, iSize)) continue;
+			fFile.seekp(iOffset + static_cast<std::streamoff>(i * iSize));
+			fFile.write(pNew + i * iSize, iSize);
+		}
+		iOffset += static_cast<std::streamoff>(iNum * iSize);
+	};
+	WriteChanged(reinterpret_cast<const char*>(vModel.data()), reinterpret_cast<const char*>(m_modelVec.data()),
+		vModel.size(), sizeof(SGMModelRecord));
+	WriteChanged(reinterpret_cast<const char*>(vLight.data()), reinterpret_cast<const char*>(m_lightVec.data()),
+		vLight.size(), sizeof(SGMLightRecord));
+	WriteChanged(reinterpret_cast<const char*>(vCharacter.data()), reinterpret_cast<const char*>(m_characterVec.data()),
+		vCharacter.size(), sizeof(SGMCharacterRecord));
+	fFile.close();
+	return !fFile.fail();
+}
+
+size_t CGMScene::_StringBytes() const
+{
+	size_t iBytes = 0;
+	for (const auto& str : m_stringVec)
+	{
+		iBytes += sizeof(uint32_t) + str.size();
+	}
+	return iBytes;
+}
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMScene.h
+/// @brief		Galaxy-Music Engine - GMScene
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.25
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMCommon.h"
+#include "GMLight.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace GM
+{
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMSceneData
+	 *  @brief 场景文件中保存的全部内容
+	 */
+	struct SGMSceneData
+	{
+		SGMSceneData() {}
+
+		std::vector<SGMModelData>		modelVec;					//!< 所有模型，包括角色的模型，按名称排序
+		std::vector<SLightData>			lightVec;					//!< 所有灯光，按名称排序
+		std::vector<std::string>		characterVec;				//!< 角色名称，第一个是主角，其余是群演
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMScene
+	*  @brief 二进制场景文件：文件头 + 字符串表 + 定长的模型、灯光、角色记录
+	*  @brief 每条记录带有自己的校验码，只修改了记录时只重写这几条记录，
+	*  @brief 字符串或者记录数量变化时才整体重写
+	*/
+	class CGMScene
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMScene();
+		/** @brief 析构 */
+		~CGMScene();
+
+		/**
+		* @brief 读取场景文件
+		* @param strFile: 场景文件路径
+		* @param sData: 输出，场景内容
+		* @return bool 成功true，文件不存在、版本不对或者校验失败返回false
+		*/
+		bool Load(const std::string& strFile, SGMSceneData& sData);
+		/**
+		* @brief 保存场景文件，和上次读写的文件相比只有记录变化时，只重写变化的记录
+		* @param strFile: 场景文件路径
+		* @param sData: 场景内容
+		* @return bool 成功true， 失败false
+		*/
+		bool Save(const std::string& strFile, const SGMSceneData& sData);
+
+	private:
+		/** @brief 模型记录 */
+		struct SGMModelRecord
+		{
+			uint32_t					iName;						//!< 名称在字符串表中的序号
+			uint32_t					iFile;						//!< 文件路径在字符串表中的序号
+			double						vPos[3];					//!< 位置，单位：cm
+			double						vOri[3];					//!< 方向，单位：°
+			double						vScale[3];					//!< 缩放
+			int32_t						iRenderBin;					//!< 渲染顺序
+			int32_t						iMaterial;					//!< 材质
+			int32_t						iBlend;						//!< 半透明混合模式
+			uint32_t					iFlags;						//!< 第0位：是否投射阴影
+			uint32_t					iReserved;					//!< 保留，对齐到8字节
+			uint32_t					iChecksum;					//!< 以上内容的校验码
+		};
+		/** @brief 灯光记录 */
+		struct SGMLightRecord
+		{
+			uint32_t					iName;						//!< 名称在字符串表中的序号
+			int32_t						iType;						//!< 灯光类型
+			double						vPos[4];					//!< 位置
+			double						vDir[4];					//!< 方向
+			float						vColor[3];					//!< 颜色
+			float						fLuminous;					//!< 发光强度，单位：cd
+			float						fAngle;						//!< 光束视场角，单位：°
+			float						fSpotExponent;				//!< 聚光程度
+			uint32_t					iFlags;						//!< 第0位：是否产生阴影
+			uint32_t					iChecksum;					//!< 以上内容的校验码
+		};
+		/** @brief 角色记录 */
+		struct SGMCharacterRecord
+		{
+			uint32_t					iName;						//!< 名称在字符串表中的序号
+			uint32_t					iChecksum;					//!< 以上内容的校验码
+		};
+
+		/**
+		* @brief 把场景内容编码成记录
+		* @param sData: 场景内容
+		* @return bool 是否向字符串表添加了新的字符串
+		*/
+		bool _Encode(const SGMSceneData& sData,
+			std::vector<SGMModelRecord>& vModel,
+			std::vector<SGMLightRecord>& vLight,
+			std::vector<SGMCharacterRecord>& vCharacter);
+		/**
+		* @brief 获取字符串在字符串表中的序号，没有则添加
+		* @param str: 字符串
+		* @return uint32_t 序号
+		*/
+		uint32_t _String(const std::string& str);
+		/** @brief 清空字符串表 */
+		void _ClearString();
+		/**
+		* @brief 整体重写场景文件，先写临时文件再替换
+		* @param strFile: 场景文件路径
+		* @return bool 成功true， 失败false
+		*/
+		bool _WriteAll(const std::string& strFile) const;
+		/**
+		* @brief 只重写变化的记录
+		* @param strFile: 场景文件路径
+		* @return bool 成功true， 失败false
+		*/
+		bool _WriteChanged(const std::string& strFile,
+			const std::vector<SGMModelRecord>& vModel,
+			const std::vector<SGMLightRecord>& vLight,
+			const std::vector<SGMCharacterRecord>& vCharacter) const;
+		/** @brief 字符串表的字节数 */
+		size_t _StringBytes() const;
+
+		// 变量
+	private:
+		std::vector<std::string>						m_stringVec;			//!< 字符串表
+		std::unordered_map<std::string, uint32_t>		m_stringMap;			//!< 字符串 -> 序号
+		std::vector<SGMModelRecord>						m_modelVec;				//!< 文件中的模型记录
+		std::vector<SGMLightRecord>						m_lightVec;				//!< 文件中的灯光记录
+		std::vector<SGMCharacterRecord>					m_characterVec;			//!< 文件中的角色记录
+		std::string										m_strFile = "";			//!< 上面的记录对应的文件，空表示和磁盘不同步
+	};
+}	// GM
@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMScheduler.cpp
+/// @brief		Galaxy-Music Engine - GMScheduler
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMScheduler.h"
+#include "GMThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define SCHEDULER_TICK				(1e-3)		// 时间轮的刻度，单位：秒
+#define SCHEDULER_BITS				6			// 每层槽数的位数，和GM_SCHEDULER_SLOT对应
+#define SCHEDULER_MASK				(GM_SCHEDULER_SLOT - 1)
+
+/*************************************************************************
+CGMScheduler Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMScheduler::CGMScheduler()
+{
+}
+
+/** @brief 析构 */
+CGMScheduler::~CGMScheduler()
+{
+}
+
+/** @brief 添加周期任务 */
+unsigned int CGMScheduler::AddPeriodic(const double fPeriod, const std::function<void(double)>& fnTask,
+	const EGMTASK_PRIORITY ePriority, const EGMTASK_THREAD eThread)
+{
+	unsigned long long iPeriod = (unsigned long long)(fPeriod / SCHEDULER_TICK + 0.5);
+	if (iPeriod < 1) iPeriod = 1;
+
+	SGMTask sTask;
+	sTask.fnTask = fnTask;
+	sTask.iPeriod = iPeriod;
+	sTask.iLast = m_iNow;
+	sTask.iDue = m_iNow + iPeriod;
+	sTask.ePriority = ePriority;
+	sTask.eThread = eThread;
+
+	const unsigned int iTask = m_iNextTask++;
+	m_taskMap[iTask] = sTask;
+	_Insert(iTask, sTask.iDue);
+	return iTask;
+}
+
+/** @brief 添加一次性任务 */
+unsigned int CGMScheduler::AddOnce(const double fDelay, const std::function<void(double)>& fnTask,
+	const EGMTASK_PRIORITY ePriority, const EGMTASK_THREAD eThread)
+{
+	unsigned long long iDelay = (fDelay > 0.0) ? (unsigned long long)(fDelay / SCHEDULER_TICK + 0.5) : 0;
+	// 最早在下一个刻度执行
+	if (iDelay < 1) iDelay = 1;
+
+	SGMTask sTask;
+	sTask.fnTask = fnTask;
+	sTask.iLast = m_iNow;
+	sTask.iDue = m_iNow + iDelay;
+	sTask.ePriority = ePriority;
+	sTask.eThread = eThread;
+
+	const unsigned int iTask = m_iNextTask++;
+	m_taskMap[iTask] = sTask;
+	_Insert(iTask, sTask.iDue);
+	return iTask;
+}
+
+/** @brief 删除任务 */
+bool CGMScheduler::Remove(const unsigned int iTask)
+{
+	// 时间轮中的编号留到所在的槽到期时再跳过
+	return m_taskMap.erase(iTask) > 0;
+}
+
+/** @brief 推进时间 */
+void CGMScheduler::Advance(const double fDeltaTime)
+{
+	if (fDeltaTime <= 0.0) return;
+
+	m_fRemainder += fDeltaTime;
+	unsigned long long iTicks = (unsigned long long)(m_fRemainder / SCHEDULER_TICK);
+	m_fRemainder -= iTicks * SCHEDULER_TICK;
+	if (0 == iTicks) return;
+
+	// 没有任务时直接跳过，不用逐个刻度转动
+	if (m_taskMap.empty())
+	{
+		m_iNow += iTicks;
+		return;
+	}
+
+	std::vector<unsigned int> vDue;
+	while (iTicks > 0)
+	{
+		iTicks--;
+		m_iNow++;
+
+		// 最高层转满一圈，超出范围的任务重新放置
+		if (0 == (m_iNow & ((1ULL << (SCHEDULER_BITS * GM_SCHEDULER_LEVEL)) - 1)))
+		{
+			std::vector<unsigned int> vOverflow;
+			vOverflow.swap(m_overflowVec);
+			for (auto& itr : vOverflow)
+			{
+				auto itrTask = m_taskMap.find(itr);
+				if (m_taskMap.end() != itrTask) _Insert(itr, itrTask->second.iDue);
+			}
+		}
+		// 从高到低逐层下放，下放到第0层当前槽的任务在这个刻度中到期
+		for (int i = GM_SCHEDULER_LEVEL - 1; i >= 1; i--)
+		{
+			if (0 == (m_iNow & ((1ULL << (SCHEDULER_BITS * i)) - 1)))
+				_Cascade(i);
+		}
+
+		std::vector<unsigned int>& vSlot = m_wheel[0][m_iNow & SCHEDULER_MASK];
+		vDue.insert(vDue.end(), vSlot.begin(), vSlot.end());
+		vSlot.clear();
+	}
+	_Run(vDue);
+}
+
+/** @brief 距离下一个任务到期的时间 */
+double CGMScheduler::GetTimeToNext() const
+{
+	if (m_taskMap.empty()) return DBL_MAX;
+
+	unsigned long long iDue = m_taskMap.begin()->second.iDue;
+	for (auto& itr : m_taskMap)
+	{
+		if (itr.second.iDue < iDue) iDue = itr.second.iDue;
+	}
+	const double fTime = (iDue - m_iNow) * SCHEDULER_TICK - m_fRemainder;
+	return (fTime > 0.0) ? fTime : 0.0;
+}
+
+/** @brief 累计推进的时间 */
+double CGMScheduler::GetTime() const
+{
+	return m_iNow * SCHEDULER_TICK + m_fRemainder;
+}
+
+void CGMScheduler::_Insert(const unsigned int iTask, const unsigned long long iDue)
+{
+	// 放到和当前刻度同属一个上层槽的最低一层
+	for (int i = 0; i < GM_SCHEDULER_LEVEL; i++)
+	{
+		const int iShift = SCHEDULER_BITS * (i + 1);
+		if ((iDue >> iShift) == (m_iNow >> iShift))
+		{
+			m_wheel[i][(iDue >> (SCHEDULER_BITS * i)) & SCHEDULER_MASK].push_back(iTask);
+			return;
+		}
+	}
+	m_overflowVec.push_back(iTask);
+}
+
+void CGMScheduler::_Cascade(const int iLevel)
+{
+	std::vector<unsigned int> vSlot;
+	vSlot.swap(m_wheel[iLevel][(m_iNow >> (SCHEDULER_BITS * iLevel)) & SCHEDULER_MASK]);
+	for (auto& itr : vSlot)
+	{
+		auto itrTask = m_taskMap.find(itr);
+		if (m_taskMap.end() != itrTask) _Insert(itr, itrTask->second.iDue);
+	}
+}
+
+void CGMScheduler::_Run(std::vector<unsigned int>& vDue)
+{
+	// 跳过已经删除的任务，按优先级、到期时间排序
+	vDue.erase(std::remove_if(vDue.begin(), vDue.end(),
+		[this](unsigned int iTask) { return m_taskMap.end() == m_taskMap.find(iTask); }), vDue.end());
+	if (vDue.empty()) return;
+	std::sort(vDue.begin(), vDue.end(), [this](unsigned int iA, unsigned int iB)
+	{
+		const SGMTask& sA = m_taskMap.at(iA);
+		const SGMTask& sB = m_taskMap.at(iB);
+		if (sA.ePriority != sB.ePriority) return sA.ePriority < sB.ePriority;
+		if (sA.iDue != sB.iDue) return sA.iDue < sB.iDue;
+		return iA < iB;
+	});
+
+	std::vector<std::function<void()>> vWorker;
+	for (auto& itr : vDue)
+	{
+		// 前面的任务可能删除了后面的任务
+		auto itrTask = m_taskMap.find(itr);
+		if (m_taskMap.end() == itrTask) continue;
+
+		SGMTask& sTask = itrTask->second;
+		const double fElapsed = (m_iNow - sTask.iLast) * SCHEDULER_TICK;
+		// 任务函数可能删除自己，先复制一份
+		std::function<void(double)> fnTask = sTask.fnTask;
+		const EGMTASK_THREAD eThread = sTask.eThread;
+		if (sTask.iPeriod > 0)
+		{
+			// 落后超过一个周期时不补执行，从现在开始重新计时
+			sTask.iLast = m_iNow;
+			sTask.iDue += sTask.iPeriod;
+			if (sTask.iDue <= m_iNow) sTask.iDue = m_iNow + sTask.iPeriod;
+			_Insert(itr, sTask.iDue);
+		}
+		else
+		{
+			m_taskMap.erase(itrTask);
+		}
+
+		if (EGMTASK_THREAD_WORKER == eThread)
+			vWorker.push_back([fnTask, fElapsed]() { fnTask(fElapsed); });
+		else
+			fnTask(fElapsed);
+	}
+
+	// 工作线程的任务同时执行，全部完成后才返回
+	GM_THREADPOOL.ParallelFor(0, int(vWorker.size()), [&vWorker](int iBegin, int iEnd)
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			vWorker.at(i)();
+		}
+	}, 1);
+}
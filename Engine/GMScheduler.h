@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMScheduler.h
+/// @brief		Galaxy-Music Engine - GMScheduler
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	Macro Defines
+	*************************************************************************/
+	#define GM_SCHEDULER_LEVEL				4			// 时间轮的层数
+	#define GM_SCHEDULER_SLOT				64			// 每层的槽数
+
+	/*************************************************************************
+	Enums
+	*************************************************************************/
+
+	/*!
+	*  @enum EGMTASK_PRIORITY
+	*  @brief 同一次Advance中到期的任务，按优先级从高到低执行
+	*/
+	enum EGMTASK_PRIORITY
+	{
+		EGMTASK_PRIORITY_HIGH,
+		EGMTASK_PRIORITY_NORMAL,
+		EGMTASK_PRIORITY_LOW
+	};
+
+	/*!
+	*  @enum EGMTASK_THREAD
+	*  @brief 任务在哪个线程中执行
+	*/
+	enum EGMTASK_THREAD
+	{
+		EGMTASK_THREAD_CALLER,		// 调用Advance的线程，按优先级依次执行
+		EGMTASK_THREAD_WORKER		// 线程池，同一次到期的任务同时执行，不能读写调用线程的数据
+	};
+
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMTask
+	*  @brief 定时任务，时间单位是时间轮的刻度
+	*/
+	struct SGMTask
+	{
+		std::function<void(double)>		fnTask;								//!< 任务函数，参数是距离上一次执行的时间，单位：秒
+		unsigned long long				iDue = 0;							//!< 到期的刻度
+		unsigned long long				iPeriod = 0;						//!< 周期，0表示只执行一次
+		unsigned long long				iLast = 0;							//!< 上一次执行或者添加时的刻度
+		EGMTASK_PRIORITY				ePriority = EGMTASK_PRIORITY_NORMAL;//!< 优先级
+		EGMTASK_THREAD					eThread = EGMTASK_THREAD_CALLER;	//!< 执行的线程
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMScheduler
+	*  @brief 定时任务调度器，取代各模块中用静态变量累加时间的写法
+	*  @brief 分层时间轮：刻度1ms，4层、每层64个槽，添加和到期都是O(1)，超过4层范围的任务在最高层转满一圈时重新放置
+	*  @brief 不是线程安全的，只能在一个线程中添加、删除和推进，每个实例各自计时
+	*/
+	class CGMScheduler
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMScheduler();
+		/** @brief 析构 */
+		~CGMScheduler();
+
+		/**
+		* @brief 添加周期任务，第一次在一个周期后执行
+		* 推进的时间超过一个周期时只执行一次，参数是实际经过的时间
+		* @param fPeriod: 周期，单位：秒，不小于1个刻度
+		* @param fnTask: 任务函数，参数是距离上一次执行的时间，单位：秒
+		* @param ePriority: 优先级
+		* @param eThread: 执行的线程
+		* @return unsigned int 任务编号，用于删除，从1开始
+		*/
+		unsigned int AddPeriodic(const double fPeriod, const std::function<void(double)>& fnTask,
+			const EGMTASK_PRIORITY ePriority = EGMTASK_PRIORITY_NORMAL, const EGMTASK_THREAD eThread = EGMTASK_THREAD_CALLER);
+		/**
+		* @brief 添加一次性任务，执行后自动删除
+		* @param fDelay: 延迟，单位：秒
+		* @param fnTask: 任务函数，参数是从添加到执行经过的时间，单位：秒
+		* @param ePriority: 优先级
+		* @param eThread: 执行的线程
+		* @return unsigned int 任务编号，用于删除，从1开始
+		*/
+		unsigned int AddOnce(const double fDelay, const std::function<void(double)>& fnTask,
+			const EGMTASK_PRIORITY ePriority = EGMTASK_PRIORITY_NORMAL, const EGMTASK_THREAD eThread = EGMTASK_THREAD_CALLER);
+		/**
+		* @brief 删除任务，可以在任务函数中调用
+		* @param iTask: 任务编号
+		* @return bool 成功true，任务不存在或者已经执行完返回false
+		*/
+		bool Remove(const unsigned int iTask);
+		/**
+		* @brief 推进时间，执行到期的任务
+		* @param fDeltaTime: 推进的时间，单位：秒
+		*/
+		void Advance(const double fDeltaTime);
+		/**
+		* @brief 距离下一个任务到期的时间，帧循环可以睡眠这么久
+		* @return double 单位：秒，没有任务时返回DBL_MAX
+		*/
+		double GetTimeToNext() const;
+		/** @brief 累计推进的时间，单位：秒 */
+		double GetTime() const;
+
+	private:
+		/** @brief 按到期刻度把任务放到时间轮中 */
+		void _Insert(const unsigned int iTask, const unsigned long long iDue);
+		/** @brief 把第iLevel层当前的槽重新放到下面的层中 */
+		void _Cascade(const int iLevel);
+		/** @brief 执行到期的任务 */
+		void _Run(std::vector<unsigned int>& vDue);
+
+		// 变量
+	private:
+		std::unordered_map<unsigned int, SGMTask>	m_taskMap;										//!< 所有任务
+		std::vector<unsigned int>					m_wheel[GM_SCHEDULER_LEVEL][GM_SCHEDULER_SLOT];	//!< 时间轮，槽中是任务编号
+		std::vector<unsigned int>					m_overflowVec;									//!< 超过时间轮范围的任务
+		unsigned long long							m_iNow = 0;										//!< 当前刻度
+		double										m_fRemainder = 0.0;								//!< 不足一个刻度的时间，单位：秒
+		unsigned int								m_iNextTask = 1;								//!< 下一个任务编号
+	};
+}	// GM
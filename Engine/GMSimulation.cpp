@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMSimulation.cpp
+/// @brief		Galaxy-Music Engine - GMSimulation
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMSimulation.h"
+#include <osg/Timer>
+
+using namespace GM;
+
+/*************************************************************************
+CGMSimulation Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMSimulation::CGMSimulation()
+{
+}
+
+/** @brief 析构 */
+CGMSimulation::~CGMSimulation()
+{
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_condition.notify_all();
+	if (m_thread.joinable()) m_thread.join();
+}
+
+/** @brief 开关工作线程 */
+void CGMSimulation::SetEnable(const bool bEnable)
+{
+	Wait();
+	m_bEnable = bEnable;
+	if (m_bEnable && !m_thread.joinable())
+	{
+		m_thread = std::thread(&CGMSimulation::_WorkerLoop, this);
+	}
+}
+
+/** @brief 开始一次模拟 */
+void CGMSimulation::Launch(const std::function<void()>& fnSimulate)
+{
+	if (!m_bEnable)
+	{
+		fnSimulate();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_fnSimulate = fnSimulate;
+		m_bBusy = true;
+	}
+	m_condition.notify_one();
+}
+
+/** @brief 等待模拟结束 */
+double CGMSimulation::Wait()
+{
+	osg::Timer_t tStart = osg::Timer::instance()->tick();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this]() { return !m_bBusy; });
+	return osg::Timer::instance()->delta_s(tStart, osg::Timer::instance()->tick());
+}
+
+/** @brief 工作线程 */
+void CGMSimulation::_WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> fnSimulate;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_bExit || m_fnSimulate; });
+			if (m_bExit) return;
+			fnSimulate.swap(m_fnSimulate);
+		}
+
+		fnSimulate();
+
+		{
+			// 在锁内通知，避免调用线程检查完条件、还没开始等待时错过通知
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bBusy = false;
+			m_doneCondition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMSimulation.h
+/// @brief		Galaxy-Music Engine - GMSimulation
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace GM
+{
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMSimulation
+	*  @brief 模拟阶段：第N帧剔除和绘制的同时，在工作线程中计算第N+1帧的角色逻辑
+	*  @brief 模拟的结果写入各模块自己的双缓冲，主线程在下一帧的更新遍历之前应用
+	*  @brief 同一时间最多只有一次模拟，Launch之后必须先Wait才能再次Launch
+	*/
+	class CGMSimulation
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMSimulation();
+		/** @brief 析构，等待工作线程退出 */
+		~CGMSimulation();
+
+		/**
+		* @brief 开关工作线程，关闭时Launch在调用线程中直接执行
+		* @param bEnable: 开启或关闭，关闭前会等待正在进行的模拟
+		*/
+		void SetEnable(const bool bEnable);
+		/** @brief 工作线程是否开启 */
+		inline bool GetEnable() const { return m_bEnable; }
+		/**
+		* @brief 开始一次模拟，工作线程开启时立即返回
+		* @param fnSimulate: 模拟函数，执行期间调用线程只能做不读写模拟数据的工作
+		*/
+		void Launch(const std::function<void()>& fnSimulate);
+		/**
+		* @brief 等待模拟结束，没有进行中的模拟时立即返回
+		* @return double 等待的时间，单位：秒
+		*/
+		double Wait();
+
+	private:
+		/** @brief 工作线程 */
+		void _WorkerLoop();
+
+		// 变量
+	private:
+		std::thread							m_thread;					//!< 工作线程，第一次开启时才创建
+		std::mutex							m_mutex;					//!< 保护下面的状态
+		std::condition_variable				m_condition;				//!< 有新的模拟时唤醒工作线程
+		std::condition_variable				m_doneCondition;			//!< 模拟完成时唤醒调用线程
+		std::function<void()>				m_fnSimulate;				//!< 等待执行的模拟函数
+		bool								m_bBusy = false;			//!< 是否有进行中的模拟
+		bool								m_bExit = false;			//!< 退出标志
+		bool								m_bEnable = false;			//!< 工作线程是否开启
+	};
+}	// GM
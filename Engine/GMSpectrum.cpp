@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMSpectrum.cpp
+/// @brief		Galaxy-Music Engine - GMSpectrum
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.24
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMSpectrum.h"
+#include <cmath>
+#include <osg/Math>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GM_SPECTRUM_SSE 1
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+CGMSpectrum Methods
+*************************************************************************/
+
+CGMSpectrum::CGMSpectrum(const int iSize) : m_iSize(iSize)
+{
+	int iLog = 0;
+	while ((1 << iLog) < iSize) iLog++;
+
+	m_bitRevVec.resize(iSize);
+	m_windowVec.resize(iSize);
+	for (int i = 0; i < iSize; i++)
+	{
+		int iRev = 0;
+		for (int b = 0; b < iLog; b++)
+		{
+			if (i & (1 << b)) iRev |= 1 << (iLog - 1 - b);
+		}
+		m_bitRevVec[i] = iRev;
+		// Hann窗
+		m_windowVec[i] = float(0.5 - 0.5 * std::cos(2.0 * osg::PI * i / iSize));
+	}
+
+	// 半长为m的那一级的旋转因子从 m-1 开始存放，总长度为 iSize-1
+	m_twReVec.resize(iSize);
+	m_twImVec.resize(iSize);
+	for (int m = 1; m < iSize; m <<= 1)
+	{
+		for (int k = 0; k < m; k++)
+		{
+			double fAngle = -osg::PI * k / m;
+			m_twReVec[m - 1 + k] = float(std::cos(fAngle));
+			m_twImVec[m - 1 + k] = float(std::sin(fAngle));
+		}
+	}
+
+	m_reVec.resize(iSize);
+	m_imVec.resize(iSize);
+}
+
+void CGMSpectrum::Power(const float* pIn, float* pPower)
+{
+	const int N = m_iSize;
+	float* pRe = m_reVec.data();
+	float* pIm = m_imVec.data();
+	for (int i = 0; i < N; i++)
+	{
+		pRe[m_bitRevVec[i]] = pIn[i] * m_windowVec[i];
+		pIm[i] = 0.0f;
+	}
+
+	for (int m = 1; m < N; m <<= 1)
+	{
+		const float* pWr = &m_twReVec[m - 1];
+		const float* pWi = &m_twImVec[m - 1];
+		for (int iBase = 0; iBase < N; iBase += 2 * m)
+		{
+			float* pAr = pRe + iBase;
+			float* pAi = pIm + iBase;
+			float* pBr = pAr + m;
+			float* pBi = pAi + m;
+			int k = 0;
+#ifdef GM_SPECTRUM_SSE
+			for (; k + 4 <= m; k += 4)
+			{
+				__m128 vWr = _mm_loadu_ps(pWr + k);
+				__m128 vWi = _mm_loadu_ps(pWi + k);
+				__m128 vBr = _mm_loadu_ps(pBr + k);
+				__m128 vBi = _mm_loadu_ps(pBi + k);
+				__m128 vTr = _mm_sub_ps(_mm_mul_ps(vBr, vWr), _mm_mul_ps(vBi, vWi));
+				__m128 vTi = _mm_add_ps(_mm_mul_ps(vBr, vWi), _mm_mul_ps(vBi, vWr));
+				__m128 vAr = _mm_loadu_ps(pAr + k);
+				__m128 vAi = _mm_loadu_ps(pAi + k);
+				_mm_storeu_ps(pBr + k, _mm_sub_ps(vAr, vTr));
+				_mm_storeu_ps(pBi + k, _mm_sub_ps(vAi, vTi));
+				_mm_storeu_ps(pAr + k, _mm_add_ps(vAr, vTr));
+				_mm_storeu_ps(pAi + k, _mm_add_ps(vAi, vTi));
+			}
+#endif
+			for (; k < m; k++)
+			{
+				float fTr = pBr[k] * pWr[k] - pBi[k] * pWi[k];
+				float fTi = pBr[k] * pWi[k] + pBi[k] * pWr[k];
+				pBr[k] = pAr[k] - fTr;
+				pBi[k] = pAi[k] - fTi;
+				pAr[k] += fTr;
+				pAi[k] += fTi;
+			}
+		}
+	}
+
+	const int iBins = N / 2 + 1;
+	int k = 0;
+#ifdef GM_SPECTRUM_SSE
+	for (; k + 4 <= iBins; k += 4)
+	{
+		__m128 vRe = _mm_loadu_ps(pRe + k);
+		__m128 vIm = _mm_loadu_ps(pIm + k);
+		_mm_storeu_ps(pPower + k, _mm_add_ps(_mm_mul_ps(vRe, vRe), _mm_mul_ps(vIm, vIm)));
+	}
+#endif
+	for (; k < iBins; k++)
+	{
+		pPower[k] = pRe[k] * pRe[k] + pIm[k] * pIm[k];
+	}
+}
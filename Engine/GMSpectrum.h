@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMSpectrum.h
+/// @brief		Galaxy-Music Engine - GMSpectrum
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.24
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMSpectrum
+	*  @brief 加窗的基2复数FFT，实部和虚部分开存储，蝶形运算按4路SIMD并行
+	*  @brief 节拍分析和口型分析共用，不是线程安全的，每个线程用自己的实例
+	*/
+	class CGMSpectrum
+	{
+		// 函数
+	public:
+		/**
+		* @brief 构造
+		* @param iSize: 窗口大小，必须是2的整数次幂
+		*/
+		CGMSpectrum(const int iSize);
+
+		/** @brief 窗口大小 */
+		inline int GetSize() const { return m_iSize; }
+
+		/**
+		* @brief 对一帧数据加窗、做FFT，输出功率谱
+		* @param pIn: 输入的一帧数据，长度为iSize
+		* @param pPower: 输出的功率谱，长度为iSize/2+1
+		*/
+		void Power(const float* pIn, float* pPower);
+
+		// 变量
+	private:
+		int						m_iSize;				//!< 窗口大小
+		std::vector<int>		m_bitRevVec;			//!< 位反转序号
+		std::vector<float>		m_windowVec;			//!< Hann窗
+		std::vector<float>		m_twReVec;				//!< 旋转因子的实部，按级连续存放
+		std::vector<float>		m_twImVec;				//!< 旋转因子的虚部
+		std::vector<float>		m_reVec;				//!< 工作区的实部
+		std::vector<float>		m_imVec;				//!< 工作区的虚部
+	};
+}	// GM
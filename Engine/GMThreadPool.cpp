@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMThreadPool.cpp
+/// @brief		Galaxy-Music Engine - GMThreadPool
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMThreadPool.h"
+
+using namespace GM;
+
+/*************************************************************************
+Global Constants
+*************************************************************************/
+
+// 自动划分时每个线程平均领取的次数，多一些可以平衡快慢不均的区间
+#define POOL_CHUNK_PER_THREAD		4
+
+// 当前线程是否正在处理池中的区间，嵌套调用时直接执行
+static thread_local bool s_bInPool = false;
+
+/*************************************************************************
+CGMThreadPool Methods
+*************************************************************************/
+
+template<> CGMThreadPool* CGMSingleton<CGMThreadPool>::msSingleton = nullptr;
+
+/** @brief 获取单例 */
+CGMThreadPool& CGMThreadPool::getSingleton(void)
+{
+	if (!msSingleton)
+		msSingleton = GM_NEW(CGMThreadPool);
+	assert(msSingleton);
+	return (*msSingleton);
+}
+
+/** @brief 构造 */
+CGMThreadPool::CGMThreadPool()
+{
+}
+
+/** @brief 析构 */
+CGMThreadPool::~CGMThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_condition.notify_all();
+	for (auto& itr : m_threadVec)
+	{
+		if (itr.joinable()) itr.join();
+	}
+	m_threadVec.clear();
+}
+
+/** @brief 释放 */
+void CGMThreadPool::Release()
+{
+	GM_DELETE(msSingleton);
+}
+
+/** @brief 并行处理[iBegin, iEnd) */
+void CGMThreadPool::ParallelFor(const int iBegin, const int iEnd, const std::function<void(int, int)>& fnRange, const int iGrain)
+{
+	if (iEnd <= iBegin) return;
+
+	std::call_once(m_startFlag, [this]() { _Start(); });
+	const int iNum = iEnd - iBegin;
+	const int iThreads = GetWorkerNum() + 1;
+	// 没有工作线程、只有一个序号或者嵌套调用时，在当前线程中直接执行
+	if (s_bInPool || iThreads <= 1 || iNum <= 1)
+	{
+		fnRange(iBegin, iEnd);
+		return;
+	}
+
+	std::shared_ptr<SGMPoolJob> pJob = std::make_shared<SGMPoolJob>();
+	pJob->fnRange = fnRange;
+	pJob->iBegin = iBegin;
+	pJob->iEnd = iEnd;
+	pJob->iGrain = (iGrain > 0) ? iGrain : (iNum / (iThreads * POOL_CHUNK_PER_THREAD) + 1);
+	pJob->iNext = iBegin;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobQueue.push_back(pJob);
+	}
+	m_condition.notify_all();
+
+	// 调用线程也参与计算
+	s_bInPool = true;
+	_Run(*pJob);
+	s_bInPool = false;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [&pJob, iNum]() { return pJob->iDone.load() >= iNum; });
+	// 工作线程可能还没来得及把领取完的任务移出队列
+	for (auto itr = m_jobQueue.begin(); itr != m_jobQueue.end(); ++itr)
+	{
+		if (*itr == pJob)
+		{
+			m_jobQueue.erase(itr);
+			break;
+		}
+	}
+}
+
+/** @brief 启动工作线程 */
+void CGMThreadPool::_Start()
+{
+	const unsigned int iHardware = std::thread::hardware_concurrency();
+	const int iWorkers = (iHardware > 1) ? int(iHardware - 1) : 0;
+	for (int i = 0; i < iWorkers; i++)
+	{
+		m_threadVec.push_back(std::thread(&CGMThreadPool::_WorkerLoop, this));
+	}
+}
+
+/** @brief 工作线程 */
+void CGMThreadPool::_WorkerLoop()
+{
+	s_bInPool = true;
+	while (true)
+	{
+		std::shared_ptr<SGMPoolJob> pJob;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_bExit || !m_jobQueue.empty(); });
+			if (m_bExit) return;
+
+			pJob = m_jobQueue.front();
+			// 所有区间都已经领取，移出队列，剩下的由领取者处理完
+			if (pJob->iNext.load() >= pJob->iEnd)
+			{
+				m_jobQueue.pop_front();
+				continue;
+			}
+		}
+		_Run(*pJob);
+	}
+}
+
+/** @brief 领取并处理区间 */
+void CGMThreadPool::_Run(SGMPoolJob& sJob)
+{
+	const int iNum = sJob.iEnd - sJob.iBegin;
+	while (true)
+	{
+		const int i0 = sJob.iNext.fetch_add(sJob.iGrain);
+		if (i0 >= sJob.iEnd) break;
+		const int i1 = (i0 + sJob.iGrain < sJob.iEnd) ? (i0 + sJob.iGrain) : sJob.iEnd;
+
+		sJob.fnRange(i0, i1);
+
+		if (sJob.iDone.fetch_add(i1 - i0) + (i1 - i0) >= iNum)
+		{
+			// 在锁内通知，避免调用线程检查完条件、还没开始等待时错过通知
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_doneCondition.notify_all();
+		}
+	}
+}
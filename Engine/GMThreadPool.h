@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMThreadPool.h
+/// @brief		Galaxy-Music Engine - GMThreadPool
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMPrerequisites.h"
+#include <functional>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace GM
+{
+	/*************************************************************************
+	Macro Defines
+	*************************************************************************/
+	#define GM_THREADPOOL				CGMThreadPool::getSingleton()
+
+	/*************************************************************************
+	Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMPoolJob
+	*  @brief 一次ParallelFor，所有线程从同一个计数器领取区间
+	*/
+	struct SGMPoolJob
+	{
+		std::function<void(int, int)>	fnRange;					//!< 处理[iBegin, iEnd)的函数
+		int								iBegin = 0;					//!< 起始序号
+		int								iEnd = 0;					//!< 结束序号，不包含
+		int								iGrain = 1;					//!< 每次领取的数量
+		std::atomic<int>				iNext{ 0 };					//!< 下一个还没有领取的序号
+		std::atomic<int>				iDone{ 0 };					//!< 已经处理完的数量
+	};
+
+	/*************************************************************************
+	Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMThreadPool
+	*  @brief 可移植的线程池，取代只能在MSVC上使用的ppl
+	*  @brief 调用线程也参与计算，嵌套调用时在当前线程中直接执行，不会死锁
+	*/
+	class CGMThreadPool : public CGMSingleton<CGMThreadPool>
+	{
+		// 函数
+	protected:
+		/** @brief 构造 */
+		CGMThreadPool();
+		/** @brief 析构 */
+		virtual ~CGMThreadPool();
+
+	public:
+		/** @brief 获取单例 */
+		static CGMThreadPool& getSingleton(void);
+		/** @brief 释放，等待工作线程退出 */
+		void Release();
+
+		/**
+		* @brief 并行处理[iBegin, iEnd)，所有区间处理完才返回
+		* @param iBegin, iEnd: 序号范围
+		* @param fnRange: 处理一个区间[i0, i1)的函数，会在多个线程中同时调用
+		* @param iGrain: 每次领取的数量，小于等于0时按线程数自动划分
+		*/
+		void ParallelFor(const int iBegin, const int iEnd, const std::function<void(int, int)>& fnRange, const int iGrain = 0);
+		/** @brief 工作线程数量，不包括调用线程 */
+		inline int GetWorkerNum() const { return int(m_threadVec.size()); }
+
+	private:
+		/** @brief 启动工作线程 */
+		void _Start();
+		/** @brief 工作线程 */
+		void _WorkerLoop();
+		/** @brief 领取并处理区间，直到全部领取完 */
+		void _Run(SGMPoolJob& sJob);
+
+		// 变量
+	private:
+		std::vector<std::thread>					m_threadVec;				//!< 工作线程
+		std::mutex									m_mutex;					//!< 保护任务队列
+		std::condition_variable						m_condition;				//!< 有新任务时唤醒工作线程
+		std::condition_variable						m_doneCondition;			//!< 任务完成时唤醒调用线程
+		std::deque<std::shared_ptr<SGMPoolJob>>		m_jobQueue;					//!< 还有区间没有领取的任务
+		std::once_flag								m_startFlag;				//!< 第一次使用时才启动线程
+		bool										m_bExit = false;			//!< 退出标志
+	};
+}	// GM
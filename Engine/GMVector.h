@@ -0,0 +1,533 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMVector.h
+/// @brief		Galaxy-Music Engine - GMVector
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+	struct SGMVector2;
+	struct SGMVector2i;
+	struct SGMVector2f;
+
+	struct SGMVector3;
+	struct SGMVector3i;
+	struct SGMVector3f;
+
+	struct SGMVector4;
+	struct SGMVector4i;
+	struct SGMVector4f;
+
+	/*!
+	*  @struct SGMVectorType
+	*  @brief 根据分量类型和维数找到对应的向量类型
+	*/
+	template<typename T, int N> struct SGMVectorType;
+	template<> struct SGMVectorType<float, 2> { typedef SGMVector2f type; };
+	template<> struct SGMVectorType<double, 2> { typedef SGMVector2 type; };
+	template<> struct SGMVectorType<int, 2> { typedef SGMVector2i type; };
+	template<> struct SGMVectorType<float, 3> { typedef SGMVector3f type; };
+	template<> struct SGMVectorType<double, 3> { typedef SGMVector3 type; };
+	template<> struct SGMVectorType<int, 3> { typedef SGMVector3i type; };
+	template<> struct SGMVectorType<float, 4> { typedef SGMVector4f type; };
+	template<> struct SGMVectorType<double, 4> { typedef SGMVector4 type; };
+	template<> struct SGMVectorType<int, 4> { typedef SGMVector4i type; };
+
+	/*!
+	*  @struct SGMVectorData
+	*  @brief 向量的存储，2维和3维与osg::Vec的内存布局相同，4维按16字节对齐
+	*/
+	template<typename T, int N> struct SGMVectorData;
+
+	template<typename T>
+	struct SGMVectorData<T, 2>
+	{
+		/** @brief 构造 */
+		constexpr SGMVectorData(T _x, T _y) : _v{ _x, _y } {}
+
+		// 变量
+		union
+		{
+			struct
+			{
+				T				x;
+				T				y;
+			};
+			struct
+			{
+				T				w;
+				T				h;
+			};
+			struct
+			{
+				T				lon;		//!< 经度
+				T				lat;		//!< 纬度
+			};
+			T					_v[2];
+		};
+	};
+
+	template<typename T>
+	struct SGMVectorData<T, 3>
+	{
+		/** @brief 构造 */
+		constexpr SGMVectorData(T _x, T _y, T _z) : _v{ _x, _y, _z } {}
+
+		// 变量
+		union
+		{
+			struct
+			{
+				T				x;
+				T				y;
+				T				z;
+			};
+			struct
+			{
+				T				lon;		//!< 经度
+				T				lat;		//!< 纬度
+				T				alt;		//!< 高度
+			};
+			T					_v[3];
+		};
+	};
+
+	template<typename T>
+	struct alignas(16) SGMVectorData<T, 4>
+	{
+		/** @brief 构造 */
+		constexpr SGMVectorData(T _x, T _y, T _z, T _w) : _v{ _x, _y, _z, _w } {}
+
+		// 变量
+		union
+		{
+			struct
+			{
+				T				x;
+				T				y;
+				T				z;
+				T				w;
+			};
+			struct
+			{
+				T				r;
+				T				g;
+				T				b;
+				T				a;
+			};
+			T					_v[4];
+		};
+	};
+
+	/*!
+	*  @struct SGMVectorBase
+	*  @brief 向量的公共运算，全部在头文件中内联，除了开方相关的运算都可以在编译期求值
+	*  @brief 编译期求值时只能通过_v或者[]访问分量，x/y/z等别名不是初始化时的联合体成员
+	*  @param T: 分量类型
+	*  @param N: 维数
+	*  @param V: 派生的向量类型，运算结果的类型
+	*/
+	template<typename T, int N, typename V>
+	struct SGMVectorBase : public SGMVectorData<T, N>
+	{
+		typedef T value_type;
+		/** @brief 长度的类型，整数向量的长度用double */
+		typedef typename std::conditional<std::is_integral<T>::value, double, T>::type length_type;
+
+		using SGMVectorData<T, N>::SGMVectorData;
+
+		/** @brief == 重载 */
+		constexpr bool operator == (const V& _sVec) const
+		{
+			for (int i = 0; i < N; i++)
+			{
+				if (this->_v[i] != _sVec._v[i]) return false;
+			}
+			return true;
+		}
+		/** @brief != 重载 */
+		constexpr bool operator != (const V& _sVec) const
+		{
+			return !(*this == _sVec);
+		}
+		/** @brief < 重载，依次比较各个分量 */
+		constexpr bool operator < (const V& _sVec) const
+		{
+			for (int i = 0; i < N; i++)
+			{
+				if (this->_v[i] < _sVec._v[i]) return true;
+				if (this->_v[i] > _sVec._v[i]) return false;
+			}
+			return false;
+		}
+		/** @brief > 重载 */
+		constexpr bool operator > (const V& _sVec) const
+		{
+			return _sVec < _Self();
+		}
+		/** @brief <= 重载 */
+		constexpr bool operator <= (const V& _sVec) const
+		{
+			return !(_sVec < _Self());
+		}
+		/** @brief >= 重载 */
+		constexpr bool operator >= (const V& _sVec) const
+		{
+			return !(*this < _sVec);
+		}
+
+		/** @brief 指针 */
+		constexpr T* ptr() { return this->_v; }
+		/** @brief 指针 */
+		constexpr const T* ptr() const { return this->_v; }
+		/** @brief [] 重载 */
+		constexpr T& operator [] (int i) { return this->_v[i]; }
+		/** @brief [] 重载 */
+		constexpr T operator [] (int i) const { return this->_v[i]; }
+
+		/** @brief * 重载，点积 */
+		constexpr T operator * (const V& _sVec) const
+		{
+			T fSum = 0;
+			for (int i = 0; i < N; i++)
+			{
+				fSum += this->_v[i] * _sVec._v[i];
+			}
+			return fSum;
+		}
+		/** @brief ^ 重载，叉积，只有3维向量可用 */
+		constexpr V operator ^ (const V& _sVec) const
+		{
+			static_assert(3 == N, "cross product is only defined for 3d vectors");
+			return V(this->_v[1] * _sVec._v[2] - this->_v[2] * _sVec._v[1],
+				this->_v[2] * _sVec._v[0] - this->_v[0] * _sVec._v[2],
+				this->_v[0] * _sVec._v[1] - this->_v[1] * _sVec._v[0]);
+		}
+		/** @brief * 重载 */
+		constexpr V operator * (T _fValue) const
+		{
+			V vResult(_Self());
+			vResult *= _fValue;
+			return vResult;
+		}
+		/** @brief *= 重载 */
+		constexpr V& operator *= (T _fValue)
+		{
+			for (int i = 0; i < N; i++)
+			{
+				this->_v[i] *= _fValue;
+			}
+			return _Self();
+		}
+		/** @brief / 重载 */
+		constexpr V operator / (T _fValue) const
+		{
+			V vResult(_Self());
+			vResult /= _fValue;
+			return vResult;
+		}
+		/** @brief /= 重载 */
+		constexpr V& operator /= (T _fValue)
+		{
+			for (int i = 0; i < N; i++)
+			{
+				this->_v[i] /= _fValue;
+			}
+			return _Self();
+		}
+		/** @brief + 重载 */
+		constexpr V operator + (const V& _sVec) const
+		{
+			V vResult(_Self());
+			vResult += _sVec;
+			return vResult;
+		}
+		/** @brief += 重载 */
+		constexpr V& operator += (const V& _sVec)
+		{
+			for (int i = 0; i < N; i++)
+			{
+				this->_v[i] += _sVec._v[i];
+			}
+			return _Self();
+		}
+		/** @brief - 重载 */
+		constexpr V operator - (const V& _sVec) const
+		{
+			V vResult(_Self());
+			vResult -= _sVec;
+			return vResult;
+		}
+		/** @brief -= 重载 */
+		constexpr V& operator -= (const V& _sVec)
+		{
+			for (int i = 0; i < N; i++)
+			{
+				this->_v[i] -= _sVec._v[i];
+			}
+			return _Self();
+		}
+		/** @brief 取反 重载 */
+		constexpr V operator - () const
+		{
+			V vResult(_Self());
+			for (int i = 0; i < N; i++)
+			{
+				vResult._v[i] = -vResult._v[i];
+			}
+			return vResult;
+		}
+
+		/** @brief 长度 */
+		length_type Length() const
+		{
+			return std::sqrt(static_cast<length_type>(SquaredLength()));
+		}
+		/** @brief 长度平方 */
+		constexpr T SquaredLength() const
+		{
+			return *this * _Self();
+		}
+		/** @brief 直线距离 */
+		length_type Distance(const V& _sVec) const
+		{
+			return (*this - _sVec).Length();
+		}
+		/** @brief 直线距离平方 */
+		constexpr T SquaredDistance(const V& _sVec) const
+		{
+			return (*this - _sVec).SquaredLength();
+		}
+		/** @brief 规范化，返回规范化之前的长度，零向量保持不变 */
+		T Normalize()
+		{
+			static_assert(std::is_floating_point<T>::value, "integer vectors can not be normalized");
+			const T fNorm = Length();
+			if (fNorm > 0)
+			{
+				*this *= static_cast<T>(1) / fNorm;
+			}
+			return fNorm;
+		}
+
+		/** @brief 相乘 */
+		static constexpr V ComponentMultiply(const V& _sVecL, const V& _sVecR)
+		{
+			V vResult(_sVecL);
+			for (int i = 0; i < N; i++)
+			{
+				vResult._v[i] *= _sVecR._v[i];
+			}
+			return vResult;
+		}
+		/** @brief 相除 */
+		static constexpr V ComponentDivide(const V& _sVecL, const V& _sVecR)
+		{
+			V vResult(_sVecL);
+			for (int i = 0; i < N; i++)
+			{
+				vResult._v[i] /= _sVecR._v[i];
+			}
+			return vResult;
+		}
+
+		/** @brief 转Int，直接截断小数部分 */
+		constexpr typename SGMVectorType<int, N>::type ToInt() const { return _Cast<int>(); }
+		/** @brief 转Float */
+		constexpr typename SGMVectorType<float, N>::type ToFloat() const { return _Cast<float>(); }
+		/** @brief 转Double */
+		constexpr typename SGMVectorType<double, N>::type ToDouble() const { return _Cast<double>(); }
+
+	private:
+		/** @brief 派生类型的自身 */
+		constexpr V& _Self() { return static_cast<V&>(*this); }
+		constexpr const V& _Self() const { return static_cast<const V&>(*this); }
+		/** @brief 逐个分量转换类型 */
+		template<typename U>
+		constexpr typename SGMVectorType<U, N>::type _Cast() const
+		{
+			typename SGMVectorType<U, N>::type vResult;
+			for (int i = 0; i < N; i++)
+			{
+				vResult._v[i] = static_cast<U>(this->_v[i]);
+			}
+			return vResult;
+		}
+	};
+
+	/*!
+	*  @struct SGMVector2f
+	*  @brief GM Vector2f
+	*/
+	struct SGMVector2f : public SGMVectorBase<float, 2, SGMVector2f>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector2f(float _x = 0, float _y = 0)
+			: SGMVectorBase(_x, _y) {}
+	};
+
+	/*!
+	 *  @struct SGMVector2
+	 *  @brief GM Vector2
+	 */
+	struct SGMVector2 : public SGMVectorBase<double, 2, SGMVector2>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector2(double _x = 0, double _y = 0)
+			: SGMVectorBase(_x, _y) {}
+		/** @brief 构造 */
+		constexpr SGMVector2(const SGMVector2f vec)
+			: SGMVectorBase(vec._v[0], vec._v[1]) {}
+		/** @brief 返回Vector2f */
+		constexpr operator SGMVector2f() const
+		{
+			return SGMVector2f(static_cast<float>(_v[0]), static_cast<float>(_v[1]));
+		}
+	};
+
+	/*!
+	*  @struct SGMVector2i
+	*  @brief GM Vector2i
+	*/
+	struct SGMVector2i : public SGMVectorBase<int, 2, SGMVector2i>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector2i(int _x = 0, int _y = 0)
+			: SGMVectorBase(_x, _y) {}
+	};
+
+	/*!
+	*  @struct SGMVector3f
+	*  @brief GM Vector3f
+	*/
+	struct SGMVector3f : public SGMVectorBase<float, 3, SGMVector3f>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector3f(float _x = 0, float _y = 0, float _z = 0)
+			: SGMVectorBase(_x, _y, _z) {}
+		/** @brief 构造 */
+		constexpr SGMVector3f(SGMVector2f _sVec2, float _z = 0)
+			: SGMVectorBase(_sVec2._v[0], _sVec2._v[1], _z) {}
+	};
+
+	/*!
+	 *  @struct SGMVector3
+	 *  @brief GM Vector3
+	 */
+	struct SGMVector3 : public SGMVectorBase<double, 3, SGMVector3>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector3(double _x = 0, double _y = 0, double _z = 0)
+			: SGMVectorBase(_x, _y, _z) {}
+		/** @brief 构造 */
+		constexpr SGMVector3(SGMVector2 _sVec2, double _z = 0)
+			: SGMVectorBase(_sVec2._v[0], _sVec2._v[1], _z) {}
+		/** @brief 构造 */
+		constexpr SGMVector3(const SGMVector3f vec)
+			: SGMVectorBase(vec._v[0], vec._v[1], vec._v[2]) {}
+		/** @brief 返回Vector3f */
+		constexpr operator SGMVector3f() const
+		{
+			return SGMVector3f(static_cast<float>(_v[0]), static_cast<float>(_v[1]), static_cast<float>(_v[2]));
+		}
+	};
+
+	/*!
+	*  @struct SGMVector3i
+	*  @brief GM Vector3i
+	*/
+	struct SGMVector3i : public SGMVectorBase<int, 3, SGMVector3i>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector3i(int _x = 0, int _y = 0, int _z = 0)
+			: SGMVectorBase(_x, _y, _z) {}
+		/** @brief 构造 */
+		constexpr SGMVector3i(SGMVector2i _sVec2, int _z = 0)
+			: SGMVectorBase(_sVec2._v[0], _sVec2._v[1], _z) {}
+	};
+
+	/*!
+	*  @struct SGMVector4f
+	*  @brief GM Vector4
+	*/
+	struct SGMVector4f : public SGMVectorBase<float, 4, SGMVector4f>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector4f(float _x = 0, float _y = 0, float _z = 0, float _w = 0)
+			: SGMVectorBase(_x, _y, _z, _w) {}
+		/** @brief 构造，颜色值按0xRRGGBBAA排列 */
+		constexpr SGMVector4f(unsigned nColorValue)
+			: SGMVectorBase(
+				static_cast<float>(nColorValue >> 24) / 255.0f,
+				static_cast<float>((nColorValue & 0xFF0000) >> 16) / 255.0f,
+				static_cast<float>((nColorValue & 0xFF00) >> 8) / 255.0f,
+				static_cast<float>(nColorValue & 0xFF) / 255.0f) {}
+		/** @brief 构造 */
+		constexpr SGMVector4f(SGMVector3f _sVec3, float _w = 0)
+			: SGMVectorBase(_sVec3._v[0], _sVec3._v[1], _sVec3._v[2], _w) {}
+	};
+
+	/*!
+	*  @struct SGMVector4
+	*  @brief GM Vector4
+	*/
+	struct SGMVector4 : public SGMVectorBase<double, 4, SGMVector4>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector4(double _x = 0, double _y = 0, double _z = 0, double _w = 0)
+			: SGMVectorBase(_x, _y, _z, _w) {}
+		/** @brief 构造，颜色值按0xRRGGBBAA排列 */
+		constexpr SGMVector4(unsigned nColorValue)
+			: SGMVectorBase(
+				static_cast<double>(nColorValue >> 24) / 255.0,
+				static_cast<double>((nColorValue & 0xFF0000) >> 16) / 255.0,
+				static_cast<double>((nColorValue & 0xFF00) >> 8) / 255.0,
+				static_cast<double>(nColorValue & 0xFF) / 255.0) {}
+		/** @brief 构造 */
+		constexpr SGMVector4(SGMVector3 _sVec3, double _w = 0)
+			: SGMVectorBase(_sVec3._v[0], _sVec3._v[1], _sVec3._v[2], _w) {}
+		/** @brief 构造 */
+		constexpr SGMVector4(const SGMVector4f vec)
+			: SGMVectorBase(vec._v[0], vec._v[1], vec._v[2], vec._v[3]) {}
+		/** @brief 返回Vector4f */
+		constexpr operator SGMVector4f() const
+		{
+			return SGMVector4f(static_cast<float>(_v[0]), static_cast<float>(_v[1]),
+				static_cast<float>(_v[2]), static_cast<float>(_v[3]));
+		}
+	};
+
+	/*!
+	*  @struct SGMVector4i
+	*  @brief GM Vector4
+	*/
+	struct SGMVector4i : public SGMVectorBase<int, 4, SGMVector4i>
+	{
+		/** @brief 构造 */
+		constexpr SGMVector4i(int _x = 0, int _y = 0, int _z = 0, int _w = 0)
+			: SGMVectorBase(_x, _y, _z, _w) {}
+		/** @brief 构造 */
+		constexpr SGMVector4i(unsigned nColorValue)
+			: SGMVectorBase(
+				static_cast<int>(nColorValue >> 24) / 255,
+				static_cast<int>((nColorValue & 0xFF0000) >> 16) / 255,
+				static_cast<int>((nColorValue & 0xFF00) >> 8) / 255,
+				static_cast<int>(nColorValue & 0xFF) / 255) {}
+		/** @brief 构造 */
+		constexpr SGMVector4i(SGMVector3i _sVec3, int _w = 0)
+			: SGMVectorBase(_sVec3._v[0], _sVec3._v[1], _sVec3._v[2], _w) {}
+	};
+}	// GM
@@ -0,0 +1,303 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMVectorOps.cpp
+/// @brief		Galaxy-Music Engine - GMVectorOps
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMVectorOps.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GM_VECTOR_SSE
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define VECTOR_BENCH_NUM			(1 << 12)	// 性能测试每批的向量数量
+#define VECTOR_BENCH_REPEAT			3200		// 性能测试每种运算的重复次数
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+static inline SGMVector3f TransformPoint(const osg::Matrixf& mMatrix, const SGMVector3f& v)
+{
+	const float fInvW = 1.0f / (mMatrix(0, 3) * v._v[0] + mMatrix(1, 3) * v._v[1] + mMatrix(2, 3) * v._v[2] + mMatrix(3, 3));
+	return SGMVector3f(
+		(mMatrix(0, 0) * v._v[0] + mMatrix(1, 0) * v._v[1] + mMatrix(2, 0) * v._v[2] + mMatrix(3, 0)) * fInvW,
+		(mMatrix(0, 1) * v._v[0] + mMatrix(1, 1) * v._v[1] + mMatrix(2, 1) * v._v[2] + mMatrix(3, 1)) * fInvW,
+		(mMatrix(0, 2) * v._v[0] + mMatrix(1, 2) * v._v[1] + mMatrix(2, 2) * v._v[2] + mMatrix(3, 2)) * fInvW);
+}
+
+static inline SGMVector4f TransformVector(const osg::Matrixf& mMatrix, const SGMVector4f& v)
+{
+	SGMVector4f vResult;
+	for (int i = 0; i < 4; i++)
+	{
+		vResult._v[i] = mMatrix(0, i) * v._v[0] + mMatrix(1, i) * v._v[1] + mMatrix(2, i) * v._v[2] + mMatrix(3, i) * v._v[3];
+	}
+	return vResult;
+}
+
+/** @brief 逐个浮点数插值，SGMVector3f和SGMVector4f都是连续的浮点数 */
+static void LerpFloats(const float* pA, const float* pB, const float fT, float* pOut, const size_t iNum)
+{
+	const float fS = 1.0f - fT;
+	size_t i = 0;
+#ifdef GM_VECTOR_SSE
+	const __m128 vS = _mm_set1_ps(fS);
+	const __m128 vT = _mm_set1_ps(fT);
+	for (; i + 4 <= iNum; i += 4)
+	{
+		const __m128 vA = _mm_loadu_ps(pA + i);
+		const __m128 vB = _mm_loadu_ps(pB + i);
+		_mm_storeu_ps(pOut + i, _mm_add_ps(_mm_mul_ps(vA, vS), _mm_mul_ps(vB, vT)));
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pOut[i] = pA[i] * fS + pB[i] * fT;
+	}
+}
+
+#ifdef GM_VECTOR_SSE
+/** @brief 把4个连续的SGMVector3f拆成x、y、z三组 */
+static inline void LoadSoA(const SGMVector3f* p, __m128& vX, __m128& vY, __m128& vZ)
+{
+	// vA = x0 y0 z0 x1, vB = y1 z1 x2 y2, vC = z2 x3 y3 z3
+	const float* pF = reinterpret_cast<const float*>(p);
+	const __m128 vA = _mm_loadu_ps(pF);
+	const __m128 vB = _mm_loadu_ps(pF + 4);
+	const __m128 vC = _mm_loadu_ps(pF + 8);
+	const __m128 vX23 = _mm_shuffle_ps(vB, vC, _MM_SHUFFLE(0, 1, 0, 2));	// x2 y1 x3 z2
+	vX = _mm_shuffle_ps(vA, vX23, _MM_SHUFFLE(2, 0, 3, 0));
+	const __m128 vY01 = _mm_shuffle_ps(vA, vB, _MM_SHUFFLE(0, 0, 0, 1));	// y0 x0 y1 y1
+	const __m128 vY23 = _mm_shuffle_ps(vB, vC, _MM_SHUFFLE(0, 2, 0, 3));	// y2 y1 y3 z2
+	vY = _mm_shuffle_ps(vY01, vY23, _MM_SHUFFLE(2, 0, 2, 0));
+	const __m128 vZ01 = _mm_shuffle_ps(vA, vB, _MM_SHUFFLE(0, 1, 0, 2));	// z0 x0 z1 y1
+	const __m128 vZ23 = _mm_shuffle_ps(vC, vC, _MM_SHUFFLE(0, 3, 0, 0));	// z2 z2 z3 z2
+	vZ = _mm_shuffle_ps(vZ01, vZ23, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/** @brief 把x、y、z三组写回4个连续的SGMVector3f */
+static inline void StoreSoA(SGMVector3f* p, const __m128 vX, const __m128 vY, const __m128 vZ)
+{
+	const __m128 vXY01 = _mm_unpacklo_ps(vX, vY);							// x0 y0 x1 y1
+	const __m128 vZX01 = _mm_shuffle_ps(vZ, vX, _MM_SHUFFLE(1, 1, 0, 0));	// z0 z0 x1 x1
+	const __m128 vYZ1 = _mm_shuffle_ps(vY, vZ, _MM_SHUFFLE(1, 1, 1, 1));	// y1 y1 z1 z1
+	const __m128 vXY2 = _mm_shuffle_ps(vX, vY, _MM_SHUFFLE(2, 2, 2, 2));	// x2 x2 y2 y2
+	const __m128 vZX23 = _mm_shuffle_ps(vZ, vX, _MM_SHUFFLE(3, 3, 2, 2));	// z2 z2 x3 x3
+	const __m128 vYZ3 = _mm_shuffle_ps(vY, vZ, _MM_SHUFFLE(3, 3, 3, 3));	// y3 y3 z3 z3
+	float* pF = reinterpret_cast<float*>(p);
+	_mm_storeu_ps(pF, _mm_shuffle_ps(vXY01, vZX01, _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(pF + 4, _mm_shuffle_ps(vYZ1, vXY2, _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(pF + 8, _mm_shuffle_ps(vZX23, vYZ3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+#endif
+
+/** @brief 计时，单位：ms */
+template<typename F>
+static double Measure(F func)
+{
+	const auto tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < VECTOR_BENCH_REPEAT; i++)
+	{
+		func();
+	}
+	const auto tEnd = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+}
+
+/*************************************************************************
+CGMVectorOps Methods
+*************************************************************************/
+
+void CGMVectorOps::Transform(const osg::Matrixf& mMatrix, const SGMVector3f* pIn, SGMVector3f* pOut, const size_t iNum)
+{
+	size_t i = 0;
+#ifdef GM_VECTOR_SSE
+	// 仿射变换的w恒为1，不需要透视除法，结果和除以1完全相同
+	const bool bAffine = (0.0f == mMatrix(0, 3)) && (0.0f == mMatrix(1, 3)) && (0.0f == mMatrix(2, 3)) && (1.0f == mMatrix(3, 3));
+	__m128 vM[4][4];
+	for (int r = 0; r < 4; r++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			vM[r][c] = _mm_set1_ps(mMatrix(r, c));
+		}
+	}
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	for (; i + 4 <= iNum; i += 4)
+	{
+		__m128 vX, vY, vZ;
+		LoadSoA(pIn + i, vX, vY, vZ);
+		__m128 vOut[3];
+		for (int c = 0; c < 3; c++)
+		{
+			vOut[c] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(vX, vM[0][c]), _mm_mul_ps(vY, vM[1][c])),
+				_mm_add_ps(_mm_mul_ps(vZ, vM[2][c]), vM[3][c]));
+		}
+		if (!bAffine)
+		{
+			const __m128 vW = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(vX, vM[0][3]), _mm_mul_ps(vY, vM[1][3])),
+				_mm_add_ps(_mm_mul_ps(vZ, vM[2][3]), vM[3][3]));
+			const __m128 vInvW = _mm_div_ps(vOne, vW);
+			for (int c = 0; c < 3; c++)
+			{
+				vOut[c] = _mm_mul_ps(vOut[c], vInvW);
+			}
+		}
+		StoreSoA(pOut + i, vOut[0], vOut[1], vOut[2]);
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pOut[i] = TransformPoint(mMatrix, pIn[i]);
+	}
+}
+
+void CGMVectorOps::Transform(const osg::Matrixf& mMatrix, const SGMVector4f* pIn, SGMVector4f* pOut, const size_t iNum)
+{
+	size_t i = 0;
+#ifdef GM_VECTOR_SSE
+	// SGMVector4f按16字节对齐，可以直接对齐读写
+	const __m128 vRow0 = _mm_loadu_ps(mMatrix.ptr());
+	const __m128 vRow1 = _mm_loadu_ps(mMatrix.ptr() + 4);
+	const __m128 vRow2 = _mm_loadu_ps(mMatrix.ptr() + 8);
+	const __m128 vRow3 = _mm_loadu_ps(mMatrix.ptr() + 12);
+	for (; i < iNum; i++)
+	{
+		const __m128 v = _mm_load_ps(pIn[i]._v);
+		const __m128 vXY = _mm_add_ps(
+			_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), vRow0),
+			_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), vRow1));
+		const __m128 vZW = _mm_add_ps(
+			_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), vRow2),
+			_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), vRow3));
+		_mm_store_ps(pOut[i]._v, _mm_add_ps(vXY, vZW));
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pOut[i] = TransformVector(mMatrix, pIn[i]);
+	}
+}
+
+void CGMVectorOps::Normalize(SGMVector3f* pData, const size_t iNum)
+{
+	size_t i = 0;
+#ifdef GM_VECTOR_SSE
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	for (; i + 4 <= iNum; i += 4)
+	{
+		__m128 vX, vY, vZ;
+		LoadSoA(pData + i, vX, vY, vZ);
+		const __m128 vLen = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vX, vX), _mm_mul_ps(vY, vY)), _mm_mul_ps(vZ, vZ)));
+		// 长度为0的向量乘1，保持不变
+		const __m128 vMask = _mm_cmpgt_ps(vLen, vZero);
+		const __m128 vInv = _mm_or_ps(_mm_and_ps(vMask, _mm_div_ps(vOne, vLen)), _mm_andnot_ps(vMask, vOne));
+		StoreSoA(pData + i, _mm_mul_ps(vX, vInv), _mm_mul_ps(vY, vInv), _mm_mul_ps(vZ, vInv));
+	}
+#endif
+	for (; i < iNum; i++)
+	{
+		pData[i].Normalize();
+	}
+}
+
+void CGMVectorOps::Lerp(const SGMVector3f* pA, const SGMVector3f* pB, const float fT, SGMVector3f* pOut, const size_t iNum)
+{
+	LerpFloats(reinterpret_cast<const float*>(pA), reinterpret_cast<const float*>(pB), fT, reinterpret_cast<float*>(pOut), iNum * 3);
+}
+
+void CGMVectorOps::Lerp(const SGMVector4f* pA, const SGMVector4f* pB, const float fT, SGMVector4f* pOut, const size_t iNum)
+{
+	LerpFloats(reinterpret_cast<const float*>(pA), reinterpret_cast<const float*>(pB), fT, reinterpret_cast<float*>(pOut), iNum * 4);
+}
+
+bool CGMVectorOps::Benchmark(const std::string& strResultFile)
+{
+	std::vector<SGMVector3f> vPoint3Vec(VECTOR_BENCH_NUM);
+	std::vector<SGMVector3f> vTarget3Vec(VECTOR_BENCH_NUM);
+	std::vector<SGMVector3f> vOut3Vec(VECTOR_BENCH_NUM);
+	std::vector<SGMVector4f> vPoint4Vec(VECTOR_BENCH_NUM);
+	std::vector<SGMVector4f> vOut4Vec(VECTOR_BENCH_NUM);
+	for (int i = 0; i < VECTOR_BENCH_NUM; i++)
+	{
+		const float f = static_cast<float>(i);
+		vPoint3Vec[i] = SGMVector3f(std::sin(f), std::cos(f * 0.7f), f * 1e-3f);
+		vTarget3Vec[i] = SGMVector3f(f * 1e-3f, std::sin(f * 1.3f), std::cos(f));
+		vPoint4Vec[i] = SGMVector4f(vPoint3Vec[i], 1.0f);
+	}
+	osg::Matrixf mMatrix = osg::Matrixf::rotate(0.3f, osg::Vec3f(0.0f, 0.0f, 1.0f)) * osg::Matrixf::translate(1.0f, 2.0f, 3.0f);
+
+	std::ostringstream ssResult;
+	ssResult << "op\tvectors\tscalar_ms\tbatch_ms\tspeedup\n";
+	auto Report = [&ssResult](const char* szName, const double fScalar, const double fBatch)
+	{
+		ssResult << szName << "\t" << VECTOR_BENCH_NUM * VECTOR_BENCH_REPEAT << "\t"
+			<< fScalar << "\t" << fBatch << "\t" << fScalar / fmax(fBatch, 1e-6) << "\n";
+	};
+
+	// 逐个向量计算，是原来调用处的写法：转成osg::Vec，算完再转回来
+	Report("transform3",
+		Measure([&]() {
+			for (int i = 0; i < VECTOR_BENCH_NUM; i++)
+			{
+				const SGMVector3f& v = vPoint3Vec[i];
+				const osg::Vec3f vOSG = osg::Vec3f(v.x, v.y, v.z) * mMatrix;
+				vOut3Vec[i] = SGMVector3f(vOSG.x(), vOSG.y(), vOSG.z());
+			}
+		}),
+		Measure([&]() { Transform(mMatrix, vPoint3Vec.data(), vOut3Vec.data(), VECTOR_BENCH_NUM); }));
+	Report("transform4",
+		Measure([&]() {
+			for (int i = 0; i < VECTOR_BENCH_NUM; i++)
+			{
+				vOut4Vec[i] = OSG2GM(GM2OSG(vPoint4Vec[i]) * mMatrix);
+			}
+		}),
+		Measure([&]() { Transform(mMatrix, vPoint4Vec.data(), vOut4Vec.data(), VECTOR_BENCH_NUM); }));
+	Report("normalize3",
+		Measure([&]() {
+			vOut3Vec = vPoint3Vec;
+			for (auto& itr : vOut3Vec)
+			{
+				itr.Normalize();
+			}
+		}),
+		Measure([&]() {
+			vOut3Vec = vPoint3Vec;
+			Normalize(vOut3Vec.data(), VECTOR_BENCH_NUM);
+		}));
+	Report("lerp3",
+		Measure([&]() {
+			for (int i = 0; i < VECTOR_BENCH_NUM; i++)
+			{
+				vOut3Vec[i] = vPoint3Vec[i] * 0.75f + vTarget3Vec[i] * 0.25f;
+			}
+		}),
+		Measure([&]() { Lerp(vPoint3Vec.data(), vTarget3Vec.data(), 0.25f, vOut3Vec.data(), VECTOR_BENCH_NUM); }));
+
+	std::ofstream outFile(strResultFile);
+	if (!outFile.is_open()) return false;
+	outFile << ssResult.str();
+	return outFile.good();
+}
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMVectorOps.h
+/// @brief		Galaxy-Music Engine - GMVectorOps
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "GMVector.h"
+#include <osg/Vec2f>
+#include <osg/Vec2d>
+#include <osg/Vec3f>
+#include <osg/Vec3d>
+#include <osg/Vec4f>
+#include <osg/Vec4d>
+#include <osg/Matrixf>
+#include <string>
+#include <cstddef>
+
+namespace GM
+{
+	/*************************************************************************
+	 Global Functions
+	*************************************************************************/
+
+	static_assert(sizeof(SGMVector2f) == sizeof(osg::Vec2f), "SGMVector2f must match osg::Vec2f");
+	static_assert(sizeof(SGMVector2) == sizeof(osg::Vec2d), "SGMVector2 must match osg::Vec2d");
+	static_assert(sizeof(SGMVector3f) == sizeof(osg::Vec3f), "SGMVector3f must match osg::Vec3f");
+	static_assert(sizeof(SGMVector3) == sizeof(osg::Vec3d), "SGMVector3 must match osg::Vec3d");
+	static_assert(sizeof(SGMVector4f) == sizeof(osg::Vec4f), "SGMVector4f must match osg::Vec4f");
+	static_assert(sizeof(SGMVector4) == sizeof(osg::Vec4d), "SGMVector4 must match osg::Vec4d");
+
+	/**
+	* @brief SGMVector 转 osg::Vec，两者内存布局相同，直接返回引用，不拷贝
+	*/
+	inline const osg::Vec2f& GM2OSG(const SGMVector2f& vGM) { return reinterpret_cast<const osg::Vec2f&>(vGM); }
+	inline const osg::Vec2d& GM2OSG(const SGMVector2& vGM) { return reinterpret_cast<const osg::Vec2d&>(vGM); }
+	inline const osg::Vec3f& GM2OSG(const SGMVector3f& vGM) { return reinterpret_cast<const osg::Vec3f&>(vGM); }
+	inline const osg::Vec3d& GM2OSG(const SGMVector3& vGM) { return reinterpret_cast<const osg::Vec3d&>(vGM); }
+	inline const osg::Vec4f& GM2OSG(const SGMVector4f& vGM) { return reinterpret_cast<const osg::Vec4f&>(vGM); }
+	inline const osg::Vec4d& GM2OSG(const SGMVector4& vGM) { return reinterpret_cast<const osg::Vec4d&>(vGM); }
+	inline osg::Vec2f& GM2OSG(SGMVector2f& vGM) { return reinterpret_cast<osg::Vec2f&>(vGM); }
+	inline osg::Vec2d& GM2OSG(SGMVector2& vGM) { return reinterpret_cast<osg::Vec2d&>(vGM); }
+	inline osg::Vec3f& GM2OSG(SGMVector3f& vGM) { return reinterpret_cast<osg::Vec3f&>(vGM); }
+	inline osg::Vec3d& GM2OSG(SGMVector3& vGM) { return reinterpret_cast<osg::Vec3d&>(vGM); }
+	inline osg::Vec4f& GM2OSG(SGMVector4f& vGM) { return reinterpret_cast<osg::Vec4f&>(vGM); }
+	inline osg::Vec4d& GM2OSG(SGMVector4& vGM) { return reinterpret_cast<osg::Vec4d&>(vGM); }
+
+	/**
+	* @brief osg::Vec 转 SGMVector，2维和3维直接返回引用
+	* 4维的SGMVector要求16字节对齐，osg::Vec4不保证，所以返回拷贝
+	*/
+	inline const SGMVector2f& OSG2GM(const osg::Vec2f& vOSG) { return reinterpret_cast<const SGMVector2f&>(vOSG); }
+	inline const SGMVector2& OSG2GM(const osg::Vec2d& vOSG) { return reinterpret_cast<const SGMVector2&>(vOSG); }
+	inline const SGMVector3f& OSG2GM(const osg::Vec3f& vOSG) { return reinterpret_cast<const SGMVector3f&>(vOSG); }
+	inline const SGMVector3& OSG2GM(const osg::Vec3d& vOSG) { return reinterpret_cast<const SGMVector3&>(vOSG); }
+	inline SGMVector4f OSG2GM(const osg::Vec4f& vOSG) { return SGMVector4f(vOSG.x(), vOSG.y(), vOSG.z(), vOSG.w()); }
+	inline SGMVector4 OSG2GM(const osg::Vec4d& vOSG) { return SGMVector4(vOSG.x(), vOSG.y(), vOSG.z(), vOSG.w()); }
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMVectorOps
+	*  @brief 对连续存放的一批向量做同样的运算，x64上用SSE一次处理4个向量
+	*  @brief 输入和输出可以是同一块内存，但不能部分重叠
+	*/
+	class CGMVectorOps
+	{
+		// 函数
+	public:
+		/**
+		* @brief 变换点，和 osg::Vec3f * osg::Matrixf 相同，包括透视除法
+		* @param mMatrix: 变换矩阵
+		* @param pIn: 输入的点
+		* @param pOut: 输出的点
+		* @param iNum: 点的数量
+		*/
+		static void Transform(const osg::Matrixf& mMatrix, const SGMVector3f* pIn, SGMVector3f* pOut, const size_t iNum);
+		/**
+		* @brief 变换齐次坐标，和 osg::Vec4f * osg::Matrixf 相同
+		* @param mMatrix: 变换矩阵
+		* @param pIn: 输入的向量
+		* @param pOut: 输出的向量
+		* @param iNum: 向量的数量
+		*/
+		static void Transform(const osg::Matrixf& mMatrix, const SGMVector4f* pIn, SGMVector4f* pOut, const size_t iNum);
+		/**
+		* @brief 原地规范化，零向量保持不变
+		* @param pData: 向量
+		* @param iNum: 向量的数量
+		*/
+		static void Normalize(SGMVector3f* pData, const size_t iNum);
+		/**
+		* @brief 线性插值，pOut[i] = pA[i] * (1 - fT) + pB[i] * fT
+		* @param pA, pB: 插值的两端
+		* @param fT: 插值系数
+		* @param pOut: 输出的向量
+		* @param iNum: 向量的数量
+		*/
+		static void Lerp(const SGMVector3f* pA, const SGMVector3f* pB, const float fT, SGMVector3f* pOut, const size_t iNum);
+		static void Lerp(const SGMVector4f* pA, const SGMVector4f* pB, const float fT, SGMVector4f* pOut, const size_t iNum);
+
+		/**
+		* @brief 性能测试，比较逐个向量计算和批量计算的耗时
+		* @param strResultFile: 结果文件路径
+		* @return bool 成功true，写文件失败false
+		*/
+		static bool Benchmark(const std::string& strResultFile = "VectorBenchmark.txt");
+	};
+}	// GM
@@ -0,0 +1,407 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMVertexQuantizer.cpp
+/// @brief		Galaxy-Music Engine - GMVertexQuantizer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "GMVertexQuantizer.h"
+#include <osg/Geode>
+#include <osg/NodeVisitor>
+#include <osgAnimation/MorphGeometry>
+#include <osgAnimation/RigGeometry>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <set>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#ifndef GL_INT_2_10_10_10_REV
+#define GL_INT_2_10_10_10_REV		0x8D9F
+#endif
+
+#define TANGENT_UNIT				6			// 生成的切线的顶点属性位置
+#define BINORMAL_UNIT				7			// 生成的副切线的顶点属性位置
+#define QUANT_NORMAL_UNIT			6			// 压缩后法线的顶点属性位置
+#define QUANT_TANGENT_UNIT			7			// 压缩后切线的顶点属性位置
+#define QUANT_SHORT_MAX				32767.0f	// 16位有符号整数的最大值
+
+/*************************************************************************
+Local Types and Functions
+*************************************************************************/
+
+namespace GM
+{
+	/** @brief 四个分量打包在一个32位整数中的有符号归一化数组，xyz各10位，w两位 */
+	typedef osg::TemplateArray<GLuint, osg::Array::UIntArrayType, 4, GL_INT_2_10_10_10_REV> CGMPacked1010102Array;
+
+	/*!
+	*  @class CGMGeometryCollector
+	*  @brief 收集资源中所有的几何体，共享的几何体只收集一次
+	*/
+	class CGMGeometryCollector : public osg::NodeVisitor
+	{
+	public:
+		CGMGeometryCollector(std::vector<osg::Geometry*>& geomVec)
+			: osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), m_geomVec(geomVec) {}
+
+		virtual void apply(osg::Geode& node)
+		{
+			for (unsigned int i = 0; i < node.getNumDrawables(); ++i)
+			{
+				osg::Geometry* pGeom = node.getDrawable(i)->asGeometry();
+				if (pGeom && m_geomSet.insert(pGeom).second)
+				{
+					m_geomVec.push_back(pGeom);
+					// 蒙皮和变形动画会改写位置和法线
+					if (dynamic_cast<osgAnimation::RigGeometry*>(pGeom) || dynamic_cast<osgAnimation::MorphGeometry*>(pGeom))
+						m_bAnimated = true;
+				}
+			}
+			traverse(node);
+		}
+
+		inline bool GetAnimated() const { return m_bAnimated; }
+
+	private:
+		std::vector<osg::Geometry*>&		m_geomVec;
+		std::set<osg::Geometry*>			m_geomSet;
+		bool								m_bAnimated = false;
+	};
+
+	/*!
+	*  @class CGMQuantizedBound
+	*  @brief 压缩后的顶点数组OSG无法计算包围盒，使用压缩前的包围盒
+	*/
+	class CGMQuantizedBound : public osg::Drawable::ComputeBoundingBoxCallback
+	{
+	public:
+		CGMQuantizedBound(const osg::BoundingBox& bb) : m_bb(bb) {}
+		virtual osg::BoundingBox computeBound(const osg::Drawable&) const { return m_bb; }
+
+	private:
+		osg::BoundingBox		m_bb;
+	};
+
+	/** @brief 数组是否是逐顶点的，并且数量正确 */
+	static bool IsPerVertex(const osg::Array* pArray, const unsigned int iNum)
+	{
+		return pArray && (osg::Array::BIND_PER_VERTEX == pArray->getBinding()) && (iNum == pArray->getNumElements());
+	}
+
+	/** @brief 读取三维向量，支持导入插件生成的float、double数组和切线生成器的四维数组 */
+	static osg::Vec3f Vec3At(const osg::Array* pArray, const unsigned int i)
+	{
+		switch (pArray->getType())
+		{
+		case osg::Array::Vec3ArrayType:
+			return static_cast<const osg::Vec3Array&>(*pArray)[i];
+		case osg::Array::Vec3dArrayType:
+			return osg::Vec3f(static_cast<const osg::Vec3dArray&>(*pArray)[i]);
+		case osg::Array::Vec4ArrayType:
+		{
+			const osg::Vec4f& v = static_cast<const osg::Vec4Array&>(*pArray)[i];
+			return osg::Vec3f(v.x(), v.y(), v.z());
+		}
+		default:
+			return osg::Vec3f();
+		}
+	}
+
+	static bool IsVec3(const osg::Array* pArray)
+	{
+		return osg::Array::Vec3ArrayType == pArray->getType() || osg::Array::Vec3dArrayType == pArray->getType();
+	}
+
+	/** @brief [-1,1]的浮点数转成n位有符号整数 */
+	static int ToSnorm(const float f, const float fMax)
+	{
+		const float fClamp = (f < -1.0f) ? -1.0f : ((f > 1.0f) ? 1.0f : f);
+		return int(std::floor(fClamp * fMax + 0.5f));
+	}
+
+	/** @brief 单位向量的八面体编码 */
+	static osg::Vec2f OctEncode(const osg::Vec3f& vN)
+	{
+		const float fL1 = std::fabs(vN.x()) + std::fabs(vN.y()) + std::fabs(vN.z());
+		if (fL1 <= 0.0f) return osg::Vec2f(0.0f, 0.0f);
+		osg::Vec2f vE(vN.x() / fL1, vN.y() / fL1);
+		if (vN.z() < 0.0f)
+		{
+			// 下半球折叠到四个角上
+			const float fX = (1.0f - std::fabs(vE.y())) * ((vE.x() >= 0.0f) ? 1.0f : -1.0f);
+			const float fY = (1.0f - std::fabs(vE.x())) * ((vE.y() >= 0.0f) ? 1.0f : -1.0f);
+			vE.set(fX, fY);
+		}
+		return vE;
+	}
+
+	/** @brief 和法线垂直的任意单位向量，没有切线的几何体使用 */
+	static osg::Vec3f AnyTangent(const osg::Vec3f& vN)
+	{
+		osg::Vec3f vT = (std::fabs(vN.x()) < 0.9f) ? (osg::Vec3f(1, 0, 0) ^ vN) : (osg::Vec3f(0, 1, 0) ^ vN);
+		if (vT.normalize() <= 0.0f) vT.set(1, 0, 0);
+		return vT;
+	}
+}	// GM
+
+/*************************************************************************
+CGMVertexQuantizer Methods
+*************************************************************************/
+
+/** @brief 构造 */
+CGMVertexQuantizer::CGMVertexQuantizer()
+{
+}
+
+/** @brief 析构 */
+CGMVertexQuantizer::~CGMVertexQuantizer()
+{
+}
+
+/** @brief 压缩模型资源的顶点格式 */
+bool CGMVertexQuantizer::Quantize(osg::Node* pAsset)
+{
+	m_sStats = SGMQuantizeStats();
+	m_geomVec.clear();
+	m_posBox.init();
+	m_vUVMin.set(FLT_MAX, FLT_MAX);
+	m_vUVMax.set(-FLT_MAX, -FLT_MAX);
+	if (!pAsset) return false;
+
+	CGMGeometryCollector hCollector(m_geomVec);
+	pAsset->accept(hCollector);
+	m_bPosition = !hCollector.GetAnimated();
+
+	// 解码参数对整个资源相同，所以先检查所有几何体
+	for (auto& itr : m_geomVec)
+	{
+		if (!_Check(itr)) return false;
+	}
+	if (m_geomVec.empty()) return false;
+	if (m_vUVMin.x() > m_vUVMax.x())
+	{
+		m_vUVMin.set(0, 0);
+		m_vUVMax.set(1, 1);
+	}
+
+	for (auto& itr : m_geomVec)
+	{
+		m_sStats.iBytesBefore += _ArrayBytes(itr);
+		_QuantizeUV(itr);
+		_QuantizeTangent(itr);
+		if (m_bPosition) _QuantizePosition(itr);
+		_ShareWithSource(itr);
+		m_sStats.iBytesAfter += _ArrayBytes(itr);
+	}
+	m_sStats.iGeometryNum = int(m_geomVec.size());
+	m_sStats.bPosition = m_bPosition;
+
+	osg::StateSet* pStateSet = pAsset->getOrCreateStateSet();
+	const osg::Vec2f vUVScale = (m_vUVMax - m_vUVMin) / (2.0f * QUANT_SHORT_MAX);
+	const osg::Vec2f vUVOffset = (m_vUVMax + m_vUVMin) * 0.5f;
+	pStateSet->setDefine("GM_QUANT_UV");
+	pStateSet->setDefine("GM_QUANT_TANGENT");
+	pStateSet->addUniform(new osg::Uniform("quantUVRange", osg::Vec4f(vUVOffset.x(), vUVOffset.y(), vUVScale.x(), vUVScale.y())));
+	if (m_bPosition)
+	{
+		const osg::Vec3f vHalf = (m_posBox._max - m_posBox._min) * 0.5f;
+		pStateSet->setDefine("GM_QUANT_POSITION");
+		pStateSet->setDefine("GM_QUANT_NORMAL");
+		pStateSet->addUniform(new osg::Uniform("quantPosOffset", osg::Vec3f(m_posBox.center())));
+		pStateSet->addUniform(new osg::Uniform("quantPosScale", vHalf / QUANT_SHORT_MAX));
+	}
+	return true;
+}
+
+bool CGMVertexQuantizer::_Check(osg::Geometry* pGeom)
+{
+	const osg::Array* pVertices = pGeom->getVertexArray();
+	if (!pVertices || !IsVec3(pVertices)) return false;
+	const unsigned int iNum = pVertices->getNumElements();
+	if (!IsPerVertex(pVertices, iNum)) return false;
+
+	// 蒙皮初始化时会把源几何体的数组拷贝回来，压缩后的数组也要给源几何体，所以顶点数量必须一致
+	if (osgAnimation::RigGeometry* pRig = dynamic_cast<osgAnimation::RigGeometry*>(pGeom))
+	{
+		const osg::Geometry* pSource = pRig->getSourceGeometry();
+		if (pSource && (pSource != pGeom) && !IsPerVertex(pSource->getVertexArray(), iNum)) return false;
+	}
+
+	const osg::Array* pNormals = pGeom->getNormalArray();
+	if (pNormals && (!IsVec3(pNormals) || !IsPerVertex(pNormals, iNum))) return false;
+	const osg::Array* pTexCoords = pGeom->getTexCoordArray(0);
+	if (pTexCoords && (osg::Array::Vec2ArrayType != pTexCoords->getType() || !IsPerVertex(pTexCoords, iNum))) return false;
+	// 这两个位置只能是生成的切线和副切线，压缩后被法线和切线占用
+	for (unsigned int i = TANGENT_UNIT; i <= BINORMAL_UNIT; i++)
+	{
+		const osg::Array* pAttrib = pGeom->getVertexAttribArray(i);
+		if (pAttrib && (osg::Array::Vec4ArrayType != pAttrib->getType())) return false;
+	}
+
+	if (pTexCoords)
+	{
+		for (auto& itr : static_cast<const osg::Vec2Array&>(*pTexCoords))
+		{
+			if (itr.x() < m_vUVMin.x()) m_vUVMin.x() = itr.x();
+			if (itr.y() < m_vUVMin.y()) m_vUVMin.y() = itr.y();
+			if (itr.x() > m_vUVMax.x()) m_vUVMax.x() = itr.x();
+			if (itr.y() > m_vUVMax.y()) m_vUVMax.y() = itr.y();
+		}
+	}
+	if (m_bPosition)
+	{
+		for (unsigned int i = 0; i < iNum; i++)
+		{
+			m_posBox.expandBy(Vec3At(pVertices, i));
+		}
+	}
+	return true;
+}
+
+void CGMVertexQuantizer::_QuantizeUV(osg::Geometry* pGeom) const
+{
+	const osg::Vec2Array* pTexCoords = static_cast<const osg::Vec2Array*>(pGeom->getTexCoordArray(0));
+	if (!pTexCoords) return;
+
+	const osg::Vec2f vHalf = (m_vUVMax - m_vUVMin) * 0.5f;
+	const osg::Vec2f vCenter = (m_vUVMax + m_vUVMin) * 0.5f;
+	osg::ref_ptr<osg::Vec2sArray> pQuantized = new osg::Vec2sArray(pTexCoords->size());
+	for (size_t i = 0; i < pTexCoords->size(); i++)
+	{
+		const osg::Vec2f& vUV = (*pTexCoords)[i];
+		const float fX = (vHalf.x() > 0.0f) ? (vUV.x() - vCenter.x()) / vHalf.x() : 0.0f;
+		const float fY = (vHalf.y() > 0.0f) ? (vUV.y() - vCenter.y()) / vHalf.y() : 0.0f;
+		(*pQuantized)[i].set(short(ToSnorm(fX, QUANT_SHORT_MAX)), short(ToSnorm(fY, QUANT_SHORT_MAX)));
+	}
+
+	// 导入插件给每种贴图一个纹理单元，通常都是同一套纹理坐标，内容相同的共用压缩后的数组
+	osg::ref_ptr<const osg::Vec2Array> pSource = pTexCoords;
+	for (unsigned int i = 0; i < pGeom->getNumTexCoordArrays(); i++)
+	{
+		const osg::Array* pUnit = pGeom->getTexCoordArray(i);
+		if (!pUnit || (pUnit != pSource.get() && (pUnit->getTotalDataSize() != pSource->getTotalDataSize()
+			|| pUnit->getType() != pSource->getType()
+			|| 0 != memcmp(pUnit->getDataPointer(), pSource->getDataPointer(), pSource->getTotalDataSize()))))
+			continue;
+		pGeom->setTexCoordArray(i, pQuantized.get(), osg::Array::BIND_PER_VERTEX);
+	}
+}
+
+void CGMVertexQuantizer::_QuantizeTangent(osg::Geometry* pGeom) const
+{
+	const unsigned int iNum = pGeom->getVertexArray()->getNumElements();
+	const osg::Array* pNormals = pGeom->getNormalArray();
+	const osg::Array* pTangents = pGeom->getVertexAttribArray(TANGENT_UNIT);
+	const osg::Array* pBinormals = pGeom->getVertexAttribArray(BINORMAL_UNIT);
+	// 切线生成失败时数组是空的
+	if (!IsPerVertex(pTangents, iNum) || !IsPerVertex(pBinormals, iNum)) pTangents = pBinormals = nullptr;
+
+	osg::ref_ptr<CGMPacked1010102Array> pPacked = new CGMPacked1010102Array(iNum);
+	pPacked->setNormalize(true);
+	for (unsigned int i = 0; i < iNum; i++)
+	{
+		osg::Vec3f vN = pNormals ? Vec3At(pNormals, i) : osg::Vec3f(0, 0, 1);
+		if (vN.normalize() <= 0.0f) vN.set(0, 0, 1);
+
+		// 切线对法线正交化，副切线只保留方向
+		osg::Vec3f vT;
+		float fSign = 1.0f;
+		if (pTangents)
+		{
+			vT = Vec3At(pTangents, i);
+			vT -= vN * (vN * vT);
+			if (((vN ^ vT) * Vec3At(pBinormals, i)) < 0.0f) fSign = -1.0f;
+		}
+		if (vT.normalize() <= 0.0f) vT = AnyTangent(vN);
+
+		const GLuint iX = GLuint(ToSnorm(vT.x(), 511.0f)) & 0x3FF;
+		const GLuint iY = GLuint(ToSnorm(vT.y(), 511.0f)) & 0x3FF;
+		const GLuint iZ = GLuint(ToSnorm(vT.z(), 511.0f)) & 0x3FF;
+		const GLuint iW = GLuint(ToSnorm(fSign, 1.0f)) & 0x3;
+		(*pPacked)[i] = iX | (iY << 10) | (iZ << 20) | (iW << 30);
+	}
+
+	pGeom->setVertexAttribArray(TANGENT_UNIT, nullptr);
+	pGeom->setVertexAttribArray(QUANT_TANGENT_UNIT, pPacked.get(), osg::Array::BIND_PER_VERTEX);
+}
+
+void CGMVertexQuantizer::_QuantizePosition(osg::Geometry* pGeom) const
+{
+	const osg::Array* pVertices = pGeom->getVertexArray();
+	const unsigned int iNum = pVertices->getNumElements();
+	const osg::Vec3f vCenter = m_posBox.center();
+	const osg::Vec3f vHalf = (m_posBox._max - m_posBox._min) * 0.5f;
+
+	osg::BoundingBox bb;
+	osg::ref_ptr<osg::Vec3sArray> pQuantized = new osg::Vec3sArray(iNum);
+	for (unsigned int i = 0; i < iNum; i++)
+	{
+		const osg::Vec3f vPos = Vec3At(pVertices, i);
+		bb.expandBy(vPos);
+		for (int j = 0; j < 3; j++)
+		{
+			const float f = (vHalf[j] > 0.0f) ? (vPos[j] - vCenter[j]) / vHalf[j] : 0.0f;
+			(*pQuantized)[i][j] = short(ToSnorm(f, QUANT_SHORT_MAX));
+		}
+	}
+
+	// 法线放到顶点属性中，固定管线的法线数组只支持三个分量
+	if (const osg::Array* pNormals = pGeom->getNormalArray())
+	{
+		osg::ref_ptr<osg::Vec2sArray> pOct = new osg::Vec2sArray(iNum);
+		pOct->setNormalize(true);
+		for (unsigned int i = 0; i < iNum; i++)
+		{
+			osg::Vec3f vN = Vec3At(pNormals, i);
+			if (vN.normalize() <= 0.0f) vN.set(0, 0, 1);
+			const osg::Vec2f vE = OctEncode(vN);
+			(*pOct)[i].set(short(ToSnorm(vE.x(), QUANT_SHORT_MAX)), short(ToSnorm(vE.y(), QUANT_SHORT_MAX)));
+		}
+		pGeom->setNormalArray(nullptr);
+		pGeom->setVertexAttribArray(QUANT_NORMAL_UNIT, pOct.get(), osg::Array::BIND_PER_VERTEX);
+	}
+
+	pGeom->setVertexArray(pQuantized.get());
+	pGeom->setComputeBoundingBoxCallback(new CGMQuantizedBound(bb));
+	pGeom->dirtyBound();
+}
+
+void CGMVertexQuantizer::_ShareWithSource(osg::Geometry* pGeom) const
+{
+	osgAnimation::RigGeometry* pRig = dynamic_cast<osgAnimation::RigGeometry*>(pGeom);
+	if (!pRig) return;
+	osg::Geometry* pSource = pRig->getSourceGeometry();
+	if (!pSource || (pSource == pGeom)) return;
+
+	// RigTransform初始化时用源几何体的纹理坐标和顶点属性覆盖蒙皮几何体的，
+	// 源几何体共用压缩后的数组，变形动画的源几何体浅拷贝时也就一起共用了
+	pSource->setTexCoordArrayList(pGeom->getTexCoordArrayList());
+	pSource->setVertexAttribArray(TANGENT_UNIT, pGeom->getVertexAttribArray(TANGENT_UNIT));
+	pSource->setVertexAttribArray(QUANT_TANGENT_UNIT, pGeom->getVertexAttribArray(QUANT_TANGENT_UNIT));
+}
+
+size_t CGMVertexQuantizer::_ArrayBytes(const osg::Geometry* pGeom)
+{
+	std::set<const osg::Array*> arraySet;
+	arraySet.insert(pGeom->getVertexArray());
+	arraySet.insert(pGeom->getNormalArray());
+	arraySet.insert(pGeom->getColorArray());
+	for (auto& itr : pGeom->getTexCoordArrayList()) arraySet.insert(itr.get());
+	for (auto& itr : pGeom->getVertexAttribArrayList()) arraySet.insert(itr.get());
+
+	size_t iBytes = 0;
+	for (auto& itr : arraySet)
+	{
+		if (itr) iBytes += itr->getTotalDataSize();
+	}
+	return iBytes;
+}
@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMVertexQuantizer.h
+/// @brief		Galaxy-Music Engine - GMVertexQuantizer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <osg/Geometry>
+#include <vector>
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	*  @struct SGMQuantizeStats
+	*  @brief 顶点格式压缩前后的统计
+	*/
+	struct SGMQuantizeStats
+	{
+		size_t				iBytesBefore = 0;				//!< 压缩前逐顶点数组的字节数
+		size_t				iBytesAfter = 0;				//!< 压缩后逐顶点数组的字节数
+		int					iGeometryNum = 0;				//!< 几何体数量
+		bool				bPosition = false;				//!< 是否压缩了位置和法线
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	*  @class CGMVertexQuantizer
+	*  @brief 模型资源的紧凑顶点格式，着色器中的解码见ModelShader/GMCommon.vert
+	*  @brief 纹理坐标：相对于资源纹理坐标范围的16位整数，GM_QUANT_UV
+	*  @brief 切线：10_10_10_2有符号归一化，w是副切线的方向，副切线在着色器中由法线和切线叉乘得到，GM_QUANT_TANGENT
+	*  @brief 位置：相对于资源包围盒的16位整数，GM_QUANT_POSITION
+	*  @brief 法线：八面体编码，两个16位有符号归一化分量，GM_QUANT_NORMAL
+	*  @brief 蒙皮和变形动画每帧在CPU上按float数组改写位置和法线，所以有动画的资源只压缩纹理坐标和切线
+	*  @brief 解码参数对整个资源相同，宏定义和uniform都放在资源根节点的状态集上，所有实例共享
+	*/
+	class CGMVertexQuantizer
+	{
+		// 函数
+	public:
+		/** @brief 构造 */
+		CGMVertexQuantizer();
+		/** @brief 析构 */
+		~CGMVertexQuantizer();
+
+		/**
+		* @brief 压缩模型资源的顶点格式，要在生成切线之后调用
+		* 只要有一个几何体的数组不是导入插件生成的格式，整个资源都不压缩
+		* @param pAsset: 模型资源的根节点
+		* @return bool 成功true，不能压缩false
+		*/
+		bool Quantize(osg::Node* pAsset);
+		/** @brief 上一次压缩的统计 */
+		inline const SGMQuantizeStats& GetStats() const { return m_sStats; }
+
+	private:
+		/** @brief 检查几何体的数组格式，同时累加包围盒和纹理坐标范围 */
+		bool _Check(osg::Geometry* pGeom);
+		/** @brief 压缩纹理坐标 */
+		void _QuantizeUV(osg::Geometry* pGeom) const;
+		/** @brief 压缩切线，位置和法线没有压缩之前调用 */
+		void _QuantizeTangent(osg::Geometry* pGeom) const;
+		/** @brief 压缩位置和法线 */
+		void _QuantizePosition(osg::Geometry* pGeom) const;
+		/** @brief 蒙皮几何体的源几何体共用压缩后的纹理坐标和切线 */
+		void _ShareWithSource(osg::Geometry* pGeom) const;
+		/** @brief 几何体所有逐顶点数组的字节数 */
+		static size_t _ArrayBytes(const osg::Geometry* pGeom);
+
+		// 变量
+	private:
+		std::vector<osg::Geometry*>			m_geomVec;						//!< 资源中的几何体
+		osg::BoundingBox					m_posBox;						//!< 所有顶点位置的包围盒
+		osg::Vec2f							m_vUVMin;						//!< 纹理坐标的最小值
+		osg::Vec2f							m_vUVMax;						//!< 纹理坐标的最大值
+		SGMQuantizeStats					m_sStats;						//!< 统计
+		bool								m_bPosition = true;				//!< 是否可以压缩位置和法线
+	};
+}	// GM
@@ -16,18 +16,66 @@
 #include <QKeyEvent>
 #include <QApplication>
 #include <QGridLayout>
+#include <osg/Timer>
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define COMMAND_CAPACITY		256			// 界面线程 -> 渲染线程的命令队列容量
+#define FRAME_SPIN_TIME			0.002		// 帧间隔最后这段时间不睡眠，只让出时间片，单位：秒
+#define FRAME_IDLE_MAX			0.1			// 空闲时最长的睡眠时间，界面线程转交的命令最多等这么久，单位：秒
+
+/*************************************************************************
+CGMRenderThread Methods
+*************************************************************************/
+
+CGMRenderThread::CGMRenderThread(CGMViewWidget* pWidget, std::function<double()> fFrame, const double fFrameTime)
+	: m_pWidget(pWidget), m_fFrame(fFrame), m_fFrameTime(fFrameTime), m_pGUIThread(QThread::currentThread())
+{
+}
+
+void CGMRenderThread::run()
+{
+	osg::Timer* pTimer = osg::Timer::instance();
+	while (!m_bStop.load())
+	{
+		const osg::Timer_t tStart = pTimer->tick();
+		m_pWidget->_ExecuteCommands();
+		double fIdle = m_fFrame();
+		// 不渲染时睡到下一个定时任务，不再按帧间隔空转
+		if (fIdle > FRAME_IDLE_MAX) fIdle = FRAME_IDLE_MAX;
+		const double fWait = (fIdle > m_fFrameTime) ? fIdle : m_fFrameTime;
+
+		// 睡眠的精度不够，最后一小段时间让出时间片等待
+		double fRest = fWait - pTimer->delta_s(tStart, pTimer->tick());
+		if (fRest > FRAME_SPIN_TIME)
+			QThread::usleep((unsigned long)((fRest - FRAME_SPIN_TIME) * 1e6));
+		while (fWait - pTimer->delta_s(tStart, pTimer->tick()) > 0.0 && !m_bStop.load())
+			QThread::yieldCurrentThread();
+	}
+	// 退出前执行完剩下的命令，界面线程中的调用不会丢失
+	m_pWidget->_ExecuteCommands();
+
+	// GL上下文只能由它所在的线程移走
+	m_pWidget->m_pGraphicsWindow->releaseContext();
+	m_pWidget->m_pGraphicsWindow->getGLWidget()->context()->moveToThread(m_pGUIThread);
+}
+
+/*************************************************************************
+CGMViewWidget Methods
+*************************************************************************/
 
 CGMViewWidget::CGMViewWidget(osgViewer::View* pView,QWidget* parent, Qt::WindowFlags f,
 	osgViewer::CompositeViewer::ThreadingModel threadingModel)
-	: QWidget(parent, f)
+	: QWidget(parent, f), m_commandRing(COMMAND_CAPACITY)
 {
 	setThreadingModel(threadingModel);
 	setKeyEventSetsDone(0);
 	setQuitEventSetsDone(false);
 	addView(pView);
 
-	osgQt::GraphicsWindowQt* gw = createGraphicsWindow(0, 0, 100, 100);
-	osgQt::GLWidget* pGLWidget = gw->getGLWidget();
+	m_pGraphicsWindow = createGraphicsWindow(0, 0, 100, 100);
+	osgQt::GLWidget* pGLWidget = m_pGraphicsWindow->getGLWidget();
 
 	QGridLayout* grid = new QGridLayout;
 	setLayout(grid);
@@ -37,14 +85,76 @@ CGMViewWidget::CGMViewWidget(osgViewer::View* pView,QWidget* parent, Qt::WindowF
 	grid->setSpacing(0);
 
 	osg::Camera* camera = pView->getCamera();
-	camera->setGraphicsContext(gw);
+	camera->setGraphicsContext(m_pGraphicsWindow.get());
 }
 
 CGMViewWidget::~CGMViewWidget()
 {
+	StopRenderThread();
 	stopThreading();
 }
 
+bool CGMViewWidget::StartRenderThread(std::function<double()> fFrame, const double fFrameTime)
+{
+	if (m_pRenderThread || !fFrame || !m_pGraphicsWindow.valid()) return false;
+	osgQt::GLWidget* pGLWidget = m_pGraphicsWindow->getGLWidget();
+	if (!pGLWidget) return false;
+
+	// 在界面线程中创建好GL上下文，之后界面线程不再使用它
+	if (!isRealized()) realize();
+	if (!m_pGraphicsWindow->valid()) return false;
+	m_pGraphicsWindow->releaseContext();
+	pGLWidget->doneCurrent();
+	// 修改尺寸会改动相机的视口，交给渲染线程在下一帧之前执行
+	pGLWidget->setDeferResize(true);
+
+	m_pRenderThread = new CGMRenderThread(this, fFrame, fFrameTime);
+	pGLWidget->context()->moveToThread(m_pRenderThread);
+	m_pRenderThread->start();
+	return true;
+}
+
+void CGMViewWidget::StopRenderThread()
+{
+	if (!m_pRenderThread) return;
+
+	m_pRenderThread->RequestStop();
+	m_pRenderThread->wait();
+	delete m_pRenderThread;
+	m_pRenderThread = nullptr;
+
+	if (m_pGraphicsWindow.valid() && m_pGraphicsWindow->getGLWidget())
+		m_pGraphicsWindow->getGLWidget()->setDeferResize(false);
+}
+
+bool CGMViewWidget::PostCommand(std::function<void()> fCommand)
+{
+	if (!m_pRenderThread || IsRenderThread()) return false;
+
+	// 队列满时等渲染线程取走，它每帧都会清空队列
+	std::function<void()>* pSlot = m_commandRing.BeginPush();
+	while (!pSlot)
+	{
+		QThread::yieldCurrentThread();
+		pSlot = m_commandRing.BeginPush();
+	}
+	*pSlot = std::move(fCommand);
+	m_commandRing.EndPush();
+	return true;
+}
+
+void CGMViewWidget::_ExecuteCommands()
+{
+	while (std::function<void()>* pCommand = m_commandRing.Front())
+	{
+		// 先移出再Pop，执行命令时界面线程可以继续写入这个位置
+		std::function<void()> fCommand = std::move(*pCommand);
+		*pCommand = nullptr;
+		m_commandRing.Pop();
+		fCommand();
+	}
+}
+
 osgQt::GraphicsWindowQt* CGMViewWidget::createGraphicsWindow(
 	int x, int y, int w, int h,
 	const std::string & name,
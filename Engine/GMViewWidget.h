@@ -12,8 +12,50 @@
 #pragma once
 
 #include "osgQt/GraphicsWindowQt.h"
+#include "GMRingBuffer.h"
 #include <osgViewer/CompositeViewer>
+#include <QThread>
+#include <functional>
+#include <atomic>
 
+class CGMViewWidget;
+
+/*!
+*  @class CGMRenderThread
+*  @brief CGMViewWidget的渲染线程，GL上下文在这个线程中，按固定的帧间隔循环执行命令和一帧
+*/
+class CGMRenderThread : public QThread
+{
+public:
+	/**
+	* @brief 构造
+	* @param pWidget: 所属的视口
+	* @param fFrame: 每帧执行的函数，包括事件、更新和渲染遍历，返回下一帧之前可以睡眠的时间，单位：秒
+	* @param fFrameTime: 帧间隔，单位：秒，0表示不等待，由垂直同步控制帧率
+	*/
+	CGMRenderThread(CGMViewWidget* pWidget, std::function<double()> fFrame, const double fFrameTime);
+
+	/** @brief 请求退出，当前帧结束后退出循环 */
+	inline void RequestStop() { m_bStop.store(true); }
+
+protected:
+	/** @brief 帧循环 */
+	void run() override;
+
+private:
+	CGMViewWidget*					m_pWidget;						//!< 所属的视口
+	std::function<double()>			m_fFrame;						//!< 每帧执行的函数，返回可以睡眠的时间
+	double							m_fFrameTime;					//!< 帧间隔，单位：秒
+	QThread*						m_pGUIThread;					//!< 界面线程，退出时把GL上下文还给它
+	std::atomic<bool>				m_bStop{ false };				//!< 退出标志
+};
+
+/*!
+*  @class CGMViewWidget
+*  @brief 三维视口，默认在界面线程中由定时器驱动渲染
+*  @brief 渲染线程模式下GL上下文移到CGMRenderThread中，帧循环与Qt事件循环互不阻塞，
+*  @brief 鼠标键盘输入仍然写入osg的事件队列，引擎接口的调用通过无锁队列转交给渲染线程
+*/
 class CGMViewWidget : public QWidget, public osgViewer::CompositeViewer
 {
 public:
@@ -22,6 +64,26 @@ public:
 		osgViewer::CompositeViewer::ThreadingModel threadingModel = osgViewer::CompositeViewer::SingleThreaded);
 	~CGMViewWidget();
 
+	/**
+	* @brief 开启渲染线程，只能在界面线程中调用
+	* @param fFrame: 每帧执行的函数，返回下一帧之前可以睡眠的时间，单位：秒，超过帧间隔时按它睡眠
+	* @param fFrameTime: 帧间隔，单位：秒，0表示由垂直同步控制帧率
+	* @return bool 成功true，已经开启或者GL上下文无效返回false
+	*/
+	bool StartRenderThread(std::function<double()> fFrame, const double fFrameTime);
+	/** @brief 关闭渲染线程，等待当前帧结束，GL上下文回到界面线程 */
+	void StopRenderThread();
+	/** @brief 渲染线程是否开启 */
+	inline bool IsRenderThreadRunning() const { return nullptr != m_pRenderThread; }
+	/** @brief 当前线程是否是渲染线程 */
+	inline bool IsRenderThread() const { return m_pRenderThread && QThread::currentThread() == m_pRenderThread; }
+	/**
+	* @brief 把命令转交给渲染线程，在下一帧开始前执行，只能在界面线程中调用
+	* @param fCommand: 命令
+	* @return bool 已经转交true，渲染线程没有开启或者当前就是渲染线程时返回false，由调用者直接执行
+	*/
+	bool PostCommand(std::function<void()> fCommand);
+
 protected:
 	osgQt::GraphicsWindowQt* createGraphicsWindow(
 		int x, int y, int w, int h,
@@ -30,4 +92,15 @@ protected:
 	/** @brief 界面上的键盘事件 */
 	void keyPressEvent(QKeyEvent* event);
 	void keyReleaseEvent(QKeyEvent* event);
+
+private:
+	/** @brief 渲染线程：执行队列中所有的命令 */
+	void _ExecuteCommands();
+
+	friend class CGMRenderThread;
+
+private:
+	osg::ref_ptr<osgQt::GraphicsWindowQt>			m_pGraphicsWindow;				//!< Qt的GL窗口
+	CGMRenderThread*								m_pRenderThread = nullptr;		//!< 渲染线程
+	GM::CGMRingBuffer<std::function<void()>>		m_commandRing;					//!< 界面线程 -> 渲染线程的命令
 };
\ No newline at end of file
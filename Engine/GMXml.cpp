@@ -12,9 +12,99 @@
 #include "GMXml.h"
 #include <Windows.h>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
 
 using namespace GM;
 
+/*************************************************************************
+ Macro Defines
+*************************************************************************/
+
+#define XML_ARENA_BLOCK				4096		// 宽字符串内存池每块的字符数
+#define XML_NUMBER_BUFFER			128			// 格式化数字和向量的缓冲区大小
+
+/*************************************************************************
+ Global Functions
+*************************************************************************/
+
+/** @brief 在原字符串上解析一个数字，成功后移动到数字之后，不分配内存 */
+static bool ParseNumber(const char*& sz, int& iValue)
+{
+	char* pEnd = nullptr;
+	const long iResult = strtol(sz, &pEnd, 10);
+	if (pEnd == sz) return false;
+	iValue = int(iResult);
+	sz = pEnd;
+	return true;
+}
+static bool ParseNumber(const char*& sz, unsigned int& iValue)
+{
+	int iResult = 0;
+	if (!ParseNumber(sz, iResult) || iResult < 0) return false;
+	iValue = static_cast<unsigned int>(iResult);
+	return true;
+}
+static bool ParseNumber(const char*& sz, float& fValue)
+{
+	char* pEnd = nullptr;
+	const float fResult = strtof(sz, &pEnd);
+	if (pEnd == sz) return false;
+	fValue = fResult;
+	sz = pEnd;
+	return true;
+}
+static bool ParseNumber(const char*& sz, double& fValue)
+{
+	char* pEnd = nullptr;
+	const double fResult = strtod(sz, &pEnd);
+	if (pEnd == sz) return false;
+	fValue = fResult;
+	sz = pEnd;
+	return true;
+}
+
+/**
+* @brief 解析以空格分隔的多个数字，只遍历一遍，任何一个失败都不修改输出
+* @param sz: 属性值，可以是nullptr
+* @param pValue: 输出
+* @param iNum: 数字个数
+*/
+template<typename T>
+static bool ParseNumbers(const char* sz, T* pValue, const int iNum)
+{
+	if (!sz) return false;
+	T tmp[4];
+	for (int i = 0; i < iNum; i++)
+	{
+		if (!ParseNumber(sz, tmp[i])) return false;
+	}
+	for (int i = 0; i < iNum; i++)
+	{
+		pValue[i] = tmp[i];
+	}
+	return true;
+}
+
+/** @brief 把多个数字格式化成以空格分隔的字符串，写入栈上的缓冲区 */
+static void FormatNumbers(char* szBuffer, const double* pValue, const int iNum)
+{
+	int iLen = 0;
+	for (int i = 0; i < iNum && iLen < XML_NUMBER_BUFFER; i++)
+	{
+		iLen += snprintf(szBuffer + iLen, XML_NUMBER_BUFFER - iLen, (0 == i) ? "%.9g" : " %.9g", pValue[i]);
+	}
+}
+static void FormatNumbers(char* szBuffer, const int* pValue, const int iNum)
+{
+	int iLen = 0;
+	for (int i = 0; i < iNum && iLen < XML_NUMBER_BUFFER; i++)
+	{
+		iLen += snprintf(szBuffer + iLen, XML_NUMBER_BUFFER - iLen, (0 == i) ? "%d" : " %d", pValue[i]);
+	}
+}
+
 /*************************************************************************
  SGMXmlNode Methods
 *************************************************************************/
@@ -28,593 +118,504 @@ bool CGMXmlNode::GetName(std::string & nodeName)
 }
 
 /** @brief 添加子节点 */
-CGMXmlNode CGMXmlNode::AddChild(const std::string& strChildName)
+CGMXmlNode CGMXmlNode::AddChild(const char* szChildName)
 {
 	if (m_pNode == nullptr)
 		return CGMXmlNode();
 
-	TiXmlNode* pEle = new TiXmlElement(strChildName.c_str());
-	//m_pNode->InsertEndChild(*pEle);
-	//return CGMXmlNode(m_pXml, pEle->ToElement());
-	return CGMXmlNode(m_pXml, (m_pNode->InsertEndChild(*pEle))->ToElement());
+	TiXmlElement sEle(szChildName);
+	return CGMXmlNode(m_pXml, (m_pNode->InsertEndChild(sEle))->ToElement());
 }
 
 /** @brief 设置String属性 */
-void CGMXmlNode::SetPropStr(const std::string& strPropertyName, const char * strPropertyValue)
+void CGMXmlNode::SetPropStr(const char* szPropertyName, const char * strPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue);
+	m_pNode->SetAttribute(szPropertyName, strPropertyValue);
 }
 
-void CGMXmlNode::SetPropWStr(const std::string & strPropertyName, const wchar_t * strPropertyValue)
+void CGMXmlNode::SetPropWStr(const char* szPropertyName, const wchar_t * strPropertyValue)
 {
-	if (m_pNode == nullptr)
+	if (m_pNode == nullptr || strPropertyValue == nullptr)
+		return;
+	const int iLen = WideCharToMultiByte(CP_UTF8, 0, strPropertyValue, -1, NULL, 0, NULL, NULL);
+	if (iLen <= 0)
 		return;
-	m_pNode->SetAttribute(strPropertyName.c_str(), _WCharToChar(strPropertyValue));
+	// 临时缓冲区，TinyXML会复制一份
+	std::vector<char> vBuffer(iLen, 0);
+	WideCharToMultiByte(CP_UTF8, 0, strPropertyValue, -1, vBuffer.data(), iLen, NULL, NULL);
+	m_pNode->SetAttribute(szPropertyName, vBuffer.data());
 }
 
 /** @brief 设置Bool属性 */
-void CGMXmlNode::SetPropBool(const std::string& strPropertyName, bool bPropertyValue)
+void CGMXmlNode::SetPropBool(const char* szPropertyName, bool bPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetAttribute(strPropertyName.c_str(), bPropertyValue ? "true" : "false");
+	m_pNode->SetAttribute(szPropertyName, bPropertyValue ? "true" : "false");
 }
 
 /** @brief 设置Int属性 */
-void CGMXmlNode::SetPropInt(const std::string& strPropertyName, int iPropertyValue)
+void CGMXmlNode::SetPropInt(const char* szPropertyName, int iPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetAttribute(strPropertyName.c_str(), iPropertyValue);
+	m_pNode->SetAttribute(szPropertyName, iPropertyValue);
 }
 
 /** @brief 设置Unsigned Int属性 */
-void CGMXmlNode::SetPropUInt(const std::string& strPropertyName, unsigned int iPropertyValue)
+void CGMXmlNode::SetPropUInt(const char* szPropertyName, unsigned int iPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetAttribute(strPropertyName.c_str(), iPropertyValue);
+	m_pNode->SetAttribute(szPropertyName, iPropertyValue);
 }
 
 /** @brief 设置Float属性 */
-void CGMXmlNode::SetPropFloat(const std::string& strPropertyName, float fPropertyValue)
+void CGMXmlNode::SetPropFloat(const char* szPropertyName, float fPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetDoubleAttribute(strPropertyName.c_str(), fPropertyValue);
+	m_pNode->SetDoubleAttribute(szPropertyName, fPropertyValue);
 }
 
 /** @brief 设置Double属性 */
-void CGMXmlNode::SetPropDouble(const std::string& strPropertyName, double fPropertyValue)
+void CGMXmlNode::SetPropDouble(const char* szPropertyName, double fPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	m_pNode->SetDoubleAttribute(strPropertyName.c_str(), fPropertyValue);
+	m_pNode->SetDoubleAttribute(szPropertyName, fPropertyValue);
 }
 
 /** @brief 设置Vector2属性 */
-void CGMXmlNode::SetPropVector2(const std::string& strPropertyName, const SGMVector2& vPropertyValue)
+void CGMXmlNode::SetPropVector2(const char* szPropertyName, const SGMVector2& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue = std::to_string(vPropertyValue.x) + " " + std::to_string(vPropertyValue.y);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[2] = { vPropertyValue.x, vPropertyValue.y };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 2);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector2i属性 */
-void CGMXmlNode::SetPropVector2(const std::string& strPropertyName, const SGMVector2i& vPropertyValue)
+void CGMXmlNode::SetPropVector2(const char* szPropertyName, const SGMVector2i& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue = std::to_string(vPropertyValue.x) + " " + std::to_string(vPropertyValue.y);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const int iValue[2] = { vPropertyValue.x, vPropertyValue.y };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, iValue, 2);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector2f属性 */
-void CGMXmlNode::SetPropVector2(const std::string& strPropertyName, const SGMVector2f& vPropertyValue)
+void CGMXmlNode::SetPropVector2(const char* szPropertyName, const SGMVector2f& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue = std::to_string(vPropertyValue.x) + " " + std::to_string(vPropertyValue.y);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[2] = { vPropertyValue.x, vPropertyValue.y };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 2);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 
 /** @brief 设置Vector3属性 */
-void CGMXmlNode::SetPropVector3(const std::string& strPropertyName, const SGMVector3& vPropertyValue)
+void CGMXmlNode::SetPropVector3(const char* szPropertyName, const SGMVector3& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[3] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 3);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector3i属性 */
-void CGMXmlNode::SetPropVector3(const std::string& strPropertyName, const SGMVector3i& vPropertyValue)
+void CGMXmlNode::SetPropVector3(const char* szPropertyName, const SGMVector3i& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const int iValue[3] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, iValue, 3);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector3f属性 */
-void CGMXmlNode::SetPropVector3(const std::string& strPropertyName, const SGMVector3f& vPropertyValue)
+void CGMXmlNode::SetPropVector3(const char* szPropertyName, const SGMVector3f& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[3] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 3);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 
 /** @brief 设置Vector4属性 */
-void CGMXmlNode::SetPropVector4(const std::string& strPropertyName, const SGMVector4& vPropertyValue)
+void CGMXmlNode::SetPropVector4(const char* szPropertyName, const SGMVector4& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z) + " " +
-		std::to_string(vPropertyValue.w);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[4] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z, vPropertyValue.w };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 4);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector4i属性 */
-void CGMXmlNode::SetPropVector4(const std::string& strPropertyName, const SGMVector4i& vPropertyValue)
+void CGMXmlNode::SetPropVector4(const char* szPropertyName, const SGMVector4i& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z) + " " +
-		std::to_string(vPropertyValue.w);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const int iValue[4] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z, vPropertyValue.w };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, iValue, 4);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 /** @brief 设置Vector4f属性 */
-void CGMXmlNode::SetPropVector4(const std::string& strPropertyName, const SGMVector4f& vPropertyValue)
+void CGMXmlNode::SetPropVector4(const char* szPropertyName, const SGMVector4f& vPropertyValue)
 {
 	if (m_pNode == nullptr)
 		return;
-	std::string strPropertyValue =
-		std::to_string(vPropertyValue.x) + " " +
-		std::to_string(vPropertyValue.y) + " " +
-		std::to_string(vPropertyValue.z) + " " +
-		std::to_string(vPropertyValue.w);
-	m_pNode->SetAttribute(strPropertyName.c_str(), strPropertyValue.c_str());
+	const double fValue[4] = { vPropertyValue.x, vPropertyValue.y, vPropertyValue.z, vPropertyValue.w };
+	char szValue[XML_NUMBER_BUFFER] = { 0 };
+	FormatNumbers(szValue, fValue, 4);
+	m_pNode->SetAttribute(szPropertyName, szValue);
 }
 
 /** @brief 获取子节点 */
-CGMXmlNode CGMXmlNode::GetChild(const std::string& strChildName) const
+CGMXmlNode CGMXmlNode::GetChild(const char* szChildName) const
 {
 	if (m_pNode == nullptr)
 		return CGMXmlNode();
 
-	TiXmlNode* pEle = 0;
-	while ((pEle = m_pNode->IterateChildren(pEle)) != 0)
-	{
-		const std::string strValue = pEle->Value();
-		if (strChildName == strValue)
-		{
-			break;
-		}
-	}
-	return CGMXmlNode(m_pXml, pEle->ToElement());
+	TiXmlElement* pEle = m_pNode->FirstChildElement(szChildName);
+	return CGMXmlNode(m_pXml, pEle);
 }
 
 /** @brief 获取子节点组 */
-VGMXmlNodeVec CGMXmlNode::GetChildren(const std::string& strChildName) const
+VGMXmlNodeVec CGMXmlNode::GetChildren(const char* szChildName) const
 {
 	VGMXmlNodeVec sList;
 	if (m_pNode)
 	{
-		TiXmlNode* pEle = 0;
-		while ((pEle = m_pNode->IterateChildren(pEle)) != 0)
+		for (TiXmlElement* pEle = m_pNode->FirstChildElement(szChildName); pEle; pEle = pEle->NextSiblingElement(szChildName))
 		{
-			const std::string strValue = pEle->Value();
-			if (strChildName == strValue)
-			{
-				sList.push_back(CGMXmlNode(m_pXml, pEle->ToElement()));
-			}
+			sList.push_back(CGMXmlNode(m_pXml, pEle));
 		}
 	}
 	return sList;
 }
 
-bool CGMXmlNode::HasProperty(const std::string & propertyName) const
+bool CGMXmlNode::HasProperty(const char* szPropertyName) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(propertyName.c_str());
-		if (value)
-			return true;
-	}
-	return false;
+	return m_pNode && m_pNode->Attribute(szPropertyName);
 }
 
 /** @brief 获取String属性 */
-const char* CGMXmlNode::GetPropStr(const std::string& strPropertyName, const char* strDefault) const
+const char* CGMXmlNode::GetPropStr(const char* szPropertyName, const char* strDefault) const
 {
 	if (m_pNode)
 	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
+		const char* value = m_pNode->Attribute(szPropertyName);
 		if (value)
 			return value;
 	}
 	return strDefault;
 }
 
-const wchar_t* CGMXmlNode::GetPropWStr(const std::string & strPropertyName, const wchar_t* strDefault) const
+const wchar_t* CGMXmlNode::GetPropWStr(const char* szPropertyName, const wchar_t* strDefault) const
 {
-	if (m_pNode)
+	if (m_pNode && m_pXml)
 	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
+		const char* value = m_pNode->Attribute(szPropertyName);
 		if (value)
-			return _CharToWChar(value);
+			return m_pXml->_ToWString(value);
 	}
 	return strDefault;
 }
 
 /** @brief 获取Bool属性 */
-bool CGMXmlNode::GetPropBool(const std::string& strPropertyName, bool bDefault) const
+bool CGMXmlNode::GetPropBool(const char* szPropertyName, bool bDefault) const
 {
 	if (m_pNode)
 	{
-		bool bValue;
-		m_pNode->QueryBoolAttribute(strPropertyName.c_str(), &bValue);
-		return bValue;
+		bool bValue = bDefault;
+		if (TIXML_SUCCESS == m_pNode->QueryBoolAttribute(szPropertyName, &bValue))
+			return bValue;
 	}
 	return bDefault;
 }
 
 /** @brief 获取Int属性 */
-int CGMXmlNode::GetPropInt(const std::string& strPropertyName, int iDefault) const
+int CGMXmlNode::GetPropInt(const char* szPropertyName, int iDefault) const
 {
-	if (m_pNode)
-	{
-		int iValue;
-		if (m_pNode->Attribute(strPropertyName.c_str(), &iValue))
-			return iValue;
-	}
-	return iDefault;
+	int iValue = iDefault;
+	if (m_pNode) ParseNumbers(m_pNode->Attribute(szPropertyName), &iValue, 1);
+	return iValue;
 }
 
 /** @brief 获取Unsigned Int属性 */
-unsigned int CGMXmlNode::GetPropUInt(const std::string& strPropertyName, unsigned int iDefault) const
+unsigned int CGMXmlNode::GetPropUInt(const char* szPropertyName, unsigned int iDefault) const
 {
-	if (m_pNode)
-	{
-		int iValue = -1;
-		if (m_pNode->Attribute(strPropertyName.c_str(), &iValue))
-		{
-			if (iValue >= 0)
-				return iValue;
-			else
-				return iDefault;
-		}
-	}
-	return iDefault;
+	unsigned int iValue = iDefault;
+	if (m_pNode) ParseNumbers(m_pNode->Attribute(szPropertyName), &iValue, 1);
+	return iValue;
 }
 
 /** @brief 获取Float属性 */
-float CGMXmlNode::GetPropFloat(const std::string& strPropertyName, float fDefault) const
+float CGMXmlNode::GetPropFloat(const char* szPropertyName, float fDefault) const
 {
-	if (m_pNode)
-	{
-		double fValue;
-		if (m_pNode->Attribute(strPropertyName.c_str(), &fValue))
-			return fValue;
-	}
-	return fDefault;
+	float fValue = fDefault;
+	if (m_pNode) ParseNumbers(m_pNode->Attribute(szPropertyName), &fValue, 1);
+	return fValue;
 }
 
 /** @brief 获取Double属性 */
-double CGMXmlNode::GetPropDouble(const std::string& strPropertyName, double fDefault) const
+double CGMXmlNode::GetPropDouble(const char* szPropertyName, double fDefault) const
 {
-	if (m_pNode)
-	{
-		double fValue;
-		if (m_pNode->Attribute(strPropertyName.c_str(), &fValue))
-			return fValue;
-	}
-	return fDefault;
+	double fValue = fDefault;
+	if (m_pNode) ParseNumbers(m_pNode->Attribute(szPropertyName), &fValue, 1);
+	return fValue;
 }
 
 /** @brief 获取Vector2属性 */
-SGMVector2 CGMXmlNode::GetPropVector2(const std::string& strPropertyName, const SGMVector2& vDefault) const
+SGMVector2 CGMXmlNode::GetPropVector2(const char* szPropertyName, const SGMVector2& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-
-			SGMVector2 vValue;
-			vValue.x = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-			vValue.y = std::stod(str);
-			return vValue;
-		}
-	}
+	double fValue[2] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 2))
+		return SGMVector2(fValue[0], fValue[1]);
 	return vDefault;
 }
 /** @brief 获取Vector2i属性 */
-SGMVector2i CGMXmlNode::GetPropVector2i(const std::string& strPropertyName, const SGMVector2i& vDefault) const
+SGMVector2i CGMXmlNode::GetPropVector2i(const char* szPropertyName, const SGMVector2i& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-
-			SGMVector2i vValue;
-			vValue.x = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-			vValue.y = std::stoi(str);
-			return vValue;
-		}
-	}
+	int iValue[2] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), iValue, 2))
+		return SGMVector2i(iValue[0], iValue[1]);
 	return vDefault;
 }
 /** @brief 获取Vector2f属性 */
-SGMVector2f CGMXmlNode::GetPropVector2f(const std::string& strPropertyName, const SGMVector2f& vDefault) const
+SGMVector2f CGMXmlNode::GetPropVector2f(const char* szPropertyName, const SGMVector2f& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-
-			SGMVector2f vValue;
-			vValue.x = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-			vValue.y = std::stof(str);
-			return vValue;
-		}
-	}
+	float fValue[2] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 2))
+		return SGMVector2f(fValue[0], fValue[1]);
 	return vDefault;
 }
 
 /** @brief 获取Vector3属性 */
-SGMVector3 CGMXmlNode::GetPropVector3(const std::string& strPropertyName, const SGMVector3& vDefault) const
+SGMVector3 CGMXmlNode::GetPropVector3(const char* szPropertyName, const SGMVector3& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector3 vValue;
-			vValue.x = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.z = std::stod(str);
-			return vValue;
-		}
-	}
+	double fValue[3] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 3))
+		return SGMVector3(fValue[0], fValue[1], fValue[2]);
 	return vDefault;
 }
 /** @brief 获取Vector3i属性 */
-SGMVector3i CGMXmlNode::GetPropVector3i(const std::string& strPropertyName, const SGMVector3i& vDefault) const
+SGMVector3i CGMXmlNode::GetPropVector3i(const char* szPropertyName, const SGMVector3i& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector3i vValue;
-			vValue.x = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.z = std::stoi(str);
-			return vValue;
-		}
-	}
+	int iValue[3] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), iValue, 3))
+		return SGMVector3i(iValue[0], iValue[1], iValue[2]);
 	return vDefault;
 }
 /** @brief 获取Vector3f属性 */
-SGMVector3f CGMXmlNode::GetPropVector3f(const std::string& strPropertyName, const SGMVector3f& vDefault) const
+SGMVector3f CGMXmlNode::GetPropVector3f(const char* szPropertyName, const SGMVector3f& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector3f vValue;
-			vValue.x = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.z = std::stof(str);
-			return vValue;
-		}
-	}
+	float fValue[3] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 3))
+		return SGMVector3f(fValue[0], fValue[1], fValue[2]);
 	return vDefault;
 }
 
 /** @brief 获取Vector4属性 */
-SGMVector4 CGMXmlNode::GetPropVector4(const std::string& strPropertyName, const SGMVector4& vDefault) const
+SGMVector4 CGMXmlNode::GetPropVector4(const char* szPropertyName, const SGMVector4& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector4 vValue;
-			vValue.x = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.z = std::stod(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.w = std::stod(str);
-			return vValue;
-		}
-	}
+	double fValue[4] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 4))
+		return SGMVector4(fValue[0], fValue[1], fValue[2], fValue[3]);
 	return vDefault;
 }
-
 /** @brief 获取Vector4i属性 */
-SGMVector4i CGMXmlNode::GetPropVector4i(const std::string& strPropertyName, const SGMVector4i& vDefault) const
+SGMVector4i CGMXmlNode::GetPropVector4i(const char* szPropertyName, const SGMVector4i& vDefault) const
 {
-	if (m_pNode)
-	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
-		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector4i vValue;
-			vValue.x = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.z = std::stoi(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.w = std::stoi(str);
-			return vValue;
-		}
-	}
+	int iValue[4] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), iValue, 4))
+		return SGMVector4i(iValue[0], iValue[1], iValue[2], iValue[3]);
 	return vDefault;
 }
 /** @brief 获取Vector4f属性 */
-SGMVector4f CGMXmlNode::GetPropVector4f(const std::string& strPropertyName, const SGMVector4f& vDefault) const
+SGMVector4f CGMXmlNode::GetPropVector4f(const char* szPropertyName, const SGMVector4f& vDefault) const
 {
-	if (m_pNode)
+	float fValue[4] = { 0 };
+	if (m_pNode && ParseNumbers(m_pNode->Attribute(szPropertyName), fValue, 4))
+		return SGMVector4f(fValue[0], fValue[1], fValue[2], fValue[3]);
+	return vDefault;
+}
+
+int CGMXmlNode::GetProps(std::initializer_list<SGMXmlField> fields) const
+{
+	if (m_pNode == nullptr)
+		return 0;
+
+	int iNum = 0;
+	// 属性列表只遍历一遍，每个属性和绑定的名称比较
+	for (const TiXmlAttribute* pAttr = m_pNode->FirstAttribute(); pAttr; pAttr = pAttr->Next())
 	{
-		const char* value = m_pNode->Attribute(strPropertyName.c_str());
-		if (value)
+		for (const SGMXmlField& sField : fields)
 		{
-			std::string str = value;
-
-			size_t nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			SGMVector4f vValue;
-			vValue.x = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.y = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			nPos = str.find(" ", 0);
-			if (nPos == std::string::npos)
-				return vDefault;
-			vValue.z = std::stof(str.substr(0, nPos));
-			str = str.substr(nPos + 1);
-
-			vValue.w = std::stof(str);
-			return vValue;
+			if (0 != strcmp(sField.szName, pAttr->Name())) continue;
+			if (_GetField(sField, pAttr->Value())) iNum++;
+			break;
 		}
 	}
-	return vDefault;
+	return iNum;
 }
 
-const wchar_t* CGMXmlNode::_CharToWChar(const char * cstr) const
+void CGMXmlNode::SetProps(std::initializer_list<SGMXmlField> fields)
 {
-	if (!cstr) return L"";
-	int length = int(strlen(cstr)) + 1;
-	wchar_t *t = (wchar_t*)malloc(sizeof(wchar_t) * length);
-	if (!t) return L"";
-	memset(t, 0, length * sizeof(wchar_t));
-	MultiByteToWideChar(CP_UTF8, 0, cstr, int(strlen(cstr)), t, length);
-	return t;
+	if (m_pNode == nullptr)
+		return;
+
+	for (const SGMXmlField& sField : fields)
+	{
+		_SetField(sField);
+	}
 }
 
-const char* CGMXmlNode::_WCharToChar(const wchar_t * wstr) const
+bool CGMXmlNode::_GetField(const SGMXmlField& sField, const char* szValue) const
 {
-	int destLen = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, NULL, 0, NULL, NULL);
-	if (destLen <= 0)
+	switch (sField.eType)
+	{
+	case EGMXML_FIELD_STR:
+		*static_cast<std::string*>(sField.pValue) = szValue;
+		return true;
+	case EGMXML_FIELD_WSTR:
 	{
-		return "";
+		const int iLen = MultiByteToWideChar(CP_UTF8, 0, szValue, -1, NULL, 0);
+		if (iLen <= 0) return false;
+		std::wstring& wstr = *static_cast<std::wstring*>(sField.pValue);
+		wstr.resize(iLen - 1);
+		if (iLen > 1) MultiByteToWideChar(CP_UTF8, 0, szValue, -1, &wstr[0], iLen);
+		return true;
 	}
-	char* sDest = (char*)malloc(sizeof(char) * destLen);
-	if (!sDest) return "";
-	memset(sDest, 0, destLen * sizeof(char));
-	destLen = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, sDest, destLen, NULL, NULL);
-	if (destLen <= 0)
+	case EGMXML_FIELD_BOOL:
 	{
-		return "";
+		bool& bValue = *static_cast<bool*>(sField.pValue);
+		if (0 == _stricmp(szValue, "true") || 0 == _stricmp(szValue, "yes") || 0 == strcmp(szValue, "1"))
+			bValue = true;
+		else if (0 == _stricmp(szValue, "false") || 0 == _stricmp(szValue, "no") || 0 == strcmp(szValue, "0"))
+			bValue = false;
+		else
+			return false;
+		return true;
+	}
+	case EGMXML_FIELD_INT:
+		return ParseNumbers(szValue, static_cast<int*>(sField.pValue), 1);
+	case EGMXML_FIELD_UINT:
+		return ParseNumbers(szValue, static_cast<unsigned int*>(sField.pValue), 1);
+	case EGMXML_FIELD_FLOAT:
+		return ParseNumbers(szValue, static_cast<float*>(sField.pValue), 1);
+	case EGMXML_FIELD_DOUBLE:
+		return ParseNumbers(szValue, static_cast<double*>(sField.pValue), 1);
+	case EGMXML_FIELD_VEC2:
+	{
+		SGMVector2& v = *static_cast<SGMVector2*>(sField.pValue);
+		double f[2];
+		if (!ParseNumbers(szValue, f, 2)) return false;
+		v = SGMVector2(f[0], f[1]);
+		return true;
+	}
+	case EGMXML_FIELD_VEC2F:
+	{
+		SGMVector2f& v = *static_cast<SGMVector2f*>(sField.pValue);
+		float f[2];
+		if (!ParseNumbers(szValue, f, 2)) return false;
+		v = SGMVector2f(f[0], f[1]);
+		return true;
+	}
+	case EGMXML_FIELD_VEC3:
+	{
+		SGMVector3& v = *static_cast<SGMVector3*>(sField.pValue);
+		double f[3];
+		if (!ParseNumbers(szValue, f, 3)) return false;
+		v = SGMVector3(f[0], f[1], f[2]);
+		return true;
+	}
+	case EGMXML_FIELD_VEC3F:
+	{
+		SGMVector3f& v = *static_cast<SGMVector3f*>(sField.pValue);
+		float f[3];
+		if (!ParseNumbers(szValue, f, 3)) return false;
+		v = SGMVector3f(f[0], f[1], f[2]);
+		return true;
+	}
+	case EGMXML_FIELD_VEC4:
+	{
+		SGMVector4& v = *static_cast<SGMVector4*>(sField.pValue);
+		double f[4];
+		if (!ParseNumbers(szValue, f, 4)) return false;
+		v = SGMVector4(f[0], f[1], f[2], f[3]);
+		return true;
+	}
+	case EGMXML_FIELD_VEC4F:
+	{
+		SGMVector4f& v = *static_cast<SGMVector4f*>(sField.pValue);
+		float f[4];
+		if (!ParseNumbers(szValue, f, 4)) return false;
+		v = SGMVector4f(f[0], f[1], f[2], f[3]);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+void CGMXmlNode::_SetField(const SGMXmlField& sField)
+{
+	switch (sField.eType)
+	{
+	case EGMXML_FIELD_STR:
+		SetPropStr(sField.szName, static_cast<const std::string*>(sField.pValue)->c_str());
+		break;
+	case EGMXML_FIELD_WSTR:
+		SetPropWStr(sField.szName, static_cast<const std::wstring*>(sField.pValue)->c_str());
+		break;
+	case EGMXML_FIELD_BOOL:
+		SetPropBool(sField.szName, *static_cast<const bool*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_INT:
+		SetPropInt(sField.szName, *static_cast<const int*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_UINT:
+		SetPropUInt(sField.szName, *static_cast<const unsigned int*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_FLOAT:
+		SetPropFloat(sField.szName, *static_cast<const float*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_DOUBLE:
+		SetPropDouble(sField.szName, *static_cast<const double*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC2:
+		SetPropVector2(sField.szName, *static_cast<const SGMVector2*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC2F:
+		SetPropVector2(sField.szName, *static_cast<const SGMVector2f*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC3:
+		SetPropVector3(sField.szName, *static_cast<const SGMVector3*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC3F:
+		SetPropVector3(sField.szName, *static_cast<const SGMVector3f*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC4:
+		SetPropVector4(sField.szName, *static_cast<const SGMVector4*>(sField.pValue));
+		break;
+	case EGMXML_FIELD_VEC4F:
+		SetPropVector4(sField.szName, *static_cast<const SGMVector4f*>(sField.pValue));
+		break;
+	default:
+		break;
 	}
-	return sDest;
 }
 
 /*************************************************************************
@@ -635,6 +636,7 @@ CGMXml::~CGMXml()
 /** @brief 创建 */
 bool CGMXml::Create(const std::string & strPathName, const std::string & strRootName)
 {
+	GM_DELETE(m_pDoc);
 	m_pDoc = new TiXmlDocument(strPathName.c_str());
 	const std::string strHead = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
 	m_pDoc->Parse(strHead.c_str());
@@ -658,6 +660,7 @@ bool CGMXml::Create(const std::string & strPathName, const std::string & strRoot
 /** @brief 加载 */
 bool CGMXml::Load(const std::string& strPathName, const std::string& strRootName)
 {
+	GM_DELETE(m_pDoc);
 	m_pDoc = new TiXmlDocument(strPathName.c_str());
 	m_pDoc->LoadFile();
 	if (m_pDoc->Error() && m_pDoc->ErrorId() == TiXmlBase::TIXML_ERROR_OPENING_FILE)
@@ -679,17 +682,35 @@ bool CGMXml::Save()
 	return m_pDoc->SaveFile();
 }
 
-CGMXmlNode CGMXml::AddChild(const std::string & strChildName)
+CGMXmlNode CGMXml::AddChild(const char* szChildName)
+{
+	return CGMXmlNode(this, m_pRoot).AddChild(szChildName);
+}
+
+CGMXmlNode CGMXml::GetChild(const char* szChildName)
 {
-	return CGMXmlNode(this, m_pRoot).AddChild(strChildName);
+	return CGMXmlNode(this, m_pRoot).GetChild(szChildName);
 }
 
-CGMXmlNode CGMXml::GetChild(const std::string& strChildName)
+VGMXmlNodeVec CGMXml::GetChildren(const char* szChildName)
 {
-	return CGMXmlNode(this, m_pRoot).GetChild(strChildName);
+	return CGMXmlNode(this, m_pRoot).GetChildren(szChildName);
 }
 
-VGMXmlNodeVec CGMXml::GetChildren(const std::string& strChildName)
+const wchar_t* CGMXml::_ToWString(const char* szValue)
 {
-	return CGMXmlNode(this, m_pRoot).GetChildren(strChildName);
+	const int iLen = MultiByteToWideChar(CP_UTF8, 0, szValue, -1, NULL, 0);
+	if (iLen <= 0) return L"";
+
+	// 从最后一块中切出一段，不够时再分配新的一块，长字符串单独占一块
+	const size_t iSize = static_cast<size_t>(iLen);
+	if (m_arenaVec.empty() || m_iArenaUsed + iSize > XML_ARENA_BLOCK)
+	{
+		m_arenaVec.emplace_back(new wchar_t[max(iSize, static_cast<size_t>(XML_ARENA_BLOCK))]);
+		m_iArenaUsed = 0;
+	}
+	wchar_t* pStr = m_arenaVec.back().get() + m_iArenaUsed;
+	MultiByteToWideChar(CP_UTF8, 0, szValue, -1, pStr, iLen);
+	m_iArenaUsed += iSize;
+	return pStr;
 }
\ No newline at end of file
@@ -13,6 +13,10 @@
 
 #include "GMStructs.h"
 #include "./Assist/tinyxml.h"
+#include <vector>
+#include <memory>
+#include <initializer_list>
+#include <type_traits>
 
 namespace GM
 {
@@ -22,6 +26,64 @@ namespace GM
 	class CGMXmlNode;
 	typedef std::vector<CGMXmlNode>			VGMXmlNodeVec;
 
+	/*************************************************************************
+	 Enums
+	*************************************************************************/
+
+	// 绑定到属性的变量类型
+	enum EGMXML_FIELD
+	{
+		EGMXML_FIELD_STR,				// std::string
+		EGMXML_FIELD_WSTR,				// std::wstring，文件中是UTF-8
+		EGMXML_FIELD_BOOL,				// bool
+		EGMXML_FIELD_INT,				// int，以及和int一样大的枚举
+		EGMXML_FIELD_UINT,				// unsigned int
+		EGMXML_FIELD_FLOAT,				// float
+		EGMXML_FIELD_DOUBLE,			// double
+		EGMXML_FIELD_VEC2,				// SGMVector2
+		EGMXML_FIELD_VEC2F,				// SGMVector2f
+		EGMXML_FIELD_VEC3,				// SGMVector3
+		EGMXML_FIELD_VEC3F,				// SGMVector3f
+		EGMXML_FIELD_VEC4,				// SGMVector4
+		EGMXML_FIELD_VEC4F				// SGMVector4f
+	};
+
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct SGMXmlField
+	 *  @brief 属性名称和变量的绑定，用于一次读写多个属性
+	 *  @brief 例如：node.GetProps({ { "fovy", &fFovy }, { "corePath", &strCorePath } });
+	 */
+	struct SGMXmlField
+	{
+		SGMXmlField(const char* _szName, std::string* p) : szName(_szName), eType(EGMXML_FIELD_STR), pValue(p) {}
+		SGMXmlField(const char* _szName, std::wstring* p) : szName(_szName), eType(EGMXML_FIELD_WSTR), pValue(p) {}
+		SGMXmlField(const char* _szName, bool* p) : szName(_szName), eType(EGMXML_FIELD_BOOL), pValue(p) {}
+		SGMXmlField(const char* _szName, int* p) : szName(_szName), eType(EGMXML_FIELD_INT), pValue(p) {}
+		SGMXmlField(const char* _szName, unsigned int* p) : szName(_szName), eType(EGMXML_FIELD_UINT), pValue(p) {}
+		SGMXmlField(const char* _szName, float* p) : szName(_szName), eType(EGMXML_FIELD_FLOAT), pValue(p) {}
+		SGMXmlField(const char* _szName, double* p) : szName(_szName), eType(EGMXML_FIELD_DOUBLE), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector2* p) : szName(_szName), eType(EGMXML_FIELD_VEC2), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector2f* p) : szName(_szName), eType(EGMXML_FIELD_VEC2F), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector3* p) : szName(_szName), eType(EGMXML_FIELD_VEC3), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector3f* p) : szName(_szName), eType(EGMXML_FIELD_VEC3F), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector4* p) : szName(_szName), eType(EGMXML_FIELD_VEC4), pValue(p) {}
+		SGMXmlField(const char* _szName, SGMVector4f* p) : szName(_szName), eType(EGMXML_FIELD_VEC4F), pValue(p) {}
+		/** @brief 枚举按int读写 */
+		template<typename T, typename = typename std::enable_if<std::is_enum<T>::value>::type>
+		SGMXmlField(const char* _szName, T* p) : szName(_szName), eType(EGMXML_FIELD_INT), pValue(p)
+		{
+			static_assert(sizeof(T) == sizeof(int), "enum must be int sized");
+		}
+
+		const char*						szName;			//!< 属性名称
+		EGMXML_FIELD					eType;			//!< 变量类型
+		void*							pValue;			//!< 变量地址
+	};
+
 	/*************************************************************************
 	 Class
 	*************************************************************************/
@@ -47,95 +109,107 @@ namespace GM
 		/** @brief 获取节点name,如果节点为空，返回false */
 		bool GetName(std::string& nodeName);
 		/** @brief 设置子节点 */
-		CGMXmlNode AddChild(const std::string& strChildName);
+		CGMXmlNode AddChild(const char* szChildName);
 
 		/** @brief 设置char *属性 */
-		void SetPropStr(const std::string& strPropertyName, const char* strPropertyValue);
+		void SetPropStr(const char* szPropertyName, const char* strPropertyValue);
 		/** @brief 设置wchar_t *属性 */
-		void SetPropWStr(const std::string& strPropertyName, const wchar_t* strPropertyValue);
+		void SetPropWStr(const char* szPropertyName, const wchar_t* strPropertyValue);
 		/** @brief 设置Bool属性 */
-		void SetPropBool(const std::string& strPropertyName, bool bPropertyValue);
+		void SetPropBool(const char* szPropertyName, bool bPropertyValue);
 		/** @brief 设置Int属性 */
-		void SetPropInt(const std::string& strPropertyName, int iPropertyValue);
+		void SetPropInt(const char* szPropertyName, int iPropertyValue);
 		/** @brief 设置Unsigned Int属性 */
-		void SetPropUInt(const std::string& strPropertyName, unsigned int iPropertyValue);
+		void SetPropUInt(const char* szPropertyName, unsigned int iPropertyValue);
 		/** @brief 设置Float属性 */
-		void SetPropFloat(const std::string& strPropertyName, float fPropertyValue);
+		void SetPropFloat(const char* szPropertyName, float fPropertyValue);
 		/** @brief 设置Double属性 */
-		void SetPropDouble(const std::string& strPropertyName, double fPropertyValue);
+		void SetPropDouble(const char* szPropertyName, double fPropertyValue);
 		/** @brief 设置Vector2属性 */
-		void SetPropVector2(const std::string& strPropertyName, const SGMVector2 & vPropertyValue);
-		void SetPropVector2(const std::string& strPropertyName, const SGMVector2i& vPropertyValue);
-		void SetPropVector2(const std::string& strPropertyName, const SGMVector2f& vPropertyValue);
+		void SetPropVector2(const char* szPropertyName, const SGMVector2 & vPropertyValue);
+		void SetPropVector2(const char* szPropertyName, const SGMVector2i& vPropertyValue);
+		void SetPropVector2(const char* szPropertyName, const SGMVector2f& vPropertyValue);
 		/** @brief 设置Vector3属性 */
-		void SetPropVector3(const std::string& strPropertyName, const SGMVector3 & vPropertyValue);
-		void SetPropVector3(const std::string& strPropertyName, const SGMVector3i& vPropertyValue);
-		void SetPropVector3(const std::string& strPropertyName, const SGMVector3f& vPropertyValue);
+		void SetPropVector3(const char* szPropertyName, const SGMVector3 & vPropertyValue);
+		void SetPropVector3(const char* szPropertyName, const SGMVector3i& vPropertyValue);
+		void SetPropVector3(const char* szPropertyName, const SGMVector3f& vPropertyValue);
 		/** @brief 设置Vector4属性 */
-		void SetPropVector4(const std::string& strPropertyName, const SGMVector4 & vPropertyValue);
-		void SetPropVector4(const std::string& strPropertyName, const SGMVector4i& vPropertyValue);
-		void SetPropVector4(const std::string& strPropertyName, const SGMVector4f& vPropertyValue);
+		void SetPropVector4(const char* szPropertyName, const SGMVector4 & vPropertyValue);
+		void SetPropVector4(const char* szPropertyName, const SGMVector4i& vPropertyValue);
+		void SetPropVector4(const char* szPropertyName, const SGMVector4f& vPropertyValue);
 
 		/** @brief 设置Enum属性 */
 		template<typename T>
-		void SetPropEnum(const std::string& strPropertyName, T ePropertyValue)
+		void SetPropEnum(const char* szPropertyName, T ePropertyValue)
 		{
-			SetPropUInt(strPropertyName, (unsigned int)ePropertyValue);
+			SetPropUInt(szPropertyName, (unsigned int)ePropertyValue);
 		}
 
 		/** @brief 获取子节点 */
-		CGMXmlNode GetChild(const std::string& strChildName) const;
+		CGMXmlNode GetChild(const char* szChildName) const;
 		/** @brief 获取子节点组 */
-		VGMXmlNodeVec GetChildren(const std::string& strChildName) const;
+		VGMXmlNodeVec GetChildren(const char* szChildName) const;
 		/** @brief 节点是否设置了某属性  */
-		bool HasProperty(const std::string& propertyName) const;
+		bool HasProperty(const char* szPropertyName) const;
 		/** @brief 获取String属性 */
-		const char* GetPropStr(const std::string& strPropertyName, const char* strDefault = "") const;
+		const char* GetPropStr(const char* szPropertyName, const char* strDefault = "") const;
 		/** @brief 获取WString属性 */
-		const wchar_t* GetPropWStr(const std::string& strPropertyName, const wchar_t* strDefault = L"") const;
+		const wchar_t* GetPropWStr(const char* szPropertyName, const wchar_t* strDefault = L"") const;
 		/** @brief 获取Bool属性 */
-		bool GetPropBool(const std::string& strPropertyName, bool bDefault = false) const;
+		bool GetPropBool(const char* szPropertyName, bool bDefault = false) const;
 		/** @brief 获取Int属性 */
-		int GetPropInt(const std::string& strPropertyName, int nDefault = 0) const;
+		int GetPropInt(const char* szPropertyName, int nDefault = 0) const;
 		/** @brief 获取Unsigned Int属性 */
-		unsigned int GetPropUInt(const std::string& strPropertyName, unsigned int nDefault = 0) const;
+		unsigned int GetPropUInt(const char* szPropertyName, unsigned int nDefault = 0) const;
 		/** @brief 获取Float属性 */
-		float GetPropFloat(const std::string& strPropertyName, float fDefault = 0) const;
+		float GetPropFloat(const char* szPropertyName, float fDefault = 0) const;
 		/** @brief 获取Double属性 */
-		double GetPropDouble(const std::string& strPropertyName, double fDefault = 0) const;
+		double GetPropDouble(const char* szPropertyName, double fDefault = 0) const;
 		/** @brief 获取Vector2属性 */
-		SGMVector2  GetPropVector2(const std::string& strPropertyName, const SGMVector2&  vDefault = SGMVector2()) const;
-		SGMVector2i GetPropVector2i(const std::string& strPropertyName, const SGMVector2i& vDefault = SGMVector2i()) const;
-		SGMVector2f GetPropVector2f(const std::string& strPropertyName, const SGMVector2f& vDefault = SGMVector2f()) const;
+		SGMVector2  GetPropVector2(const char* szPropertyName, const SGMVector2&  vDefault = SGMVector2()) const;
+		SGMVector2i GetPropVector2i(const char* szPropertyName, const SGMVector2i& vDefault = SGMVector2i()) const;
+		SGMVector2f GetPropVector2f(const char* szPropertyName, const SGMVector2f& vDefault = SGMVector2f()) const;
 		/** @brief 获取Vector3属性 */
-		SGMVector3  GetPropVector3(const std::string& strPropertyName, const SGMVector3&  vDefault = SGMVector3()) const;
-		SGMVector3i GetPropVector3i(const std::string& strPropertyName, const SGMVector3i& vDefault = SGMVector3i()) const;
-		SGMVector3f GetPropVector3f(const std::string& strPropertyName, const SGMVector3f& vDefault = SGMVector3f()) const;
+		SGMVector3  GetPropVector3(const char* szPropertyName, const SGMVector3&  vDefault = SGMVector3()) const;
+		SGMVector3i GetPropVector3i(const char* szPropertyName, const SGMVector3i& vDefault = SGMVector3i()) const;
+		SGMVector3f GetPropVector3f(const char* szPropertyName, const SGMVector3f& vDefault = SGMVector3f()) const;
 		/** @brief 获取Vector4f属性 */
-		SGMVector4  GetPropVector4(const std::string& strPropertyName, const SGMVector4&  vDefault = SGMVector4()) const;
-		SGMVector4i GetPropVector4i(const std::string& strPropertyName, const SGMVector4i& vDefault = SGMVector4i()) const;
-		SGMVector4f GetPropVector4f(const std::string& strPropertyName, const SGMVector4f& vDefault = SGMVector4f()) const;
+		SGMVector4  GetPropVector4(const char* szPropertyName, const SGMVector4&  vDefault = SGMVector4()) const;
+		SGMVector4i GetPropVector4i(const char* szPropertyName, const SGMVector4i& vDefault = SGMVector4i()) const;
+		SGMVector4f GetPropVector4f(const char* szPropertyName, const SGMVector4f& vDefault = SGMVector4f()) const;
 		/** @brief 获取Enum属性 */
 		template<typename T>
-		T GetPropEnum(const std::string& strPropertyName, T eDefault) const
+		T GetPropEnum(const char* szPropertyName, T eDefault) const
 		{
-			return (T)GetPropUInt(strPropertyName, (unsigned int)eDefault);
+			return (T)GetPropUInt(szPropertyName, (unsigned int)eDefault);
 		}
 
+		/**
+		* @brief 一次读取多个属性，只遍历一遍属性列表，不存在或者格式不对的属性保持变量原来的值
+		* @param fields: 属性名称和变量的绑定
+		* @return int 读到的属性数量
+		*/
+		int GetProps(std::initializer_list<SGMXmlField> fields) const;
+		/**
+		* @brief 一次写入多个属性
+		* @param fields: 属性名称和变量的绑定
+		*/
+		void SetProps(std::initializer_list<SGMXmlField> fields);
+
 		// 函数
 	private:
 		/**
-		* 字符串转换 char* to wchar_t*
-		* @param cstr:	多字节字符串
-		* @return wchar_t 宽字节字符串
+		* @brief 读取一个属性到绑定的变量
+		* @param sField: 绑定
+		* @param szValue: 属性值
+		* @return bool 格式正确true，否则false
 		*/
-		const wchar_t* _CharToWChar(const char* cstr) const;
+		bool _GetField(const SGMXmlField& sField, const char* szValue) const;
 		/**
-		* 字符串转换 wchar_t* to char*
-		* @param wstr:	宽字节字符串
-		* @return char 多字节字符串
+		* @brief 把绑定的变量写入属性
+		* @param sField: 绑定
 		*/
-		const char* _WCharToChar(const wchar_t* wstr) const;
+		void _SetField(const SGMXmlField& sField);
 
 		// 变量
 	private:
@@ -164,16 +238,27 @@ namespace GM
 		bool Save();
 
 		/** @brief 添加子节点 */
-		CGMXmlNode AddChild(const std::string& strChildName);
+		CGMXmlNode AddChild(const char* szChildName);
 		/** @brief 获取第一个符合条件的子节点 */
-		CGMXmlNode GetChild(const std::string& strChildName);
+		CGMXmlNode GetChild(const char* szChildName);
 		/** @brief 获取子节点组 */
-		VGMXmlNodeVec GetChildren(const std::string& strChildName);
+		VGMXmlNodeVec GetChildren(const char* szChildName);
+
+	private:
+		friend class CGMXmlNode;
+		/**
+		* @brief 把UTF-8字符串转换成宽字符串，结果存在文档的内存池中，和文档的生命周期相同
+		* @param szValue: UTF-8字符串
+		* @return const wchar_t* 宽字符串
+		*/
+		const wchar_t* _ToWString(const char* szValue);
 
 	// 变量
 	private:
 		TiXmlDocument*				m_pDoc;		//!< 文档指针
 		TiXmlElement*				m_pRoot;	//!< 根节点
+		std::vector<std::unique_ptr<wchar_t[]>>	m_arenaVec;			//!< 宽字符串内存池，按块分配
+		size_t						m_iArenaUsed = 0;	//!< 最后一块已经使用的字符数
 	};
 
 }	// GM
@@ -0,0 +1,275 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2024~2044, LiuTao
+/// All rights reserved.
+///
+/// @file		SoftBoneSolver.cpp
+/// @brief		GMEngine - Soft Bone Solver
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.02
+//////////////////////////////////////////////////////////////////////////
+
+#include "SoftBoneSolver.h"
+#include <cmath>
+#include <algorithm>
+#include <initializer_list>
+#include <osg/Math>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GM_SOFT_SSE 1
+#endif
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define SOFT_MAX_FRAME_DELTA		0.25		// 单帧最多积分的时间，防止卡顿后“爆炸”
+#define SOFT_MAX_SUBSTEPS			32			// 单帧最多的子步数
+
+/*************************************************************************
+Global Functions
+*************************************************************************/
+
+// 分配一个通道，没有空闲通道时一次扩展4个，保证数组长度总是4的倍数
+static int AllocLane(std::vector<int>& freeLanes, int& iLaneNum, std::initializer_list<std::vector<float>*> arrays)
+{
+	if (freeLanes.empty())
+	{
+		for (int i = 3; i >= 0; i--)
+		{
+			freeLanes.push_back(iLaneNum + i);
+		}
+		iLaneNum += 4;
+		for (auto pArray : arrays)
+		{
+			pArray->resize(iLaneNum, 0.0f);
+		}
+	}
+	int iLane = freeLanes.back();
+	freeLanes.pop_back();
+	return iLane;
+}
+
+/*************************************************************************
+SoftBoneSolver Methods
+*************************************************************************/
+
+SoftBoneSolver* SoftBoneSolver::instance()
+{
+	static SoftBoneSolver s_solver;
+	return &s_solver;
+}
+
+SoftBoneSolver::SoftBoneSolver()
+{
+}
+
+void SoftBoneSolver::advance(const osg::FrameStamp* pFrameStamp)
+{
+	if (!pFrameStamp) return;
+	// 同一帧里每根软骨都会调用一次，只有第一次生效
+	if (pFrameStamp->getFrameNumber() == _iLastFrame) return;
+	_iLastFrame = pFrameStamp->getFrameNumber();
+
+	const double fTime = pFrameStamp->getReferenceTime();
+	if (_fLastTime < 0.0)
+	{
+		_fLastTime = fTime;
+		_fFrameDelta = 0.0;
+		return;
+	}
+	_fFrameDelta = osg::clampBetween(fTime - _fLastTime, 0.0, SOFT_MAX_FRAME_DELTA);
+	_fLastTime = fTime;
+
+	// 冲量在本帧开始时一次性加到速度上，与子步数无关
+#ifdef GM_SOFT_SSE
+	for (int i = 0; i < _iRotLaneNum; i += 4)
+	{
+		__m128 v = _mm_loadu_ps(&_rotVelocity[i]);
+		__m128 imp = _mm_loadu_ps(&_rotImpulse[i]);
+		_mm_storeu_ps(&_rotVelocity[i], _mm_add_ps(v, imp));
+		_mm_storeu_ps(&_rotImpulse[i], _mm_setzero_ps());
+	}
+#else
+	for (int i = 0; i < _iRotLaneNum; i++)
+	{
+		_rotVelocity[i] += _rotImpulse[i];
+		_rotImpulse[i] = 0.0f;
+	}
+#endif
+
+	_fAccumTime += _fFrameDelta;
+	int iStep = 0;
+	while (_fAccumTime >= _fSubStep && iStep < SOFT_MAX_SUBSTEPS)
+	{
+		_step();
+		_fAccumTime -= _fSubStep;
+		iStep++;
+	}
+	if (iStep == SOFT_MAX_SUBSTEPS) _fAccumTime = 0.0;
+}
+
+void SoftBoneSolver::setSubStep(double fSubStep)
+{
+	_fSubStep = osg::clampBetween(fSubStep, 1e-4, 0.1);
+	for (int i = 0; i < _iTransLaneNum; i++)
+	{
+		_updateTransCoef(i);
+	}
+}
+
+int SoftBoneSolver::addRotLane(float fStiffness, float fDamping)
+{
+	int iLane = AllocLane(_rotFreeLanes, _iRotLaneNum,
+		{ &_rotValue, &_rotVelocity, &_rotStiffness, &_rotDamping, &_rotImpulse });
+	setRotLane(iLane, fStiffness, fDamping);
+	return iLane;
+}
+
+void SoftBoneSolver::removeRotLane(int iLane)
+{
+	if (iLane < 0 || iLane >= _iRotLaneNum) return;
+	// 空闲通道全为0，参与积分也不会产生任何结果
+	_rotValue[iLane] = 0.0f;
+	_rotVelocity[iLane] = 0.0f;
+	_rotStiffness[iLane] = 0.0f;
+	_rotDamping[iLane] = 0.0f;
+	_rotImpulse[iLane] = 0.0f;
+	_rotFreeLanes.push_back(iLane);
+}
+
+void SoftBoneSolver::setRotLane(int iLane, float fStiffness, float fDamping)
+{
+	_rotStiffness[iLane] = fStiffness;
+	_rotDamping[iLane] = fDamping;
+}
+
+int SoftBoneSolver::addTransLane(float fAngularFreq, float fPhase, float fDecay)
+{
+	int iLane = AllocLane(_transFreeLanes, _iTransLaneNum,
+		{ &_transValue, &_transAmp, &_transSin, &_transCos, &_transFreq,
+		&_transDecay, &_transRotSin, &_transRotCos, &_transStepDecay });
+	_transValue[iLane] = 0.0f;
+	_transAmp[iLane] = 0.0f;
+	_transSin[iLane] = std::sin(fPhase);
+	_transCos[iLane] = std::cos(fPhase);
+	_transFreq[iLane] = fAngularFreq;
+	_transDecay[iLane] = fDecay;
+	_updateTransCoef(iLane);
+	return iLane;
+}
+
+void SoftBoneSolver::removeTransLane(int iLane)
+{
+	if (iLane < 0 || iLane >= _iTransLaneNum) return;
+	_transValue[iLane] = 0.0f;
+	_transAmp[iLane] = 0.0f;
+	_transSin[iLane] = 0.0f;
+	_transCos[iLane] = 0.0f;
+	_transFreq[iLane] = 0.0f;
+	_transDecay[iLane] = 0.0f;
+	_transRotSin[iLane] = 0.0f;
+	_transRotCos[iLane] = 1.0f;
+	_transStepDecay[iLane] = 0.0f;
+	_transFreeLanes.push_back(iLane);
+}
+
+void SoftBoneSolver::setTransDecay(int iLane, float fDecay)
+{
+	_transDecay[iLane] = fDecay;
+	_updateTransCoef(iLane);
+}
+
+void SoftBoneSolver::_updateTransCoef(int iLane)
+{
+	const double fAngle = _transFreq[iLane] * _fSubStep;
+	_transRotSin[iLane] = float(std::sin(fAngle));
+	_transRotCos[iLane] = float(std::cos(fAngle));
+	_transStepDecay[iLane] = float(std::pow(double(std::max(_transDecay[iLane], 0.0f)), _fSubStep));
+}
+
+void SoftBoneSolver::_step()
+{
+	const float h = float(_fSubStep);
+	_stepRot(h);
+	_stepTrans(h);
+}
+
+void SoftBoneSolver::_stepRot(float h)
+{
+	// 半隐式欧拉：先用加速度更新速度，再用新速度更新位置
+	// v += h * (-k*x - c*v); x += h * v;
+#ifdef GM_SOFT_SSE
+	const __m128 vH = _mm_set1_ps(h);
+	for (int i = 0; i < _iRotLaneNum; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&_rotValue[i]);
+		__m128 v = _mm_loadu_ps(&_rotVelocity[i]);
+		__m128 k = _mm_loadu_ps(&_rotStiffness[i]);
+		__m128 c = _mm_loadu_ps(&_rotDamping[i]);
+
+		__m128 a = _mm_add_ps(_mm_mul_ps(k, x), _mm_mul_ps(c, v));
+		v = _mm_sub_ps(v, _mm_mul_ps(vH, a));
+		x = _mm_add_ps(x, _mm_mul_ps(vH, v));
+
+		_mm_storeu_ps(&_rotValue[i], x);
+		_mm_storeu_ps(&_rotVelocity[i], v);
+	}
+#else
+	for (int i = 0; i < _iRotLaneNum; i++)
+	{
+		float a = _rotStiffness[i] * _rotValue[i] + _rotDamping[i] * _rotVelocity[i];
+		_rotVelocity[i] -= h * a;
+		_rotValue[i] += h * _rotVelocity[i];
+	}
+#endif
+}
+
+void SoftBoneSolver::_stepTrans(float h)
+{
+	// 速度 = amp * sin(phase)，相位用复数旋转代替sin()，便于SIMD
+	// x = (x + h * amp * sin) * decay; amp *= decay;
+#ifdef GM_SOFT_SSE
+	const __m128 vH = _mm_set1_ps(h);
+	for (int i = 0; i < _iTransLaneNum; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&_transValue[i]);
+		__m128 amp = _mm_loadu_ps(&_transAmp[i]);
+		__m128 s = _mm_loadu_ps(&_transSin[i]);
+		__m128 c = _mm_loadu_ps(&_transCos[i]);
+		__m128 rs = _mm_loadu_ps(&_transRotSin[i]);
+		__m128 rc = _mm_loadu_ps(&_transRotCos[i]);
+		__m128 d = _mm_loadu_ps(&_transStepDecay[i]);
+
+		x = _mm_mul_ps(_mm_add_ps(x, _mm_mul_ps(vH, _mm_mul_ps(amp, s))), d);
+		amp = _mm_mul_ps(amp, d);
+		__m128 s1 = _mm_add_ps(_mm_mul_ps(s, rc), _mm_mul_ps(c, rs));
+		__m128 c1 = _mm_sub_ps(_mm_mul_ps(c, rc), _mm_mul_ps(s, rs));
+		// 一阶重新归一化，防止长时间运行后相位的模长漂移
+		__m128 n = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(3.0f),
+			_mm_add_ps(_mm_mul_ps(s1, s1), _mm_mul_ps(c1, c1))));
+		s1 = _mm_mul_ps(s1, n);
+		c1 = _mm_mul_ps(c1, n);
+
+		_mm_storeu_ps(&_transValue[i], x);
+		_mm_storeu_ps(&_transAmp[i], amp);
+		_mm_storeu_ps(&_transSin[i], s1);
+		_mm_storeu_ps(&_transCos[i], c1);
+	}
+#else
+	for (int i = 0; i < _iTransLaneNum; i++)
+	{
+		const float d = _transStepDecay[i];
+		_transValue[i] = (_transValue[i] + h * _transAmp[i] * _transSin[i]) * d;
+		_transAmp[i] *= d;
+		float s = _transSin[i] * _transRotCos[i] + _transCos[i] * _transRotSin[i];
+		float c = _transCos[i] * _transRotCos[i] - _transSin[i] * _transRotSin[i];
+		float n = 0.5f * (3.0f - (s * s + c * c));
+		_transSin[i] = s * n;
+		_transCos[i] = c * n;
+	}
+#endif
+}
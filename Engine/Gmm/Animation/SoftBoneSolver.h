@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2024~2044, LiuTao
+/// All rights reserved.
+///
+/// @file		SoftBoneSolver.h
+/// @brief		GMEngine - Soft Bone Solver
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.02
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <osg/FrameStamp>
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define SOFT_REFERENCE_FPS		60.0		// 软骨参数原本是按60帧调出来的，换算成秒时用到
+
+namespace GM
+{
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	 *  @class SoftBoneSolver
+	 *  @brief 软骨弹簧的集中解算器
+	 *  所有软骨元素把各自的弹簧状态登记为SoA数组中的一个“通道”，
+	 *  解算器每帧按固定的墙钟子步长统一积分（SSE一次处理4个通道），
+	 *  元素只负责写入骨骼动画带来的激励、读出积分后的偏移。
+	 *  这样无论15帧还是144帧，抖动的快慢与幅度都保持一致。
+	 */
+	class SoftBoneSolver
+	{
+	public:
+		static SoftBoneSolver* instance();
+
+		/**
+		* @brief 每帧推进一次解算，同一帧内重复调用会被忽略
+		* @param pFrameStamp: 当前帧的时间戳
+		*/
+		void advance(const osg::FrameStamp* pFrameStamp);
+		/** @brief 上一次推进所经过的墙钟时间，单位：秒 */
+		inline double getFrameDelta() const { return _fFrameDelta; }
+		/** @brief 设置固定子步长，单位：秒 */
+		void setSubStep(double fSubStep);
+		inline double getSubStep() const { return _fSubStep; }
+
+		/**
+		* @brief 添加一个旋转弹簧通道（阻尼弹簧：x'' = -k*x - c*x'）
+		* @param fStiffness: 刚度k，单位：1/s^2
+		* @param fDamping: 阻尼c，单位：1/s
+		* @return int: 通道序号
+		*/
+		int addRotLane(float fStiffness, float fDamping);
+		void removeRotLane(int iLane);
+		void setRotLane(int iLane, float fStiffness, float fDamping);
+		/** @brief 给通道施加一次速度冲量（骨骼动画本身的速度变化） */
+		inline void addRotImpulse(int iLane, float fDeltaVelocity) { _rotImpulse[iLane] += fDeltaVelocity; }
+		/** @brief 积分后的旋转偏移，单位：弧度 */
+		inline float getRotOffset(int iLane) const { return _rotValue[iLane]; }
+
+		/**
+		* @brief 添加一个平移抖动通道（衰减的正弦速度场）
+		* @param fAngularFreq: 角频率，单位：弧度/秒
+		* @param fPhase: 初始相位，单位：弧度
+		* @param fDecay: 每秒衰减到原来的比例
+		* @return int: 通道序号
+		*/
+		int addTransLane(float fAngularFreq, float fPhase, float fDecay);
+		void removeTransLane(int iLane);
+		void setTransDecay(int iLane, float fDecay);
+		/** @brief 激发通道，把抖动速度的振幅重置为fAmplitude */
+		inline void exciteTrans(int iLane, float fAmplitude) { _transAmp[iLane] = fAmplitude; }
+		/** @brief 积分后的平移偏移 */
+		inline float getTransOffset(int iLane) const { return _transValue[iLane]; }
+
+	private:
+		SoftBoneSolver();
+
+		/** @brief 以固定子步长积分一步 */
+		void _step();
+		void _stepRot(float h);
+		void _stepTrans(float h);
+		/** @brief 计算子步内的相位旋转与衰减系数 */
+		void _updateTransCoef(int iLane);
+
+	private:
+		double _fSubStep = 1.0 / 120.0;			//!< 固定子步长，单位：秒
+		double _fAccumTime = 0.0;				//!< 尚未积分的时间，单位：秒
+		double _fLastTime = -1.0;				//!< 上一帧的参考时间，单位：秒
+		double _fFrameDelta = 0.0;				//!< 上一帧到这一帧的时间，单位：秒
+		unsigned int _iLastFrame = ~0u;			//!< 上一次推进时的帧号
+
+		// 旋转弹簧通道，SoA
+		int _iRotLaneNum = 0;
+		std::vector<int> _rotFreeLanes;
+		std::vector<float> _rotValue;			//!< 偏移
+		std::vector<float> _rotVelocity;		//!< 偏移的速度
+		std::vector<float> _rotStiffness;		//!< 刚度
+		std::vector<float> _rotDamping;			//!< 阻尼
+		std::vector<float> _rotImpulse;			//!< 本帧累计的速度冲量
+
+		// 平移抖动通道，SoA
+		int _iTransLaneNum = 0;
+		std::vector<int> _transFreeLanes;
+		std::vector<float> _transValue;			//!< 偏移
+		std::vector<float> _transAmp;			//!< 速度的振幅
+		std::vector<float> _transSin;			//!< 相位的正弦
+		std::vector<float> _transCos;			//!< 相位的余弦
+		std::vector<float> _transFreq;			//!< 角频率
+		std::vector<float> _transDecay;			//!< 每秒衰减比例
+		std::vector<float> _transRotSin;		//!< 每个子步的相位旋转，正弦
+		std::vector<float> _transRotCos;		//!< 每个子步的相位旋转，余弦
+		std::vector<float> _transStepDecay;		//!< 每个子步的衰减比例
+	};
+} // namespace GM
@@ -11,6 +11,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "StackedSoftRotElement.h"
+#include "SoftBoneSolver.h"
+#include <cmath>
 
 using namespace GM;
 
@@ -21,7 +23,10 @@ Global Constants
 StackedSoftRotElement::StackedSoftRotElement(){}
 
 StackedSoftRotElement::StackedSoftRotElement(const StackedSoftRotElement& rhs, const osg::CopyOp& co)
-	: StackedRotateAxisElement(rhs, co){}
+	: StackedRotateAxisElement(rhs, co), _fElastic(rhs._fElastic), _fDamping(rhs._fDamping)
+{
+	_registerLane();
+}
 
 StackedSoftRotElement::StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle)
 	: osgAnimation::StackedRotateAxisElement(name, axis, angle){}
@@ -32,29 +37,65 @@ StackedSoftRotElement::StackedSoftRotElement(const osg::Vec3& axis, double angle
 	setName("quaternion");
 }
 
-StackedSoftRotElement::StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle, double fElastic)
+StackedSoftRotElement::StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle,
+	double fElastic, double fDamping)
 	: osgAnimation::StackedRotateAxisElement(name, axis, angle)
 {
 	_fElastic = fElastic;
+	_fDamping = fDamping;
+	_registerLane();
+}
+
+StackedSoftRotElement::~StackedSoftRotElement()
+{
+	SoftBoneSolver::instance()->removeRotLane(_iLane);
 }
 
-void StackedSoftRotElement::update(float frame)
+void StackedSoftRotElement::setElastic(double fElastic, double fDamping)
 {
-	StackedRotateAxisElement::update(frame);
-	if (0 == _fElastic) return;
+	_fElastic = fElastic;
+	_fDamping = fDamping;
+	_registerLane();
+}
 
-	_fRigAngle = _angle;
-	double _fRigAngleVelocity = _fRigAngle - _fLastRigAngle;
+void StackedSoftRotElement::_registerLane()
+{
+	SoftBoneSolver* pSolver = SoftBoneSolver::instance();
+	if (0 == _fElastic)
+	{
+		pSolver->removeRotLane(_iLane);
+		_iLane = -1;
+		return;
+	}
 
-	double fRigAngleAcce = _fLastRigAngleVelocity - _fRigAngleVelocity;
-	double fElasticAcce = -_fShakeValue / _fElastic;
+	// 原来每帧：v += -x/elastic; x += v; x *= damping;
+	// 换算成连续时间：刚度 k = fps^2/elastic，阻尼 c = -ln(damping)*fps
+	const double fStiffness = SOFT_REFERENCE_FPS * SOFT_REFERENCE_FPS / _fElastic;
+	const double fDamping = -std::log(osg::clampBetween(_fDamping, 1e-3, 1.0)) * SOFT_REFERENCE_FPS;
+	if (_iLane < 0)
+		_iLane = pSolver->addRotLane(fStiffness, fDamping);
+	else
+		pSolver->setRotLane(_iLane, fStiffness, fDamping);
+}
 
-	_vShakeVelocity += fElasticAcce + fRigAngleAcce;
-	_fShakeValue += _vShakeVelocity;
-	_angle += _fShakeValue;
+void StackedSoftRotElement::update(float time)
+{
+	// 没有动画通道时，先还原上一帧的原始角度，避免偏移被累加
+	if (_bHasLastRig) _angle = _fLastRigAngle;
+	StackedRotateAxisElement::update(time);
+	if (_iLane < 0) return;
 
-	_fShakeValue *= 0.9;
+	SoftBoneSolver* pSolver = SoftBoneSolver::instance();
+	const double fDeltaTime = pSolver->getFrameDelta();
+	if (fDeltaTime > 0.0)
+	{
+		// 骨骼动画本身的角速度变化，作为惯性冲量反向施加给弹簧
+		const double fRigAngleVelocity = _bHasLastRig ? (_angle - _fLastRigAngle) / fDeltaTime : 0.0;
+		pSolver->addRotImpulse(_iLane, float(_fLastRigAngleVelocity - fRigAngleVelocity));
+		_fLastRigAngleVelocity = fRigAngleVelocity;
+	}
+	_fLastRigAngle = _angle;
+	_bHasLastRig = true;
 
-	_fLastRigAngle = _fRigAngle;
-	_fLastRigAngleVelocity = _fRigAngleVelocity;
+	_angle += pSolver->getRotOffset(_iLane);
 }
@@ -21,21 +21,37 @@ namespace GM
 	public:
 		StackedSoftRotElement();
 		StackedSoftRotElement(const StackedSoftRotElement&, const osg::CopyOp&);
+		META_Object(GM, StackedSoftRotElement)
 		StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle);
 		StackedSoftRotElement(const osg::Vec3& axis, double angle);
-		StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle, double fElastic);
+		StackedSoftRotElement(const std::string& name, const osg::Vec3& axis, double angle,
+			double fElastic, double fDamping = 0.9);
+		~StackedSoftRotElement();
 
-		void update(float frame = 0.0);
+		/**
+		* @brief 更新旋转，弹簧本身由SoftBoneSolver按墙钟时间积分
+		* @param time: 参考时间，单位：秒
+		*/
+		void update(float time = 0.0);
+
+		/**
+		* @brief 设置弹性与阻尼
+		* @param fElastic: 弹性，越大越软，0表示不抖动
+		* @param fDamping: 阻尼，每个参考帧（1/60秒）抖动保留的比例，原来固定为0.9
+		*/
+		void setElastic(double fElastic, double fDamping);
 
 	protected:
+		void _registerLane();
 
-		double _fElastic = 0.0;
+	protected:
 
-		double _vShakeVelocity = 0.0;
-		double _fShakeValue = 0.0;
+		double _fElastic = 0.0;
+		double _fDamping = 0.9;
+		int _iLane = -1;						//!< 在SoftBoneSolver中的通道
 
-		double _fRigAngle = 0.0;
 		double _fLastRigAngle = 0.0;
 		double _fLastRigAngleVelocity = 0.0;
+		bool _bHasLastRig = false;
 	};
 } // namespace GM
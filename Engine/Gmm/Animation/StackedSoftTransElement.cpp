@@ -11,6 +11,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "StackedSoftTransElement.h"
+#include "SoftBoneSolver.h"
+#include <cmath>
 
 using namespace GM;
 
@@ -20,7 +22,8 @@ StackedSoftTransElement::StackedSoftTransElement()
 }
 
 StackedSoftTransElement::StackedSoftTransElement(const StackedSoftTransElement& rhs, const osg::CopyOp& co)
-	: StackedTranslateElement(rhs, co)
+	: StackedTranslateElement(rhs, co),
+	_vSoftVelocityRange(rhs._vSoftVelocityRange), _vSoftCenter(rhs._vSoftCenter), _fDecay(rhs._fDecay)
 {
 	Init();
 }
@@ -47,6 +50,14 @@ StackedSoftTransElement::StackedSoftTransElement(const std::string& name, const
 	Init();
 }
 
+StackedSoftTransElement::~StackedSoftTransElement()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		SoftBoneSolver::instance()->removeTransLane(_iLane[i]);
+	}
+}
+
 void StackedSoftTransElement::Init()
 {
 	if (_bInit) return;
@@ -61,30 +72,64 @@ void StackedSoftTransElement::Init()
 		iPseudoNoise(m_iRandom) * 1e-3f,
 		iPseudoNoise(m_iRandom) * 1e-3f);
 
+	_registerLanes();
 	_bInit = true;
 }
 
-void StackedSoftTransElement::update(float frame)
+void StackedSoftTransElement::setDecay(double fDecay)
+{
+	_fDecay = fDecay;
+	if (_iLane[0] < 0) return;
+
+	const float fDecayPerSecond = std::pow(osg::clampBetween(_fDecay, 0.0, 1.0), SOFT_REFERENCE_FPS);
+	for (int i = 0; i < 3; i++)
+	{
+		SoftBoneSolver::instance()->setTransDecay(_iLane[i], fDecayPerSecond);
+	}
+}
+
+void StackedSoftTransElement::_registerLanes()
 {
-	StackedTranslateElement::update(frame);
 	if (0 == _vSoftVelocityRange.length2()) return;
 
-	_vRigTranslate = _translate;
-	osg::Vec3 _vDeltaPos = _vRigTranslate - _vLastRigTranslate;
-	if ((_vDeltaPos.length2() - _vLastDeltaPos.length2()) > 0.01f)
+	// 原来每帧的相位增量分别是0.5、1.37、1.31，换算成角频率
+	const float fFreq[3] = { 0.5f, 1.37f, 1.31f };
+	const float fDecayPerSecond = std::pow(osg::clampBetween(_fDecay, 0.0, 1.0), SOFT_REFERENCE_FPS);
+	for (int i = 0; i < 3; i++)
 	{
-		_vSoftVelocityMax = _vSoftVelocityRange;
+		_iLane[i] = SoftBoneSolver::instance()->addTransLane(
+			fFreq[i] * SOFT_REFERENCE_FPS, _vSoftPhase[i], fDecayPerSecond);
 	}
-	_vLastRigTranslate = _vRigTranslate;
-	_vLastDeltaPos = _vDeltaPos;
-
-	_vSoftVelocity = osg::Vec3(
-		_vSoftVelocityMax.x() * sin(frame * 0.5 + _vSoftPhase.x()),
-		_vSoftVelocityMax.y() * sin(frame * 1.37 + _vSoftPhase.y()),
-		_vSoftVelocityMax.z() * sin(frame * 1.31 + _vSoftPhase.z()));
-	_vSoftTrans += _vSoftVelocity;
-	_translate += _vSoftTrans + _vSoftCenter;
-
-	_vSoftVelocityMax *= 0.98;
-	_vSoftTrans *= 0.98;
+}
+
+void StackedSoftTransElement::update(float time)
+{
+	// 没有动画通道时，先还原上一帧的原始平移，避免偏移被累加
+	if (_bHasLastRig) _translate = _vLastRigTranslate;
+	StackedTranslateElement::update(time);
+	if (_iLane[0] < 0) return;
+
+	SoftBoneSolver* pSolver = SoftBoneSolver::instance();
+	const double fDeltaTime = pSolver->getFrameDelta();
+	if (fDeltaTime > 0.0 && _bHasLastRig)
+	{
+		// 原来的判据是“每帧位移的平方增加了0.01”，这里换算成按参考帧率的速度
+		osg::Vec3 vRigVelocity = (_translate - _vLastRigTranslate) / fDeltaTime;
+		const double fThreshold = 0.01 * SOFT_REFERENCE_FPS * SOFT_REFERENCE_FPS;
+		if ((vRigVelocity.length2() - _vLastRigVelocity.length2()) > fThreshold)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				pSolver->exciteTrans(_iLane[i], _vSoftVelocityRange[i] * SOFT_REFERENCE_FPS);
+			}
+		}
+		_vLastRigVelocity = vRigVelocity;
+	}
+	_vLastRigTranslate = _translate;
+	_bHasLastRig = true;
+
+	_translate += osg::Vec3(
+		pSolver->getTransOffset(_iLane[0]),
+		pSolver->getTransOffset(_iLane[1]),
+		pSolver->getTransOffset(_iLane[2])) + _vSoftCenter;
 }
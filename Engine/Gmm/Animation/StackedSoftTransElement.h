@@ -21,13 +21,29 @@ namespace GM
 	public:
 		StackedSoftTransElement();
 		StackedSoftTransElement(const StackedSoftTransElement&, const osg::CopyOp&);
+		META_Object(GM, StackedSoftTransElement)
 		StackedSoftTransElement(const std::string& name, const osg::Vec3& translate = osg::Vec3(0,0,0));
 		StackedSoftTransElement(const osg::Vec3& translate);
 		StackedSoftTransElement(const std::string& name, const osg::Vec3& translate,
 			const osg::Vec3& vSoftRange, const osg::Vec3& vSoftCenter);
 
+		~StackedSoftTransElement();
+
 		void Init();
-		void update(float frame = 0.0);
+		/**
+		* @brief 更新平移，抖动本身由SoftBoneSolver按墙钟时间积分
+		* @param time: 参考时间，单位：秒
+		*/
+		void update(float time = 0.0);
+
+		/**
+		* @brief 设置抖动的衰减
+		* @param fDecay: 每个参考帧（1/60秒）抖动保留的比例，原来固定为0.98
+		*/
+		void setDecay(double fDecay);
+
+	protected:
+		void _registerLanes();
 
 	protected:
 		bool    _bInit = false;
@@ -35,13 +51,11 @@ namespace GM
 		osg::Vec3 _vSoftVelocityRange = osg::Vec3(0.0f, 0.0f, 0.0f);
 		osg::Vec3 _vSoftCenter = osg::Vec3(0.0f, 0.0f, 0.0f);
 		osg::Vec3 _vSoftPhase = osg::Vec3(0.0f, 0.0f, 0.0f);
+		double _fDecay = 0.98;
+		int _iLane[3] = { -1, -1, -1 };								//!< 在SoftBoneSolver中的通道，xyz各一个
 
-		osg::Vec3 _vSoftVelocity = osg::Vec3(0.0f, 0.0f, 0.0f);
-		osg::Vec3 _vSoftVelocityMax = osg::Vec3(0.0f, 0.0f, 0.0f);
-
-		osg::Vec3 _vSoftTrans = osg::Vec3(0.0f, 0.0f, 0.0f);
-		osg::Vec3 _vRigTranslate = osg::Vec3(0.0f, 0.0f, 0.0f);
 		osg::Vec3 _vLastRigTranslate = osg::Vec3(0.0f, 0.0f, 0.0f);
-		osg::Vec3 _vLastDeltaPos = osg::Vec3(0.0f, 0.0f, 0.0f);
+		osg::Vec3 _vLastRigVelocity = osg::Vec3(0.0f, 0.0f, 0.0f);
+		bool _bHasLastRig = false;
 	};
 } // namespace GM
@@ -11,6 +11,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "UpdateSoftBone.h"
+#include "SoftBoneSolver.h"
 #include <osgAnimation/Bone>
 #include <osg/NodeVisitor>
 
@@ -37,11 +38,13 @@ void UpdateSoftBone::operator()(osg::Node* node, osg::NodeVisitor* nv)
             return;
         }
 
-        // if I use real time,the shake will be not smooth,so I use the frame number instead
-        //float time = nv->getFrameStamp()->getReferenceTime();
-        unsigned int iFrame = nv->getFrameStamp()->getFrameNumber();
+        // the springs are integrated by the solver with a fixed sub-step in real time,
+        // so the shake is smooth and independent of the frame rate
+        const osg::FrameStamp* pFrameStamp = nv->getFrameStamp();
+        SoftBoneSolver::instance()->advance(pFrameStamp);
+        float time = pFrameStamp ? pFrameStamp->getReferenceTime() : 0.0f;
         // here we would prefer to have a flag inside transform stack in order to avoid update and a dirty state in matrixTransform if it's not require.
-        _transforms.update(iFrame);
+        _transforms.update(time);
         const osg::Matrix& matrix = _transforms.getMatrix();
         b->setMatrix(matrix);
 
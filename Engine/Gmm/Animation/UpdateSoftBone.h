@@ -28,6 +28,8 @@ namespace GM
     public:
         UpdateSoftBone(const std::string& name = "");
         UpdateSoftBone(const osgAnimation::UpdateBone& , const osg::CopyOp&);
+        // keep the type when a model instance clones its callbacks
+        META_Object(GM, UpdateSoftBone)
         void operator()(osg::Node* node, osg::NodeVisitor* nv);
     };
 
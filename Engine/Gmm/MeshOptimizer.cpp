@@ -0,0 +1,634 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2024~2044, LiuTao
+/// All rights reserved.
+///
+/// @file		MeshOptimizer.cpp
+/// @brief		GMEngine - Mesh Optimizer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#include "MeshOptimizer.h"
+#include <osg/BlendFunc>
+#include <osg/NodeVisitor>
+#include <osg/TriangleIndexFunctor>
+#include <osgAnimation/MorphGeometry>
+#include <osgAnimation/RigGeometry>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <thread>
+
+using namespace GM;
+
+/*************************************************************************
+ Local Functions
+*************************************************************************/
+
+namespace
+{
+	/** @brief 收集所有图元的三角形，跳过退化的三角形 */
+	struct TriangleCollector
+	{
+		std::vector<unsigned int>* pIndices;
+
+		void operator()(unsigned int i0, unsigned int i1, unsigned int i2)
+		{
+			if (i0 == i1 || i1 == i2 || i2 == i0) return;
+			pIndices->push_back(i0);
+			pIndices->push_back(i1);
+			pIndices->push_back(i2);
+		}
+	};
+
+	/** @brief Forsyth算法的顶点分数：缓存中越靠前越高，剩余的三角形越少越高 */
+	float vertexScore(int iCachePos, unsigned int nRemaining)
+	{
+		if (0 == nRemaining) return -1.0f;
+
+		float fScore = 0.0f;
+		if (iCachePos >= 0)
+		{
+			// 刚用过的三个顶点分数固定，避免总是沿着同一条带子走
+			if (iCachePos < 3)
+				fScore = 0.75f;
+			else
+				fScore = std::pow(1.0f - float(iCachePos - 3) / float(MESH_CACHE_SIZE - 3), 1.5f);
+		}
+		fScore += 2.0f / std::sqrt(float(nRemaining));
+		return fScore;
+	}
+
+	/** @brief 几何体所有的逐顶点数组，合并和重排顶点时都要处理 */
+	void getVertexArrays(osg::Geometry* pGeometry, std::vector<osg::Array*>& arrays)
+	{
+		const unsigned int nVertices = pGeometry->getVertexArray()->getNumElements();
+		arrays.push_back(pGeometry->getVertexArray());
+		if (pGeometry->getNormalArray()) arrays.push_back(pGeometry->getNormalArray());
+		if (pGeometry->getColorArray()) arrays.push_back(pGeometry->getColorArray());
+		if (pGeometry->getSecondaryColorArray()) arrays.push_back(pGeometry->getSecondaryColorArray());
+		for (unsigned int i = 0; i < pGeometry->getNumTexCoordArrays(); ++i)
+		{
+			if (pGeometry->getTexCoordArray(i)) arrays.push_back(pGeometry->getTexCoordArray(i));
+		}
+		for (unsigned int i = 0; i < pGeometry->getNumVertexAttribArrays(); ++i)
+		{
+			if (pGeometry->getVertexAttribArray(i)) arrays.push_back(pGeometry->getVertexAttribArray(i));
+		}
+		arrays.erase(std::remove_if(arrays.begin(), arrays.end(), [nVertices](const osg::Array* pArray)
+		{
+			return pArray->getBinding() != osg::Array::BIND_PER_VERTEX || pArray->getNumElements() != nVertices;
+		}), arrays.end());
+	}
+
+	/** @brief 用三角形索引生成一个GL_TRIANGLES的DrawElements，替换几何体原来的图元 */
+	void setTriangles(osg::Geometry* pGeometry, const std::vector<unsigned int>& indices, unsigned int nVertices)
+	{
+		osg::ref_ptr<osg::DrawElements> pElements;
+		if (nVertices < 0xFFFF)
+			pElements = new osg::DrawElementsUShort(GL_TRIANGLES);
+		else
+			pElements = new osg::DrawElementsUInt(GL_TRIANGLES);
+		pElements->reserveElements(static_cast<unsigned int>(indices.size()));
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			pElements->addElement(indices[i]);
+		}
+		pGeometry->removePrimitiveSet(0, pGeometry->getNumPrimitiveSets());
+		pGeometry->addPrimitiveSet(pElements.get());
+	}
+
+	/** @brief 按映射重排数组，映射是一一对应的 */
+	void remapArray(osg::Array* pArray, const std::vector<unsigned int>& remap)
+	{
+		const unsigned int nSize = pArray->getElementSize();
+		unsigned char* pData = static_cast<unsigned char*>(const_cast<GLvoid*>(pArray->getDataPointer()));
+		std::vector<unsigned char> source(pData, pData + nSize * remap.size());
+		for (size_t i = 0; i < remap.size(); ++i)
+		{
+			memcpy(pData + nSize * remap[i], &source[nSize * i], nSize);
+		}
+		pArray->dirty();
+	}
+
+	/** @brief 收集静态几何体，共享的几何体只处理一次 */
+	class GeometryCollector : public osg::NodeVisitor
+	{
+	public:
+		GeometryCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+		virtual void apply(osg::Geometry& geometry)
+		{
+			if (dynamic_cast<osgAnimation::RigGeometry*>(&geometry)) return;
+			if (dynamic_cast<osgAnimation::MorphGeometry*>(&geometry)) return;
+			if (_geometrySet.insert(&geometry).second)
+				_geometryVector.push_back(&geometry);
+		}
+
+		std::vector<osg::Geometry*> _geometryVector;
+
+	private:
+		std::set<osg::Geometry*> _geometrySet;
+	};
+}
+
+/*************************************************************************
+ MeshOptimizer Methods
+*************************************************************************/
+
+std::vector<unsigned int> MeshOptimizer::weld(osg::Geometry* pGeometry, const std::vector<int>& controlPoints)
+{
+	std::vector<unsigned int> remap;
+	if (!pGeometry || !pGeometry->getVertexArray()) return remap;
+
+	std::vector<osg::Array*> arrays;
+	getVertexArrays(pGeometry, arrays);
+	const unsigned int nVertices = pGeometry->getVertexArray()->getNumElements();
+
+	// 每个顶点的键：控制点序号，然后是所有数组的字节
+	size_t nStride = sizeof(int);
+	for (size_t i = 0; i < arrays.size(); ++i) nStride += arrays[i]->getElementSize();
+	std::vector<unsigned char> keys(nStride * nVertices);
+	for (unsigned int v = 0; v < nVertices; ++v)
+	{
+		unsigned char* pKey = &keys[nStride * v];
+		const int nControlPoint = v < controlPoints.size() ? controlPoints[v] : -1;
+		memcpy(pKey, &nControlPoint, sizeof(int));
+		pKey += sizeof(int);
+		for (size_t i = 0; i < arrays.size(); ++i)
+		{
+			const unsigned int nSize = arrays[i]->getElementSize();
+			memcpy(pKey, static_cast<const unsigned char*>(arrays[i]->getDataPointer()) + nSize * v, nSize);
+			pKey += nSize;
+		}
+	}
+
+	// 开放寻址的哈希表保存每组相同顶点中的第一个，哈希是键的FNV-1a
+	unsigned int nBuckets = 1;
+	while (nBuckets < nVertices * 2) nBuckets <<= 1;
+	std::vector<unsigned int> buckets(nBuckets, UINT_MAX);
+	std::vector<unsigned int> representatives;
+	representatives.reserve(nVertices);
+	remap.resize(nVertices);
+	for (unsigned int v = 0; v < nVertices; ++v)
+	{
+		const unsigned char* pKey = &keys[nStride * v];
+		unsigned long long hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < nStride; ++i)
+		{
+			hash ^= pKey[i];
+			hash *= 1099511628211ULL;
+		}
+
+		unsigned int nBucket = static_cast<unsigned int>(hash) & (nBuckets - 1);
+		while (true)
+		{
+			const unsigned int nFound = buckets[nBucket];
+			if (nFound == UINT_MAX)
+			{
+				buckets[nBucket] = static_cast<unsigned int>(representatives.size());
+				remap[v] = static_cast<unsigned int>(representatives.size());
+				representatives.push_back(v);
+				break;
+			}
+			if (memcmp(pKey, &keys[nStride * representatives[nFound]], nStride) == 0)
+			{
+				remap[v] = nFound;
+				break;
+			}
+			nBucket = (nBucket + 1) & (nBuckets - 1);
+		}
+	}
+
+	std::vector<unsigned int> triangles;
+	osg::TriangleIndexFunctor<TriangleCollector> functor;
+	functor.pIndices = &triangles;
+	pGeometry->accept(functor);
+
+	// 代表顶点是递增的，可以原地压缩数组
+	const unsigned int nWelded = static_cast<unsigned int>(representatives.size());
+	for (size_t i = 0; i < arrays.size(); ++i)
+	{
+		const unsigned int nSize = arrays[i]->getElementSize();
+		unsigned char* pData = static_cast<unsigned char*>(const_cast<GLvoid*>(arrays[i]->getDataPointer()));
+		for (unsigned int n = 0; n < nWelded; ++n)
+		{
+			if (representatives[n] != n)
+				memcpy(pData + nSize * n, pData + nSize * representatives[n], nSize);
+		}
+		arrays[i]->resizeArray(nWelded);
+		arrays[i]->dirty();
+	}
+
+	// 合并后变成退化的三角形也去掉
+	std::vector<unsigned int> indices;
+	indices.reserve(triangles.size());
+	for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+	{
+		const unsigned int i0 = remap[triangles[i]];
+		const unsigned int i1 = remap[triangles[i + 1]];
+		const unsigned int i2 = remap[triangles[i + 2]];
+		if (i0 == i1 || i1 == i2 || i2 == i0) continue;
+		indices.push_back(i0);
+		indices.push_back(i1);
+		indices.push_back(i2);
+	}
+	setTriangles(pGeometry, indices, nWelded);
+	pGeometry->dirtyBound();
+	return remap;
+}
+
+MeshOptimizeResult MeshOptimizer::optimize(osg::Geometry* pGeometry, bool bOpaque, std::vector<unsigned int>& remap)
+{
+	MeshOptimizeResult sResult;
+	remap.clear();
+	if (!pGeometry || !pGeometry->getVertexArray()) return sResult;
+
+	const osg::Array* pVertexArray = pGeometry->getVertexArray();
+	const unsigned int nVertices = pVertexArray->getNumElements();
+	std::vector<unsigned int> indices;
+	osg::TriangleIndexFunctor<TriangleCollector> functor;
+	functor.pIndices = &indices;
+	pGeometry->accept(functor);
+	if (indices.empty()) return sResult;
+
+	sResult.before = analyzeVertexCache(indices, nVertices);
+
+	if (bOpaque)
+	{
+		std::vector<osg::Vec3f> positions(nVertices);
+		if (pVertexArray->getType() == osg::Array::Vec3dArrayType)
+		{
+			const osg::Vec3dArray* pVertices = static_cast<const osg::Vec3dArray*>(pVertexArray);
+			for (unsigned int i = 0; i < nVertices; ++i) positions[i] = (*pVertices)[i];
+		}
+		else if (pVertexArray->getType() == osg::Array::Vec3ArrayType)
+		{
+			const osg::Vec3Array* pVertices = static_cast<const osg::Vec3Array*>(pVertexArray);
+			for (unsigned int i = 0; i < nVertices; ++i) positions[i] = (*pVertices)[i];
+		}
+
+		optimizeVertexCache(indices, nVertices);
+		if (pVertexArray->getType() == osg::Array::Vec3dArrayType || pVertexArray->getType() == osg::Array::Vec3ArrayType)
+			sResult.iClusters = optimizeOverdraw(indices, positions);
+	}
+
+	remap = optimizeVertexFetch(indices, nVertices);
+	std::vector<osg::Array*> arrays;
+	getVertexArrays(pGeometry, arrays);
+	for (size_t i = 0; i < arrays.size(); ++i)
+	{
+		remapArray(arrays[i], remap);
+	}
+
+	setTriangles(pGeometry, indices, nVertices);
+
+	sResult.after = analyzeVertexCache(indices, nVertices);
+	sResult.bOptimized = true;
+	return sResult;
+}
+
+MeshOptimizeResult MeshOptimizer::optimizeNode(osg::Node* pNode)
+{
+	MeshOptimizeResult sTotal;
+	if (!pNode) return sTotal;
+
+	GeometryCollector collector;
+	pNode->accept(collector);
+	const std::vector<osg::Geometry*>& geometryVector = collector._geometryVector;
+	std::vector<MeshOptimizeResult> resultVector(geometryVector.size());
+
+	// 每个线程依次领取一个几何体
+	std::atomic<size_t> iNext(0);
+	auto fnWork = [&]()
+	{
+		std::vector<unsigned int> remap;
+		for (size_t i = iNext++; i < geometryVector.size(); i = iNext++)
+		{
+			osg::Geometry* pGeometry = geometryVector[i];
+			resultVector[i] = optimize(pGeometry, isOpaque(pGeometry), remap);
+		}
+	};
+	size_t nThreads = std::thread::hardware_concurrency();
+	if (nThreads < 1) nThreads = 1;
+	if (nThreads > geometryVector.size()) nThreads = geometryVector.size();
+	std::vector<std::thread> threadVector;
+	for (size_t i = 1; i < nThreads; ++i)
+	{
+		threadVector.push_back(std::thread(fnWork));
+	}
+	fnWork();
+	for (auto& itr : threadVector)
+	{
+		itr.join();
+	}
+
+	for (auto& itr : resultVector)
+	{
+		if (!itr.bOptimized) continue;
+		sTotal.before.iTriangles += itr.before.iTriangles;
+		sTotal.before.iVertices += itr.before.iVertices;
+		sTotal.before.iTransformed += itr.before.iTransformed;
+		sTotal.after.iTriangles += itr.after.iTriangles;
+		sTotal.after.iVertices += itr.after.iVertices;
+		sTotal.after.iTransformed += itr.after.iTransformed;
+		sTotal.iClusters += itr.iClusters;
+		sTotal.bOptimized = true;
+	}
+	VertexCacheStats* pStats[] = { &sTotal.before, &sTotal.after };
+	for (auto& itr : pStats)
+	{
+		itr->fACMR = itr->iTriangles ? float(itr->iTransformed) / float(itr->iTriangles) : 0.0f;
+		itr->fATVR = itr->iVertices ? float(itr->iTransformed) / float(itr->iVertices) : 0.0f;
+	}
+	return sTotal;
+}
+
+bool MeshOptimizer::isOpaque(const osg::Geometry* pGeometry)
+{
+	const osg::StateSet* pStateSet = pGeometry->getStateSet();
+	if (!pStateSet) return true;
+	if (osg::StateSet::TRANSPARENT_BIN == pStateSet->getRenderingHint()) return false;
+	if (pStateSet->getAttribute(osg::StateAttribute::BLENDFUNC)) return false;
+	return true;
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices,
+	unsigned int nVertices, unsigned int nCacheSize)
+{
+	VertexCacheStats sStats;
+	sStats.iTriangles = static_cast<unsigned int>(indices.size() / 3);
+
+	// 记录每个顶点进入缓存时的序号，和当前序号相差超过缓存大小就已经被挤出
+	std::vector<unsigned int> timestamps(nVertices, 0);
+	unsigned int iTime = nCacheSize + 1;
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		const unsigned int v = indices[i];
+		if (0 == timestamps[v]) sStats.iVertices++;
+		if (iTime - timestamps[v] > nCacheSize)
+		{
+			timestamps[v] = iTime++;
+			sStats.iTransformed++;
+		}
+	}
+
+	sStats.fACMR = sStats.iTriangles ? float(sStats.iTransformed) / float(sStats.iTriangles) : 0.0f;
+	sStats.fATVR = sStats.iVertices ? float(sStats.iTransformed) / float(sStats.iVertices) : 0.0f;
+	return sStats;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, unsigned int nVertices)
+{
+	const size_t nTriangles = indices.size() / 3;
+	if (nTriangles < 2) return;
+
+	// 每个顶点相邻的三角形，压缩存储，三角形输出后从列表中移除
+	std::vector<unsigned int> offsets(nVertices + 1, 0);
+	for (size_t i = 0; i < indices.size(); ++i) offsets[indices[i] + 1]++;
+	for (unsigned int v = 0; v < nVertices; ++v) offsets[v + 1] += offsets[v];
+	std::vector<unsigned int> remaining(nVertices, 0);
+	std::vector<unsigned int> adjacency(indices.size());
+	for (size_t t = 0; t < nTriangles; ++t)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int v = indices[t * 3 + k];
+			adjacency[offsets[v] + remaining[v]++] = static_cast<unsigned int>(t);
+		}
+	}
+
+	std::vector<int> cachePos(nVertices, -1);
+	std::vector<float> vertexScores(nVertices);
+	for (unsigned int v = 0; v < nVertices; ++v) vertexScores[v] = vertexScore(-1, remaining[v]);
+	std::vector<float> triangleScores(nTriangles);
+	for (size_t t = 0; t < nTriangles; ++t)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+	}
+	std::vector<char> emitted(nTriangles, 0);
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	unsigned int cache[MESH_CACHE_SIZE + 3];
+	unsigned int nCache = 0;
+	size_t iCursor = 0;
+	long long iBest = -1;
+
+	for (size_t n = 0; n < nTriangles; ++n)
+	{
+		// 缓存附近没有候选时，取下一个还没输出的三角形
+		if (iBest < 0)
+		{
+			while (emitted[iCursor]) iCursor++;
+			iBest = static_cast<long long>(iCursor);
+		}
+		const size_t t = static_cast<size_t>(iBest);
+		emitted[t] = 1;
+		const unsigned int* pTri = &indices[t * 3];
+		result.push_back(pTri[0]);
+		result.push_back(pTri[1]);
+		result.push_back(pTri[2]);
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int v = pTri[k];
+			unsigned int* pList = &adjacency[offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; ++j)
+			{
+				if (pList[j] == t)
+				{
+					pList[j] = pList[remaining[v] - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// 新的LRU缓存：这个三角形的顶点在最前面
+		unsigned int newCache[MESH_CACHE_SIZE + 3];
+		unsigned int nNewCache = 0;
+		for (int k = 0; k < 3; ++k) newCache[nNewCache++] = pTri[k];
+		for (unsigned int i = 0; i < nCache; ++i)
+		{
+			const unsigned int v = cache[i];
+			if (v != pTri[0] && v != pTri[1] && v != pTri[2])
+				newCache[nNewCache++] = v;
+		}
+
+		// 被挤出缓存的顶点
+		for (unsigned int i = MESH_CACHE_SIZE; i < nNewCache; ++i)
+		{
+			const unsigned int v = newCache[i];
+			cachePos[v] = -1;
+			const float fScore = vertexScore(-1, remaining[v]);
+			const float fDelta = fScore - vertexScores[v];
+			vertexScores[v] = fScore;
+			for (unsigned int j = 0; j < remaining[v]; ++j) triangleScores[adjacency[offsets[v] + j]] += fDelta;
+		}
+
+		nCache = (nNewCache < MESH_CACHE_SIZE) ? nNewCache : MESH_CACHE_SIZE;
+		for (unsigned int i = 0; i < nCache; ++i)
+		{
+			const unsigned int v = newCache[i];
+			cache[i] = v;
+			cachePos[v] = static_cast<int>(i);
+			const float fScore = vertexScore(static_cast<int>(i), remaining[v]);
+			const float fDelta = fScore - vertexScores[v];
+			vertexScores[v] = fScore;
+			for (unsigned int j = 0; j < remaining[v]; ++j) triangleScores[adjacency[offsets[v] + j]] += fDelta;
+		}
+
+		// 下一个三角形只在缓存中顶点相邻的三角形里找
+		iBest = -1;
+		float fBestScore = -1.0f;
+		for (unsigned int i = 0; i < nCache; ++i)
+		{
+			const unsigned int v = cache[i];
+			for (unsigned int j = 0; j < remaining[v]; ++j)
+			{
+				const unsigned int tri = adjacency[offsets[v] + j];
+				if (triangleScores[tri] > fBestScore)
+				{
+					fBestScore = triangleScores[tri];
+					iBest = tri;
+				}
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+unsigned int MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices,
+	const std::vector<osg::Vec3f>& positions, float fThreshold)
+{
+	const size_t nTriangles = indices.size() / 3;
+	if (nTriangles < 2) return nTriangles ? 1u : 0u;
+	const unsigned int nVertices = static_cast<unsigned int>(positions.size());
+
+	// 硬边界：三个顶点都不在缓存中的三角形，缓存优化在这里重新开始
+	std::vector<unsigned int> timestamps(nVertices, 0);
+	unsigned int iTime = MESH_FIFO_SIZE + 1;
+	auto fnMisses = [&](size_t t) -> unsigned int
+	{
+		unsigned int nMisses = 0;
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int v = indices[t * 3 + k];
+			if (iTime - timestamps[v] > MESH_FIFO_SIZE)
+			{
+				timestamps[v] = iTime++;
+				nMisses++;
+			}
+		}
+		return nMisses;
+	};
+	std::vector<size_t> hardVector;
+	for (size_t t = 0; t < nTriangles; ++t)
+	{
+		if (3 == fnMisses(t)) hardVector.push_back(t);
+	}
+	hardVector.push_back(nTriangles);
+
+	// 软边界：从簇的开头清空缓存，ACMR不超过整个硬簇的fThreshold倍时就可以切开
+	std::vector<size_t> clusterVector;
+	for (size_t h = 0; h + 1 < hardVector.size(); ++h)
+	{
+		const size_t iStart = hardVector[h];
+		const size_t iEnd = hardVector[h + 1];
+		iTime += MESH_FIFO_SIZE + 1;
+		unsigned int nClusterMisses = 0;
+		for (size_t t = iStart; t < iEnd; ++t) nClusterMisses += fnMisses(t);
+		const float fClusterACMR = float(nClusterMisses) / float(iEnd - iStart) * fThreshold;
+
+		clusterVector.push_back(iStart);
+		iTime += MESH_FIFO_SIZE + 1;
+		unsigned int nMisses = 0;
+		size_t iFaces = 0;
+		for (size_t t = iStart; t < iEnd; ++t)
+		{
+			nMisses += fnMisses(t);
+			iFaces++;
+			if (t + 1 < iEnd && float(nMisses) <= fClusterACMR * float(iFaces))
+			{
+				clusterVector.push_back(t + 1);
+				iTime += MESH_FIFO_SIZE + 1;
+				nMisses = 0;
+				iFaces = 0;
+			}
+		}
+	}
+	clusterVector.push_back(nTriangles);
+	const size_t nClusters = clusterVector.size() - 1;
+
+	// 簇的面积加权中心和平均法线，网格中心
+	std::vector<osg::Vec3f> centerVector(nClusters), normalVector(nClusters);
+	osg::Vec3f vMeshCenter;
+	float fMeshArea = 0.0f;
+	for (size_t c = 0; c < nClusters; ++c)
+	{
+		osg::Vec3f vCenter, vNormal;
+		float fArea = 0.0f;
+		for (size_t t = clusterVector[c]; t < clusterVector[c + 1]; ++t)
+		{
+			const osg::Vec3f& p0 = positions[indices[t * 3]];
+			const osg::Vec3f& p1 = positions[indices[t * 3 + 1]];
+			const osg::Vec3f& p2 = positions[indices[t * 3 + 2]];
+			const osg::Vec3f vCross = (p1 - p0) ^ (p2 - p0);
+			const float fTriArea = vCross.length();
+			vCenter += (p0 + p1 + p2) * (fTriArea / 3.0f);
+			vNormal += vCross;
+			fArea += fTriArea;
+		}
+		vMeshCenter += vCenter;
+		fMeshArea += fArea;
+		centerVector[c] = (fArea > 0.0f) ? vCenter / fArea : positions[indices[clusterVector[c] * 3]];
+		vNormal.normalize();
+		normalVector[c] = vNormal;
+	}
+	if (fMeshArea > 0.0f) vMeshCenter /= fMeshArea;
+
+	// 朝外并且离中心远的簇先画，遮住后面的簇
+	std::vector<float> sortKey(nClusters);
+	std::vector<size_t> orderVector(nClusters);
+	for (size_t c = 0; c < nClusters; ++c)
+	{
+		sortKey[c] = (centerVector[c] - vMeshCenter) * normalVector[c];
+		orderVector[c] = c;
+	}
+	std::stable_sort(orderVector.begin(), orderVector.end(),
+		[&sortKey](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	for (size_t i = 0; i < nClusters; ++i)
+	{
+		const size_t c = orderVector[i];
+		result.insert(result.end(), indices.begin() + clusterVector[c] * 3, indices.begin() + clusterVector[c + 1] * 3);
+	}
+	indices.swap(result);
+	return static_cast<unsigned int>(nClusters);
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexFetch(std::vector<unsigned int>& indices, unsigned int nVertices)
+{
+	std::vector<unsigned int> remap(nVertices, UINT_MAX);
+	unsigned int iNext = 0;
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		unsigned int& iNew = remap[indices[i]];
+		if (UINT_MAX == iNew) iNew = iNext++;
+		indices[i] = iNew;
+	}
+	// 没有被引用的顶点保持相对顺序放在最后
+	for (unsigned int v = 0; v < nVertices; ++v)
+	{
+		if (UINT_MAX == remap[v]) remap[v] = iNext++;
+	}
+	return remap;
+}
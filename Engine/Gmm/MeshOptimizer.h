@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2024~2044, LiuTao
+/// All rights reserved.
+///
+/// @file		MeshOptimizer.h
+/// @brief		GMEngine - Mesh Optimizer
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <osg/Geometry>
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+#define MESH_CACHE_SIZE				32			// Forsyth算法假设的LRU缓存大小
+#define MESH_FIFO_SIZE				16			// 统计ACMR时模拟的FIFO缓存大小，接近常见显卡的后变换缓存
+#define MESH_OVERDRAW_THRESHOLD		1.05f		// 按遮挡排序切分簇时，允许ACMR变差的比例
+
+namespace GM
+{
+	/*************************************************************************
+	 Structs
+	*************************************************************************/
+
+	/*!
+	 *  @struct VertexCacheStats
+	 *  @brief 后变换缓存的统计
+	 */
+	struct VertexCacheStats
+	{
+		unsigned int	iTriangles = 0;			//!< 三角形数量
+		unsigned int	iVertices = 0;			//!< 被引用的顶点数量
+		unsigned int	iTransformed = 0;		//!< 缓存未命中、需要执行顶点着色器的次数
+		float			fACMR = 0.0f;			//!< 每个三角形的平均未命中数，理想值约0.5，最差3
+		float			fATVR = 0.0f;			//!< 每个顶点的平均变换次数，理想值1
+	};
+
+	/*!
+	 *  @struct MeshOptimizeResult
+	 *  @brief 一个几何体优化前后的统计
+	 */
+	struct MeshOptimizeResult
+	{
+		VertexCacheStats	before;				//!< 优化前
+		VertexCacheStats	after;				//!< 优化后
+		unsigned int		iClusters = 0;		//!< 按遮挡排序的簇数量，不透明几何体才有
+		bool				bOptimized = false;	//!< 是否执行了优化
+	};
+
+	/*************************************************************************
+	 Class
+	*************************************************************************/
+
+	/*!
+	 *  @class MeshOptimizer
+	 *  @brief 导入模型的网格优化，只依赖OSG，导入插件和离线工具都可以直接编译进去
+	 *  weld合并相同的顶点，optimize依次执行：Forsyth顶点缓存重排三角形、按遮挡把不透明网格的簇从外向内排序、按首次使用重排顶点
+	 *  不同几何体之间互不影响，optimizeNode在多个线程中并行处理
+	 */
+	class MeshOptimizer
+	{
+	public:
+		/**
+		* @brief 合并相同的顶点，所有图元合并成一个GL_TRIANGLES的DrawElements
+		* 所有逐顶点数组逐字节相同、并且来自同一个控制点的顶点才合并，蒙皮权重和变形目标的偏移不会改变
+		* @param pGeometry: 几何体
+		* @param controlPoints: 每个顶点的控制点序号，没有的是-1
+		* @return std::vector<unsigned int>: 旧顶点序号到新顶点序号的映射
+		*/
+		static std::vector<unsigned int> weld(osg::Geometry* pGeometry, const std::vector<int>& controlPoints);
+		/**
+		* @brief 优化一个几何体，所有图元合并成一个GL_TRIANGLES的DrawElements
+		* 半透明几何体只重排顶点，三角形保持原来的顺序，以免改变混合结果
+		* @param pGeometry: 几何体，只能有逐顶点的数组
+		* @param bOpaque: 是否不透明，不透明时才按遮挡排序
+		* @param remap: 输出，旧顶点序号到新顶点序号的映射
+		* @return MeshOptimizeResult: 优化前后的统计
+		*/
+		static MeshOptimizeResult optimize(osg::Geometry* pGeometry, bool bOpaque, std::vector<unsigned int>& remap);
+		/**
+		* @brief 并行优化节点下所有的静态几何体，蒙皮和变形几何体的顶点序号被其他数据引用，跳过
+		* @param pNode: 根节点
+		* @return MeshOptimizeResult: 所有几何体的统计之和
+		*/
+		static MeshOptimizeResult optimizeNode(osg::Node* pNode);
+		/** @brief 几何体的材质是否不透明，根据状态集的渲染提示和混合方式判断，模型整体的混合方式要调用者另外判断 */
+		static bool isOpaque(const osg::Geometry* pGeometry);
+
+		/** @brief 模拟FIFO缓存，统计ACMR和ATVR */
+		static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices,
+			unsigned int nVertices, unsigned int nCacheSize = MESH_FIFO_SIZE);
+		/** @brief Tom Forsyth的线性时间顶点缓存优化，重排三角形 */
+		static void optimizeVertexCache(std::vector<unsigned int>& indices, unsigned int nVertices);
+		/**
+		* @brief 把缓存优化后的三角形切成簇，按簇的朝向从外向内排序，减少不透明网格自身的重复绘制
+		* @param indices: 缓存优化后的索引
+		* @param positions: 顶点位置
+		* @param fThreshold: 允许簇内ACMR变差的比例
+		* @return unsigned int: 簇数量
+		*/
+		static unsigned int optimizeOverdraw(std::vector<unsigned int>& indices,
+			const std::vector<osg::Vec3f>& positions, float fThreshold = MESH_OVERDRAW_THRESHOLD);
+		/**
+		* @brief 按首次使用的顺序给顶点重新编号，没有被引用的顶点放在最后
+		* @param indices: 索引，直接改成新序号
+		* @param nVertices: 顶点数量
+		* @return std::vector<unsigned int>: 旧序号到新序号的映射
+		*/
+		static std::vector<unsigned int> optimizeVertexFetch(std::vector<unsigned int>& indices, unsigned int nVertices);
+	};
+}	// GM
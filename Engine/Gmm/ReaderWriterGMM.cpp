@@ -275,6 +275,9 @@ ReaderWriterGMM::readNode(const std::string& filenameInit,
             bool useFbxRoot = false;
             bool lightmapTextures = false;
             bool tessellatePolygons = false;
+            bool weldVertices = true;
+            bool optimizeMesh = true;
+            bool transparentMesh = false;
             bool zUp = false;
             if (options)
             {
@@ -294,6 +297,18 @@ ReaderWriterGMM::readNode(const std::string& filenameInit,
                     {
                         tessellatePolygons = true;
                     }
+                    if (opt == "NoWeldVertices")
+                    {
+                        weldVertices = false;
+                    }
+                    if (opt == "NoOptimizeMesh")
+                    {
+                        optimizeMesh = false;
+                    }
+                    if (opt == "Transparent")
+                    {
+                        transparentMesh = true;
+                    }
                     if (opt == "ZUp")
                     {
                         zUp = true;
@@ -360,7 +375,10 @@ ReaderWriterGMM::readNode(const std::string& filenameInit,
                 *localOptions,
                 authoringTool,
                 lightmapTextures,
-                tessellatePolygons);
+                tessellatePolygons,
+                weldVertices,
+                optimizeMesh,
+                transparentMesh);
 
             ReadResult res = reader.readFbxNode(pNode, bIsBone, nLightCount);
 
@@ -24,6 +24,9 @@ public:
         supportsOption("UseFbxRoot", "(Read/write option) If the source OSG root node is a simple group with no stateset, the writer will put its children directly under the GMM root, and vice-versa for reading");
         supportsOption("LightmapTextures", "(Read option) Interpret texture maps as overriding the lighting. 3D Studio Max may export files that should be interpreted in this way.");
         supportsOption("TessellatePolygons", "(Read option) Tessellate mesh polygons. If the model contains concave polygons this may be necessary, however tessellating can be very slow and may erroneously produce triangle shards.");
+        supportsOption("NoWeldVertices", "(Read option) Keep one vertex per polygon corner and draw with DrawArrays, instead of welding identical corners into indexed triangles.");
+        supportsOption("NoOptimizeMesh", "(Read option) Keep the triangle and vertex order of welded meshes, instead of reordering them for the post-transform vertex cache and overdraw.");
+        supportsOption("Transparent", "(Read option) The model is drawn with blending, so mesh optimization keeps the triangle order of every mesh instead of sorting it for overdraw.");
     }
 
     const char* className() const { return "GMM reader/writer"; }
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <future>
 #include <sstream>
 
 #include <osg/BlendFunc>
@@ -8,6 +9,7 @@
 #include <osg/TexMat>
 #include <osg/TexGen>
 #include <osg/TexEnvCombine>
+#include <osg/Timer>
 
 #include <osgUtil/Tessellator>
 
@@ -25,6 +27,7 @@
 #include <fbxsdk.h>
 
 #include "gmmReader.h"
+#include "MeshOptimizer.h"
 
 enum GeometryType
 {
@@ -530,15 +533,104 @@ const FbxLayerElementUV* getUVElementForChannel(std::string uvChannelName,
     return 0;
 }
 
-typedef std::pair<osg::Geometry*, int> GIPair;
-typedef std::multimap<int, GIPair> FbxToOsgVertexMap;
-typedef std::map<GIPair, int> OsgToFbxNormalMap;
+/// One polygon corner as it is read: the FBX control point and normal it came from
+/// and the OSG vertex it went to. Corners are only appended while the mesh is read.
+struct FbxCorner
+{
+    int controlPoint;
+    osg::Geometry* pGeometry;
+    int vertex;
+    int normal;
+};
+typedef std::vector<FbxCorner> FbxCornerList;
+
+/// Flat compressed sparse row mapping from FBX control point to OSG vertices:
+/// the vertices of control point c are vertices[offsets[c]] .. vertices[offsets[c + 1] - 1].
+/// It replaces a multimap and a map of geometry/vertex pairs, which made skin
+/// and blend shape import allocate a node per corner and search for every lookup.
+struct FbxToOsgVertexMap
+{
+    struct Vertex
+    {
+        osg::Geometry* pGeometry;
+        int index;
+        int normal;     // FBX normal of the first corner, -1 without normals
+    };
+
+    std::vector<int> offsets;
+    std::vector<Vertex> vertices;
+
+    /// Counting sort of the corners by control point in one pass, stable so the
+    /// first corner of every vertex keeps its normal. Corners that were welded
+    /// into the same vertex are stored once.
+    void build(const FbxCornerList& corners, int nControlPoints)
+    {
+        offsets.assign(nControlPoints + 1, 0);
+        for (FbxCornerList::const_iterator it = corners.begin(); it != corners.end(); ++it)
+        {
+            if (it->controlPoint >= 0 && it->controlPoint < nControlPoints)
+                ++offsets[it->controlPoint + 1];
+        }
+        for (int c = 0; c < nControlPoints; ++c)
+        {
+            offsets[c + 1] += offsets[c];
+        }
+
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        vertices.resize(offsets.back());
+        for (FbxCornerList::const_iterator it = corners.begin(); it != corners.end(); ++it)
+        {
+            if (it->controlPoint < 0 || it->controlPoint >= nControlPoints) continue;
+
+            // A control point only has a handful of vertices, a linear search is enough
+            const int begin = offsets[it->controlPoint];
+            int& end = fill[it->controlPoint];
+            bool duplicate = false;
+            for (int i = begin; i < end && !duplicate; ++i)
+            {
+                duplicate = vertices[i].pGeometry == it->pGeometry && vertices[i].index == it->vertex;
+            }
+            if (duplicate) continue;
+
+            Vertex& vertex = vertices[end++];
+            vertex.pGeometry = it->pGeometry;
+            vertex.index = it->vertex;
+            vertex.normal = it->normal;
+        }
+
+        // Close the gaps left by the duplicates
+        int size = 0;
+        for (int c = 0; c < nControlPoints; ++c)
+        {
+            const int begin = offsets[c];
+            const int end = fill[c];
+            offsets[c] = size;
+            for (int i = begin; i < end; ++i)
+            {
+                vertices[size++] = vertices[i];
+            }
+        }
+        offsets[nControlPoints] = size;
+        vertices.resize(size);
+    }
+
+    const Vertex* begin(int controlPoint) const
+    {
+        if (controlPoint < 0 || controlPoint + 1 >= static_cast<int>(offsets.size())) return 0;
+        return vertices.data() + offsets[controlPoint];
+    }
+
+    const Vertex* end(int controlPoint) const
+    {
+        if (controlPoint < 0 || controlPoint + 1 >= static_cast<int>(offsets.size())) return 0;
+        return vertices.data() + offsets[controlPoint + 1];
+    }
+};
 
 void readMeshTriangle(const FbxMesh * fbxMesh, int i /*polygonIndex*/,
                       int posInPoly0, int posInPoly1, int posInPoly2,
                       int meshVertex0, int meshVertex1, int meshVertex2,
-                      FbxToOsgVertexMap& fbxToOsgVertMap,
-                      OsgToFbxNormalMap& osgToFbxNormMap,
+                      FbxCornerList& corners,
                       const FbxVector4* pFbxVertices,
                       const FbxLayerElementNormal* pFbxNormals,
                       const FbxLayerElementUV* pFbxUVs_diffuse,
@@ -565,9 +657,10 @@ void readMeshTriangle(const FbxMesh * fbxMesh, int i /*polygonIndex*/,
         v1 = fbxMesh->GetPolygonVertex(i, posInPoly1),
         v2 = fbxMesh->GetPolygonVertex(i, posInPoly2);
 
-    fbxToOsgVertMap.insert(FbxToOsgVertexMap::value_type(v0, GIPair(pGeometry, pVertices->getNumElements())));
-    fbxToOsgVertMap.insert(FbxToOsgVertexMap::value_type(v1, GIPair(pGeometry, pVertices->getNumElements() + 1)));
-    fbxToOsgVertMap.insert(FbxToOsgVertexMap::value_type(v2, GIPair(pGeometry, pVertices->getNumElements() + 2)));
+    const int osgVertex0 = pVertices->getNumElements();
+    FbxCorner corner0 = { v0, pGeometry, osgVertex0, -1 };
+    FbxCorner corner1 = { v1, pGeometry, osgVertex0 + 1, -1 };
+    FbxCorner corner2 = { v2, pGeometry, osgVertex0 + 2, -1 };
 
     addVec3ArrayElement(*pVertices, pFbxVertices[v0]);
     addVec3ArrayElement(*pVertices, pFbxVertices[v1]);
@@ -579,15 +672,19 @@ void readMeshTriangle(const FbxMesh * fbxMesh, int i /*polygonIndex*/,
         int n1 = getVertexIndex(pFbxNormals, fbxMesh, i, posInPoly1, meshVertex1);
         int n2 = getVertexIndex(pFbxNormals, fbxMesh, i, posInPoly2, meshVertex2);
 
-        osgToFbxNormMap.insert(OsgToFbxNormalMap::value_type(GIPair(pGeometry, pNormals->getNumElements()), n0));
-        osgToFbxNormMap.insert(OsgToFbxNormalMap::value_type(GIPair(pGeometry, pNormals->getNumElements() + 1), n1));
-        osgToFbxNormMap.insert(OsgToFbxNormalMap::value_type(GIPair(pGeometry, pNormals->getNumElements() + 2), n2));
+        corner0.normal = n0;
+        corner1.normal = n1;
+        corner2.normal = n2;
 
         addVec3ArrayElement(*pNormals, pFbxNormals->GetDirectArray().GetAt(n0));
         addVec3ArrayElement(*pNormals, pFbxNormals->GetDirectArray().GetAt(n1));
         addVec3ArrayElement(*pNormals, pFbxNormals->GetDirectArray().GetAt(n2));
     }
 
+    corners.push_back(corner0);
+    corners.push_back(corner1);
+    corners.push_back(corner2);
+
     // add texture maps data (avoid duplicates)...
     if (pTexCoords_diffuse)
     {
@@ -698,6 +795,86 @@ struct PolygonRef
 };
 typedef std::vector<PolygonRef> PolygonRefList;
 
+/// Welds every geometry of the geode and points the corners at the welded vertices;
+/// FbxToOsgVertexMap::build then keeps each welded vertex once per control point.
+/// With optimizeMesh the welded geometry is also reordered for the vertex cache,
+/// and sorted for overdraw only when neither the model nor its material blends;
+/// the geometries are independent, so each one is processed on its own thread.
+void weldGeode(osg::Geode* pGeode,
+               FbxCornerList& corners,
+               bool optimizeMesh,
+               bool transparentMesh)
+{
+    typedef std::map<osg::Geometry*, std::vector<int> > ControlPointMap;
+    ControlPointMap controlPointMap;
+    for (FbxCornerList::const_iterator it = corners.begin(); it != corners.end(); ++it)
+    {
+        std::vector<int>& controlPoints = controlPointMap[it->pGeometry];
+        if (controlPoints.size() <= static_cast<size_t>(it->vertex))
+            controlPoints.resize(it->vertex + 1, -1);
+        controlPoints[it->vertex] = it->controlPoint;
+    }
+
+    std::vector<osg::Geometry*> geometries;
+    for (unsigned i = 0; i < pGeode->getNumDrawables(); ++i)
+    {
+        osg::Geometry* pGeometry = pGeode->getDrawable(i)->asGeometry();
+        if (pGeometry) geometries.push_back(pGeometry);
+    }
+
+    std::vector<unsigned int> vertexCounts(geometries.size(), 0);
+    std::vector<std::vector<unsigned int> > remaps(geometries.size());
+    std::vector<GM::MeshOptimizeResult> results(geometries.size());
+    std::vector<std::future<void> > futures;
+    for (size_t i = 0; i < geometries.size(); ++i)
+    {
+        osg::Geometry* pGeometry = geometries[i];
+        vertexCounts[i] = pGeometry->getVertexArray() ? pGeometry->getVertexArray()->getNumElements() : 0;
+        const std::vector<int>& controlPoints = controlPointMap[pGeometry];
+        futures.push_back(std::async(std::launch::async, [&, i, pGeometry]()
+        {
+            remaps[i] = GM::MeshOptimizer::weld(pGeometry, controlPoints);
+            if (!optimizeMesh) return;
+
+            // Compose the weld and optimizer remaps, old corner -> final vertex
+            std::vector<unsigned int> optimizeRemap;
+            results[i] = GM::MeshOptimizer::optimize(pGeometry,
+                !transparentMesh && GM::MeshOptimizer::isOpaque(pGeometry), optimizeRemap);
+            if (optimizeRemap.empty()) return;
+            for (size_t j = 0; j < remaps[i].size(); ++j)
+                remaps[i][j] = optimizeRemap[remaps[i][j]];
+        }));
+    }
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].get();
+    }
+
+    typedef std::map<osg::Geometry*, std::vector<unsigned int> > RemapMap;
+    RemapMap remapMap;
+    for (size_t i = 0; i < geometries.size(); ++i)
+    {
+        osg::Geometry* pGeometry = geometries[i];
+        OSG_INFO << "GMM weld " << pGeometry->getName() << ": " << vertexCounts[i] << " -> "
+            << (pGeometry->getVertexArray() ? pGeometry->getVertexArray()->getNumElements() : 0) << " vertices" << std::endl;
+        if (results[i].bOptimized)
+        {
+            OSG_INFO << "GMM optimize " << pGeometry->getName() << ": ACMR "
+                << results[i].before.fACMR << " -> " << results[i].after.fACMR << ", ATVR "
+                << results[i].before.fATVR << " -> " << results[i].after.fATVR << ", "
+                << results[i].iClusters << " overdraw clusters" << std::endl;
+        }
+        remapMap[pGeometry].swap(remaps[i]);
+    }
+
+    for (FbxCornerList::iterator it = corners.begin(); it != corners.end(); ++it)
+    {
+        const std::vector<unsigned int>& remap = remapMap[it->pGeometry];
+        if (static_cast<size_t>(it->vertex) < remap.size())
+            it->vertex = remap[it->vertex];
+    }
+}
+
 osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
     FbxNode* pNode,
     FbxMesh* fbxMesh,
@@ -781,8 +958,8 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
         geomType |= GEOMETRY_MORPH;
     }
 
-    FbxToOsgVertexMap fbxToOsgVertMap;
-    OsgToFbxNormalMap osgToFbxNormMap;
+    FbxCornerList corners;
+    corners.reserve(fbxMesh->GetPolygonVertexCount());
 
     // First add only triangles and quads (easy to split into triangles without
     // more processing)
@@ -832,7 +1009,7 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
             readMeshTriangle(fbxMesh, i,
                 0, 1, 2,
                 nVertex, nVertex+1, nVertex+2,
-                fbxToOsgVertMap, osgToFbxNormMap,
+                corners,
                 pFbxVertices, pFbxNormals, pFbxUVs_diffuse, pFbxUVs_opacity, pFbxUVs_emissive, pFbxUVs_ambient, pFbxUVs_normal, pFbxUVs_specular, pFbxUVs_shininess, pFbxColors,
                 pGeometry,
                 pVertices, pNormals, pTexCoords_diffuse, pTexCoords_opacity, pTexCoords_emissive, pTexCoords_ambient, pTexCoords_normal, pTexCoords_specular, pTexCoords_shininess, pColors);
@@ -849,14 +1026,14 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
             readMeshTriangle(fbxMesh, i,
                 0, 1, p02,
                 nVertex, nVertex+1, nVertex+p02,
-                fbxToOsgVertMap, osgToFbxNormMap,
+                corners,
                 pFbxVertices, pFbxNormals, pFbxUVs_diffuse, pFbxUVs_opacity, pFbxUVs_emissive, pFbxUVs_ambient, pFbxUVs_normal, pFbxUVs_specular, pFbxUVs_shininess, pFbxColors,
                 pGeometry,
                 pVertices, pNormals, pTexCoords_diffuse, pTexCoords_opacity, pTexCoords_emissive, pTexCoords_ambient, pTexCoords_normal, pTexCoords_specular, pTexCoords_shininess, pColors);
             readMeshTriangle(fbxMesh, i,
                 p10, 2, 3,
                 nVertex+p10, nVertex+2, nVertex+3,
-                fbxToOsgVertMap, osgToFbxNormMap,
+                corners,
                 pFbxVertices, pFbxNormals, pFbxUVs_diffuse, pFbxUVs_opacity, pFbxUVs_emissive, pFbxUVs_ambient, pFbxUVs_normal, pFbxUVs_specular, pFbxUVs_shininess, pFbxColors,
                 pGeometry,
                 pVertices, pNormals, pTexCoords_diffuse, pTexCoords_opacity, pTexCoords_emissive, pTexCoords_ambient, pTexCoords_normal, pTexCoords_specular, pTexCoords_shininess, pColors);
@@ -878,7 +1055,7 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
                 readMeshTriangle(fbxMesh, i,
                     0, j - 1, j,
                     nVertex0, nVertex - 1, nVertex,
-                    fbxToOsgVertMap, osgToFbxNormMap,
+                    corners,
                     pFbxVertices, pFbxNormals, pFbxUVs_diffuse, pFbxUVs_opacity, pFbxUVs_emissive, pFbxUVs_ambient, pFbxUVs_normal, pFbxUVs_specular, pFbxUVs_shininess, pFbxColors,
                     pGeometry,
                     pVertices, pNormals, pTexCoords_diffuse, pTexCoords_opacity, pTexCoords_emissive, pTexCoords_ambient, pTexCoords_normal, pTexCoords_specular, pTexCoords_shininess, pColors);
@@ -922,14 +1099,15 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
         for (int j = 0, nVertex = it->nVertex; j<lPolygonSize; ++j, ++nVertex)
         {
             int v0 = fbxMesh->GetPolygonVertex(i, j);
-            fbxToOsgVertMap.insert(FbxToOsgVertexMap::value_type(v0, GIPair(pGeometry, pVertices->getNumElements())));
+            FbxCorner corner = { v0, pGeometry, static_cast<int>(pVertices->getNumElements()), -1 };
             addVec3ArrayElement(*pVertices, pFbxVertices[v0]);
             if (pNormals)
             {
                 int n0 = getVertexIndex(pFbxNormals, fbxMesh, i, j, nVertex);
-                osgToFbxNormMap.insert(OsgToFbxNormalMap::value_type(GIPair(pGeometry, pNormals->getNumElements()), n0));
+                corner.normal = n0;
                 addVec3ArrayElement(*pNormals, pFbxNormals->GetDirectArray().GetAt(n0));
             }
+            corners.push_back(corner);
 
             // add texture maps data (avoid duplicates)...
             if (pTexCoords_diffuse)
@@ -996,6 +1174,18 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
         }
     }
 
+    // Weld the per-corner vertices before morph targets and rig geometry copy the arrays
+    if (weldVertices)
+    {
+        weldGeode(pGeode, corners, optimizeMesh, transparentMesh);
+    }
+
+    osg::Timer_t mappingStart = osg::Timer::instance()->tick();
+    FbxToOsgVertexMap fbxToOsgVertMap;
+    fbxToOsgVertMap.build(corners, fbxMesh->GetControlPointsCount());
+    FbxCornerList().swap(corners);
+    osg::Timer_t mappingBuilt = osg::Timer::instance()->tick();
+
     // Process morph geometry before converting geometry to rig
     if (geomType & GEOMETRY_MORPH)
     {
@@ -1080,40 +1270,37 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
                 for (int gmmIndex = 0; gmmIndex < nControlPoints; ++gmmIndex)
                 {
                     osg::Vec3d vPos = convertVec3(pControlPoints[gmmIndex]);
-                    for (FbxToOsgVertexMap::const_iterator it =
-                        fbxToOsgVertMap.find(gmmIndex);
-                        it != fbxToOsgVertMap.end() &&
-                        it->first == gmmIndex; ++it)
+                    for (const FbxToOsgVertexMap::Vertex* it = fbxToOsgVertMap.begin(gmmIndex),
+                        *itEnd = fbxToOsgVertMap.end(gmmIndex); it != itEnd; ++it)
                     {
-                        GIPair gi = it->second;
                         osgAnimation::MorphGeometry& morphGeom =
-                            dynamic_cast<osgAnimation::MorphGeometry&>(*gi.first);
+                            static_cast<osgAnimation::MorphGeometry&>(*it->pGeometry);
                         osg::Geometry* pGeometry = morphGeom.getMorphTarget(nMorphTarget).getGeometry();
 
                         if (pGeometry->getVertexArray()->getType() == osg::Array::Vec3dArrayType)
                         {
                             osg::Vec3dArray* pVertices = static_cast<osg::Vec3dArray*>(pGeometry->getVertexArray());
-                            (*pVertices)[gi.second] = vPos;
+                            (*pVertices)[it->index] = vPos;
                         }
                         else
                         {
                             osg::Vec3Array* pVertices = static_cast<osg::Vec3Array*>(pGeometry->getVertexArray());
-                            (*pVertices)[gi.second] = vPos;
+                            (*pVertices)[it->index] = vPos;
                         }
 
-                        if (pFbxShapeNormals && pGeometry->getNormalArray())
+                        if (pFbxShapeNormals && pGeometry->getNormalArray() && it->normal >= 0)
                         {
                             if (pGeometry->getNormalArray()->getType() == osg::Array::Vec3dArrayType)
                             {
                                 osg::Vec3dArray* pNormals = static_cast<osg::Vec3dArray*>(pGeometry->getNormalArray());
-                                (*pNormals)[gi.second] = convertVec3(
-                                    pFbxShapeNormals->GetDirectArray().GetAt(osgToFbxNormMap[gi]));
+                                (*pNormals)[it->index] = convertVec3(
+                                    pFbxShapeNormals->GetDirectArray().GetAt(it->normal));
                             }
                             else
                             {
                                 osg::Vec3Array* pNormals = static_cast<osg::Vec3Array*>(pGeometry->getNormalArray());
-                                (*pNormals)[gi.second] = convertVec3(
-                                    pFbxShapeNormals->GetDirectArray().GetAt(osgToFbxNormMap[gi]));
+                                (*pNormals)[it->index] = convertVec3(
+                                    pFbxShapeNormals->GetDirectArray().GetAt(it->normal));
                             }
                         }
                     }
@@ -1173,28 +1360,30 @@ osgDB::ReaderWriter::ReadResult OsgFbxReader::readMesh(
                     int gmmIndex = pIndices[k];
                     float weight = static_cast<float>(pWeights[k]);
 
-                    for (FbxToOsgVertexMap::const_iterator it =
-                        fbxToOsgVertMap.find(gmmIndex);
-                        it != fbxToOsgVertMap.end() &&
-                        it->first == gmmIndex; ++it)
+                    for (const FbxToOsgVertexMap::Vertex* it = fbxToOsgVertMap.begin(gmmIndex),
+                        *itEnd = fbxToOsgVertMap.end(gmmIndex); it != itEnd; ++it)
                     {
-                        GIPair gi = it->second;
                         osgAnimation::RigGeometry& rig =
-                            dynamic_cast<osgAnimation::RigGeometry&>(
-                            *old2newGeometryMap[gi.first]);
+                            static_cast<osgAnimation::RigGeometry&>(
+                            *old2newGeometryMap[it->pGeometry]);
                         addBindMatrix(boneBindMatrices, pBone, bindMatrix, &rig);
                         osgAnimation::VertexInfluenceMap& vim =
                             *rig.getInfluenceMap();
                         osgAnimation::VertexInfluence& vi =
                             getVertexInfluence(vim, pBone->GetName());
                         vi.push_back(osgAnimation::VertexIndexWeight(
-                            gi.second, weight));
+                            it->index, weight));
                     }
                 }
             }
         }
     }
 
+    OSG_INFO << "GMM vertex mapping " << pGeode->getName() << ": " << fbxToOsgVertMap.vertices.size()
+        << " vertices, built in " << osg::Timer::instance()->delta_m(mappingStart, mappingBuilt)
+        << " ms, blend shapes and skin in " << osg::Timer::instance()->delta_m(mappingBuilt, osg::Timer::instance()->tick())
+        << " ms" << std::endl;
+
     FbxAMatrix gmmGeometricTransform;
     gmmGeometricTransform.SetTRS(
         pNode->GeometricTranslation.Get(),
@@ -28,7 +28,7 @@ public:
     const std::set<const FbxNode*>& gmmSkeletons;
     std::map<FbxNode*, osgAnimation::Skeleton*> skeletonMap;
     const osgDB::Options& options;
-    bool lightmapTextures, tessellatePolygons;
+    bool lightmapTextures, tessellatePolygons, weldVertices, optimizeMesh, transparentMesh;
 
     enum AuthoringTool
     {
@@ -45,7 +45,10 @@ public:
         const osgDB::Options& options1,
         AuthoringTool authoringTool1,
         bool lightmapTextures1,
-        bool tessellatePolygons1)
+        bool tessellatePolygons1,
+        bool weldVertices1 = true,
+        bool optimizeMesh1 = true,
+        bool transparentMesh1 = false)
         : pSdkManager(pSdkManager1),
         gmmScene(gmmScene1),
         gmmMaterialToOsgStateSet(gmmMaterialToOsgStateSet1),
@@ -53,6 +56,9 @@ public:
         options(options1),
         lightmapTextures(lightmapTextures1),
         tessellatePolygons(tessellatePolygons1),
+        weldVertices(weldVertices1),
+        optimizeMesh(optimizeMesh1),
+        transparentMesh(transparentMesh1),
         authoringTool(authoringTool1)
     {}
 
@@ -0,0 +1,291 @@
+//////////////////////////////////////////////////////////////////////////
+/// COPYRIGHT NOTICE
+/// Copyright (c) 2020~2030, LiuTao
+/// All rights reserved.
+///
+/// @file		GMAudioBackendTest.cpp
+/// @brief		Galaxy-Music Engine - wav解码器、空输出和文件后端的检查
+/// @version	1.0
+/// @author		LiuTao
+/// @date		2025.03.26
+///
+/// 只依赖标准库，不需要BASS、OSG和声卡，单独编译运行：
+///   g++ -std=c++14 -pthread -I Engine Engine/GMAudioBackend.cpp Engine/Test/GMAudioBackendTest.cpp -o GMAudioBackendTest
+///   cl /EHsc /std:c++14 /I Engine Engine\GMAudioBackend.cpp Engine\Test\GMAudioBackendTest.cpp
+/// 全部通过返回0，否则打印失败的检查并返回1
+//////////////////////////////////////////////////////////////////////////
+
+#include "GMAudioBackend.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+using namespace GM;
+
+/*************************************************************************
+Macro Defines
+*************************************************************************/
+
+#define GM_CHECK(x) do { if (!(x)) { printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #x); s_iFailed++; } } while (0)
+
+/*************************************************************************
+Local Functions
+*************************************************************************/
+
+static int s_iFailed = 0;
+
+/** @brief 写一个小端整数 */
+static void _WriteLE(std::ofstream& file, unsigned int iValue, int iBytes)
+{
+	for (int i = 0; i < iBytes; i++)
+	{
+		file.put(char((iValue >> (8 * i)) & 0xFF));
+	}
+}
+
+/**
+* @brief 写wav文件，数据块前面放一个无关的块，检查解码器会跳过它
+* @param strFile: 文件路径
+* @param iFormat: 1整数PCM，3浮点PCM
+* @param iBits: 每个采样的位数
+* @param sampleVec: [-1,1]的交错采样
+*/
+static void _WriteWav(const std::string& strFile, int iFormat, int iChannels, int iRate, int iBits,
+	const std::vector<float>& sampleVec)
+{
+	const int iBytes = iBits / 8;
+	const unsigned int iDataSize = unsigned(sampleVec.size() * iBytes);
+	std::ofstream file(strFile, std::ios::binary);
+	file.write("RIFF", 4);
+	_WriteLE(file, 4 + 8 + 16 + 8 + 2 + 8 + iDataSize, 4);
+	file.write("WAVE", 4);
+	file.write("fmt ", 4);
+	_WriteLE(file, 16, 4);
+	_WriteLE(file, iFormat, 2);
+	_WriteLE(file, iChannels, 2);
+	_WriteLE(file, iRate, 4);
+	_WriteLE(file, iRate * iChannels * iBytes, 4);
+	_WriteLE(file, iChannels * iBytes, 2);
+	_WriteLE(file, iBits, 2);
+	file.write("LIST", 4);
+	_WriteLE(file, 1, 4);
+	file.put(0);
+	file.put(0);	// 奇数长度的块有一个填充字节
+	file.write("data", 4);
+	_WriteLE(file, iDataSize, 4);
+	for (float f : sampleVec)
+	{
+		if (3 == iFormat)
+		{
+			unsigned int iValue = 0;
+			memcpy(&iValue, &f, 4);
+			_WriteLE(file, iValue, 4);
+		}
+		else
+		{
+			const double fMax = double(1u << (iBits - 1)) - 1.0;
+			_WriteLE(file, unsigned(int(std::floor(f * fMax + 0.5))), iBytes);
+		}
+	}
+}
+
+static std::wstring _W(const std::string& str)
+{
+	return std::wstring(str.begin(), str.end());
+}
+
+/** @brief 各种位深的wav解码出的采样、长度、跳转 */
+static void _TestWavDecoder()
+{
+	std::vector<float> sampleVec;
+	for (int i = 0; i < 200; i++)
+	{
+		sampleVec.push_back(float(std::sin(i * 0.1)) * 0.5f);	// 左
+		sampleVec.push_back(-float(i) / 200.0f);					// 右
+	}
+
+	const int iBitsArray[] = { 16, 24, 32 };
+	for (int iBits : iBitsArray)
+	{
+		for (int iFormat = 1; iFormat <= 3; iFormat += 2)
+		{
+			if (3 == iFormat && 32 != iBits) continue;
+			const std::string strFile = "GMAudioBackendTest.wav";
+			_WriteWav(strFile, iFormat, 2, 22050, iBits, sampleVec);
+
+			CGMWavDecoder hDecoder;
+			GM_CHECK(hDecoder.Open(_W(strFile)));
+			GM_CHECK(22050 == hDecoder.GetSampleRate());
+			GM_CHECK(2 == hDecoder.GetChannels());
+			GM_CHECK(200 == hDecoder.GetLength());
+
+			// 解码按2^(n-1)缩放，写入按2^(n-1)-1，16位整数的误差最大
+			const float fTolerance = (3 == iFormat) ? 0.0f : 2.0f / 32767.0f;
+			std::vector<float> outVec(sampleVec.size() + 64, 9.0f);
+			GM_CHECK(150 == hDecoder.Read(outVec.data(), 150));
+			GM_CHECK(50 == hDecoder.Read(outVec.data() + 300, 80));
+			GM_CHECK(0 == hDecoder.Read(outVec.data() + 400, 10));
+			for (size_t i = 0; i < sampleVec.size(); i++)
+			{
+				GM_CHECK(std::fabs(outVec[i] - sampleVec[i]) <= fTolerance);
+			}
+
+			GM_CHECK(hDecoder.Seek(120));
+			float vFrame[2];
+			GM_CHECK(1 == hDecoder.Read(vFrame, 1));
+			GM_CHECK(std::fabs(vFrame[0] - sampleVec[240]) <= fTolerance);
+			GM_CHECK(std::fabs(vFrame[1] - sampleVec[241]) <= fTolerance);
+			GM_CHECK(hDecoder.Seek(1000));
+			GM_CHECK(0 == hDecoder.Read(vFrame, 1));
+			std::remove(strFile.c_str());
+		}
+	}
+
+	// 不支持的格式和不存在的文件
+	const std::string strBad = "GMAudioBackendTest.bad";
+	{
+		std::ofstream file(strBad, std::ios::binary);
+		file.write("RIFF\0\0\0\0MP3 ", 12);
+	}
+	CGMWavDecoder hBad;
+	GM_CHECK(!hBad.Open(_W(strBad)));
+	std::remove(strBad.c_str());
+	_WriteWav(strBad, 1, 2, 22050, 8, sampleVec);
+	CGMWavDecoder h8Bits;
+	GM_CHECK(!h8Bits.Open(_W(strBad)));
+	std::remove(strBad.c_str());
+	CGMWavDecoder hMissing;
+	GM_CHECK(!hMissing.Open(L"GMAudioBackendTest.missing.wav"));
+}
+
+/** @brief 文件后端按真实时间拉取采样，暂停和加锁时不拉取 */
+static void _TestFileBackend()
+{
+	const std::string strFile = "GMAudioBackendTest.wav";
+	_WriteWav(strFile, 1, 1, 48000, 16, std::vector<float>(48000, 0.25f));
+
+	CGMFileBackend hBackend;
+	GM_CHECK(hBackend.Init());
+	std::unique_ptr<CGMAudioDecoder> pDecoder(hBackend.OpenDecoder(_W(strFile)));
+	GM_CHECK(nullptr != pDecoder);
+	GM_CHECK(nullptr == hBackend.OpenDecoder(L"GMAudioBackendTest.missing.wav"));
+	if (!pDecoder)
+	{
+		std::remove(strFile.c_str());
+		return;
+	}
+
+	const int iRate = 48000;
+	long long iCallbackFrames = 0;
+	GM_CHECK(hBackend.OpenOutput(iRate, 1, [&](float* pData, int iFrames)
+	{
+		const int iRead = pDecoder->Read(pData, iFrames);
+		for (int i = iRead; i < iFrames; i++) pData[i] = 0.0f;
+		iCallbackFrames += iFrames;
+	}));
+	GM_CHECK(iRate == hBackend.GetOutputSampleRate());
+	GM_CHECK(1 == hBackend.GetOutputChannels());
+	GM_CHECK(hBackend.SetVolume(1.0f));
+
+	// 没有播放时不拉取
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	GM_CHECK(0 == hBackend.GetPulledFrames());
+
+	auto tStart = std::chrono::steady_clock::now();
+	hBackend.Play();
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	hBackend.Lock(true);
+	const double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+	const long long iPulled = hBackend.GetPulledFrames();
+	GM_CHECK(iPulled == iCallbackFrames);
+	GM_CHECK(iPulled == hBackend.GetPlayedFrames());
+	// 拉取的帧数跟随真实时间，开始播放前的不到一个更新间隔也会算进去，另外允许调度的误差
+	GM_CHECK(iPulled <= (long long)((fSeconds + 0.01) * iRate));
+	GM_CHECK(iPulled >= (long long)((fSeconds - 0.1) * iRate));
+	GM_CHECK(std::fabs(hBackend.GetLevel() - 0.25f) < 0.01f);
+
+	// 加锁期间不调用回调
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	GM_CHECK(iPulled == hBackend.GetPulledFrames());
+	hBackend.Lock(false);
+
+	hBackend.Pause();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	const long long iPaused = hBackend.GetPulledFrames();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	GM_CHECK(iPaused == hBackend.GetPulledFrames());
+	GM_CHECK(0.0f == hBackend.GetLevel());
+
+	// 换输出流不会让帧数归零
+	hBackend.CloseOutput();
+	GM_CHECK(0 == hBackend.GetOutputSampleRate());
+	GM_CHECK(hBackend.OpenOutput(iRate, 2, [](float* pData, int iFrames) { memset(pData, 0, sizeof(float) * 2 * iFrames); }));
+	GM_CHECK(iPaused == hBackend.GetPulledFrames());
+
+	hBackend.Release();
+	pDecoder.reset();
+	std::remove(strFile.c_str());
+}
+
+/*!
+*  @class CGMManualBackend
+*  @brief 和导出后端一样由调用者推进的空输出，不需要BASS
+*/
+class CGMManualBackend : public CGMNullBackend
+{
+public:
+	bool Init() { return true; }
+	void Release() { CloseOutput(); }
+	CGMAudioDecoder* OpenDecoder(const std::wstring&) { return nullptr; }
+	void Advance(const double fSeconds) { _Mix(fSeconds); }
+};
+
+/** @brief 按固定时间推进时，不足一帧的部分留到下一次，总帧数不漂移 */
+static void _TestNullBackend()
+{
+	CGMManualBackend hBackend;
+	GM_CHECK(hBackend.Init());
+	long long iCallbackFrames = 0;
+	GM_CHECK(hBackend.OpenOutput(48000, 2, [&](float* pData, int iFrames)
+	{
+		for (int i = 0; i < iFrames * 2; i++) pData[i] = -0.5f;
+		iCallbackFrames += iFrames;
+	}));
+
+	hBackend.Advance(1.0);
+	GM_CHECK(0 == hBackend.GetPulledFrames());
+
+	hBackend.Play();
+	for (int i = 0; i < 7 * 100; i++)
+	{
+		hBackend.Advance(1.0 / 7.0);
+	}
+	GM_CHECK(4800000 - 1 <= hBackend.GetPulledFrames() && hBackend.GetPulledFrames() <= 4800000);
+	GM_CHECK(iCallbackFrames == hBackend.GetPulledFrames());
+	GM_CHECK(std::fabs(hBackend.GetLevel() - 0.25f) < 1e-6f);
+
+	GM_CHECK(hBackend.SetVolume(4.0f));
+	hBackend.Advance(0.01);
+	GM_CHECK(1.0f == hBackend.GetLevel());
+	hBackend.Release();
+	GM_CHECK(0 == hBackend.GetOutputChannels());
+}
+
+/*************************************************************************
+Main
+*************************************************************************/
+
+int main()
+{
+	_TestWavDecoder();
+	_TestNullBackend();
+	_TestFileBackend();
+	if (0 == s_iFailed)
+		printf("GMAudioBackendTest: all checks passed\n");
+	return (0 == s_iFailed) ? 0 : 1;
+}
@@ -148,6 +148,8 @@ GLWidget::GLWidget( QWidget* parent, const QGLWidget* shareWidget, Qt::WindowFla
 : QGLWidget(parent, shareWidget, f),
 _gw( NULL ),
 _touchEventsEnabled( false ),
+_deferResize( false ),
+_resizePending( false ),
 _forwardKeyEvents( forwardKeyEvents )
 {
     _devicePixelRatio = GETDEVICEPIXELRATIO();
@@ -158,6 +160,8 @@ GLWidget::GLWidget( QGLContext* context, QWidget* parent, const QGLWidget* share
 : QGLWidget(context, parent, shareWidget, f),
 _gw( NULL ),
 _touchEventsEnabled( false ),
+_deferResize( false ),
+_resizePending( false ),
 _forwardKeyEvents( forwardKeyEvents )
 {
     _devicePixelRatio = GETDEVICEPIXELRATIO();
@@ -168,6 +172,8 @@ GLWidget::GLWidget( const QGLFormat& format, QWidget* parent, const QGLWidget* s
 : QGLWidget(format, parent, shareWidget, f),
 _gw( NULL ),
 _touchEventsEnabled( false ),
+_deferResize( false ),
+_resizePending( false ),
 _forwardKeyEvents( forwardKeyEvents )
 {
     _devicePixelRatio = GETDEVICEPIXELRATIO();
@@ -203,14 +209,31 @@ void GLWidget::setTouchEventsEnabled(bool e)
 #endif
 }
 
+void GLWidget::setDeferResize( bool d )
+{
+    if (d==_deferResize)
+        return;
+
+    _deferResize = d;
+
+    // the context is back in this thread, apply the last deferred resize now
+    if (!_deferResize && getNumDeferredEvents() > 0)
+        processDeferredEvents();
+}
+
 void GLWidget::processDeferredEvents()
 {
     QQueue<QEvent::Type> deferredEventQueueCopy;
+    bool resizePending = false;
+    QRect pendingRect;
     {
         QMutexLocker lock(&_deferredEventQueueMutex);
         deferredEventQueueCopy = _deferredEventQueue;
         _eventCompressor.clear();
         _deferredEventQueue.clear();
+        resizePending = _resizePending;
+        pendingRect = _pendingRect;
+        _resizePending = false;
     }
 
     while (!deferredEventQueueCopy.isEmpty())
@@ -218,6 +241,9 @@ void GLWidget::processDeferredEvents()
         QEvent event(deferredEventQueueCopy.dequeue());
         QGLWidget::event(&event);
     }
+
+    if (resizePending && _gw)
+        _gw->resized( pendingRect.x(), pendingRect.y(), pendingRect.width(), pendingRect.height() );
 }
 
 bool GLWidget::event( QEvent* event )
@@ -288,7 +314,10 @@ void GLWidget::resizeEvent( QResizeEvent* event )
 
     int scaled_width = static_cast<int>(size.width()*_devicePixelRatio);
     int scaled_height = static_cast<int>(size.height()*_devicePixelRatio);
-    _gw->resized( x(), y(), scaled_width,  scaled_height);
+    if (_deferResize)
+        enqueueDeferredResize( x(), y(), scaled_width, scaled_height );
+    else
+        _gw->resized( x(), y(), scaled_width,  scaled_height);
     _gw->getEventQueue()->windowResize( x(), y(), scaled_width, scaled_height );
     _gw->requestRedraw();
 }
@@ -298,7 +327,10 @@ void GLWidget::moveEvent( QMoveEvent* event )
     const QPoint& pos = event->pos();
     int scaled_width = static_cast<int>(width()*_devicePixelRatio);
     int scaled_height = static_cast<int>(height()*_devicePixelRatio);
-    _gw->resized( pos.x(), pos.y(), scaled_width,  scaled_height );
+    if (_deferResize)
+        enqueueDeferredResize( pos.x(), pos.y(), scaled_width, scaled_height );
+    else
+        _gw->resized( pos.x(), pos.y(), scaled_width,  scaled_height );
     _gw->getEventQueue()->windowResize( pos.x(), pos.y(), scaled_width,  scaled_height );
 }
 
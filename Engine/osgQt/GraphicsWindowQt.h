@@ -67,6 +67,11 @@ public:
     inline bool getTouchEventsEnabled() const { return _touchEventsEnabled; }
     void setTouchEventsEnabled( bool e );
 
+    /** When the graphics context is current in another thread, resize and move are deferred
+     *  and applied by that thread before its next makeCurrent, like the deferred Hide/Show events. */
+    inline bool getDeferResize() const { return _deferResize; }
+    void setDeferResize( bool d );
+
     void setKeyboardModifiers( QInputEvent* event );
 
     virtual void keyPressEvent( QKeyEvent* event );
@@ -83,7 +88,13 @@ protected:
     int getNumDeferredEvents()
     {
         QMutexLocker lock(&_deferredEventQueueMutex);
-        return _deferredEventQueue.count();
+        return _deferredEventQueue.count() + (_resizePending ? 1 : 0);
+    }
+    void enqueueDeferredResize( int x, int y, int width, int height )
+    {
+        QMutexLocker lock(&_deferredEventQueueMutex);
+        _pendingRect = QRect(x, y, width, height);
+        _resizePending = true;
     }
     void enqueueDeferredEvent(QEvent::Type eventType, QEvent::Type removeEventType = QEvent::None)
     {
@@ -112,6 +123,10 @@ protected:
 
     bool _touchEventsEnabled;
 
+    bool _deferResize;
+    bool _resizePending;
+    QRect _pendingRect;
+
     bool _forwardKeyEvents;
     qreal _devicePixelRatio;
 
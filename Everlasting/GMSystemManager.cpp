@@ -13,6 +13,10 @@
 #include "GMSystemManager.h"
 #include "GMStatsAndAchievements.h"
 #include "UI/GMUIManager.h"
+#include "../Engine/GMVectorOps.h"
+#include "../Engine/GMKit.h"
+#include "../Engine/GMScheduler.h"
+#include <osg/Timer>
 
 #include <thread>
 #include <QDesktopWidget>
@@ -28,7 +32,8 @@ using namespace GM;
 Macro Defines
 *************************************************************************/
 
-#define FRAME_UPDATE	15 	// 多少帧更新一次信息
+#define INFO_UPDATE_TIME	0.45	// 更新信息的间隔，单位：s
+#define FRAME_TIME			30		// 帧间隔，单位：ms
 
 /*************************************************************************
 CGMSystemManager Methods
@@ -66,8 +71,52 @@ bool CGMSystemManager::Init()
 	// 初始化界面
 	GM_UI_MANAGER.Init();
 
+	// 命令行参数：角色性能测试
+	if (QApplication::arguments().contains("--benchmark-dancers"))
+	{
+		GM_ENGINE.StartCharacterBenchmark();
+	}
+	// 命令行参数：向量批量运算性能测试
+	if (QApplication::arguments().contains("--benchmark-vectors"))
+	{
+		CGMVectorOps::Benchmark();
+	}
+	// 命令行参数：半精度转换和图片批量采样性能测试
+	if (QApplication::arguments().contains("--benchmark-kit"))
+	{
+		CGMKit::Benchmark();
+	}
+	// 命令行参数：录制输入，用于无界面模式的回放测试
+	const int iRecordArg = QApplication::arguments().indexOf("--record");
+	if (iRecordArg >= 0 && iRecordArg + 1 < QApplication::arguments().size())
+	{
+		GM_ENGINE.StartRecord(QApplication::arguments().at(iRecordArg + 1).toLocal8Bit().toStdString());
+	}
+
+	// 命令行参数：渲染放到独立的线程中，界面操作和渲染互不阻塞
+	if (QApplication::arguments().contains("--render-thread"))
+	{
+		GM_ENGINE.SetRenderThread(true, FRAME_TIME * 1e-3);
+	}
+	// 命令行参数：角色逻辑在工作线程中与绘制重叠
+	if (QApplication::arguments().contains("--parallel-sim"))
+	{
+		GM_ENGINE.SetParallelSimulation(true);
+	}
+	// 命令行参数：每帧都重绘背景、前景和阴影，用于对比性能
+	if (QApplication::arguments().contains("--no-pass-cache"))
+	{
+		GM_ENGINE.SetPassCache(false);
+	}
+
+	// 间隔更新的信息注册成定时任务
+	m_pScheduler = GM_NEW(CGMScheduler);
+	m_pScheduler->AddPeriodic(INFO_UPDATE_TIME, [this](double) { _UpdateInfo(); });
+
 	// 启动定时器
-	startTimer(30);
+	m_fLastTime = osg::Timer::instance()->time_s();
+	m_iTimerInterval = FRAME_TIME;
+	m_iTimerID = startTimer(m_iTimerInterval);
 
 	m_bInit = true;
 	return true;
@@ -79,6 +128,8 @@ bool CGMSystemManager::Release()
 	if (!m_bInit)
 		return true;
 
+	killTimer(m_iTimerID);
+	GM_DELETE(m_pScheduler);
 	GM_UI_MANAGER.Release();
 	GM_ENGINE.Release();
 
@@ -100,25 +151,46 @@ void CGMSystemManager::timerEvent(QTimerEvent *event)
 		m_bFirst = false;
 	}
 
-	// 间隔更新
-	m_iFrameCount++;
-	if (FRAME_UPDATE <= m_iFrameCount)
+	// 执行到期的定时任务
+	double fTime = osg::Timer::instance()->time_s();
+	m_pScheduler->Advance(fTime - m_fLastTime);
+	m_fLastTime = fTime;
+
+	_Render();
+	_UpdateTimer();
+}
+
+void CGMSystemManager::_UpdateInfo()
+{
+	if (GM_ENGINE.IsWelcomeFinished())
+	{
+		GM_UI_MANAGER.UpdateAudioInfo();
+	}
+	if (GM_ENGINE.IsWallpaper())
 	{
-		if (GM_ENGINE.IsWelcomeFinished())
-		{
-			GM_UI_MANAGER.UpdateAudioInfo();
-		}
-		if (GM_ENGINE.IsWallpaper())
-		{
-			GM_UI_MANAGER.UpdateWallpaper();
-		}
-
-		m_pStatsAndAchievements->RunFrame();
-
-		m_iFrameCount = 0;
+		GM_UI_MANAGER.UpdateWallpaper();
 	}
 
-	_Render();
+	m_pStatsAndAchievements->RunFrame();
+}
+
+void CGMSystemManager::_UpdateTimer()
+{
+	// 渲染时按帧间隔触发，不渲染时睡到引擎或者界面的下一个定时任务，减少空闲时的CPU占用
+	int iInterval = FRAME_TIME;
+	if (!GM_ENGINE.GetRendering())
+	{
+		double fIdle = GM_ENGINE.GetIdleTime();
+		const double fNext = m_pScheduler->GetTimeToNext();
+		if (fNext < fIdle) fIdle = fNext;
+		const int iIdle = int(fIdle * 1000);
+		if (iIdle > iInterval) iInterval = iIdle;
+	}
+	if (iInterval == m_iTimerInterval) return;
+
+	killTimer(m_iTimerID);
+	m_iTimerInterval = iInterval;
+	m_iTimerID = startTimer(m_iTimerInterval);
 }
 
 void CGMSystemManager::_Render()
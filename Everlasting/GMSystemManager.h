@@ -37,6 +37,7 @@ Class
 *************************************************************************/
 
 class CGMStatsAndAchievements;
+namespace GM { class CGMScheduler; }
 
 /*!
 *  @class CGMSystemManager
@@ -65,6 +66,10 @@ protected:
 private:
 	/** @brief 渲染更新 */
 	void _Render();
+	/** @brief 间隔更新界面上的信息 */
+	void _UpdateInfo();
+	/** @brief 不渲染时按下一个定时任务到期的时间调整定时器 */
+	void _UpdateTimer();
 
 public:
 	/** @brief 获取单例 */
@@ -74,7 +79,10 @@ private:
 	bool							m_bInit = false;				//!< 初始化标识
 	bool							m_bFirst = true;				//!< 是否第一帧
 
-	int								m_iFrameCount = 0;				//!< 帧数计数器，15帧一循环
+	GM::CGMScheduler*				m_pScheduler = nullptr;			//!< 界面线程的定时任务
+	double							m_fLastTime = 0.0;				//!< 上一次定时器触发的时间，单位：秒
+	int								m_iTimerID = 0;					//!< 定时器编号
+	int								m_iTimerInterval = 0;			//!< 定时器当前的间隔，单位：ms
 	uint							m_nKeyMask = 0;
 
 	CGMStatsAndAchievements*		m_pStatsAndAchievements = nullptr; //!< 统计和成就管理器
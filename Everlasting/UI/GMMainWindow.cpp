@@ -7,6 +7,8 @@
 #include <QKeyEvent>
 #include <QScreen>
 #include <QMenu>
+#include <QDateTime>
+#include <QStandardPaths>
 
 #include <atlbase.h> // Add this include to define CComPtr
 #include <ShObjIdl.h>
@@ -61,6 +63,7 @@ CGMMainWindow::CGMMainWindow(QWidget* parent)
 		QMenu* trayMenu = new QMenu(this);
 		//trayMenu->addAction(QString::fromLocal8Bit("播放器"), m_pPlayKitWidget, SLOT(show()));
 		m_pWallpaperPlayAct = trayMenu->addAction(QString::fromLocal8Bit("播放音乐"), this, SLOT(_slotWallpaperPlayOrPause()));
+		trayMenu->addAction(QString::fromLocal8Bit("截图"), this, SLOT(_slotScreenshot()));
 		trayMenu->addAction(QString::fromLocal8Bit("退出"), this, SLOT(_slotClose()));
 		m_pTrayIcon->setContextMenu(trayMenu);
 		m_pTrayIcon->show();
@@ -507,6 +510,14 @@ void CGMMainWindow::_slotWallpaperPlayOrPause()
 	}
 }
 
+void CGMMainWindow::_slotScreenshot()
+{
+	// 截图在后台线程写入，这里只发出请求
+	const QString strFile = QStandardPaths::writableLocation(QStandardPaths::PicturesLocation)
+		+ "/EVERLASTING/EVERLASTING_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz") + ".png";
+	GM_ENGINE.Capture(strFile.toLocal8Bit().toStdString());
+}
+
 void CGMMainWindow::_slotWakeUpWallpaper()
 {
 	// 清空历史记录
@@ -875,6 +886,12 @@ bool CGMMainWindow::eventFilter(QObject* obj, QEvent* event)
 			return true; // 事件已处理，不再传递
 		}
 		break;
+		case Qt::Key_F12:
+		{
+			_slotScreenshot();
+			return true; // 事件已处理，不再传递
+		}
+		break;
 		case Qt::Key_F11:
 		{
 			SetFullScreen(!m_bFull);
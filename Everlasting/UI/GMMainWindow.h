@@ -88,6 +88,11 @@ private slots:
 	*/
 	void _slotWallpaperPlayOrPause();
 
+	/**
+	* @brief 截图，保存到“图片/EVERLASTING”文件夹
+	*/
+	void _slotScreenshot();
+
 	/**
 	* @brief 唤醒桌面壁纸
 	*/
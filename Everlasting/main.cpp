@@ -11,6 +11,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "GMSystemManager.h"
+#include "../Engine/GMHeadless.h"
+#include "../Engine/GMExporter.h"
 #include "steam/steam_api.h"
 #include <QTextCodec>
 #include <QFileInfo>
@@ -19,11 +21,38 @@
 #include <QIcon>
 #include <QTranslator>
 #include <iostream>
+#include <cstring>
 
 using namespace GM;
 
 int main(int argc, char **argv)
 {
+	// 无界面性能测试，不需要Steam和Qt窗口
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "--headless"))
+		{
+			SGMHeadlessOption sOption;
+			if (!CGMHeadless::ParseArgs(argc, argv, sOption))
+			{
+				std::cout << "Invalid headless arguments" << std::endl;
+				return EXIT_FAILURE;
+			}
+			return CGMHeadless::Run(sOption);
+		}
+		// 离线导出视频，同样不需要Steam和Qt窗口
+		if (0 == strcmp(argv[i], "--export"))
+		{
+			SGMExportOption sOption;
+			if (!CGMExporter::ParseArgs(argc, argv, sOption))
+			{
+				std::cout << "Invalid export arguments" << std::endl;
+				return EXIT_FAILURE;
+			}
+			return CGMExporter::Run(sOption);
+		}
+	}
+
 	if (SteamAPI_RestartAppIfNecessary(4241180))
 	{
 		// if Steam is not running or the game wasn't started through Steam, SteamAPI_RestartAppIfNecessary starts the 